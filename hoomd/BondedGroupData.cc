@@ -303,6 +303,92 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initializeFromS
         }
     }
 
+/*! \param members Member tags of the local groups
+    \param typeval Types (or constraint values) of the local groups
+    \param tags Group tags of the local groups
+    \param global_tags Set of all active group tags in the whole system (identical on all ranks)
+    \param type_mapping Group type names
+
+    Each rank supplies the groups it stored locally when the data was saved. Unused tags below the maximum tag
+    are made available for recycling. In MPI simulations, the member ranks are reset and refreshed by the
+    Communicator on the next migration step.
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::restoreLocalGroups(
+    const std::vector<members_t>& members,
+    const std::vector<typeval_t>& typeval,
+    const std::vector<unsigned int>& tags,
+    const std::vector<unsigned int>& global_tags,
+    const std::vector<std::string>& type_mapping)
+    {
+    assert(members.size() == typeval.size() && members.size() == tags.size());
+
+    // re-initialize data structures
+    initialize();
+
+    m_type_mapping = type_mapping;
+
+    m_tag_set.insert(global_tags.begin(), global_tags.end());
+    m_invalid_cached_tags = true;
+
+    unsigned int max_tag = m_tag_set.empty() ? 0 : *m_tag_set.rbegin();
+    for (unsigned int tag = max_tag; tag-- > 0;)
+        if (m_tag_set.find(tag) == m_tag_set.end())
+            m_recycled_tags.push(tag);
+
+    m_group_rtag.resize(m_tag_set.empty() ? 0 : max_tag+1);
+
+    unsigned int n_groups = members.size();
+    m_groups.resize(n_groups);
+    m_group_typeval.resize(n_groups);
+    m_group_tag.resize(n_groups);
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        m_group_ranks.resize(n_groups);
+    #endif
+
+        {
+        ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::overwrite);
+        ArrayHandle<typeval_t> h_typeval(m_group_typeval, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_tag(m_group_tag, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_rtag(m_group_rtag, access_location::host, access_mode::overwrite);
+
+        for (unsigned int tag = 0; tag < m_group_rtag.size(); ++tag)
+            h_group_rtag.data[tag] = GROUP_NOT_LOCAL;
+
+        for (unsigned int group_idx = 0; group_idx < n_groups; ++group_idx)
+            {
+            unsigned int tag = tags[group_idx];
+            if (m_tag_set.find(tag) == m_tag_set.end())
+                {
+                m_exec_conf->msg->error() << name << " tag " << tag << " is not an active tag" << std::endl;
+                throw runtime_error(std::string("Error initializing ") + name + std::string(" data."));
+                }
+
+            h_groups.data[group_idx] = members[group_idx];
+            h_typeval.data[group_idx] = typeval[group_idx];
+            h_group_tag.data[group_idx] = tag;
+            h_group_rtag.data[tag] = group_idx;
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        ArrayHandle<ranks_t> h_group_ranks(m_group_ranks, access_location::host, access_mode::overwrite);
+        memset(h_group_ranks.data, 0, sizeof(ranks_t)*n_groups);
+        }
+    #endif
+
+    m_n_groups = n_groups;
+    m_nglobal = m_tag_set.size();
+
+    // notify observers
+    m_group_num_change_signal.emit();
+    notifyGroupReorder();
+    }
+
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::addBondedGroup(Group g)
     {
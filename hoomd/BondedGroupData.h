@@ -249,6 +249,13 @@ class BondedGroupData
         //! Take a snapshot
         virtual std::map<unsigned int, unsigned int> takeSnapshot(Snapshot& snapshot) const;
 
+        //! Replace the local groups without communication
+        void restoreLocalGroups(const std::vector<members_t>& members,
+                                const std::vector<typeval_t>& typeval,
+                                const std::vector<unsigned int>& tags,
+                                const std::vector<unsigned int>& global_tags,
+                                const std::vector<std::string>& type_mapping);
+
         //! Get local number of bonded groups
         unsigned int getN() const
             {
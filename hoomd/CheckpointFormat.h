@@ -0,0 +1,153 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file CheckpointFormat.h
+    \brief Helper functions shared by CheckpointWriter and CheckpointReader
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __CHECKPOINT_FORMAT_H__
+#define __CHECKPOINT_FORMAT_H__
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+/*! A checkpoint consists of one index file and one data file per MPI rank. Both are written in native byte order
+    and are only meant to be read back by the same build of HOOMD-blue on the same type of machine.
+
+    The index file \a fname is written by the root rank. It stores the global state: timestep, box, type names,
+    active tags, integrator variables and the domain decomposition. The data file \a fname.<timestep>.<rank> holds the local
+    particles (as pdata_element records) and the local bonded groups of that rank.
+
+    Every file begins with the magic string, the format version, sizeof(Scalar), sizeof(pdata_element) and the
+    timestep, so that mismatched or partially overwritten checkpoints are detected on reading.
+*/
+namespace hoomd
+{
+namespace detail
+{
+
+//! Magic string at the beginning of every checkpoint file
+const char checkpoint_magic[8] = {'H','O','O','M','D','C','K','P'};
+
+//! Current version of the checkpoint format
+const uint32_t checkpoint_version = 1;
+
+//! Write a plain value
+template<class T>
+inline void checkpoint_write(std::ostream& out, const T& v)
+    {
+    out.write((const char *)&v, sizeof(T));
+    }
+
+//! Write a vector of plain values, preceded by its length
+template<class T>
+inline void checkpoint_write(std::ostream& out, const std::vector<T>& v)
+    {
+    uint64_t n = v.size();
+    out.write((const char *)&n, sizeof(uint64_t));
+    if (n > 0)
+        out.write((const char *)&v[0], sizeof(T)*n);
+    }
+
+//! Write a string, preceded by its length
+inline void checkpoint_write(std::ostream& out, const std::string& s)
+    {
+    uint64_t n = s.size();
+    out.write((const char *)&n, sizeof(uint64_t));
+    out.write(s.data(), n);
+    }
+
+//! Write a list of strings
+inline void checkpoint_write(std::ostream& out, const std::vector<std::string>& v)
+    {
+    uint64_t n = v.size();
+    out.write((const char *)&n, sizeof(uint64_t));
+    for (unsigned int i = 0; i < n; ++i)
+        checkpoint_write(out, v[i]);
+    }
+
+//! Read a plain value
+template<class T>
+inline void checkpoint_read(std::istream& in, T& v)
+    {
+    in.read((char *)&v, sizeof(T));
+    if (!in)
+        throw std::runtime_error("Unexpected end of checkpoint file");
+    }
+
+//! Read a vector of plain values
+template<class T>
+inline void checkpoint_read(std::istream& in, std::vector<T>& v)
+    {
+    uint64_t n = 0;
+    checkpoint_read(in, n);
+    v.resize(n);
+    if (n > 0)
+        in.read((char *)&v[0], sizeof(T)*n);
+    if (!in)
+        throw std::runtime_error("Unexpected end of checkpoint file");
+    }
+
+//! Read a string
+inline void checkpoint_read(std::istream& in, std::string& s)
+    {
+    uint64_t n = 0;
+    checkpoint_read(in, n);
+    s.resize(n);
+    if (n > 0)
+        in.read(&s[0], n);
+    if (!in)
+        throw std::runtime_error("Unexpected end of checkpoint file");
+    }
+
+//! Read a list of strings
+inline void checkpoint_read(std::istream& in, std::vector<std::string>& v)
+    {
+    uint64_t n = 0;
+    checkpoint_read(in, n);
+    v.resize(n);
+    for (unsigned int i = 0; i < n; ++i)
+        checkpoint_read(in, v[i]);
+    }
+
+//! Compress a sorted list of tags into half-open ranges [first, second)
+/*! Tags are contiguous in the common case, so this stores the global tag set in a few bytes instead of
+    4 bytes per particle.
+*/
+inline std::vector< std::pair<unsigned int, unsigned int> > checkpoint_encode_tags(const std::vector<unsigned int>& tags)
+    {
+    std::vector< std::pair<unsigned int, unsigned int> > ranges;
+    for (unsigned int i = 0; i < tags.size(); ++i)
+        {
+        if (!ranges.empty() && ranges.back().second == tags[i])
+            ranges.back().second++;
+        else
+            ranges.push_back(std::make_pair(tags[i], tags[i]+1));
+        }
+    return ranges;
+    }
+
+//! Expand a list of tag ranges into a sorted list of tags
+inline std::vector<unsigned int> checkpoint_decode_tags(const std::vector< std::pair<unsigned int, unsigned int> >& ranges)
+    {
+    std::vector<unsigned int> tags;
+    for (unsigned int i = 0; i < ranges.size(); ++i)
+        for (unsigned int tag = ranges[i].first; tag < ranges[i].second; ++tag)
+            tags.push_back(tag);
+    return tags;
+    }
+
+} // end namespace detail
+} // end namespace hoomd
+
+#endif
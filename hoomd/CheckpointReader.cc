@@ -0,0 +1,293 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file CheckpointReader.cc
+    \brief Defines the CheckpointReader class
+*/
+
+#include "CheckpointReader.h"
+#include "CheckpointFormat.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#include "DomainDecomposition.h"
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <string.h>
+#include <errno.h>
+#include <stdexcept>
+
+using namespace std;
+using namespace hoomd::detail;
+namespace py = pybind11;
+
+/*! \param exec_conf The execution configuration
+    \param fname Base file name of the checkpoint
+
+    The index file is read on the root rank and broadcast to all other ranks.
+*/
+CheckpointReader::CheckpointReader(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                   const std::string &fname)
+    : m_exec_conf(exec_conf), m_fname(fname), m_timestep(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CheckpointReader: " << fname << endl;
+
+    int success = 1;
+    if (m_exec_conf->isRoot())
+        {
+        m_exec_conf->msg->notice(3) << "init.read_checkpoint: open checkpoint " << fname << endl;
+        ifstream in(fname.c_str(), ios::in | ios::binary);
+        if (!in)
+            {
+            m_exec_conf->msg->error() << "init.read_checkpoint: " << strerror(errno) << " - " << fname << endl;
+            success = 0;
+            }
+        else
+            {
+            ostringstream contents;
+            contents << in.rdbuf();
+            m_index = contents.str();
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    bcast(success, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (!success)
+        throw runtime_error("Error opening checkpoint");
+
+    #ifdef ENABLE_MPI
+    bcast(m_index, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    istringstream index(m_index);
+    m_timestep = readHeader(index, m_fname);
+    }
+
+/*! \param in Stream to read from
+    \param fname File name (for error messages)
+
+    \returns The timestep stored in the header
+
+    Validate the magic string, format version and build compatibility.
+*/
+uint64_t CheckpointReader::readHeader(std::istream& in, const std::string& fname)
+    {
+    char magic[sizeof(checkpoint_magic)];
+    in.read(magic, sizeof(magic));
+    if (!in || memcmp(magic, checkpoint_magic, sizeof(magic)) != 0)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << fname << " is not a valid checkpoint file" << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    uint32_t version = 0, scalar_size = 0, element_size = 0;
+    checkpoint_read(in, version);
+    checkpoint_read(in, scalar_size);
+    checkpoint_read(in, element_size);
+    if (version != checkpoint_version)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: invalid checkpoint version " << version << " in " << fname << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+    if (scalar_size != sizeof(Scalar) || element_size != sizeof(pdata_element))
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << fname
+                                  << " was written by a build with a different precision" << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    uint64_t timestep = 0;
+    checkpoint_read(in, timestep);
+    return timestep;
+    }
+
+/*! Construct the SystemDefinition (and the domain decomposition in MPI runs) and fill it from the checkpoint.
+    Each rank reads only its own data file.
+*/
+std::shared_ptr<SystemDefinition> CheckpointReader::getSystemDefinition()
+    {
+    istringstream index(m_index);
+    readHeader(index, m_fname);
+
+    uint32_t nranks = 0;
+    checkpoint_read(index, nranks);
+    if (nranks != m_exec_conf->getNRanks())
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << m_fname << " was written by " << nranks
+                                  << " ranks, it cannot be read by " << m_exec_conf->getNRanks() << " ranks" << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    // box
+    uint32_t dimensions = 3;
+    Scalar3 L;
+    Scalar xy, xz, yz;
+    checkpoint_read(index, dimensions);
+    checkpoint_read(index, L);
+    checkpoint_read(index, xy);
+    checkpoint_read(index, xz);
+    checkpoint_read(index, yz);
+    BoxDim box(L);
+    box.setTiltFactors(xy, xz, yz);
+
+    // domain decomposition
+    uint8_t has_decomposition = 0;
+    checkpoint_read(index, has_decomposition);
+
+    unsigned int file_rank = 0;
+    std::shared_ptr<DomainDecomposition> decomposition;
+    if (has_decomposition)
+        {
+        #ifdef ENABLE_MPI
+        uint3 grid;
+        std::vector<Scalar> cum_frac[3];
+        std::vector<unsigned int> cart_ranks;
+        checkpoint_read(index, grid);
+        checkpoint_read(index, cum_frac[0]);
+        checkpoint_read(index, cum_frac[1]);
+        checkpoint_read(index, cum_frac[2]);
+        checkpoint_read(index, cart_ranks);
+
+        decomposition = std::shared_ptr<DomainDecomposition>(
+            new DomainDecomposition(m_exec_conf, L, grid.x, grid.y, grid.z, false));
+
+        uint3 new_grid = decomposition->getGridSize();
+        if (new_grid.x != grid.x || new_grid.y != grid.y || new_grid.z != grid.z)
+            {
+            m_exec_conf->msg->error() << "init.read_checkpoint: unable to recreate the " << grid.x << "x" << grid.y
+                                      << "x" << grid.z << " domain decomposition" << endl;
+            throw runtime_error("Error reading checkpoint");
+            }
+
+        for (unsigned int dir = 0; dir < 3; ++dir)
+            decomposition->setCumulativeFractions(dir, cum_frac[dir], 0);
+
+        // read the file of the rank that owned this domain when the checkpoint was written
+        uint3 pos = decomposition->getGridPos();
+        file_rank = cart_ranks[decomposition->getDomainIndexer()(pos.x, pos.y, pos.z)];
+        #else
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << m_fname << " requires MPI support" << endl;
+        throw runtime_error("Error reading checkpoint");
+        #endif
+        }
+
+    // particle types, tags, and global state
+    std::vector<std::string> type_mapping;
+    std::vector< std::pair<unsigned int, unsigned int> > tag_ranges;
+    uint8_t accel_set = 0;
+    Scalar3 origin;
+    int3 o_image;
+    checkpoint_read(index, type_mapping);
+    checkpoint_read(index, tag_ranges);
+    checkpoint_read(index, accel_set);
+    checkpoint_read(index, origin);
+    checkpoint_read(index, o_image);
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(0,
+                                                                  box,
+                                                                  type_mapping.size(),
+                                                                  0,
+                                                                  0,
+                                                                  0,
+                                                                  0,
+                                                                  m_exec_conf,
+                                                                  decomposition));
+    sysdef->setNDimensions(dimensions);
+
+    // open the local data file
+    ostringstream local_name;
+    local_name << m_fname << "." << m_timestep << "." << file_rank;
+    m_exec_conf->msg->notice(3) << "init.read_checkpoint: reading " << local_name.str() << endl;
+    ifstream local(local_name.str().c_str(), ios::in | ios::binary);
+    if (!local)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << strerror(errno) << " - " << local_name.str() << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+    if (readHeader(local, local_name.str()) != m_timestep)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << local_name.str()
+                                  << " does not belong to the same checkpoint as " << m_fname << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    uint32_t rank = 0;
+    checkpoint_read(local, rank);
+    if (rank != file_rank)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << local_name.str() << " belongs to rank " << rank << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::vector<pdata_element> particles;
+    checkpoint_read(local, particles);
+    pdata->restoreLocalParticles(particles, checkpoint_decode_tags(tag_ranges), type_mapping);
+    pdata->setOrigin(origin, o_image);
+    if (accel_set)
+        pdata->notifyAccelSet();
+
+    restoreGroups(index, local, sysdef->getBondData());
+    restoreGroups(index, local, sysdef->getAngleData());
+    restoreGroups(index, local, sysdef->getDihedralData());
+    restoreGroups(index, local, sysdef->getImproperData());
+    restoreGroups(index, local, sysdef->getConstraintData());
+    restoreGroups(index, local, sysdef->getPairData());
+
+    // integrator variables
+    std::shared_ptr<IntegratorData> integrator_data = sysdef->getIntegratorData();
+    uint32_t n_integrators = 0;
+    checkpoint_read(index, n_integrators);
+    integrator_data->load(n_integrators);
+    for (unsigned int i = 0; i < n_integrators; ++i)
+        {
+        IntegratorVariables v;
+        checkpoint_read(index, v.type);
+        checkpoint_read(index, v.variable);
+        integrator_data->setIntegratorVariables(i, v);
+        }
+
+    return sysdef;
+    }
+
+/*! \param index Stream of the index file
+    \param local Stream of the local data file
+    \param gdata Bonded group data to restore
+*/
+template<class group_data>
+void CheckpointReader::restoreGroups(std::istream& index, std::istream& local, std::shared_ptr<group_data> gdata)
+    {
+    std::vector<std::string> type_mapping;
+    std::vector< std::pair<unsigned int, unsigned int> > tag_ranges;
+    checkpoint_read(index, type_mapping);
+    checkpoint_read(index, tag_ranges);
+
+    std::vector<typename group_data::members_t> members;
+    std::vector<typeval_t> typeval;
+    std::vector<unsigned int> tags;
+    checkpoint_read(local, members);
+    checkpoint_read(local, typeval);
+    checkpoint_read(local, tags);
+
+    if (members.size() != typeval.size() || members.size() != tags.size())
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: corrupt " << group_data::getName() << " data" << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    gdata->restoreLocalGroups(members, typeval, tags, checkpoint_decode_tags(tag_ranges), type_mapping);
+    }
+
+void export_CheckpointReader(py::module& m)
+    {
+    py::class_< CheckpointReader, std::shared_ptr<CheckpointReader> >(m,"CheckpointReader")
+    .def(py::init<std::shared_ptr<ExecutionConfiguration>, const string&>())
+    .def("getTimeStep", &CheckpointReader::getTimeStep)
+    .def("getSystemDefinition", &CheckpointReader::getSystemDefinition)
+    ;
+    }
@@ -0,0 +1,71 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file CheckpointReader.h
+    \brief Declares the CheckpointReader class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "SystemDefinition.h"
+
+#include <string>
+#include <memory>
+#include <iostream>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __CHECKPOINT_READER_H__
+#define __CHECKPOINT_READER_H__
+
+//! Restores a native binary checkpoint
+/*! CheckpointReader reads the files written by CheckpointWriter and builds a SystemDefinition from them. The index
+    file is read on the root rank and broadcast, after which every rank reads only its own data file and fills its
+    local ParticleData and bonded group tables directly. No snapshot is created and no particle data is scattered.
+
+    The checkpoint must be restored with the same number of ranks it was written with. The domain decomposition
+    (grid and box fractions) is restored from the checkpoint, and each rank reads the data file written by the rank
+    that owned the same domain.
+
+    Integrator variables are placed in IntegratorData, so integrators constructed afterwards in the same order pick
+    up their thermostat and barostat state.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT CheckpointReader
+    {
+    public:
+        //! Open the checkpoint and read the index file
+        CheckpointReader(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                         const std::string &fname);
+
+        //! Returns the timestep of the simulation
+        unsigned int getTimeStep() const
+            {
+            return m_timestep;
+            }
+
+        //! Build the system definition from the checkpoint
+        std::shared_ptr<SystemDefinition> getSystemDefinition();
+
+    private:
+        std::shared_ptr<ExecutionConfiguration> m_exec_conf; //!< The execution configuration
+        std::string m_fname;                                   //!< Base file name
+        std::string m_index;                                   //!< Contents of the index file
+        uint64_t m_timestep;                                   //!< Timestep of the checkpoint
+
+        //! Check the header common to all checkpoint files
+        uint64_t readHeader(std::istream& in, const std::string& fname);
+
+        //! Restore a bonded group data from the index and local data files
+        template<class group_data>
+        void restoreGroups(std::istream& index, std::istream& local, std::shared_ptr<group_data> gdata);
+    };
+
+//! Exports CheckpointReader to python
+void export_CheckpointReader(pybind11::module& m);
+
+#endif
@@ -0,0 +1,330 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file CheckpointWriter.cc
+    \brief Defines the CheckpointWriter class
+*/
+
+#include "CheckpointWriter.h"
+#include "CheckpointFormat.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <stdexcept>
+
+using namespace std;
+using namespace hoomd::detail;
+namespace py = pybind11;
+
+/*! \param sysdef SystemDefinition containing the data to save
+    \param fname Base file name. The index file is \a fname, the per-rank data files are \a fname.<timestep>.<rank>
+
+    No file operations are attempted until analyze() is called.
+*/
+CheckpointWriter::CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef,
+                                   const std::string &fname)
+    : Analyzer(sysdef), m_fname(fname), m_have_prev(false), m_prev_timestep(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CheckpointWriter: " << m_fname << endl;
+    }
+
+CheckpointWriter::~CheckpointWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying CheckpointWriter" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    Every rank writes its data file under a temporary name and renames it to the versioned name
+    \a fname.<timestep>.<rank> once all ranks succeeded. The data files referenced by the current index file are
+    left untouched until the root rank has renamed the new index file in place, so that an interruption at any
+    point leaves one complete checkpoint on disk. The files of the previous checkpoint are removed last.
+
+    The success flags are reduced over all ranks after every step, so that all ranks throw together.
+*/
+void CheckpointWriter::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Checkpoint");
+
+    // find the checkpoint we are about to replace
+    if (!m_have_prev)
+        {
+        m_have_prev = readPreviousTimestep(m_prev_timestep);
+        #ifdef ENABLE_MPI
+        if (m_pdata->getDomainDecomposition())
+            {
+            bcast(m_have_prev, 0, m_exec_conf->getMPICommunicator());
+            bcast(m_prev_timestep, 0, m_exec_conf->getMPICommunicator());
+            }
+        #endif
+        }
+
+    const string local_name = getDataFileName(timestep, m_exec_conf->getRank());
+    const string local_tmp = local_name + ".tmp";
+    const string index_tmp = m_fname + ".tmp";
+
+    m_exec_conf->msg->notice(3) << "dump.checkpoint: writing " << local_name << endl;
+
+    int success = 1;
+        {
+        ofstream out(local_tmp.c_str(), ios::out | ios::binary | ios::trunc);
+        writeLocal(out, timestep);
+        out.close();
+        if (!out)
+            {
+            m_exec_conf->msg->error() << "dump.checkpoint: " << strerror(errno) << " - " << local_tmp << endl;
+            success = 0;
+            }
+        }
+
+    if (m_exec_conf->isRoot())
+        {
+        ofstream out(index_tmp.c_str(), ios::out | ios::binary | ios::trunc);
+        writeIndex(out, timestep);
+        out.close();
+        if (!out)
+            {
+            m_exec_conf->msg->error() << "dump.checkpoint: " << strerror(errno) << " - " << index_tmp << endl;
+            success = 0;
+            }
+        }
+
+    if (!allSucceeded(success))
+        {
+        remove(local_tmp.c_str());
+        if (m_exec_conf->isRoot())
+            remove(index_tmp.c_str());
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    // the current index does not reference the new data files, so they can be put in place first
+    if (rename(local_tmp.c_str(), local_name.c_str()) != 0)
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: " << strerror(errno) << " - " << local_name << endl;
+        success = 0;
+        }
+
+    if (!allSucceeded(success))
+        {
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    // renaming the index commits the new checkpoint
+    if (m_exec_conf->isRoot() && rename(index_tmp.c_str(), m_fname.c_str()) != 0)
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: " << strerror(errno) << " - " << m_fname << endl;
+        success = 0;
+        }
+
+    if (!allSucceeded(success))
+        {
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    // the previous data files are no longer referenced
+    if (m_have_prev && m_prev_timestep != timestep)
+        remove(getDataFileName(m_prev_timestep, m_exec_conf->getRank()).c_str());
+
+    m_have_prev = true;
+    m_prev_timestep = timestep;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param timestep Time step of the checkpoint
+    \param rank Rank that writes the file
+    \returns The name of the data file
+*/
+std::string CheckpointWriter::getDataFileName(uint64_t timestep, unsigned int rank) const
+    {
+    ostringstream name;
+    name << m_fname << "." << timestep << "." << rank;
+    return name.str();
+    }
+
+/*! \param timestep Set to the time step of the existing index file
+    \returns true if a valid index file exists on the root rank
+
+    Only the root rank reads the file, the result needs to be broadcast to the other ranks.
+*/
+bool CheckpointWriter::readPreviousTimestep(uint64_t& timestep)
+    {
+    if (!m_exec_conf->isRoot())
+        return false;
+
+    // the header is read by hand, a missing or truncated file is not an error here
+    ifstream in(m_fname.c_str(), ios::in | ios::binary);
+    char magic[sizeof(checkpoint_magic)];
+    uint32_t header[3];
+    in.read(magic, sizeof(magic));
+    in.read((char *)header, sizeof(header));
+    in.read((char *)&timestep, sizeof(timestep));
+
+    return in && memcmp(magic, checkpoint_magic, sizeof(magic)) == 0 && header[0] == checkpoint_version;
+    }
+
+/*! \param success Flag of this rank (1 or 0)
+    \returns true if all ranks succeeded
+*/
+bool CheckpointWriter::allSucceeded(int success)
+    {
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        MPI_Allreduce(MPI_IN_PLACE, &success, 1, MPI_INT, MPI_MIN, m_exec_conf->getMPICommunicator());
+    #endif
+
+    return success != 0;
+    }
+
+/*! \param out Stream to write to
+    \param timestep Current time step
+*/
+void CheckpointWriter::writeLocal(std::ostream& out, unsigned int timestep)
+    {
+    out.write(checkpoint_magic, sizeof(checkpoint_magic));
+    checkpoint_write(out, checkpoint_version);
+    checkpoint_write(out, (uint32_t)sizeof(Scalar));
+    checkpoint_write(out, (uint32_t)sizeof(pdata_element));
+    checkpoint_write(out, (uint64_t)timestep);
+    checkpoint_write(out, (uint32_t)m_exec_conf->getRank());
+
+    std::vector<pdata_element> particles;
+    m_pdata->packLocalParticles(particles);
+    checkpoint_write(out, particles);
+
+    writeGroupsLocal(out, m_sysdef->getBondData());
+    writeGroupsLocal(out, m_sysdef->getAngleData());
+    writeGroupsLocal(out, m_sysdef->getDihedralData());
+    writeGroupsLocal(out, m_sysdef->getImproperData());
+    writeGroupsLocal(out, m_sysdef->getConstraintData());
+    writeGroupsLocal(out, m_sysdef->getPairData());
+    }
+
+/*! \param out Stream to write to
+    \param timestep Current time step
+*/
+void CheckpointWriter::writeIndex(std::ostream& out, unsigned int timestep)
+    {
+    out.write(checkpoint_magic, sizeof(checkpoint_magic));
+    checkpoint_write(out, checkpoint_version);
+    checkpoint_write(out, (uint32_t)sizeof(Scalar));
+    checkpoint_write(out, (uint32_t)sizeof(pdata_element));
+    checkpoint_write(out, (uint64_t)timestep);
+    checkpoint_write(out, (uint32_t)m_exec_conf->getNRanks());
+
+    // box
+    checkpoint_write(out, (uint32_t)m_sysdef->getNDimensions());
+    const BoxDim& box = m_pdata->getGlobalBox();
+    checkpoint_write(out, box.getL());
+    checkpoint_write(out, box.getTiltFactorXY());
+    checkpoint_write(out, box.getTiltFactorXZ());
+    checkpoint_write(out, box.getTiltFactorYZ());
+
+    // domain decomposition
+    uint8_t has_decomposition = 0;
+    #ifdef ENABLE_MPI
+    std::shared_ptr<DomainDecomposition> decomposition = m_pdata->getDomainDecomposition();
+    if (decomposition)
+        {
+        has_decomposition = 1;
+        checkpoint_write(out, has_decomposition);
+        checkpoint_write(out, decomposition->getGridSize());
+        checkpoint_write(out, decomposition->getCumulativeFractions(0));
+        checkpoint_write(out, decomposition->getCumulativeFractions(1));
+        checkpoint_write(out, decomposition->getCumulativeFractions(2));
+
+        ArrayHandle<unsigned int> h_cart_ranks(decomposition->getCartRanks(), access_location::host, access_mode::read);
+        std::vector<unsigned int> cart_ranks(h_cart_ranks.data, h_cart_ranks.data + m_exec_conf->getNRanks());
+        checkpoint_write(out, cart_ranks);
+        }
+    else
+    #endif
+        {
+        checkpoint_write(out, has_decomposition);
+        }
+
+    // particle types and tags
+    std::vector<std::string> type_mapping;
+    for (unsigned int i = 0; i < m_pdata->getNTypes(); ++i)
+        type_mapping.push_back(m_pdata->getNameByType(i));
+    checkpoint_write(out, type_mapping);
+
+    std::vector<unsigned int> tags(m_pdata->getNGlobal());
+    for (unsigned int n = 0; n < tags.size(); ++n)
+        tags[n] = m_pdata->getNthTag(n);
+    checkpoint_write(out, checkpoint_encode_tags(tags));
+
+    checkpoint_write(out, (uint8_t)m_pdata->isAccelSet());
+    checkpoint_write(out, m_pdata->getOrigin());
+    checkpoint_write(out, m_pdata->getOriginImage());
+
+    writeGroupsIndex(out, m_sysdef->getBondData());
+    writeGroupsIndex(out, m_sysdef->getAngleData());
+    writeGroupsIndex(out, m_sysdef->getDihedralData());
+    writeGroupsIndex(out, m_sysdef->getImproperData());
+    writeGroupsIndex(out, m_sysdef->getConstraintData());
+    writeGroupsIndex(out, m_sysdef->getPairData());
+
+    // integrator variables
+    std::shared_ptr<IntegratorData> integrator_data = m_sysdef->getIntegratorData();
+    checkpoint_write(out, (uint32_t)integrator_data->getNumIntegrators());
+    for (unsigned int i = 0; i < integrator_data->getNumIntegrators(); ++i)
+        {
+        const IntegratorVariables& v = integrator_data->getIntegratorVariables(i);
+        checkpoint_write(out, v.type);
+        checkpoint_write(out, v.variable);
+        }
+    }
+
+/*! \param out Stream to write to
+    \param gdata Bonded group data to write
+
+    Only the local groups are written, ghost groups are recreated by the Communicator.
+*/
+template<class group_data>
+void CheckpointWriter::writeGroupsLocal(std::ostream& out, std::shared_ptr<group_data> gdata)
+    {
+    unsigned int n_groups = gdata->getN();
+
+    ArrayHandle<typename group_data::members_t> h_groups(gdata->getMembersArray(), access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_typeval(gdata->getTypeValArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(gdata->getTags(), access_location::host, access_mode::read);
+
+    checkpoint_write(out, std::vector<typename group_data::members_t>(h_groups.data, h_groups.data + n_groups));
+    checkpoint_write(out, std::vector<typeval_t>(h_typeval.data, h_typeval.data + n_groups));
+    checkpoint_write(out, std::vector<unsigned int>(h_tag.data, h_tag.data + n_groups));
+    }
+
+/*! \param out Stream to write to
+    \param gdata Bonded group data to write
+*/
+template<class group_data>
+void CheckpointWriter::writeGroupsIndex(std::ostream& out, std::shared_ptr<group_data> gdata)
+    {
+    std::vector<std::string> type_mapping;
+    for (unsigned int i = 0; i < gdata->getNTypes(); ++i)
+        type_mapping.push_back(gdata->getNameByType(i));
+    checkpoint_write(out, type_mapping);
+
+    std::vector<unsigned int> tags(gdata->getNGlobal());
+    for (unsigned int n = 0; n < tags.size(); ++n)
+        tags[n] = gdata->getNthTag(n);
+    checkpoint_write(out, checkpoint_encode_tags(tags));
+    }
+
+void export_CheckpointWriter(py::module& m)
+    {
+    py::class_<CheckpointWriter, std::shared_ptr<CheckpointWriter> >(m,"CheckpointWriter",py::base<Analyzer>())
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::string >())
+    ;
+    }
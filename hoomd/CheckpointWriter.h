@@ -0,0 +1,83 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifndef __CHECKPOINTWRITER_H__
+#define __CHECKPOINTWRITER_H__
+
+#include "Analyzer.h"
+
+#include <string>
+#include <memory>
+#include <iostream>
+#include <stdint.h>
+
+/*! \file CheckpointWriter.h
+    \brief Declares the CheckpointWriter class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Analyzer for writing native binary checkpoints
+/*! CheckpointWriter saves the full simulation state every time analyze() is called, so that CheckpointReader can
+    restore it exactly. Unlike a GSD restart file, the data is not gathered on the root rank. Every rank writes
+    its own local particle data arrays and bonded group tables to a separate file in parallel, and the root rank
+    writes a small index file with the global state (box, type names, integrator variables and the domain
+    decomposition). See CheckpointFormat.h for the layout.
+
+    Data files carry the timestep in their name. They are first written under a temporary name and renamed once
+    all ranks have finished, and the index file is renamed last. The data files of the previous checkpoint are only
+    removed after that, so that an interrupted write never replaces a complete checkpoint with a partial one.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT CheckpointWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef,
+                         const std::string &fname);
+
+        //! Destructor
+        ~CheckpointWriter();
+
+        //! Write out the checkpoint for the current timestep
+        void analyze(unsigned int timestep);
+
+    private:
+        std::string m_fname;                //!< The base file name we are writing to
+        bool m_have_prev;                   //!< True if m_prev_timestep refers to an existing checkpoint
+        uint64_t m_prev_timestep;           //!< Time step of the checkpoint that is replaced by the next write
+
+        //! Get the name of a per-rank data file
+        std::string getDataFileName(uint64_t timestep, unsigned int rank) const;
+
+        //! Read the time step of the existing index file (root rank only)
+        bool readPreviousTimestep(uint64_t& timestep);
+
+        //! Reduce a success flag over all ranks
+        bool allSucceeded(int success);
+
+        //! Write the per-rank data file
+        void writeLocal(std::ostream& out, unsigned int timestep);
+
+        //! Write the index file (root rank only)
+        void writeIndex(std::ostream& out, unsigned int timestep);
+
+        //! Write the local groups of a bonded group data
+        template<class group_data>
+        void writeGroupsLocal(std::ostream& out, std::shared_ptr<group_data> gdata);
+
+        //! Write the global information of a bonded group data
+        template<class group_data>
+        void writeGroupsIndex(std::ostream& out, std::shared_ptr<group_data> gdata);
+    };
+
+//! Exports the CheckpointWriter class to python
+void export_CheckpointWriter(pybind11::module& m);
+
+#endif
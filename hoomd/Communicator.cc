@@ -1538,6 +1538,9 @@ void Communicator::migrateParticles()
 
 void Communicator::updateGhostWidth()
     {
+    // let subscribers refresh the data their per-type requests depend on
+    m_ghost_layer_width_update.emit();
+
         {
         // reset values (this may not be needed in most cases, but it doesn't harm to be safe
         ArrayHandle<Scalar> h_r_ghost(m_r_ghost, access_location::host, access_mode::overwrite);
@@ -201,6 +201,16 @@ class PYBIND11_EXPORT Communicator
             return m_extra_ghost_layer_width_requests;
             }
 
+        //! Subscribe to list of functions that are called before the ghost layer widths are requested
+        /*! Subscribers may use this call to refresh (collectively over all ranks) the data they need to
+         * answer the per-type ghost layer width requests, instead of recomputing it once per type.
+         * \return A Nano::Signal object reference to be used for connect and disconnect calls.
+         */
+        Nano::Signal<void ()>& getGhostLayerWidthUpdateSignal()
+            {
+            return m_ghost_layer_width_update;
+            }
+
 
         //! Subscribe to list of functions that determine the communication flags
         /*! This method keeps track of all functions that may request communication flags
@@ -539,6 +549,9 @@ class PYBIND11_EXPORT Communicator
         Nano::Signal<Scalar(unsigned int type) >
             m_extra_ghost_layer_width_requests;  //!< List of functions that request an extra ghost layer width
 
+        Nano::Signal<void ()>
+            m_ghost_layer_width_update;  //!< List of functions called before the ghost layer width requests
+
         Nano::Signal<void (unsigned int timestep)>
             m_compute_callbacks;   //!< List of functions that are called after ghost communication
 
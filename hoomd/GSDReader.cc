@@ -13,6 +13,7 @@
 #include "ExecutionConfiguration.h"
 #include "hoomd/extern/gsd.h"
 #include <string.h>
+#include <sys/mman.h>
 
 #include <stdexcept>
 using namespace std;
@@ -23,15 +24,20 @@ namespace py = pybind11;
     \param name File name to read
     \param frame Frame index to read from the file
     \param from_end Count frames back from the end of the file
+    \param use_mmap Map the file into memory and read chunks directly from the mapping
 
     The GSDReader constructor opens the GSD file, initializes an empty snapshot, and reads the file into
     memory (on the root rank).
+
+    When \a use_mmap is set, the whole file is mapped read-only once. Chunks are then copied from the mapping
+    into the snapshot without a system call per chunk, and type names are parsed in place with readChunkView().
 */
 GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                      const std::string &name,
                      const uint64_t frame,
-                     bool from_end)
-    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame)
+                     bool from_end,
+                     bool use_mmap)
+    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame), m_file_data(NULL), m_file_data_size(0)
     {
     m_snapshot = std::shared_ptr< SnapshotSystemData<float> >(new SnapshotSystemData<float>);
 
@@ -101,9 +107,22 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         throw runtime_error("Error opening GSD file");
         }
 
-    readHeader();
-    readParticles();
-    readTopology();
+    if (use_mmap)
+        mapFile();
+
+    // the destructor does not run when the constructor throws
+    try
+        {
+        readHeader();
+        readParticles();
+        readTopology();
+        }
+    catch (...)
+        {
+        unmapFile();
+        gsd_close(&m_handle);
+        throw;
+        }
     }
 
 GSDReader::~GSDReader()
@@ -116,9 +135,112 @@ GSDReader::~GSDReader()
         }
     #endif
 
+    unmapFile();
     gsd_close(&m_handle);
     }
 
+/*! Release the memory mapping, if any
+*/
+void GSDReader::unmapFile()
+    {
+    if (m_file_data != NULL)
+        munmap((void *)m_file_data, m_file_data_size);
+
+    m_file_data = NULL;
+    m_file_data_size = 0;
+    }
+
+/*! Map the entire file read-only. If the mapping fails, issue a warning and fall back to reading chunks
+    with gsd_read_chunk.
+*/
+void GSDReader::mapFile()
+    {
+    if (m_handle.file_size <= 0)
+        return;
+
+    m_exec_conf->msg->notice(3) << "data.gsd_snapshot: memory mapping gsd file " << m_name << endl;
+    size_t size = (size_t)m_handle.file_size;
+    void *ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, m_handle.fd, 0);
+    if (ptr == MAP_FAILED)
+        {
+        m_exec_conf->msg->warning() << "data.gsd_snapshot: unable to map " << m_name << " (" << strerror(errno)
+                                    << "), reading without mmap" << endl;
+        return;
+        }
+
+    // frames are accessed in arbitrary order, do not read ahead into neighboring frames
+    madvise(ptr, size, MADV_RANDOM);
+
+    m_file_data = (const char *)ptr;
+    m_file_data_size = size;
+    }
+
+/*! \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param expected_size Expected size of the data chunk in bytes.
+    \param cur_n N in the current frame.
+
+    Locate the named chunk at the given frame, falling back to frame 0. Return NULL when the chunk is not
+    present (or when the frame 0 N does not match \a cur_n). Throw an exception if the chunk size does not
+    match \a expected_size.
+*/
+const struct gsd_index_entry* GSDReader::findChunk(uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n)
+    {
+    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
+    if (entry == NULL && frame != 0)
+        entry = gsd_find_chunk(&m_handle, 0, name);
+
+    if (entry == NULL || (cur_n != 0 && entry->N != cur_n))
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return NULL;
+        }
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
+    size_t actual_size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (actual_size != expected_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    return entry;
+    }
+
+/*! \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param expected_size Expected size of the data chunk in bytes.
+    \param cur_n N in the current frame.
+
+    Same semantics as readChunk(), but instead of copying the data return a pointer into the memory mapped
+    file. The pointer remains valid for the lifetime of the GSDReader. Return NULL if the chunk is not
+    found. Empty chunks return a valid pointer that must not be dereferenced. The reader must have been opened
+    with use_mmap.
+*/
+const void *GSDReader::readChunkView(uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n)
+    {
+    if (m_file_data == NULL)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: chunk views require a memory mapped file" << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    const struct gsd_index_entry* entry = findChunk(frame, name, expected_size, cur_n);
+    if (entry == NULL)
+        return NULL;
+
+    if (expected_size == 0)
+        return m_file_data;
+
+    if (entry->location == 0 || entry->location + expected_size > m_file_data_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid GSD file " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    return m_file_data + entry->location;
+    }
+
 /*! \param data Pointer to data to read into
     \param frame Frame index to read from
     \param name Name of the data chunk
@@ -135,24 +257,24 @@ GSDReader::~GSDReader()
 */
 bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n)
     {
-    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
-    if (entry == NULL && frame != 0)
-        entry = gsd_find_chunk(&m_handle, 0, name);
+    if (m_file_data != NULL)
+        {
+        const void *view = readChunkView(frame, name, expected_size, cur_n);
+        if (view == NULL)
+            return false;
 
-    if (entry == NULL || (cur_n != 0 && entry->N != cur_n))
+        if (expected_size > 0)
+            memcpy(data, view, expected_size);
+        return true;
+        }
+
+    const struct gsd_index_entry* entry = findChunk(frame, name, expected_size, cur_n);
+    if (entry == NULL)
         {
-        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
         return false;
         }
     else
         {
-        m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
-        size_t actual_size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
-        if (actual_size != expected_size)
-            {
-            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
-            throw runtime_error("Error reading GSD file");
-            }
         int retval = gsd_read_chunk(&m_handle, data, entry);
 
         if (retval == -1)
@@ -207,6 +329,20 @@ std::vector<std::string> GSDReader::readTypes(uint64_t frame, const char *name)
     else
         {
         size_t actual_size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+
+        // parse the names in place when the file is mapped
+        if (m_file_data != NULL)
+            {
+            const char *data = (const char *)readChunkView(frame, name, actual_size);
+            type_mapping.clear();
+            for (unsigned int i = 0; i < entry->N; i++)
+                {
+                size_t l = strnlen(data + i*entry->M, entry->M);
+                type_mapping.push_back(std::string(data + i*entry->M, l));
+                }
+            return type_mapping;
+            }
+
         std::vector<char> data(actual_size);
         int retval = gsd_read_chunk(&m_handle, &data[0], entry);
 
@@ -373,9 +509,11 @@ void export_GSDReader(py::module& m)
     {
     py::class_< GSDReader, std::shared_ptr<GSDReader> >(m,"GSDReader")
     .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool>())
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool, bool>())
     .def("getTimeStep", &GSDReader::getTimeStep)
     .def("getSnapshot", &GSDReader::getSnapshot)
     .def("clearSnapshot", &GSDReader::clearSnapshot)
     .def("readTypeShapesPy", &GSDReader::readTypeShapesPy)
+    .def("isMapped", &GSDReader::isMapped)
     ;
     }
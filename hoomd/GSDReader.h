@@ -39,7 +39,8 @@ class PYBIND11_EXPORT GSDReader
         GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                   const std::string &name,
                   const uint64_t frame,
-                  bool from_end);
+                  bool from_end,
+                  bool use_mmap=false);
 
         //! Destructor
         ~GSDReader();
@@ -73,6 +74,15 @@ class PYBIND11_EXPORT GSDReader
         //! Helper function to read a quantity from the file
         bool readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n=0);
 
+        //! Get a read-only view of a quantity in the memory mapped file
+        const void *readChunkView(uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n=0);
+
+        //! Test if the file data is memory mapped
+        bool isMapped() const
+            {
+            return m_file_data != NULL;
+            }
+
         //! clears the snapshot object
         void clearSnapshot()
             {
@@ -94,6 +104,17 @@ class PYBIND11_EXPORT GSDReader
         uint64_t m_frame;                                            //!< Cached frame
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
+        const char *m_file_data;                                     //!< Memory mapped file contents (NULL when not mapped)
+        size_t m_file_data_size;                                     //!< Size of the mapped region in bytes
+
+        //! Helper function to locate a chunk and validate its size
+        const struct gsd_index_entry* findChunk(uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n);
+
+        //! Helper function to map the data section of the file into memory
+        void mapFile();
+
+        //! Helper function to release the memory mapping
+        void unmapFile();
 
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
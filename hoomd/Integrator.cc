@@ -20,8 +20,88 @@ namespace py = pybind11;
 #include "Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
+#include <memory>
+
 using namespace std;
 
+//! Host arrays of one force that is summed into the net force
+struct force_sum_arrays
+    {
+    const Scalar4 *force;       //!< Force and energy of each particle
+    const Scalar4 *torque;      //!< Torque of each particle
+    const Scalar *virial;       //!< Virial of each particle
+    unsigned int virial_pitch;  //!< Pitch of the virial array
+    Scalar scale;               //!< Scale factor of the force and torque
+    };
+
+//! Add forces into the net force, torque and virial of the particles
+/*! \param net_force Net force and energy, added to
+    \param net_torque Net torque, added to
+    \param net_virial Net virial, added to
+    \param net_virial_pitch Pitch of \a net_virial
+    \param forces Arrays of the forces to add
+    \param nparticles Number of particles to sum
+
+    The particles are summed in parallel if TBB is available. Each particle adds up the forces in the order they are
+    listed, which gives the same result as adding the forces one after another regardless of the number of threads.
+*/
+static void sum_net_force(Scalar4 *net_force,
+                          Scalar4 *net_torque,
+                          Scalar *net_virial,
+                          const unsigned int net_virial_pitch,
+                          const std::vector<force_sum_arrays>& forces,
+                          const unsigned int nparticles)
+    {
+    auto sum_particles = [&](unsigned int first, unsigned int last)
+        {
+        for (unsigned int j = first; j < last; ++j)
+            {
+            Scalar4 f = net_force[j];
+            Scalar4 t = net_torque[j];
+            Scalar v[6];
+            for (unsigned int k = 0; k < 6; ++k)
+                v[k] = net_virial[k*net_virial_pitch+j];
+
+            for (auto cur = forces.begin(); cur != forces.end(); ++cur)
+                {
+                const Scalar4 force = cur->force[j];
+                const Scalar4 torque = cur->torque[j];
+                f.x += cur->scale*force.x;
+                f.y += cur->scale*force.y;
+                f.z += cur->scale*force.z;
+                f.w += force.w;
+
+                t.x += cur->scale*torque.x;
+                t.y += cur->scale*torque.y;
+                t.z += cur->scale*torque.z;
+                t.w += cur->scale*torque.w;
+
+                for (unsigned int k = 0; k < 6; ++k)
+                    v[k] += cur->virial[k*cur->virial_pitch+j];
+                }
+
+            net_force[j] = f;
+            net_torque[j] = t;
+            for (unsigned int k = 0; k < 6; ++k)
+                net_virial[k*net_virial_pitch+j] = v[k];
+            }
+        };
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nparticles),
+        [&](const tbb::blocked_range<unsigned int>& r)
+            {
+            sum_particles(r.begin(), r.end());
+            });
+    #else
+    sum_particles(0, nparticles);
+    #endif
+    }
+
 /*! \param sysdef System to update
     \param deltaT Time step to use
 */
@@ -48,9 +128,44 @@ void Integrator::addForceCompute(std::shared_ptr<ForceCompute> fc)
     {
     assert(fc);
     m_forces.push_back(fc);
+    m_force_periods.push_back(1);
     fc->setDeltaT(m_deltaT);
     }
 
+/*! \param fc ForceCompute to set the period of
+    \param period Number of time steps between evaluations of \a fc
+
+    This implements multiple time step (r-RESPA) integration in its impulse form. A force with period \a period is
+    only evaluated on time steps that are a multiple of \a period, and its force and torque are then applied with
+    \a period times their value. For velocity Verlet style integration methods, this is identical to nested r-RESPA
+    where the slow force kicks the velocities by half an outer step at the start and end of each outer step.
+
+    The energy and virial of a force are not scaled. Thermodynamic quantities computed from the net force and virial
+    therefore only include all forces on time steps that are a multiple of every period.
+
+    \a fc must have been added with addForceCompute() first. The period is reset when the forces are removed.
+*/
+void Integrator::setForcePeriod(std::shared_ptr<ForceCompute> fc, unsigned int period)
+    {
+    if (period == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.*: The period of a force must be at least 1" << endl;
+        throw runtime_error("Error setting force period");
+        }
+
+    for (unsigned int i=0; i < m_forces.size(); i++)
+        {
+        if (m_forces[i] == fc)
+            {
+            m_force_periods[i] = period;
+            return;
+            }
+        }
+
+    m_exec_conf->msg->error() << "integrate.*: Cannot set the period of a force that is not integrated" << endl;
+    throw runtime_error("Error setting force period");
+    }
+
 /*! \param fc ForceConstraint to add
 */
 void Integrator::addForceConstraint(std::shared_ptr<ForceConstraint> fc)
@@ -74,6 +189,7 @@ void Integrator::setHalfStepHook(std::shared_ptr<HalfStepHook> hook)
 void Integrator::removeForceComputes()
     {
     m_forces.clear();
+    m_force_periods.clear();
     m_constraint_forces.clear();
     }
 
@@ -303,15 +419,18 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
     }
 
 /*! \param timestep Current time step of the simulation
-    \post All added force computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
+    \post All added force computes in \a m_forces that are due at \a timestep are computed and totaled up in
+          \a m_net_force and \a m_net_virial
     \note The summation step is performed <b>on the CPU</b> and will result in a lot of data traffic back and forth
           if the forces and/or integrator are on the GPU. Call computeNetForcesGPU() to sum the forces on the GPU
 */
 void Integrator::computeNetForce(unsigned int timestep)
     {
-    std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+    for (unsigned int i = 0; i < m_forces.size(); ++i)
+        {
+        if (isForceDue(i, timestep))
+            m_forces[i]->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -349,44 +468,44 @@ void Integrator::computeNetForce(unsigned int timestep)
         assert(6*nparticles <= net_virial.getNumElements());
         assert(nparticles <= net_torque.getNumElements());
 
-        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        // acquire the arrays of all forces that are due, so that all of them are added in one pass over the particles
+        std::vector< std::unique_ptr< ArrayHandle<Scalar4> > > h_forces, h_torques;
+        std::vector< std::unique_ptr< ArrayHandle<Scalar> > > h_virials;
+        std::vector<force_sum_arrays> sum_arrays;
+        for (unsigned int i = 0; i < m_forces.size(); ++i)
             {
-            GlobalArray<Scalar4>& h_force_array = (*force_compute)->getForceArray();
-            GlobalArray<Scalar>& h_virial_array = (*force_compute)->getVirialArray();
-            GlobalArray<Scalar4>& h_torque_array = (*force_compute)->getTorqueArray();
+            if (!isForceDue(i, timestep))
+                continue;
+
+            const std::shared_ptr<ForceCompute>& force_compute = m_forces[i];
+            GlobalArray<Scalar4>& h_force_array = force_compute->getForceArray();
+            GlobalArray<Scalar>& h_virial_array = force_compute->getVirialArray();
+            GlobalArray<Scalar4>& h_torque_array = force_compute->getTorqueArray();
 
             assert(nparticles <= h_force_array.getNumElements());
             assert(6*nparticles <= h_virial_array.getNumElements());
             assert(nparticles <= h_torque_array.getNumElements());
 
-            ArrayHandle<Scalar4> h_force(h_force_array,access_location::host,access_mode::read);
-            ArrayHandle<Scalar> h_virial(h_virial_array,access_location::host,access_mode::read);
-            ArrayHandle<Scalar4> h_torque(h_torque_array,access_location::host,access_mode::read);
+            h_forces.emplace_back(new ArrayHandle<Scalar4>(h_force_array,access_location::host,access_mode::read));
+            h_virials.emplace_back(new ArrayHandle<Scalar>(h_virial_array,access_location::host,access_mode::read));
+            h_torques.emplace_back(new ArrayHandle<Scalar4>(h_torque_array,access_location::host,access_mode::read));
 
-            unsigned int virial_pitch = h_virial_array.getPitch();
-            for (unsigned int j = 0; j < nparticles; j++)
-                {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
-
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
-                h_net_torque.data[j].w += h_torque.data[j].w;
-
-                for (unsigned int k = 0; k < 6; k++)
-                    {
-                    h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
-                    }
-                }
+            force_sum_arrays arrays;
+            arrays.force = h_forces.back()->data;
+            arrays.torque = h_torques.back()->data;
+            arrays.virial = h_virials.back()->data;
+            arrays.virial_pitch = h_virial_array.getPitch();
+            // forces evaluated every few steps are applied as an impulse
+            arrays.scale = Scalar(m_force_periods[i]);
+            sum_arrays.push_back(arrays);
 
             for (unsigned int k = 0; k < 6; k++)
-                external_virial[k] += (*force_compute)->getExternalVirial(k);
+                external_virial[k] += force_compute->getExternalVirial(k);
 
-            external_energy += (*force_compute)->getExternalEnergy();
+            external_energy += force_compute->getExternalEnergy();
             }
+
+        sum_net_force(h_net_force.data, h_net_torque.data, h_net_virial.data, net_virial_pitch, sum_arrays, nparticles);
         }
 
     for (unsigned int k = 0; k < 6; k++)
@@ -438,40 +557,38 @@ void Integrator::computeNetForce(unsigned int timestep)
         unsigned int nparticles = m_pdata->getN();
         assert(nparticles <= net_force.getNumElements());
         assert(6*nparticles <= net_virial.getNumElements());
+        std::vector< std::unique_ptr< ArrayHandle<Scalar4> > > h_forces, h_torques;
+        std::vector< std::unique_ptr< ArrayHandle<Scalar> > > h_virials;
+        std::vector<force_sum_arrays> sum_arrays;
         for (force_constraint = m_constraint_forces.begin(); force_constraint != m_constraint_forces.end(); ++force_constraint)
             {
             GlobalArray<Scalar4>& h_force_array =(*force_constraint)->getForceArray();
             GlobalArray<Scalar>& h_virial_array =(*force_constraint)->getVirialArray();
             GlobalArray<Scalar4>& h_torque_array = (*force_constraint)->getTorqueArray();
-            ArrayHandle<Scalar4> h_force(h_force_array,access_location::host,access_mode::read);
-            ArrayHandle<Scalar> h_virial(h_virial_array,access_location::host,access_mode::read);
-            ArrayHandle<Scalar4> h_torque(h_torque_array,access_location::host,access_mode::read);
-            unsigned int virial_pitch = h_virial_array.getPitch();
 
             assert(nparticles <= h_force_array.getNumElements());
             assert(6*nparticles <= h_virial_array.getNumElements());
             assert(nparticles <= h_torque_array.getNumElements());
 
-            for (unsigned int j = 0; j < nparticles; j++)
-                {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
-
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
-                h_net_torque.data[j].w += h_torque.data[j].w;
-
-                for (unsigned int k = 0; k < 6; k++)
-                    h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
-                }
+            h_forces.emplace_back(new ArrayHandle<Scalar4>(h_force_array,access_location::host,access_mode::read));
+            h_virials.emplace_back(new ArrayHandle<Scalar>(h_virial_array,access_location::host,access_mode::read));
+            h_torques.emplace_back(new ArrayHandle<Scalar4>(h_torque_array,access_location::host,access_mode::read));
+
+            force_sum_arrays arrays;
+            arrays.force = h_forces.back()->data;
+            arrays.torque = h_torques.back()->data;
+            arrays.virial = h_virials.back()->data;
+            arrays.virial_pitch = h_virial_array.getPitch();
+            arrays.scale = Scalar(1.0);
+            sum_arrays.push_back(arrays);
+
             for (unsigned int k = 0; k < 6; k++)
                 external_virial[k] += (*force_constraint)->getExternalVirial(k);
 
             external_energy += (*force_constraint)->getExternalEnergy();
             }
+
+        sum_net_force(h_net_force.data, h_net_torque.data, h_net_virial.data, net_virial_pitch, sum_arrays, nparticles);
         }
 
     for (unsigned int k = 0; k < 6; k++)
@@ -499,12 +616,16 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         throw runtime_error("Error computing accelerations");
         }
 
-    // compute all the normal forces first
-
-    std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
-
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+    // compute all the normal forces that are due first
+    std::vector<unsigned int> due_forces;
+    for (unsigned int i = 0; i < m_forces.size(); ++i)
+        {
+        if (isForceDue(i, timestep))
+            {
+            m_forces[i]->compute(timestep);
+            due_forces.push_back(i);
+            }
+        }
 
     if (m_prof)
         {
@@ -541,7 +662,7 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         // there is no need to zero out the initial net force and virial here, the first call to the addition kernel
         // will do that
         // ahh!, but we do need to zer out the net force and virial if there are 0 forces!
-        if (m_forces.size() == 0)
+        if (due_forces.size() == 0)
             {
             // start by zeroing the net force and virial arrays
             cudaMemset(d_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
@@ -554,86 +675,92 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         // now, add up the accelerations
         // sum all the forces into the net force
         // perform the sum in groups of 6 to avoid kernel launch and memory access overheads
-        for (unsigned int cur_force = 0; cur_force < m_forces.size(); cur_force += 6)
+        for (unsigned int cur_force = 0; cur_force < due_forces.size(); cur_force += 6)
             {
             // grab the device pointers for the current set
             gpu_force_list force_list;
 
-            const GlobalArray<Scalar4>& d_force_array0 = m_forces[cur_force]->getForceArray();
+            const GlobalArray<Scalar4>& d_force_array0 = m_forces[due_forces[cur_force]]->getForceArray();
             ArrayHandle<Scalar4> d_force0(d_force_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar>& d_virial_array0 = m_forces[cur_force]->getVirialArray();
+            const GlobalArray<Scalar>& d_virial_array0 = m_forces[due_forces[cur_force]]->getVirialArray();
             ArrayHandle<Scalar> d_virial0(d_virial_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar4>& d_torque_array0 = m_forces[cur_force]->getTorqueArray();
+            const GlobalArray<Scalar4>& d_torque_array0 = m_forces[due_forces[cur_force]]->getTorqueArray();
             ArrayHandle<Scalar4> d_torque0(d_torque_array0,access_location::device,access_mode::read);
             force_list.f0 = d_force0.data;
             force_list.v0 = d_virial0.data;
             force_list.vpitch0 = d_virial_array0.getPitch();
             force_list.t0 = d_torque0.data;
+            force_list.s0 = Scalar(m_force_periods[due_forces[cur_force]]);
 
-            if (cur_force+1 < m_forces.size())
+            if (cur_force+1 < due_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array1 = m_forces[cur_force+1]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array1 = m_forces[due_forces[cur_force+1]]->getForceArray();
                 ArrayHandle<Scalar4> d_force1(d_force_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array1 = m_forces[cur_force+1]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array1 = m_forces[due_forces[cur_force+1]]->getVirialArray();
                 ArrayHandle<Scalar> d_virial1(d_virial_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array1 = m_forces[cur_force+1]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array1 = m_forces[due_forces[cur_force+1]]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque1(d_torque_array1,access_location::device,access_mode::read);
                 force_list.f1 = d_force1.data;
                 force_list.v1 = d_virial1.data;
                 force_list.vpitch1 = d_virial_array1.getPitch();
                 force_list.t1 = d_torque1.data;
+                force_list.s1 = Scalar(m_force_periods[due_forces[cur_force+1]]);
                 }
-            if (cur_force+2 < m_forces.size())
+            if (cur_force+2 < due_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array2 = m_forces[cur_force+2]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array2 = m_forces[due_forces[cur_force+2]]->getForceArray();
                 ArrayHandle<Scalar4> d_force2(d_force_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array2 = m_forces[cur_force+2]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array2 = m_forces[due_forces[cur_force+2]]->getVirialArray();
                 ArrayHandle<Scalar> d_virial2(d_virial_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array2 = m_forces[cur_force+2]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array2 = m_forces[due_forces[cur_force+2]]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque2(d_torque_array2,access_location::device,access_mode::read);
                 force_list.f2 = d_force2.data;
                 force_list.v2 = d_virial2.data;
                 force_list.vpitch2 = d_virial_array2.getPitch();
                 force_list.t2 = d_torque2.data;
+                force_list.s2 = Scalar(m_force_periods[due_forces[cur_force+2]]);
                 }
-            if (cur_force+3 < m_forces.size())
+            if (cur_force+3 < due_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array3 = m_forces[cur_force+3]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array3 = m_forces[due_forces[cur_force+3]]->getForceArray();
                 ArrayHandle<Scalar4> d_force3(d_force_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array3 = m_forces[cur_force+3]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array3 = m_forces[due_forces[cur_force+3]]->getVirialArray();
                 ArrayHandle<Scalar> d_virial3(d_virial_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array3 = m_forces[cur_force+3]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array3 = m_forces[due_forces[cur_force+3]]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque3(d_torque_array3,access_location::device,access_mode::read);
                 force_list.f3 = d_force3.data;
                 force_list.v3 = d_virial3.data;
                 force_list.vpitch3 = d_virial_array3.getPitch();
                 force_list.t3 = d_torque3.data;
+                force_list.s3 = Scalar(m_force_periods[due_forces[cur_force+3]]);
                 }
-            if (cur_force+4 < m_forces.size())
+            if (cur_force+4 < due_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array4 = m_forces[cur_force+4]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array4 = m_forces[due_forces[cur_force+4]]->getForceArray();
                 ArrayHandle<Scalar4> d_force4(d_force_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array4 = m_forces[cur_force+4]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array4 = m_forces[due_forces[cur_force+4]]->getVirialArray();
                 ArrayHandle<Scalar> d_virial4(d_virial_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array4 = m_forces[cur_force+4]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array4 = m_forces[due_forces[cur_force+4]]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque4(d_torque_array4,access_location::device,access_mode::read);
                 force_list.f4 = d_force4.data;
                 force_list.v4 = d_virial4.data;
                 force_list.vpitch4 = d_virial_array4.getPitch();
                 force_list.t4 = d_torque4.data;
+                force_list.s4 = Scalar(m_force_periods[due_forces[cur_force+4]]);
                 }
-            if (cur_force+5 < m_forces.size())
+            if (cur_force+5 < due_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array5 = m_forces[cur_force+5]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array5 = m_forces[due_forces[cur_force+5]]->getForceArray();
                 ArrayHandle<Scalar4> d_force5(d_force_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array5 = m_forces[cur_force+5]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array5 = m_forces[due_forces[cur_force+5]]->getVirialArray();
                 ArrayHandle<Scalar> d_virial5(d_virial_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array5 = m_forces[cur_force+5]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array5 = m_forces[due_forces[cur_force+5]]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque5(d_torque_array5,access_location::device,access_mode::read);
                 force_list.f5 = d_force5.data;
                 force_list.v5 = d_virial5.data;
                 force_list.vpitch5 = d_virial_array5.getPitch();
                 force_list.t5 = d_torque5.data;
+                force_list.s5 = Scalar(m_force_periods[due_forces[cur_force+5]]);
                 }
 
             // clear on the first iteration only
@@ -662,11 +789,11 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         }
 
     // add up external virials and energies
-    for (unsigned int cur_force = 0; cur_force < m_forces.size(); cur_force ++)
+    for (unsigned int cur_force = 0; cur_force < due_forces.size(); cur_force ++)
         {
         for (unsigned int k = 0; k < 6; k++)
-            external_virial[k] += m_forces[cur_force]->getExternalVirial(k);
-        external_energy += m_forces[cur_force]->getExternalEnergy();
+            external_virial[k] += m_forces[due_forces[cur_force]]->getExternalVirial(k);
+        external_energy += m_forces[due_forces[cur_force]]->getExternalEnergy();
         }
 
     for (unsigned int k = 0; k < 6; k++)
@@ -911,11 +1038,12 @@ void Integrator::setCommunicator(std::shared_ptr<Communicator> comm)
 
 void Integrator::computeCallback(unsigned int timestep)
     {
-    // pre-compute all active forces
-    std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
-
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->preCompute(timestep);
+    // pre-compute all active forces that are due
+    for (unsigned int i = 0; i < m_forces.size(); ++i)
+        {
+        if (isForceDue(i, timestep))
+            m_forces[i]->preCompute(timestep);
+        }
     }
 #endif
 
@@ -944,6 +1072,7 @@ void export_Integrator(py::module& m)
     .def("addForceConstraint", &Integrator::addForceConstraint)
     .def("setHalfStepHook", &Integrator::setHalfStepHook)
     .def("removeForceComputes", &Integrator::removeForceComputes)
+    .def("setForcePeriod", &Integrator::setForcePeriod)
     .def("removeHalfStepHook", &Integrator::removeHalfStepHook)
     .def("setDeltaT", &Integrator::setDeltaT)
     .def("getNDOF", &Integrator::getNDOF)
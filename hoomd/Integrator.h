@@ -84,6 +84,9 @@ class PYBIND11_EXPORT Integrator : public Updater
         //! Set HalfStepHook
         virtual void setHalfStepHook(std::shared_ptr<HalfStepHook> hook);
 
+        //! Set the number of time steps between evaluations of a ForceCompute
+        virtual void setForcePeriod(std::shared_ptr<ForceCompute> fc, unsigned int period);
+
         //! Removes all ForceComputes from the list
         virtual void removeForceComputes();
 
@@ -142,6 +145,7 @@ class PYBIND11_EXPORT Integrator : public Updater
     protected:
         Scalar m_deltaT;                                            //!< The time step
         std::vector< std::shared_ptr<ForceCompute> > m_forces;    //!< List of all the force computes
+        std::vector<unsigned int> m_force_periods;                  //!< Time steps between evaluations of each force
 
         std::vector< std::shared_ptr<ForceConstraint> > m_constraint_forces;    //!< List of all the constraints
 
@@ -151,6 +155,15 @@ class PYBIND11_EXPORT Integrator : public Updater
         //! helper function to compute initial accelerations
         void computeAccelerations(unsigned int timestep);
 
+        //! Test if a force is evaluated at a time step
+        /*! \param i Index of the force in m_forces
+            \param timestep Time step to test
+        */
+        bool isForceDue(unsigned int i, unsigned int timestep) const
+            {
+            return (timestep % m_force_periods[i]) == 0;
+            }
+
         //! helper function to compute net force/virial
         void computeNetForce(unsigned int timestep);
 
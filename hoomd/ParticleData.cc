@@ -256,10 +256,14 @@ const BoxDim & ParticleData::getGlobalBox() const
     }
 
 /*! \b ANY time particles are rearranged in memory, this function must be called.
+    \param first_arrived Index of the first particle that was not local before the rearrangement (getN() if the
+           particles were only permuted or removed, zero if unknown)
     \note The call must be made after calling release()
 */
-void ParticleData::notifyParticleSort()
+void ParticleData::notifyParticleSort(unsigned int first_arrived)
     {
+    m_first_arrived = first_arrived;
+
     #ifdef ENABLE_CUDA
     if (m_exec_conf->isCUDAEnabled())
         {
@@ -2130,8 +2134,8 @@ void ParticleData::setType(unsigned int tag, unsigned int typ)
         {
         ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::readwrite);
         h_pos.data[idx].w = __int_as_scalar(typ);
-        // signal that the types have changed
-        notifyParticleSort();
+        // signal that the types have changed, the order of particles is unchanged
+        notifyParticleSort(getN());
         }
     }
 
@@ -2413,6 +2417,157 @@ void ParticleData::removeParticle(unsigned int tag)
     notifyParticleSort();
     }
 
+/*! \param out Buffer to pack the local particles into (resized to getN())
+
+    Unlike removeParticles(), the particle data is left untouched. Particles are packed in local index order.
+ */
+void ParticleData::packLocalParticles(std::vector<pdata_element>& out)
+    {
+    out.resize(m_nparticles);
+
+    ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_accel(getAccelerations(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(getImages(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_force(getNetForce(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_torque(getNetTorqueArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
+
+    unsigned int net_virial_pitch = m_net_virial.getPitch();
+    for (unsigned int i = 0; i < m_nparticles; ++i)
+        {
+        pdata_element& p = out[i];
+        p.pos = h_pos.data[i];
+        p.vel = h_vel.data[i];
+        p.accel = h_accel.data[i];
+        p.charge = h_charge.data[i];
+        p.diameter = h_diameter.data[i];
+        p.image = h_image.data[i];
+        p.body = h_body.data[i];
+        p.orientation = h_orientation.data[i];
+        p.angmom = h_angmom.data[i];
+        p.inertia = h_inertia.data[i];
+        p.net_force = h_net_force.data[i];
+        p.net_torque = h_net_torque.data[i];
+        for (unsigned int j = 0; j < 6; ++j)
+            p.net_virial[j] = h_net_virial.data[net_virial_pitch*j+i];
+        p.tag = h_tag.data[i];
+        }
+    }
+
+/*! \param in Particles to place in the local particle data, in local index order
+    \param global_tags Set of all active particle tags in the whole system (identical on all ranks)
+    \param type_mapping Particle type names
+
+    restoreLocalParticles() is the counterpart of packLocalParticles(). Every rank supplies only its own particles
+    and no data is communicated. Tags missing from \a global_tags below the maximum tag are made available for
+    recycling, as if the particles had been removed.
+
+    \pre In parallel simulations, \a in must hold exactly the particles inside the local box.
+ */
+void ParticleData::restoreLocalParticles(const std::vector<pdata_element>& in,
+                                         const std::vector<unsigned int>& global_tags,
+                                         const std::vector<std::string>& type_mapping)
+    {
+    m_exec_conf->msg->notice(4) << "ParticleData: restoring local particles" << std::endl;
+
+    if (type_mapping.size() == 0)
+        {
+        m_exec_conf->msg->error() << "Number of particle types must be greater than 0." << endl;
+        throw std::runtime_error("Error initializing ParticleData");
+        }
+
+    removeAllGhostParticles();
+
+    // rebuild the set of active tags and the reservoir of recycled tags
+    m_tag_set.clear();
+    m_tag_set.insert(global_tags.begin(), global_tags.end());
+    m_invalid_cached_tags = true;
+
+    while (! m_recycled_tags.empty())
+        m_recycled_tags.pop();
+
+    unsigned int max_tag = m_tag_set.empty() ? 0 : *m_tag_set.rbegin();
+    for (unsigned int tag = max_tag; tag-- > 0;)
+        if (m_tag_set.find(tag) == m_tag_set.end())
+            m_recycled_tags.push(tag);
+
+    m_rtag.resize(m_tag_set.empty() ? 0 : max_tag+1);
+
+    resize(in.size());
+
+        {
+        ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel(getVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel(getAccelerations(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge(getCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter(getDiameters(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image(getImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body(getBodies(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom(getAngularMomentumArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia(getMomentsOfInertiaArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_force(getNetForce(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque(getNetTorqueArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::overwrite);
+
+        for (unsigned int tag = 0; tag < m_rtag.size(); ++tag)
+            h_rtag.data[tag] = NOT_LOCAL;
+
+        unsigned int net_virial_pitch = m_net_virial.getPitch();
+        for (unsigned int idx = 0; idx < m_nparticles; ++idx)
+            {
+            const pdata_element& p = in[idx];
+            h_pos.data[idx] = p.pos;
+            h_vel.data[idx] = p.vel;
+            h_accel.data[idx] = p.accel;
+            h_charge.data[idx] = p.charge;
+            h_diameter.data[idx] = p.diameter;
+            h_image.data[idx] = p.image;
+            h_body.data[idx] = p.body;
+            h_orientation.data[idx] = p.orientation;
+            h_angmom.data[idx] = p.angmom;
+            h_inertia.data[idx] = p.inertia;
+            h_net_force.data[idx] = p.net_force;
+            h_net_torque.data[idx] = p.net_torque;
+            for (unsigned int j = 0; j < 6; ++j)
+                h_net_virial.data[net_virial_pitch*j+idx] = p.net_virial[j];
+            h_tag.data[idx] = p.tag;
+
+            if (p.tag > max_tag || m_tag_set.find(p.tag) == m_tag_set.end())
+                {
+                m_exec_conf->msg->error() << "Local particle tag " << p.tag << " is not an active tag" << std::endl;
+                throw std::runtime_error("Error initializing ParticleData");
+                }
+            h_rtag.data[p.tag] = idx;
+            h_comm_flags.data[idx] = 0;
+            }
+        }
+
+    m_type_mapping = type_mapping;
+
+    setNGlobal(m_tag_set.size());
+
+    // notify listeners about resorting of local particles
+    notifyParticleSort();
+
+    m_origin = make_scalar3(0,0,0);
+    m_o_image = make_int3(0,0,0);
+
+    // notify listeners that number of types has changed
+    m_num_types_signal.emit();
+    }
+
 //! Return the nth active global tag
 /*! \param n Index of bond in global bond table
  */
@@ -2787,8 +2942,8 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
 
     if (m_prof) m_prof->pop();
 
-    // notify subscribers that particle data order has been changed
-    notifyParticleSort();
+    // notify subscribers that particle data order has been changed, no particles were added
+    notifyParticleSort(m_nparticles);
     }
 
 //! Remove particles from local domain and append new particle data
@@ -2862,8 +3017,8 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
 
     if (m_prof) m_prof->pop();
 
-    // notify subscribers that particle data order has been changed
-    notifyParticleSort();
+    // notify subscribers that particle data order has been changed, new particles were appended
+    notifyParticleSort(old_nparticles);
     }
 
 #ifdef ENABLE_CUDA
@@ -3020,8 +3175,8 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
     swapNetVirial();
     swapTags();
 
-    // notify subscribers
-    notifyParticleSort();
+    // notify subscribers, no particles were added
+    notifyParticleSort(m_nparticles);
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
@@ -3087,8 +3242,8 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
             CHECK_CUDA_ERROR();
         }
 
-    // notify subscribers
-    notifyParticleSort();
+    // notify subscribers, new particles were appended
+    notifyParticleSort(old_nparticles);
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
@@ -729,7 +729,17 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Notify listeners that the particles have been rearranged in memory
-        void notifyParticleSort();
+        void notifyParticleSort(unsigned int first_arrived=0);
+
+        //! Get the index of the first particle that may be new to the local domain after the last rearrangement
+        /*! Particles with lower indices were already local before the last call to notifyParticleSort(), although
+            their order may have changed. Listeners can use this to update their data incrementally. A value of zero
+            means that all particles must be considered new.
+         */
+        unsigned int getFirstArrivedParticle() const
+            {
+            return m_first_arrived;
+            }
 
         //! Connects a function to be called every time the box size is changed
         Nano::Signal<void ()>& getBoxChangeSignal()
@@ -981,6 +991,14 @@ class PYBIND11_EXPORT ParticleData
         template <class Real>
         std::map<unsigned int, unsigned int> takeSnapshot(SnapshotParticleData<Real> &snapshot);
 
+        //! Pack all local particles into a buffer
+        void packLocalParticles(std::vector<pdata_element>& out);
+
+        //! Replace the local particles with the contents of a buffer
+        void restoreLocalParticles(const std::vector<pdata_element>& in,
+                                   const std::vector<unsigned int>& global_tags,
+                                   const std::vector<std::string>& type_mapping);
+
         //! Add ghost particles at the end of the local particle data
         void addGhostParticles(const unsigned int nghosts);
 
@@ -1115,6 +1133,7 @@ class PYBIND11_EXPORT ParticleData
         std::vector<std::string> m_type_mapping;    //!< Mapping between particle type indices and names
 
         Nano::Signal<void ()> m_sort_signal;       //!< Signal that is triggered when particles are sorted in memory
+        unsigned int m_first_arrived = 0;          //!< Index of the first particle that may be new since the last sort
         Nano::Signal<void ()> m_boxchange_signal;  //!< Signal that is triggered when the box size changes
         Nano::Signal<void ()> m_max_particle_num_signal; //!< Signal that is triggered when the maximum particle number changes
         Nano::Signal<void ()> m_ghost_particles_removed_signal; //!< Signal that is triggered when ghost particles are removed
@@ -376,6 +376,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
+      m_incremental_update(false),
       m_selector(selector),
       m_update_tags(update_tags),
       m_warning_printed(false)
@@ -414,6 +415,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
+      m_incremental_update(false),
       m_update_tags(false),
       m_warning_printed(false)
     {
@@ -833,6 +835,7 @@ void ParticleGroup::rebuildIndexList() const
         ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
         unsigned int nparticles = m_pdata->getN();
         unsigned int cur_member = 0;
+        m_local_member_tags.clear();
         for (unsigned int idx = 0; idx < nparticles; idx ++)
             {
             assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
@@ -841,6 +844,7 @@ void ParticleGroup::rebuildIndexList() const
             if (is_member)
                 {
                 h_member_idx.data[cur_member] = idx;
+                m_local_member_tags.push_back(h_tag.data[idx]);
                 cur_member++;
                 }
             }
@@ -849,6 +853,13 @@ void ParticleGroup::rebuildIndexList() const
         assert(m_num_local_members <= m_member_tags.getNumElements());
         }
 
+    // subsequent rearrangements of the particles can be tracked by tag (on the CPU only)
+    #ifdef ENABLE_CUDA
+    m_incremental_update = !m_pdata->getExecConf()->isCUDAEnabled();
+    #else
+    m_incremental_update = true;
+    #endif
+
     // index has been rebuilt
     m_particles_sorted = false;
 
@@ -861,6 +872,103 @@ void ParticleGroup::rebuildIndexList() const
     #endif
     }
 
+/*! \pre m_local_member_tags lists the tags of all local members at the time of the last update, followed by the
+         tags of members that arrived since. It may contain duplicates and tags of members that have left.
+    \post m_is_member and m_member_idx are updated as by rebuildIndexList()
+
+    The cost of the update is O(M log M) in the number M of local members. It is only used for sparse groups
+    (M <= N/8), dense groups are rebuilt with the linear scan in rebuildIndexList().
+*/
+void ParticleGroup::updateIndexList() const
+    {
+    m_pdata->getExecConf()->msg->notice(10) << "ParticleGroup: updating index" << std::endl;
+
+    ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    // clear the flags at the previous member indices
+    for (unsigned int i = 0; i < m_num_local_members; ++i)
+        h_is_member.data[h_member_idx.data[i]] = 0;
+
+    // look up the current index of every member that is still local
+    unsigned int nparticles = m_pdata->getN();
+    unsigned int cur_member = 0;
+    for (unsigned int i = 0; i < m_local_member_tags.size(); ++i)
+        {
+        unsigned int idx = h_rtag.data[m_local_member_tags[i]];
+        if (idx < nparticles && !h_is_member.data[idx])
+            {
+            h_is_member.data[idx] = 1;
+            h_member_idx.data[cur_member] = idx;
+            cur_member++;
+            }
+        }
+
+    // keep the index list in index order
+    std::sort(h_member_idx.data, h_member_idx.data + cur_member);
+
+    m_num_local_members = cur_member;
+    assert(m_num_local_members <= m_member_tags.getNumElements());
+
+    m_local_member_tags.resize(cur_member);
+    for (unsigned int i = 0; i < cur_member; ++i)
+        m_local_member_tags[i] = h_tag.data[h_member_idx.data[i]];
+
+    m_particles_sorted = false;
+    }
+
+/*! Members among the particles that arrived in the local domain are recorded right away, so that the index list can
+    be updated lazily from the member tags in updateIndexList(). If the particle data cannot be tracked
+    incrementally, a full rebuild is scheduled instead.
+*/
+void ParticleGroup::slotParticleSort()
+    {
+    m_particles_sorted = true;
+
+    if (!m_incremental_update)
+        return;
+
+    unsigned int nparticles = m_pdata->getN();
+    unsigned int first_arrived = m_pdata->getFirstArrivedParticle();
+
+    // rebuild from scratch if arrays are pending reallocation, or if most particles are new
+    if (m_reallocated || m_global_ptl_num_change || 2*(nparticles - first_arrived) > nparticles)
+        {
+        m_incremental_update = false;
+        return;
+        }
+
+    if (first_arrived == nparticles)
+        return;
+
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
+
+    unsigned int n_tags = m_is_member_tag.getNumElements();
+    for (unsigned int idx = first_arrived; idx < nparticles; ++idx)
+        {
+        unsigned int tag = h_tag.data[idx];
+        if (tag >= n_tags)
+            {
+            m_incremental_update = false;
+            return;
+            }
+
+        if (h_is_member_tag.data[tag])
+            m_local_member_tags.push_back(tag);
+        }
+
+    // the member tags grow with every sort until the group is accessed, stop tracking them once updateIndexList()
+    // would not use them
+    if (8*m_local_member_tags.size() > nparticles)
+        {
+        m_incremental_update = false;
+        m_local_member_tags.clear();
+        }
+    }
+
 void ParticleGroup::updateGPUAdvice() const
     {
     #ifdef ENABLE_CUDA
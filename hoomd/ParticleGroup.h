@@ -221,7 +221,7 @@ class PYBIND11_EXPORT ParticleGroup
         // @{
 
         //! Constructs an empty particle group
-        ParticleGroup() : m_num_local_members(0) {};
+        ParticleGroup() : m_num_local_members(0), m_incremental_update(false) {};
 
         //! Constructs a particle group of all particles that meet the given selection
         ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleSelector> selector,
@@ -371,6 +371,8 @@ class PYBIND11_EXPORT ParticleGroup
         mutable bool m_global_ptl_num_change;           //!< True if the global particle number changed
 
         mutable GlobalArray<unsigned int> m_is_member_tag;  //!< One byte per particle, == 1 if tag is a member of the group
+        mutable std::vector<unsigned int> m_local_member_tags; //!< Tags of local members and of member tags that arrived since
+        mutable bool m_incremental_update;              //!< True if the index list can be updated from m_local_member_tags
         std::shared_ptr<ParticleSelector> m_selector; //!< The associated particle selector
 
         bool m_update_tags;                             //!< True if tags should be updated when global number of particles changes
@@ -386,6 +388,9 @@ class PYBIND11_EXPORT ParticleGroup
         //! Helper function to rebuild the index lists after the particles have been sorted
         void rebuildIndexList() const;
 
+        //! Helper function to update the index lists from the tags of the local members
+        void updateIndexList() const;
+
         //! Helper function to rebuild internal arrays
         void checkRebuild() const
             {
@@ -400,11 +405,16 @@ class PYBIND11_EXPORT ParticleGroup
                 {
                 reallocate();
                 m_reallocated = false;
+                m_incremental_update = false;
                 update_gpu_advice = true;
                 }
              if (m_particles_sorted)
                 {
-                rebuildIndexList();
+                // sorting the member indices only pays off for sparse groups
+                if (m_incremental_update && 8*m_local_member_tags.size() <= m_pdata->getN())
+                    updateIndexList();
+                else
+                    rebuildIndexList();
                 m_particles_sorted = false;
                 }
             if (update_gpu_advice)
@@ -420,10 +430,7 @@ class PYBIND11_EXPORT ParticleGroup
             }
 
         //! Helper function to be called when the particles are resorted
-        void slotParticleSort()
-            {
-            m_particles_sorted = true;
-            }
+        void slotParticleSort();
 
         //! Update the GPU memory advice
         void updateGPUAdvice() const;
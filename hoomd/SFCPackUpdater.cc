@@ -12,6 +12,14 @@
 #include "SFCPackUpdater.h"
 #include "Communicator.h"
 
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 #include <math.h>
 #include <stdexcept>
 #include <algorithm>
@@ -21,21 +29,97 @@
 using namespace std;
 namespace py = pybind11;
 
+//! Run \a f(c) for every chunk c in [0, nchunks), in parallel if TBB is available
+template<class F>
+static void for_each_chunk(unsigned int nchunks, const F& f)
+    {
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, nchunks, f);
+    #else
+    for (unsigned int c = 0; c < nchunks; ++c)
+        f(c);
+    #endif
+    }
+
+//! First element of chunk \a c when splitting \a n elements into \a nchunks chunks
+static inline unsigned int chunk_begin(unsigned int n, unsigned int nchunks, unsigned int c)
+    {
+    return (unsigned int)((uint64_t)n * c / nchunks);
+    }
+
+//! Compute the position of a grid cell along a hilbert curve
+/*! \param x Cell coordinates, overwritten
+    \param bits Number of bits per coordinate (at least 1)
+    \param ndim Number of dimensions (2 or 3)
+    \returns The index of the cell along the curve, a number with \a bits * \a ndim significant bits
+
+    Transforms the coordinates into the transposed hilbert index (J. Skilling, AIP Conf. Proc. 707, 381 (2004)) and
+    interleaves the bits of the transpose.
+*/
+static inline uint64_t hilbert_key(unsigned int x[3], unsigned int bits, unsigned int ndim)
+    {
+    const unsigned int M = 1u << (bits - 1);
+
+    // inverse undo excess work
+    for (unsigned int Q = M; Q > 1; Q >>= 1)
+        {
+        unsigned int P = Q - 1;
+        for (unsigned int i = 0; i < ndim; i++)
+            {
+            if (x[i] & Q)
+                x[0] ^= P;
+            else
+                {
+                unsigned int t = (x[0] ^ x[i]) & P;
+                x[0] ^= t;
+                x[i] ^= t;
+                }
+            }
+        }
+
+    // gray encode
+    for (unsigned int i = 1; i < ndim; i++)
+        x[i] ^= x[i-1];
+    unsigned int t = 0;
+    for (unsigned int Q = M; Q > 1; Q >>= 1)
+        if (x[ndim-1] & Q)
+            t ^= Q - 1;
+    for (unsigned int i = 0; i < ndim; i++)
+        x[i] ^= t;
+
+    // interleave, most significant bit first
+    uint64_t key = 0;
+    for (int b = bits - 1; b >= 0; b--)
+        for (unsigned int i = 0; i < ndim; i++)
+            key = (key << 1) | ((x[i] >> b) & 1);
+    return key;
+    }
+
+//! Map a fractional coordinate to a grid cell, clamping particles slightly outside the box
+static inline unsigned int grid_cell(Scalar f, unsigned int grid)
+    {
+    Scalar c = f * Scalar(grid);
+    if (c < Scalar(0.0))
+        return 0;
+    if (c >= Scalar(grid))
+        return grid - 1;
+    return (unsigned int)c;
+    }
+
 /*! \param sysdef System to perform sorts on
  */
 SFCPackUpdater::SFCPackUpdater(std::shared_ptr<SystemDefinition> sysdef)
-        : Updater(sysdef), m_last_grid(0), m_last_dim(0)
+        : Updater(sysdef), m_last_grid(0), m_last_dim(0), m_tolerance(0.0), m_sorted_locality(0.0)
     {
     m_exec_conf->msg->notice(5) << "Constructing SFCPackUpdater" << endl;
 
     // perform lots of sanity checks
     assert(m_pdata);
 
-    m_sort_order.resize(m_pdata->getMaxN());
-    m_particle_bins.resize(m_pdata->getMaxN());
+    reallocate();
 
     // set the default grid
-    // Grid dimension must always be a power of 2 and determines the memory usage for m_traversal_order
+    // Grid dimension must always be a power of 2 and determines the memory usage for m_traversal_order on the GPU
     // To prevent massive overruns of the memory, always use 256 for 3d and 4096 for 2d
     if (m_sysdef->getNDimensions() == 2)
         m_grid = 4096;
@@ -51,7 +135,19 @@ SFCPackUpdater::SFCPackUpdater(std::shared_ptr<SystemDefinition> sysdef)
 void SFCPackUpdater::reallocate()
     {
     m_sort_order.resize(m_pdata->getMaxN());
-    m_particle_bins.resize(m_pdata->getMaxN());
+    m_sort_order_tmp.resize(m_pdata->getMaxN());
+    m_keys.resize(m_pdata->getMaxN());
+    m_keys_tmp.resize(m_pdata->getMaxN());
+    }
+
+/*! Use more than one chunk only if there are enough particles to make threading worthwhile
+*/
+unsigned int SFCPackUpdater::getNumChunks() const
+    {
+    unsigned int nchunks = m_exec_conf->getNumThreads();
+    if (nchunks < 1 || m_pdata->getN() < 65536)
+        nchunks = 1;
+    return nchunks;
     }
 
 /*! Destructor
@@ -70,6 +166,18 @@ SFCPackUpdater::~SFCPackUpdater()
  */
 void SFCPackUpdater::update(unsigned int timestep)
     {
+    // skip the sort if particles are still ordered well enough
+    if (m_tolerance > Scalar(0.0) && m_sorted_locality > Scalar(0.0))
+        {
+        Scalar locality = getLocality();
+        if (locality <= m_tolerance * m_sorted_locality)
+            {
+            m_exec_conf->msg->notice(6) << "SFCPackUpdater: skipping sort, locality increased by a factor of "
+                                        << locality / m_sorted_locality << std::endl;
+            return;
+            }
+        }
+
     m_exec_conf->msg->notice(6) << "SFCPackUpdater: particle sort" << std::endl;
 
     #ifdef ENABLE_MPI
@@ -95,8 +203,12 @@ void SFCPackUpdater::update(unsigned int timestep)
     // apply that sort order to the particles
     applySortOrder();
 
-    // trigger sort signal (this also forces particle migration)
-    m_pdata->notifyParticleSort();
+    // reference for adaptive sorting
+    if (m_tolerance > Scalar(0.0))
+        m_sorted_locality = getLocality();
+
+    // trigger sort signal (this also forces particle migration), the particles were only permuted
+    m_pdata->notifyParticleSort(m_pdata->getN());
 
     #ifdef ENABLE_MPI
     if (m_comm)
@@ -109,143 +221,240 @@ void SFCPackUpdater::update(unsigned int timestep)
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*! The particle data is gathered once into the alternate arrays, which are then swapped in.
+*/
 void SFCPackUpdater::applySortOrder()
     {
     assert(m_pdata);
     assert(m_sort_order.size() >= m_pdata->getN());
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
-
-    // construct a temporary holding array for the sorted data
-    Scalar4 *scal4_tmp = new Scalar4[m_pdata->getN()];
-
-    // sort positions and types
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_pos.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_pos.data[i] = scal4_tmp[i];
-
-    // sort velocities and mass
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_vel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_vel.data[i] = scal4_tmp[i];
-
-    Scalar3 *scal3_tmp = new Scalar3[m_pdata->getN()];
-    // sort accelerations
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_accel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_accel.data[i] = scal3_tmp[i];
-
-    Scalar *scal_tmp  = new Scalar[m_pdata->getN()];
-    // sort charge
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_charge.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_charge.data[i] = scal_tmp[i];
-
-    // sort diameter
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_diameter.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_diameter.data[i] = scal_tmp[i];
-
-    // sort angular momentum
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_angmom.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_angmom.data[i] = scal4_tmp[i];
-
-    // sort moment of inertia
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_inertia.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_inertia.data[i] = scal3_tmp[i];
-
-    // in case anyone access it from frame to frame, sort the net virial
-        {
-        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
-        unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
 
-        for (unsigned int j = 0; j < 6; j++)
+        {
+        // access alternate arrays to write to
+        ArrayHandle<Scalar4> h_pos_alt(m_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel_alt(m_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel_alt(m_pdata->getAltAccelerations(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge_alt(m_pdata->getAltCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter_alt(m_pdata->getAltDiameters(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image_alt(m_pdata->getAltImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body_alt(m_pdata->getAltBodies(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag_alt(m_pdata->getAltTags(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation_alt(m_pdata->getAltOrientationArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom_alt(m_pdata->getAltAngularMomentumArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia_alt(m_pdata->getAltMomentsOfInertiaArray(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_net_virial_alt(m_pdata->getAltNetVirial(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_force_alt(m_pdata->getAltNetForce(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque_alt(m_pdata->getAltNetTorqueArray(), access_location::host, access_mode::overwrite);
+
+        // access live particle data to read from
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+        const unsigned int N = m_pdata->getN();
+        const unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
+        const unsigned int nchunks = getNumChunks();
+
+        // gather the particle data in sorted order and rebuild the rtags
+        for_each_chunk(nchunks, [&](unsigned int c)
             {
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                scal_tmp[i] = h_net_virial.data[j*virial_pitch+m_sort_order[i]];
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                h_net_virial.data[j*virial_pitch+i] = scal_tmp[i];
-            }
+            for (unsigned int i = chunk_begin(N, nchunks, c); i < chunk_begin(N, nchunks, c+1); i++)
+                {
+                unsigned int j = m_sort_order[i];
+                h_pos_alt.data[i] = h_pos.data[j];
+                h_vel_alt.data[i] = h_vel.data[j];
+                h_accel_alt.data[i] = h_accel.data[j];
+                h_charge_alt.data[i] = h_charge.data[j];
+                h_diameter_alt.data[i] = h_diameter.data[j];
+                h_image_alt.data[i] = h_image.data[j];
+                h_body_alt.data[i] = h_body.data[j];
+                h_tag_alt.data[i] = h_tag.data[j];
+                h_orientation_alt.data[i] = h_orientation.data[j];
+                h_angmom_alt.data[i] = h_angmom.data[j];
+                h_inertia_alt.data[i] = h_inertia.data[j];
+                for (unsigned int k = 0; k < 6; k++)
+                    h_net_virial_alt.data[k*virial_pitch+i] = h_net_virial.data[k*virial_pitch+j];
+                h_net_force_alt.data[i] = h_net_force.data[j];
+                h_net_torque_alt.data[i] = h_net_torque.data[j];
+
+                h_rtag.data[h_tag.data[j]] = i;
+                }
+            });
         }
 
-    // sort net force, net torque, and orientation
-        {
-        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+    // make alternate arrays current
+    m_pdata->swapPositions();
+    m_pdata->swapVelocities();
+    m_pdata->swapAccelerations();
+    m_pdata->swapCharges();
+    m_pdata->swapDiameters();
+    m_pdata->swapImages();
+    m_pdata->swapBodies();
+    m_pdata->swapTags();
+    m_pdata->swapOrientations();
+    m_pdata->swapAngularMomenta();
+    m_pdata->swapMomentsOfInertia();
+    m_pdata->swapNetVirial();
+    m_pdata->swapNetForce();
+    m_pdata->swapNetTorque();
+    }
 
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_force.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_force.data[i] = scal4_tmp[i];
-        }
+/*! \returns The mean distance between particles that are adjacent in memory, averaged over all ranks
 
+    Right after a sort, this is of the order of the interparticle spacing. It grows as particles diffuse away from
+    their neighbors along the curve.
+*/
+Scalar SFCPackUpdater::getLocality()
+    {
+    const BoxDim& box = m_pdata->getGlobalBox();
+    const unsigned int N = m_pdata->getN();
+    const unsigned int nchunks = getNumChunks();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    std::vector<double> chunk_sum(nchunks, 0.0);
+    for_each_chunk(nchunks, [&](unsigned int c)
         {
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::readwrite);
+        double sum = 0.0;
+        unsigned int begin = std::max(chunk_begin(N, nchunks, c), 1u);
+        for (unsigned int i = begin; i < chunk_begin(N, nchunks, c+1); i++)
+            {
+            Scalar3 dx = make_scalar3(h_pos.data[i].x - h_pos.data[i-1].x,
+                                      h_pos.data[i].y - h_pos.data[i-1].y,
+                                      h_pos.data[i].z - h_pos.data[i-1].z);
+            dx = box.minImage(dx);
+            sum += sqrt(dot(dx, dx));
+            }
+        chunk_sum[c] = sum;
+        });
 
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_torque.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_torque.data[i] = scal4_tmp[i];
-        }
+    double sum_count[2] = {0.0, N > 0 ? double(N - 1) : 0.0};
+    for (unsigned int c = 0; c < nchunks; c++)
+        sum_count[0] += chunk_sum[c];
 
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        MPI_Allreduce(MPI_IN_PLACE, sum_count, 2, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (sum_count[1] == 0.0)
+        return Scalar(0.0);
+    return Scalar(sum_count[0] / sum_count[1]);
+    }
+
+/*! \param ndim Number of dimensions
+    \returns The number of significant bits in the keys
+
+    Fills m_keys with the hilbert curve key of every local particle and initializes m_sort_order to the identity.
+    The grid resolution is m_grid cells per dimension, limited to what fits in a 64-bit key.
+*/
+unsigned int SFCPackUpdater::computeKeys(unsigned int ndim)
+    {
+    assert(m_pdata);
+    assert(m_keys.size() >= m_pdata->getN());
+
+    unsigned int bits = 1;
+    while (bits < 31 && (1u << bits) < m_grid)
+        bits++;
+    if (ndim == 3 && bits > 21)
+        bits = 21;
+    const unsigned int grid = 1u << bits;
+
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int N = m_pdata->getN();
+    const unsigned int nchunks = getNumChunks();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    for_each_chunk(nchunks, [&](unsigned int c)
         {
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        for (unsigned int n = chunk_begin(N, nchunks, c); n < chunk_begin(N, nchunks, c+1); n++)
+            {
+            Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+            Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
 
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_orientation.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_orientation.data[i] = scal4_tmp[i];
-        }
+            unsigned int x[3];
+            x[0] = grid_cell(f.x, grid);
+            x[1] = grid_cell(f.y, grid);
+            x[2] = (ndim == 3) ? grid_cell(f.z, grid) : 0;
 
-    // sort image
-    int3 *int3_tmp = new int3[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        int3_tmp[i] = h_image.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_image.data[i] = int3_tmp[i];
-
-    // sort body
-    unsigned int *uint_tmp = new unsigned int[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_body.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_body.data[i] = uint_tmp[i];
-
-    // sort global tag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_tag.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_tag.data[i] = uint_tmp[i];
-
-    // rebuild global rtag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            m_keys[n] = hilbert_key(x, bits, ndim);
+            m_sort_order[n] = n;
+            }
+        });
+
+    return bits*ndim;
+    }
+
+/*! \param key_bits Number of significant bits in the keys
+
+    Least significant digit radix sort with 8 bit digits. Each chunk of particles histograms its digits, the
+    histograms are scanned in (digit, chunk) order to keep the sort stable and every chunk then scatters its
+    particles independently. Passes where all particles share the same digit are skipped.
+*/
+void SFCPackUpdater::radixSort(unsigned int key_bits)
+    {
+    const unsigned int N = m_pdata->getN();
+    const unsigned int nchunks = getNumChunks();
+    std::vector<unsigned int> offsets(nchunks*256);
+
+    for (unsigned int shift = 0; shift < key_bits; shift += 8)
         {
-        h_rtag.data[h_tag.data[i]] = i;
-        }
+        // histogram the current digit in every chunk
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for_each_chunk(nchunks, [&](unsigned int c)
+            {
+            unsigned int *hist = &offsets[c*256];
+            for (unsigned int i = chunk_begin(N, nchunks, c); i < chunk_begin(N, nchunks, c+1); i++)
+                hist[(m_keys[i] >> shift) & 0xff]++;
+            });
+
+        // exclusive scan
+        bool trivial = false;
+        unsigned int offset = 0;
+        for (unsigned int d = 0; d < 256; d++)
+            {
+            unsigned int digit_start = offset;
+            for (unsigned int c = 0; c < nchunks; c++)
+                {
+                unsigned int count = offsets[c*256+d];
+                offsets[c*256+d] = offset;
+                offset += count;
+                }
+            if (offset - digit_start == N)
+                trivial = true;
+            }
 
-    delete[] scal_tmp;
-    delete[] scal4_tmp;
-    delete[] scal3_tmp;
-    delete[] uint_tmp;
-    delete[] int3_tmp;
+        if (trivial)
+            continue;
 
+        // scatter
+        for_each_chunk(nchunks, [&](unsigned int c)
+            {
+            unsigned int *pos = &offsets[c*256];
+            for (unsigned int i = chunk_begin(N, nchunks, c); i < chunk_begin(N, nchunks, c+1); i++)
+                {
+                unsigned int j = pos[(m_keys[i] >> shift) & 0xff]++;
+                m_keys_tmp[j] = m_keys[i];
+                m_sort_order_tmp[j] = m_sort_order[i];
+                }
+            });
+
+        m_keys.swap(m_keys_tmp);
+        m_sort_order.swap(m_sort_order_tmp);
+        }
     }
 
 //! x walking table for the hilbert curve
@@ -443,143 +652,12 @@ void SFCPackUpdater::generateTraversalOrder(int i, int j, int k, int w, int Mx,
 
 void SFCPackUpdater::getSortedOrder2D()
     {
-    // start by checking the saneness of some member variables
-    assert(m_pdata);
-    assert(m_sort_order.size() >= m_pdata->getN());
-
-    // make even bin dimensions
-    const BoxDim& box = m_pdata->getBox();
-
-    // put the particles in the bins
-    {
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-
-    // for each particle
-    for (unsigned int n = 0; n < m_pdata->getN(); n++)
-        {
-        // find the bin each particle belongs in
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        int jb = (unsigned int)(f.y * m_grid) % m_grid;
-
-        // if the particle is slightly outside, move back into grid
-        if (ib < 0) ib = 0;
-        if (ib >= (int)m_grid) ib = m_grid - 1;
-
-        if (jb < 0) jb = 0;
-        if (jb >= (int)m_grid) jb = m_grid - 1;
-
-        // record its bin
-        unsigned int bin = ib*m_grid + jb;
-
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(bin, n);
-        }
-    }
-
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+    radixSort(computeKeys(2));
     }
 
 void SFCPackUpdater::getSortedOrder3D()
     {
-    // start by checking the saneness of some member variables
-    assert(m_pdata);
-    assert(m_sort_order.size() >= m_pdata->getN());
-
-    // make even bin dimensions
-    const BoxDim& box = m_pdata->getBox();
-
-    // reallocate memory arrays if m_grid changed
-    // also regenerate the traversal order
-    if (m_last_grid != m_grid || m_last_dim != 3)
-        {
-        if (m_grid > 256)
-            {
-            unsigned int mb = m_grid*m_grid*m_grid*4 / 1024 / 1024;
-            m_exec_conf->msg->warning() << "sorter is about to allocate a very large amount of memory (" << mb << "MB)"
-                 << " and may crash." << endl;
-            m_exec_conf->msg->warning() << "            Reduce the amount of memory allocated to prevent this by decreasing the " << endl;
-            m_exec_conf->msg->warning() << "            grid dimension (i.e. sorter.set_params(grid=128) ) or by disabling it " << endl;
-            m_exec_conf->msg->warning() << "            ( sorter.disable() ) before beginning the run()." << endl;
-            }
-
-        // generate the traversal order
-        GPUArray<unsigned int> traversal_order(m_grid*m_grid*m_grid,m_exec_conf);
-        m_traversal_order.swap(traversal_order);
-
-        vector< unsigned int > reverse_order(m_grid*m_grid*m_grid);
-        reverse_order.clear();
-
-        // we need to start the hilbert curve with a seed order 0,1,2,3,4,5,6,7
-        unsigned int cell_order[8];
-        for (unsigned int i = 0; i < 8; i++)
-            cell_order[i] = i;
-        generateTraversalOrder(0,0,0, m_grid, m_grid, cell_order, reverse_order);
-
-        // access traversal order
-        ArrayHandle<unsigned int> h_traversal_order(m_traversal_order, access_location::host, access_mode::overwrite);
-
-        for (unsigned int i = 0; i < m_grid*m_grid*m_grid; i++)
-            h_traversal_order.data[reverse_order[i]] = i;
-
-        // write the traversal order out to a file for testing/presentations
-        // writeTraversalOrder("hilbert.mol2", reverse_order);
-
-        m_last_grid = m_grid;
-        // store the last system dimension computed so we can be mindful if that ever changes
-        m_last_dim = m_sysdef->getNDimensions();
-        }
-
-    // sanity checks
-    assert(m_particle_bins.size() >= m_pdata->getN());
-    assert(m_traversal_order.getNumElements() == m_grid*m_grid*m_grid);
-
-    // put the particles in the bins
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-
-    // access traversal order
-    ArrayHandle<unsigned int> h_traversal_order(m_traversal_order, access_location::host, access_mode::read);
-
-    // for each particle
-    for (unsigned int n = 0; n < m_pdata->getN(); n++)
-        {
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        int jb = (unsigned int)(f.y * m_grid) % m_grid;
-        int kb = (unsigned int)(f.z * m_grid) % m_grid;
-
-        // if the particle is slightly outside, move back into grid
-        if (ib < 0) ib = 0;
-        if (ib >= (int)m_grid) ib = m_grid - 1;
-
-        if (jb < 0) jb = 0;
-        if (jb >= (int)m_grid) jb = m_grid - 1;
-
-        if (kb < 0) kb = 0;
-        if (kb >= (int)m_grid) kb = m_grid - 1;
-
-        // record its bin
-        unsigned int bin = ib*(m_grid*m_grid) + jb * m_grid + kb;
-
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(h_traversal_order.data[bin], n);
-        }
-
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+    radixSort(computeKeys(3));
     }
 
 void SFCPackUpdater::writeTraversalOrder(const std::string& fname, const vector< unsigned int >& reverse_order)
@@ -617,5 +695,7 @@ void export_SFCPackUpdater(py::module& m)
     py::class_<SFCPackUpdater, std::shared_ptr<SFCPackUpdater> >(m,"SFCPackUpdater",py::base<Updater>())
     .def(py::init< std::shared_ptr<SystemDefinition> >())
     .def("setGrid", &SFCPackUpdater::setGrid)
+    .def("setTolerance", &SFCPackUpdater::setTolerance)
+    .def("getLocality", &SFCPackUpdater::getLocality)
     ;
     }
@@ -18,6 +18,8 @@
 #include <memory>
 #include <vector>
 #include <utility>
+#include <stdexcept>
+#include <stdint.h>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
 #ifndef __SFCPACK_UPDATER_H__
@@ -40,9 +42,17 @@
     dimension can be changed by calling setGrid().
 
     Implementation details:<br>
-    The rearranging is done by computing bins for the particles, and then ordering the particles based on the order in
-    which those bins appear along a hilbert curve. It is very efficient, even when the box size changes often as the
-    grid dimension is kept constant.
+    On the CPU, every particle is assigned a 64-bit key that gives the position of its grid cell along a hilbert curve.
+    The key is computed directly from the cell coordinates with bit operations, so no traversal table is stored and
+    the grid can be as fine as 2^21 cells per dimension in 3D (2^31 in 2D). The keys are sorted with a least
+    significant digit radix sort (parallelized with TBB when available) that only processes as many 8 bit digits as
+    the grid resolution requires, and the resulting permutation is applied with a single gather per array into the
+    alternate particle data arrays, which are then swapped in.
+
+    When a tolerance is set with setTolerance(), update() first measures how well the current order preserves
+    locality (the mean distance between particles adjacent in memory) and only sorts once that has grown by more than
+    the given factor since the last sort. The updater can then be called often at little cost, and the sort happens
+    when the system actually needs it.
 
     \ingroup updaters
 */
@@ -67,11 +77,30 @@ class PYBIND11_EXPORT SFCPackUpdater : public Updater
             m_grid = (unsigned int)pow(2.0, ceil(log(double(grid)) / log(2.0)));;
             }
 
+        //! Set the locality tolerance for adaptive sorting
+        /*! \param tolerance Sort only when the locality metric has grown by more than this factor since the last sort
+            \note A value of 0 sorts on every call to update()
+        */
+        void setTolerance(Scalar tolerance)
+            {
+            if (tolerance != Scalar(0.0) && tolerance < Scalar(1.0))
+                {
+                m_exec_conf->msg->error() << "update.sort: tolerance must be 0 or >= 1" << std::endl;
+                throw std::runtime_error("Error setting sorter parameters");
+                }
+            m_tolerance = tolerance;
+            }
+
+        //! Get the locality metric of the current particle order
+        Scalar getLocality();
+
     protected:
         unsigned int m_grid;        //!< Grid dimension to use
         unsigned int m_last_grid;   //!< The last value of MMax
         unsigned int m_last_dim;    //!< Check the last dimension we ran at
         GPUArray< unsigned int > m_traversal_order;      //!< Generated traversal order of bins
+        Scalar m_tolerance;         //!< Locality tolerance for adaptive sorting (0 to always sort)
+        Scalar m_sorted_locality;   //!< Locality metric measured right after the last sort
 
         //! Helper function that actually performs the sort
         virtual void getSortedOrder2D();
@@ -90,9 +119,20 @@ class PYBIND11_EXPORT SFCPackUpdater : public Updater
         //! Reallocate internal arrays
         virtual void reallocate();
 
+        //! Compute the hilbert curve keys of the local particles
+        unsigned int computeKeys(unsigned int ndim);
+
+        //! Sort m_sort_order by m_keys
+        void radixSort(unsigned int key_bits);
+
+        //! Number of parallel chunks to split loops over particles into
+        unsigned int getNumChunks() const;
+
     private:
         std::vector<unsigned int> m_sort_order;             //!< Generated sort order of the particles
-        std::vector< std::pair<unsigned int, unsigned int> > m_particle_bins;    //!< Binned particles
+        std::vector<unsigned int> m_sort_order_tmp;         //!< Scratch space for the radix sort
+        std::vector<uint64_t> m_keys;                       //!< Hilbert curve keys of the particles
+        std::vector<uint64_t> m_keys_tmp;                   //!< Scratch space for the radix sort
 
    };
 
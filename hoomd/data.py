@@ -2307,18 +2307,19 @@ def make_snapshot(N, box, particle_types=['A'], bond_types=[], angle_types=[], d
 
     return snapshot;
 
-def gsd_snapshot(filename, frame=0):
+def gsd_snapshot(filename, frame=0, mmap=False):
     R""" Read a snapshot from a GSD file.
 
     Args:
         filename (str): GSD file to read the snapshot from.
         frame (int): Frame to read from the GSD file. Negative values index from the end of the file.
+        mmap (bool): Memory map the file and copy data chunks from the mapping.
 
     :py:func:`hoomd.data.gsd_snapshot()` opens the given GSD file and reads a snapshot from it.
     """
     hoomd.context._verify_init();
 
-    reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0);
+    reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0, mmap);
     return reader.getSnapshot();
 
 
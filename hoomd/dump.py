@@ -728,3 +728,55 @@ class gsd(hoomd.analyze._analyzer):
         .. versionadded:: 2.7
         """
         return self.cpp_analyzer.user_log;
+
+class checkpoint(hoomd.analyze._analyzer):
+    R""" Writes native binary checkpoints for fast restarts
+
+    Args:
+        filename (str): Base file name of the checkpoint
+        period (int): Number of time steps between checkpoints, or None to write a single checkpoint immediately.
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+
+    :py:class:`checkpoint` saves the full state of the system (particles, bonded groups, box, domain decomposition,
+    and integrator variables) so that :py:func:`hoomd.init.read_checkpoint` can restore it exactly. In contrast to
+    restart files written by :py:class:`gsd`, the particle data is not gathered on the root rank. Every MPI rank writes
+    its local data in native binary form to the file *filename.<timestep>.<rank>* in parallel, and the root rank writes
+    a small index file *filename*. The files of the previous checkpoint are only removed once the new one is complete.
+
+    Checkpoints are meant for restarting the same job. They must be read by the same build of HOOMD-blue, on
+    the same number of MPI ranks. Use :py:class:`gsd` for portable output.
+
+    Examples::
+
+        dump.checkpoint(filename="restart.ckp", period=100000)
+        ckp = dump.checkpoint(filename="restart.ckp", period=None)
+
+    .. versionadded:: 2.9
+    """
+    def __init__(self, filename, period, phase=0):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        hoomd.analyze._analyzer.__init__(self);
+
+        # every rank writes its own file, so all ranks need the name given on the root rank
+        filename = _hoomd.mpi_bcast_str(filename, hoomd.context.exec_conf);
+        self.cpp_analyzer = _hoomd.CheckpointWriter(hoomd.context.current.system_definition, filename);
+
+        if period is not None:
+            self.setupAnalyzer(period, phase);
+        else:
+            self.cpp_analyzer.analyze(hoomd.context.current.system.getCurrentTimeStep());
+
+        # store metadata
+        self.filename = filename
+        self.period = period
+        self.phase = phase
+        self.metadata_fields = ['filename','period','phase']
+
+    def write(self):
+        """ Write a checkpoint at the current time step.
+
+        Call :py:meth:`write` at the end of a simulation to ensure that the checkpoint holds the final state.
+        """
+        self.cpp_analyzer.analyze(hoomd.context.current.system.getCurrentTimeStep());
@@ -22,6 +22,10 @@
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 namespace hpmc
 {
 
@@ -161,7 +165,16 @@ class AnalyzerSDF : public Analyzer
                        const quat<Scalar>& orientation_i,
                        const quat<Scalar>& orientation_j,
                        const typename Shape::param_type& params_i,
-                       const typename Shape::param_type& params_j);
+                       const typename Shape::param_type& params_j,
+                       unsigned int max_bin);
+
+        //! Determine the smallest s bin of all pairs of a given particle
+        unsigned int computeMinBin(unsigned int i,
+                                   const detail::AABBTree& aabb_tree,
+                                   const std::vector<vec3<Scalar> >& image_list,
+                                   Scalar extra_width,
+                                   const Scalar4 *h_postype,
+                                   const Scalar4 *h_orientation);
     };
 
 
@@ -326,6 +339,9 @@ void AnalyzerSDF<Shape>::zeroHistogram()
     for averaging, and it operates without any communication
       - The integrator performs the ghost exchange (with the ghost width extra that we add)
       - Only on writeOutput() do we need to sum the per-rank histograms into a global histogram
+
+    With TBB, particles are processed in parallel, each thread counts into its own histogram and the thread
+    histograms are summed at the end.
 */
 template < class Shape >
 void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
@@ -341,77 +357,125 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
 
-    const std::vector<param_type, managed_allocator<param_type> > & params = m_mc->getParams();
-
     // loop through N particles
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > hist_parallel(std::vector<unsigned int>(m_hist.size(), 0));
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        std::vector<unsigned int>& hist = hist_parallel.local();
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            {
+            unsigned int min_bin = computeMinBin(i, aabb_tree, image_list, extra_width, h_postype.data, h_orientation.data);
+
+            // record the minimum bin
+            if (min_bin < hist.size())
+                hist[min_bin]++;
+            }
+        });
+
+    hist_parallel.combine_each([&](const std::vector<unsigned int>& hist)
+        {
+        for (unsigned int k = 0; k < m_hist.size(); k++)
+            m_hist[k] += hist[k];
+        });
+    #else
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
         {
-        int min_bin = m_hist.size();
+        unsigned int min_bin = computeMinBin(i, aabb_tree, image_list, extra_width, h_postype.data, h_orientation.data);
 
-        // read in the current position and orientation
-        Scalar4 postype_i = h_postype.data[i];
-        Scalar4 orientation_i = h_orientation.data[i];
-        Shape shape_i(quat<Scalar>(orientation_i), params[__scalar_as_int(postype_i.w)]);
-        vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+        // record the minimum bin
+        if (min_bin < m_hist.size())
+            m_hist[min_bin]++;
+        } // end loop over all particles
+    #endif
+    }
 
-        // construct the AABB around the particle's circumsphere
-        // pad with enough extra width so that when scaled by lmax, found particles might touch
-        detail::AABB aabb_i_local(vec3<Scalar>(0,0,0), shape_i.getCircumsphereDiameter()/Scalar(2) + extra_width);
+/*! \param i Index of the particle
+    \param aabb_tree AABB tree of the integrator
+    \param image_list Periodic images to check
+    \param extra_width Extra search width so that all particles that may touch when scaled by lmax are found
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
 
-        const unsigned int n_images = image_list.size();
-        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-            {
-            vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
-            detail::AABB aabb = aabb_i_local;
-            aabb.translate(pos_i_image);
+    \returns The smallest s bin of all pairs of particle *i*, or the number of bins when no neighbor touches *i*
+              within lmax
 
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
+    Each pair is only searched for bins below the smallest one found so far.
+*/
+template < class Shape >
+unsigned int AnalyzerSDF<Shape>::computeMinBin(unsigned int i,
+                                               const detail::AABBTree& aabb_tree,
+                                               const std::vector<vec3<Scalar> >& image_list,
+                                               Scalar extra_width,
+                                               const Scalar4 *h_postype,
+                                               const Scalar4 *h_orientation)
+    {
+    const std::vector<param_type, managed_allocator<param_type> > & params = m_mc->getParams();
+
+    unsigned int min_bin = m_hist.size();
+
+    // read in the current position and orientation
+    Scalar4 postype_i = h_postype[i];
+    Scalar4 orientation_i = h_orientation[i];
+    Shape shape_i(quat<Scalar>(orientation_i), params[__scalar_as_int(postype_i.w)]);
+    vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+    // construct the AABB around the particle's circumsphere
+    // pad with enough extra width so that when scaled by lmax, found particles might touch
+    detail::AABB aabb_i_local(vec3<Scalar>(0,0,0), shape_i.getCircumsphereDiameter()/Scalar(2) + extra_width);
+
+    const unsigned int n_images = image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
                 {
-                if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                if (aabb_tree.isNodeLeaf(cur_node_idx))
                     {
-                    if (aabb_tree.isNodeLeaf(cur_node_idx))
+                    for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                         {
-                        for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                            {
-                            // read in its position and orientation
-                            unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        // read in its position and orientation
+                        unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                continue;
+                        // skip i==j in the 0 image
+                        if (cur_image == 0 && i == j)
+                            continue;
 
-                            Scalar4 postype_j = h_postype.data[j];
-                            Scalar4 orientation_j = h_orientation.data[j];
+                        Scalar4 postype_j = h_postype[j];
+                        Scalar4 orientation_j = h_orientation[j];
 
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
 
+                        int bin = computeBin(r_ij,
+                                             quat<Scalar>(orientation_i),
+                                             quat<Scalar>(orientation_j),
+                                             params[__scalar_as_int(postype_i.w)],
+                                             params[__scalar_as_int(postype_j.w)],
+                                             min_bin);
 
-                            int bin = computeBin(r_ij,
-                                                 quat<Scalar>(orientation_i),
-                                                 quat<Scalar>(orientation_j),
-                                                 params[__scalar_as_int(postype_i.w)],
-                                                 params[__scalar_as_int(postype_j.w)]);
-
-                            if (bin >= 0)
-                                min_bin = std::min(min_bin, bin);
-                            }
+                        if (bin >= 0)
+                            min_bin = std::min(min_bin, (unsigned int)bin);
                         }
                     }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                    }
-                } // end loop over AABB nodes
-            } // end loop over images
-
-        // record the minimum bin
-        if ((unsigned int)min_bin < m_hist.size())
-            m_hist[min_bin]++;
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            } // end loop over AABB nodes
+        } // end loop over images
 
-        } // end loop over all particles
+    return min_bin;
     }
 
 /*! \param r_ij Vector pointing from particle i to j (already wrapped into the box)
@@ -419,8 +483,9 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
     \param orientation_j Orientation of particle j
     \param params_i Parameters for particle i
     \param params_j Parameters for particle j
+    \param max_bin Only bins below max_bin are searched
 
-    \returns s bin index
+    \returns s bin index, or \a max_bin if the particles do not overlap at the left boundary of \a max_bin
 
     In the first general version, computeBin uses a binary search tree to determine
     the bin. In this way, only a test_overlap method is needed, no extra math. The
@@ -434,10 +499,15 @@ int AnalyzerSDF<Shape>:: computeBin(const vec3<Scalar>& r_ij,
                              const quat<Scalar>& orientation_i,
                              const quat<Scalar>& orientation_j,
                              const typename Shape::param_type& params_i,
-                             const typename Shape::param_type& params_j)
+                             const typename Shape::param_type& params_j,
+                             unsigned int max_bin)
     {
     unsigned int L=0;
-    unsigned int R=m_hist.size();
+    unsigned int R=max_bin;
+
+    // no bin to search
+    if (R == 0)
+        return max_bin;
 
     // if the particles already overlap a the left boundary, return an out of range value
     if (detail::test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, L*m_dl))
@@ -445,7 +515,7 @@ int AnalyzerSDF<Shape>:: computeBin(const vec3<Scalar>& r_ij,
 
     // if the particles do not overlap a the right boundary, return an out of range value
     if (!detail::test_scaled_overlap<Shape>(r_ij, orientation_i, orientation_j, params_i, params_j, R*m_dl))
-        return m_hist.size();
+        return max_bin;
 
     // progressively narrow the search window by halves
     do
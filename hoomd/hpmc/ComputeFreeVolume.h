@@ -25,6 +25,10 @@
 
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 
 namespace hpmc
 {
@@ -88,6 +92,16 @@ class ComputeFreeVolume : public Compute
         const std::string m_suffix;                              //!< Log suffix
 
         GPUArray<unsigned int> m_n_overlap_all;                  //!< Number of overlap volume particles in box
+
+        //! Test a single sample for overlaps
+        bool checkTestParticleOverlap(const vec3<Scalar>& pos_i,
+                                      const Shape& shape_i,
+                                      const std::vector<vec3<Scalar> >& image_list,
+                                      const detail::AABBTree& aabb_tree,
+                                      const Scalar4 *h_postype,
+                                      const Scalar4 *h_orientation,
+                                      const unsigned int *h_overlaps,
+                                      unsigned int& err_count);
     };
 
 
@@ -129,13 +143,95 @@ void ComputeFreeVolume<Shape>::compute(unsigned int timestep)
     this->computeFreeVolume(timestep);
     }
 
+/*! \param pos_i Position of the test particle
+    \param shape_i Shape of the test particle
+    \param image_list Periodic images to check
+    \param aabb_tree AABB tree of the local and ghost particles
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+    \param err_count Error counter for the overlap checks
+    \returns true if the test particle overlaps with any particle
+
+    The search stops at the first overlap found.
+*/
+template<class Shape>
+bool ComputeFreeVolume<Shape>::checkTestParticleOverlap(const vec3<Scalar>& pos_i,
+                                                        const Shape& shape_i,
+                                                        const std::vector<vec3<Scalar> >& image_list,
+                                                        const detail::AABBTree& aabb_tree,
+                                                        const Scalar4 *h_postype,
+                                                        const Scalar4 *h_orientation,
+                                                        const unsigned int *h_overlaps,
+                                                        unsigned int& err_count)
+    {
+    const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = m_mc->getParams();
+    const Index2D& overlap_idx = m_mc->getOverlapIndexer();
+
+    detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+
+    // All image boxes (including the primary)
+    const unsigned int n_images = image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search, subtrees that do not overlap are skipped
+        for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        // read in its position and orientation
+                        unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        Scalar4 postype_j = h_postype[j];
+                        Scalar4 orientation_j = h_orientation[j];
+
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
+
+                        if (h_overlaps[overlap_idx(m_type, typ_j)]
+                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                            && test_overlap(r_ij, shape_i, shape_j, err_count))
+                            {
+                            return true;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            }  // end loop over AABB nodes
+        } // end loop over images
+
+    return false;
+    }
+
 /*! \return the current free volume estimate by MC integration
+
+    The local box is divided into a grid of strata with (close to) one sample each. Every full round of samples
+    places one sample uniformly in each stratum, the remaining samples are placed uniformly in the box. This
+    keeps the estimate unbiased and reduces its variance compared to purely random sampling.
+
+    Every sample uses its own counter-based random number stream, so the samples are checked in parallel and the
+    result does not depend on the number of threads.
 */
 template<class Shape>
 void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
     {
     unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
 
     this->m_exec_conf->msg->notice(5) << "HPMC computing free volume " << timestep << std::endl;
 
@@ -159,7 +255,6 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
         const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = m_mc->getParams();
 
         ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
-        const Index2D& overlap_idx = m_mc->getOverlapIndexer();
 
         // generate n_sample random test depletants in the global box
         unsigned int n_sample = m_n_sample;
@@ -168,7 +263,19 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
         n_sample /= this->m_exec_conf->getNRanks();
         #endif
 
-        for (unsigned int i = 0; i < n_sample; i++)
+        // set up the strata
+        const unsigned int ndim = m_sysdef->getNDimensions();
+        unsigned int n_strata_dim = 1;
+        while (((ndim == 2) ? (n_strata_dim+1)*(n_strata_dim+1)
+            : (n_strata_dim+1)*(n_strata_dim+1)*(n_strata_dim+1)) <= n_sample)
+            {
+            n_strata_dim++;
+            }
+        Index3D strata_idx(n_strata_dim, n_strata_dim, (ndim == 2) ? 1 : n_strata_dim);
+        const unsigned int n_strata = strata_idx.getNumElements();
+        const unsigned int n_stratified = (n_sample/n_strata)*n_strata;
+
+        auto count_sample = [&](unsigned int i, unsigned int& err_count) -> unsigned int
             {
             // select a random particle coordinate in the box
             hoomd::RandomGenerator rng_i(hoomd::RNGIdentifier::ComputeFreeVolume, m_seed, m_exec_conf->getRank(), i, timestep);
@@ -178,6 +285,17 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
             Scalar zrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
 
             Scalar3 f = make_scalar3(xrand, yrand, zrand);
+            if (i < n_stratified)
+                {
+                uint3 stratum = strata_idx.getTriple(i % n_strata);
+                f.x = (Scalar(stratum.x) + f.x)/Scalar(strata_idx.getW());
+                f.y = (Scalar(stratum.y) + f.y)/Scalar(strata_idx.getH());
+                f.z = (Scalar(stratum.z) + f.z)/Scalar(strata_idx.getD());
+                }
+            if (ndim == 2)
+                {
+                f.z = Scalar(0.5);
+                }
             vec3<Scalar> pos_i = vec3<Scalar>(box.makeCoordinates(f));
 
             Shape shape_i(quat<Scalar>(), params[m_type]);
@@ -187,72 +305,26 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
                 }
 
             // check for overlaps with neighboring particle's positions
-            bool overlap=false;
-            detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
-
-            // All image boxes (including the primary)
-            const unsigned int n_images = image_list.size();
-            for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-                {
-                vec3<Scalar> pos_i_image = pos_i + image_list[cur_image];
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i_image);
-
-                // stackless search
-                for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
-                    {
-                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
-                        {
-                        if (aabb_tree.isNodeLeaf(cur_node_idx))
-                            {
-                            for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                                {
-                                // read in its position and orientation
-                                unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                Scalar4 postype_j;
-                                Scalar4 orientation_j;
-
-                                // load the position and orientation of the j particle
-                                postype_j = h_postype.data[j];
-                                orientation_j = h_orientation.data[j];
-
-                                // put particles in coordinate system of particle i
-                                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
-
-                                unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
-
-                                if (h_overlaps.data[overlap_idx(m_type, typ_j)]
-                                    && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                    && test_overlap(r_ij, shape_i, shape_j, err_count))
-                                    {
-                                    overlap = true;
-                                    break;
-                                    }
-                                }
-                            }
-                        }
-                    else
-                        {
-                        // skip ahead
-                        cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                        }
-
-                    if (overlap)
-                        break;
-                    }  // end loop over AABB nodes
-
-                if (overlap)
-                    break;
-                } // end loop over images
-
-            if (overlap)
-                {
-                overlap_count++;
-                }
-            } // end loop through all particles
-
+            return checkTestParticleOverlap(pos_i, shape_i, image_list, aabb_tree, h_postype.data,
+                h_orientation.data, h_overlaps.data, err_count) ? 1 : 0;
+            };
+
+        #ifdef ENABLE_TBB
+        overlap_count = tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, n_sample),
+            0u,
+            [&](const tbb::blocked_range<unsigned int>& r, unsigned int overlap_count)->unsigned int {
+            unsigned int local_err_count = 0;
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                overlap_count += count_sample(i, local_err_count);
+            return overlap_count;
+            }, [](unsigned int x, unsigned int y)->unsigned int { return x+y; } );
+        #else
+        unsigned int err_count = 0;
+        for (unsigned int i = 0; i < n_sample; i++)
+            {
+            overlap_count += count_sample(i, err_count);
+            } // end loop through all samples
+        #endif
         } // end lexical scope
 
     #ifdef ENABLE_MPI
@@ -306,6 +306,14 @@ class GPUTree
             return m_leaf_capacity;
             }
 
+        #ifndef NVCC
+        //! Write the tree to a stream (see ShapeParamCache.h)
+        friend void param_write(std::ostream& out, const GPUTree& tree);
+
+        //! Read the tree from a stream (see ShapeParamCache.h)
+        friend void param_read(std::istream& in, GPUTree& tree, bool managed);
+        #endif
+
     private:
         ManagedArray<vec3<OverlapReal> > m_center;
         ManagedArray<vec3<OverlapReal> > m_lengths;
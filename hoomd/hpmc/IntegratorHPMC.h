@@ -34,6 +34,71 @@ namespace hpmc
     \ingroup hpmc_integrators
 */
 
+//! Pairs of particles for a batched patch energy evaluation
+/*! The pair data is stored as one array per argument of PatchEnergy::energy(), so that a runtime compiled
+    evaluator can loop over all pairs in a single call.
+*/
+struct PatchEnergyBatch
+    {
+    std::vector< vec3<float> > r_ij;    //!< Vectors pointing from particle i to j
+    std::vector<unsigned int> type_i;   //!< Types of particle i
+    std::vector< quat<float> > q_i;     //!< Orientations of particle i
+    std::vector<float> d_i;             //!< Diameters of particle i
+    std::vector<float> charge_i;        //!< Charges of particle i
+    std::vector<unsigned int> type_j;   //!< Types of particle j
+    std::vector< quat<float> > q_j;     //!< Orientations of particle j
+    std::vector<float> d_j;             //!< Diameters of particle j
+    std::vector<float> charge_j;        //!< Charges of particle j
+    std::vector<unsigned int> idx;      //!< Index of particle j, for use by the caller
+    std::vector<float> energy;          //!< Energies of the pairs, set by PatchEnergy::energyBatch()
+
+    //! Remove all pairs
+    void clear()
+        {
+        r_ij.clear();
+        type_i.clear();
+        q_i.clear();
+        d_i.clear();
+        charge_i.clear();
+        type_j.clear();
+        q_j.clear();
+        d_j.clear();
+        charge_j.clear();
+        idx.clear();
+        energy.clear();
+        }
+
+    //! Add a pair
+    void push_back(const vec3<float>& r,
+        unsigned int typ_i,
+        const quat<float>& qi,
+        float di,
+        float chargei,
+        unsigned int typ_j,
+        const quat<float>& qj,
+        float dj,
+        float chargej,
+        unsigned int j)
+        {
+        r_ij.push_back(r);
+        type_i.push_back(typ_i);
+        q_i.push_back(qi);
+        d_i.push_back(di);
+        charge_i.push_back(chargei);
+        type_j.push_back(typ_j);
+        q_j.push_back(qj);
+        d_j.push_back(dj);
+        charge_j.push_back(chargej);
+        idx.push_back(j);
+        }
+
+    //! Get the number of pairs
+    unsigned int size() const
+        {
+        return r_ij.size();
+        }
+    };
+
 class PatchEnergy
     {
     public:
@@ -77,6 +142,29 @@ class PatchEnergy
         return 0;
         }
 
+    //! evaluate the energies of a batch of pairs
+    /*! \param batch Pairs to evaluate, batch.energy is set to the energy of every pair
+
+        The base class evaluates every pair with energy(), derived classes may evaluate all pairs at once.
+    */
+    virtual void energyBatch(PatchEnergyBatch& batch)
+        {
+        unsigned int n = batch.size();
+        batch.energy.resize(n);
+        for (unsigned int k = 0; k < n; k++)
+            {
+            batch.energy[k] = energy(batch.r_ij[k],
+                batch.type_i[k],
+                batch.q_i[k],
+                batch.d_i[k],
+                batch.charge_i[k],
+                batch.type_j[k],
+                batch.q_j[k],
+                batch.d_j[k],
+                batch.charge_j[k]);
+            }
+        }
+
     };
 
 class PYBIND11_EXPORT IntegratorHPMC : public Integrator
@@ -322,6 +410,9 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         //! Enable deterministic simulations
         virtual void setDeterministic(bool deterministic) {};
 
+        //! Enable caching of the old configuration patch energies between trial moves
+        virtual void setPatchEnergyCache(bool enable) {};
+
         //! Prepare for the run
         virtual void prepRun(unsigned int timestep)
             {
@@ -12,6 +12,9 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <climits>
 
 #include "hoomd/Integrator.h"
 #include "HPMCPrecisionSetup.h"
@@ -105,6 +108,12 @@ class UpdateOrder
         std::vector<unsigned int> m_update_order; //!< Update order
     };
 
+//! Marks a particle without cached patch energies
+const unsigned int PATCH_CACHE_INVALID = 0xffffffff;
+
+//! Number of particles of recent overlaps that are checked first for overlaps after a box change
+const unsigned int OVERLAP_HINT_SIZE = 16;
+
 }; // end namespace detail
 
 //! HPMC on systems of mono-disperse shapes
@@ -133,6 +142,7 @@ class IntegratorHPMCMono : public IntegratorHPMC
                 free(m_aabbs);
             m_pdata->getBoxChangeSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotBoxChanged>(this);
             m_pdata->getParticleSortSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotSorted>(this);
+            m_pdata->getGlobalParticleNumberChangeSignal().template disconnect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotNumParticlesChanged>(this);
             }
 
         virtual void printStats();
@@ -161,6 +171,19 @@ class IntegratorHPMCMono : public IntegratorHPMC
             this->m_external_base = (ExternalField*)external.get();
             }
 
+        //! Enable caching of the old configuration patch energies between trial moves
+        /*! \param enable True to cache the pair energies of every particle with its neighbors
+
+            With the cache enabled, a trial move evaluates only the patch energy of the new configuration, the energy
+            of the old configuration is summed from the cached pair energies. The cache lives for one call to update()
+            and is updated exactly for the neighbors of every accepted move. It relies on the patch energy being
+            symmetric, U_ij = U_ji, which the Metropolis criterion already assumes.
+        */
+        virtual void setPatchEnergyCache(bool enable)
+            {
+            m_patch_cache = enable;
+            }
+
         //! Get a list of logged quantities
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -371,6 +394,36 @@ class IntegratorHPMCMono : public IntegratorHPMC
 
         Scalar m_extra_image_width;                 //! Extra width to extend the image list
 
+        bool m_patch_cache;                         //!< True if old configuration patch energies are cached
+        unsigned int m_patch_cache_max;             //!< Maximum number of cached pair energies per particle
+        unsigned int m_patch_cache_overflow;        //!< Largest number of pair energies that did not fit the cache
+        std::vector<unsigned int> m_patch_cache_n;  //!< Number of cached pair energies per particle
+        std::vector<unsigned int> m_patch_cache_nbr; //!< Neighbor index of every cached pair energy
+        std::vector<float> m_patch_cache_energy;    //!< Cached pair energies, m_patch_cache_max per particle
+
+        std::vector<unsigned int> m_overlap_hint;   //!< Tags of the particles in the most recently found overlaps
+
+        //! Count the overlaps of a single particle
+        unsigned int countParticleOverlaps(unsigned int i,
+                                           bool early_exit,
+                                           const Scalar4 *h_postype,
+                                           const Scalar4 *h_orientation,
+                                           const unsigned int *h_tag,
+                                           const unsigned int *h_overlaps,
+                                           unsigned int& j_overlap,
+                                           unsigned int& err_count);
+
+        //! Move a particle to the front of the overlap hints
+        void addOverlapHint(unsigned int tag)
+            {
+            std::vector<unsigned int>::iterator it = std::find(m_overlap_hint.begin(), m_overlap_hint.end(), tag);
+            if (it != m_overlap_hint.end())
+                m_overlap_hint.erase(it);
+            else if (m_overlap_hint.size() == detail::OVERLAP_HINT_SIZE)
+                m_overlap_hint.pop_back();
+            m_overlap_hint.insert(m_overlap_hint.begin(), tag);
+            }
+
         Index2D m_overlap_idx;                      //!!< Indexer for interaction matrix
 
         //! Set the nominal width appropriate for looped moves
@@ -382,6 +435,78 @@ class IntegratorHPMCMono : public IntegratorHPMC
         //! Limit the maximum move distances
         virtual void limitMoveDistances();
 
+        //! Clear the patch energy cache and size it for the local particles
+        void resetPatchCache()
+            {
+            if (m_patch_cache_overflow > m_patch_cache_max)
+                m_patch_cache_max = m_patch_cache_overflow;
+
+            unsigned int N = m_pdata->getN();
+            m_patch_cache_n.assign(N, detail::PATCH_CACHE_INVALID);
+            m_patch_cache_nbr.resize(N*m_patch_cache_max);
+            m_patch_cache_energy.resize(N*m_patch_cache_max);
+            }
+
+        //! Store the pair energies of particle i
+        /*! \param i Local particle index
+            \param nbr Neighbors of i, one entry per interacting image
+            \param energy Pair energies with the neighbors
+        */
+        void storePatchCache(unsigned int i, const std::vector<unsigned int>& nbr, const std::vector<float>& energy)
+            {
+            if (nbr.size() > m_patch_cache_max)
+                {
+                // leave i uncached, the cache grows at the next reset
+                m_patch_cache_overflow = std::max(m_patch_cache_overflow, (unsigned int)nbr.size());
+                m_patch_cache_n[i] = detail::PATCH_CACHE_INVALID;
+                return;
+                }
+
+            std::copy(nbr.begin(), nbr.end(), m_patch_cache_nbr.begin() + i*m_patch_cache_max);
+            std::copy(energy.begin(), energy.end(), m_patch_cache_energy.begin() + i*m_patch_cache_max);
+            m_patch_cache_n[i] = nbr.size();
+            }
+
+        //! Remove all pair energies of particle j with particle i from the cache
+        void removePatchCacheNeighbor(unsigned int j, unsigned int i)
+            {
+            unsigned int n = m_patch_cache_n[j];
+            if (n == detail::PATCH_CACHE_INVALID)
+                return;
+
+            unsigned int offset = j*m_patch_cache_max;
+            unsigned int m = 0;
+            for (unsigned int k = 0; k < n; k++)
+                {
+                if (m_patch_cache_nbr[offset + k] != i)
+                    {
+                    m_patch_cache_nbr[offset + m] = m_patch_cache_nbr[offset + k];
+                    m_patch_cache_energy[offset + m] = m_patch_cache_energy[offset + k];
+                    m++;
+                    }
+                }
+            m_patch_cache_n[j] = m;
+            }
+
+        //! Add a pair energy of particle j with particle i to the cache
+        void addPatchCacheNeighbor(unsigned int j, unsigned int i, float energy)
+            {
+            unsigned int n = m_patch_cache_n[j];
+            if (n == detail::PATCH_CACHE_INVALID)
+                return;
+
+            if (n == m_patch_cache_max)
+                {
+                m_patch_cache_overflow = std::max(m_patch_cache_overflow, n+1);
+                m_patch_cache_n[j] = detail::PATCH_CACHE_INVALID;
+                return;
+                }
+
+            m_patch_cache_nbr[j*m_patch_cache_max + n] = i;
+            m_patch_cache_energy[j*m_patch_cache_max + n] = energy;
+            m_patch_cache_n[j] = n+1;
+            }
+
         //! callback so that the box change signal can invalidate the image list
         virtual void slotBoxChanged()
             {
@@ -397,6 +522,12 @@ class IntegratorHPMCMono : public IntegratorHPMC
             {
             m_aabb_tree_invalid = true;
             }
+
+        //! callback so that the overlap hints do not refer to removed particles or to a previous snapshot
+        void slotNumParticlesChanged()
+            {
+            m_overlap_hint.clear();
+            }
     };
 
 template <class Shape>
@@ -407,7 +538,10 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
               m_image_list_is_initialized(false),
               m_image_list_valid(false),
               m_hasOrientation(true),
-              m_extra_image_width(0.0)
+              m_extra_image_width(0.0),
+              m_patch_cache(false),
+              m_patch_cache_max(16),
+              m_patch_cache_overflow(0)
     {
     // allocate the parameter storage
     m_params = std::vector<param_type, managed_allocator<param_type> >(m_pdata->getNTypes(), param_type(), managed_allocator<param_type>(m_exec_conf->isCUDAEnabled()));
@@ -424,6 +558,7 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     // Connect to the BoxChange signal
     m_pdata->getBoxChangeSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotBoxChanged>(this);
     m_pdata->getParticleSortSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotSorted>(this);
+    m_pdata->getGlobalParticleNumberChangeSignal().template connect<IntegratorHPMCMono<Shape>, &IntegratorHPMCMono<Shape>::slotNumParticlesChanged>(this);
 
     m_image_list_rebuilds = 0;
     m_image_list_warning_issued = false;
@@ -573,6 +708,14 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     // access interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
+    // pairs for the patch energy of the old and new configuration
+    PatchEnergyBatch batch_old, batch_new;
+
+    // the cached patch energies are only valid within this call
+    bool patch_cache = m_patch_cache && m_patch && !m_patch_log;
+    if (patch_cache)
+        resetPatchCache();
+
     // loop over local particles nselect times
     for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
         {
@@ -665,6 +808,10 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
             // patch + field interaction deltaU
             double patch_field_energy_diff = 0;
 
+            bool old_cached = patch_cache && m_patch_cache_n[i] != detail::PATCH_CACHE_INVALID;
+            batch_old.clear();
+            batch_new.clear();
+
             // check for overlaps with neighboring particle's positions (also calculate the new energy)
             // All image boxes (including the primary)
             const unsigned int n_images = m_image_list.size();
@@ -731,16 +878,16 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                                     }
                                 else if (m_patch && !m_patch_log && dot(r_ij,r_ij) <= rcut*rcut) // If there is no overlap and m_patch is not NULL, calculate energy
                                     {
-                                    // deltaU = U_old - U_new: subtract energy of new configuration
-                                    patch_field_energy_diff -= m_patch->energy(r_ij, typ_i,
-                                                               quat<float>(shape_i.orientation),
-                                                               h_diameter.data[i],
-                                                               h_charge.data[i],
-                                                               typ_j,
-                                                               quat<float>(orientation_j),
-                                                               h_diameter.data[j],
-                                                               h_charge.data[j]
-                                                               );
+                                    // the energies are evaluated in one batch once no overlap is found
+                                    batch_new.push_back(vec3<float>(r_ij), typ_i,
+                                                        quat<float>(shape_i.orientation),
+                                                        h_diameter.data[i],
+                                                        h_charge.data[i],
+                                                        typ_j,
+                                                        quat<float>(orientation_j),
+                                                        h_diameter.data[j],
+                                                        h_charge.data[j],
+                                                        j);
                                     }
                                 }
                             }
@@ -759,8 +906,23 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     break;
                 } // end loop over images
 
-            // calculate old patch energy only if m_patch not NULL and no overlaps
             if (m_patch && !m_patch_log && !overlap)
+                {
+                // deltaU = U_old - U_new: subtract energy of new configuration
+                m_patch->energyBatch(batch_new);
+                for (unsigned int k = 0; k < batch_new.size(); k++)
+                    patch_field_energy_diff -= batch_new.energy[k];
+                }
+
+            // calculate old patch energy only if m_patch not NULL and no overlaps
+            if (old_cached && !overlap)
+                {
+                // deltaU = U_old - U_new: add the cached energy of the old configuration
+                unsigned int offset = i*m_patch_cache_max;
+                for (unsigned int k = 0; k < m_patch_cache_n[i]; k++)
+                    patch_field_energy_diff += m_patch_cache_energy[offset + k];
+                }
+            else if (m_patch && !m_patch_log && !overlap)
                 {
                 for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                     {
@@ -812,17 +974,17 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
 
                                     Scalar rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
 
-                                    // deltaU = U_old - U_new: add energy of old configuration
                                     if (dot(r_ij,r_ij) <= rcut*rcut)
-                                        patch_field_energy_diff += m_patch->energy(r_ij,
-                                                                   typ_i,
-                                                                   quat<float>(orientation_i),
-                                                                   h_diameter.data[i],
-                                                                   h_charge.data[i],
-                                                                   typ_j,
-                                                                   quat<float>(orientation_j),
-                                                                   h_diameter.data[j],
-                                                                   h_charge.data[j]);
+                                        batch_old.push_back(vec3<float>(r_ij),
+                                                            typ_i,
+                                                            quat<float>(orientation_i),
+                                                            h_diameter.data[i],
+                                                            h_charge.data[i],
+                                                            typ_j,
+                                                            quat<float>(orientation_j),
+                                                            h_diameter.data[j],
+                                                            h_charge.data[j],
+                                                            j);
                                     }
                                 }
                             }
@@ -833,6 +995,11 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                             }
                         }  // end loop over AABB nodes
                     } // end loop over images
+
+                // deltaU = U_old - U_new: add energy of old configuration
+                m_patch->energyBatch(batch_old);
+                for (unsigned int k = 0; k < batch_old.size(); k++)
+                    patch_field_energy_diff += batch_old.energy[k];
                 } // end if (m_patch)
 
             // Add external energetic contribution
@@ -866,6 +1033,39 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
                     }
+
+                if (patch_cache)
+                    {
+                    // replace the pair energies with i in the caches of its old and new neighbors
+                    if (old_cached)
+                        {
+                        unsigned int offset = i*m_patch_cache_max;
+                        for (unsigned int k = 0; k < m_patch_cache_n[i]; k++)
+                            {
+                            unsigned int j = m_patch_cache_nbr[offset + k];
+                            if (j != i && j < m_pdata->getN())
+                                removePatchCacheNeighbor(j, i);
+                            }
+                        }
+                    else
+                        {
+                        for (unsigned int k = 0; k < batch_old.size(); k++)
+                            {
+                            unsigned int j = batch_old.idx[k];
+                            if (j != i && j < m_pdata->getN())
+                                removePatchCacheNeighbor(j, i);
+                            }
+                        }
+
+                    for (unsigned int k = 0; k < batch_new.size(); k++)
+                        {
+                        unsigned int j = batch_new.idx[k];
+                        if (j != i && j < m_pdata->getN())
+                            addPatchCacheNeighbor(j, i, batch_new.energy[k]);
+                        }
+
+                    storePatchCache(i, batch_new.idx, batch_new.energy);
+                    }
                 }
             else
                 {
@@ -877,6 +1077,10 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     else
                         counters.rotate_reject_count++;
                     }
+
+                // the old configuration energies were computed in full, keep them for the next trial move of i
+                if (patch_cache && !old_cached && !overlap)
+                    storePatchCache(i, batch_old.idx, batch_old.energy);
                 }
             } // end loop over all particles
         } // end loop over nselect
@@ -930,6 +1134,98 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     m_aabb_tree_invalid = true;
     }
 
+/*! \param i Index of the particle to check
+    \param early_exit Return at the first overlap found
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_tag Particle tags
+    \param h_overlaps Interaction matrix
+    \param j_overlap Set to the index of the last overlapping particle found
+    \param err_count Error counter of the overlap checks
+
+    \returns The number of overlaps of particle i with particles of equal or larger tag, or with \a early_exit 1 if
+              i overlaps any particle and 0 otherwise
+*/
+template <class Shape>
+unsigned int IntegratorHPMCMono<Shape>::countParticleOverlaps(unsigned int i,
+                                                              bool early_exit,
+                                                              const Scalar4 *h_postype,
+                                                              const Scalar4 *h_orientation,
+                                                              const unsigned int *h_tag,
+                                                              const unsigned int *h_overlaps,
+                                                              unsigned int& j_overlap,
+                                                              unsigned int& err_count)
+    {
+    unsigned int overlap_count = 0;
+
+    // read in the current position and orientation
+    Scalar4 postype_i = h_postype[i];
+    Scalar4 orientation_i = h_orientation[i];
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    Shape shape_i(quat<Scalar>(orientation_i), m_params[typ_i]);
+    vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+    // Check particle against AABB tree for neighbors
+    detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+
+    const unsigned int n_images = m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        // read in its position and orientation
+                        unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // skip i==j in the 0 image
+                        if (cur_image == 0 && i == j)
+                            continue;
+
+                        Scalar4 postype_j = h_postype[j];
+                        Scalar4 orientation_j = h_orientation[j];
+
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
+
+                        // count every pair once, unless any overlap is enough
+                        if ((early_exit || h_tag[i] <= h_tag[j])
+                            && h_overlaps[m_overlap_idx(typ_i,typ_j)]
+                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                            && test_overlap(r_ij, shape_i, shape_j, err_count)
+                            && test_overlap(-r_ij, shape_j, shape_i, err_count))
+                            {
+                            overlap_count++;
+                            j_overlap = j;
+                            if (early_exit)
+                                return overlap_count;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            } // end loop over AABB nodes
+        } // end loop over images
+
+    return overlap_count;
+    }
+
 /*! \param timestep current step
     \param early_exit exit at first overlap found if true
     \returns number of overlaps if early_exit=false, 1 if early_exit=true
@@ -963,90 +1259,99 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, boo
     // access parameters and interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
-    // Loop over all particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    if (early_exit)
         {
-        // read in the current position and orientation
-        Scalar4 postype_i = h_postype.data[i];
-        Scalar4 orientation_i = h_orientation.data[i];
-        unsigned int typ_i = __scalar_as_int(postype_i.w);
-        Shape shape_i(quat<Scalar>(orientation_i), m_params[typ_i]);
-        vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+        // check the particles of the most recently found overlaps first, box moves that are rejected tend to be
+        // rejected by the same tightly packed particles
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        unsigned int n_rtag = m_pdata->getRTags().getNumElements();
+        unsigned int i_overlap = UINT_MAX;
+        unsigned int j_overlap = UINT_MAX;
+        for (unsigned int k = 0; k < m_overlap_hint.size(); k++)
+            {
+            // skip particles that were removed or are not local
+            if (m_overlap_hint[k] >= n_rtag)
+                continue;
+            unsigned int i = h_rtag.data[m_overlap_hint[k]];
+            if (i >= m_pdata->getN())
+                continue;
 
-        // Check particle against AABB tree for neighbors
-        detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
+            if (countParticleOverlaps(i, true, h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data,
+                    j_overlap, err_count))
+                {
+                i_overlap = i;
+                break;
+                }
+            }
 
-        const unsigned int n_images = m_image_list.size();
-        for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        if (i_overlap == UINT_MAX)
             {
-            vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
-            detail::AABB aabb = aabb_i_local;
-            aabb.translate(pos_i_image);
-
-            // stackless search
-            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+            // scan all particles in parallel until any thread finds an overlap
+            #ifdef ENABLE_TBB
+            std::atomic<bool> found(false);
+            tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+                [&](const tbb::blocked_range<unsigned int>& r)
                 {
-                if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                unsigned int local_err_count = 0;
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
                     {
-                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    if (found.load(std::memory_order_relaxed))
+                        break;
+
+                    unsigned int j = UINT_MAX;
+                    if (countParticleOverlaps(i, true, h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data,
+                            j, local_err_count))
                         {
-                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        if (!found.exchange(true))
                             {
-                            // read in its position and orientation
-                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                            // skip i==j in the 0 image
-                            if (cur_image == 0 && i == j)
-                                continue;
-
-                            Scalar4 postype_j = h_postype.data[j];
-                            Scalar4 orientation_j = h_orientation.data[j];
-
-                            // put particles in coordinate system of particle i
-                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
-
-                            unsigned int typ_j = __scalar_as_int(postype_j.w);
-                            Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
-
-                            if (h_tag.data[i] <= h_tag.data[j]
-                                && h_overlaps.data[m_overlap_idx(typ_i,typ_j)]
-                                && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                && test_overlap(r_ij, shape_i, shape_j, err_count)
-                                && test_overlap(-r_ij, shape_j, shape_i, err_count))
-                                {
-                                overlap_count++;
-                                if (early_exit)
-                                    {
-                                    // exit early from loop over neighbor particles
-                                    break;
-                                    }
-                                }
+                            i_overlap = i;
+                            j_overlap = j;
                             }
+                        break;
                         }
                     }
-                else
-                    {
-                    // skip ahead
-                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                    }
-
-                if (overlap_count && early_exit)
+                });
+            #else
+            for (unsigned int i = 0; i < m_pdata->getN(); i++)
+                {
+                if (countParticleOverlaps(i, true, h_postype.data, h_orientation.data, h_tag.data, h_overlaps.data,
+                        j_overlap, err_count))
                     {
+                    i_overlap = i;
                     break;
                     }
-                } // end loop over AABB nodes
-
-            if (overlap_count && early_exit)
-                {
-                break;
                 }
-            } // end loop over images
+            #endif
+            }
 
-        if (overlap_count && early_exit)
+        if (i_overlap != UINT_MAX)
             {
-            break;
+            overlap_count = 1;
+            addOverlapHint(h_tag.data[j_overlap]);
+            addOverlapHint(h_tag.data[i_overlap]);
             }
-        } // end loop over particles
+        }
+    else
+        {
+        // Loop over all particles
+        #ifdef ENABLE_TBB
+        overlap_count = tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+            0u,
+            [&](const tbb::blocked_range<unsigned int>& r, unsigned int overlap_count)->unsigned int {
+            unsigned int local_err_count = 0;
+            unsigned int j_overlap;
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                overlap_count += countParticleOverlaps(i, false, h_postype.data, h_orientation.data, h_tag.data,
+                    h_overlaps.data, j_overlap, local_err_count);
+            return overlap_count;
+            }, [](unsigned int x, unsigned int y)->unsigned int { return x+y; } );
+        #else
+        unsigned int j_overlap;
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            overlap_count += countParticleOverlaps(i, false, h_postype.data, h_orientation.data, h_tag.data,
+                h_overlaps.data, j_overlap, err_count);
+        #endif
+        }
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
 
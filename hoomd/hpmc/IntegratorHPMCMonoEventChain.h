@@ -0,0 +1,671 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __HPMC_MONO_EVENT_CHAIN__H__
+#define __HPMC_MONO_EVENT_CHAIN__H__
+
+#include "IntegratorHPMCMono.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/RNGIdentifiers.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+#include <climits>
+#include <limits>
+
+/*! \file IntegratorHPMCMonoEventChain.h
+    \brief Defines the template class for event-chain Monte Carlo of hard shapes
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+//! Template class for event-chain Monte Carlo
+/*! Instead of attempting small random displacements that are rejected when they overlap, an event chain moves one
+    particle along a direction until it collides with another particle, which then continues the move along the same
+    direction (lifting). The chain ends after its total displacement reaches the chain length. All moves are
+    rejection free, which relaxes dense hard particle systems much faster than local Metropolis moves.
+
+    Every step runs nselect chains per particle, each started on a particle in the shuffled update order and moving
+    along a randomly chosen positive coordinate axis. Collision distances are computed with sweep_distance(), which
+    must be implemented for the shape. Rotations of anisotropic shapes are performed with the Metropolis moves of
+    IntegratorHPMCMono (using only the rotation move sizes) before the chains run.
+
+    Collision partners are searched in segments of at most the nominal width, which keeps the swept volume within the
+    range covered by the image list.
+
+    With domain decomposition, a particle only moves within the active region of its domain, so that every particle
+    it can hit is local. A chain that reaches the boundary of the active region, or lifts to a particle outside of it,
+    is interrupted and keeps its remaining length. After all ranks have run their chains, the grid is shifted randomly,
+    particles are migrated, and the interrupted chains are handed to the ranks that now own their particles. This
+    repeats until every chain has moved by the full chain length, so the chain length does not depend on the
+    configuration.
+
+    Every segment of a chain counts as an accepted translation.
+
+    \ingroup hpmc_integrators
+*/
+template< class Shape >
+class IntegratorHPMCMonoEventChain : public IntegratorHPMCMono<Shape>
+    {
+    public:
+        //! Construct the integrator
+        IntegratorHPMCMonoEventChain(std::shared_ptr<SystemDefinition> sysdef,
+                                     unsigned int seed);
+        //! Destructor
+        virtual ~IntegratorHPMCMonoEventChain();
+
+        //! Set the total displacement of every chain
+        void setChainLength(Scalar chain_length)
+            {
+            if (chain_length < Scalar(0.0))
+                {
+                this->m_exec_conf->msg->error() << "integrate.mode_hpmc: chain_length must be non-negative" << std::endl;
+                throw std::runtime_error("Error setting event chain parameters");
+                }
+            m_chain_length = chain_length;
+            }
+
+        //! Get the total displacement of every chain
+        Scalar getChainLength()
+            {
+            return m_chain_length;
+            }
+
+        //! Take one timestep forward
+        virtual void update(unsigned int timestep);
+
+    protected:
+        Scalar m_chain_length;                  //!< Total displacement of every chain
+
+        //! Find the first particle hit by particle i moving along a direction
+        unsigned int findCollision(unsigned int i,
+                                   const vec3<Scalar>& pos_i,
+                                   const Shape& shape_i,
+                                   unsigned int typ_i,
+                                   const vec3<Scalar>& direction,
+                                   unsigned int exclude,
+                                   OverlapReal& dist,
+                                   hpmc_counters_t& counters,
+                                   const Scalar4 *h_postype,
+                                   const Scalar4 *h_orientation,
+                                   const unsigned int *h_overlaps);
+
+        //! Move a chain until it has covered its length or has to continue on another rank
+        Scalar runChain(unsigned int& i,
+                        unsigned int& prev,
+                        const vec3<Scalar>& direction,
+                        Scalar remaining,
+                        hpmc_counters_t& counters,
+                        Scalar4 *h_postype,
+                        const Scalar4 *h_orientation,
+                        int3 *h_image,
+                        const unsigned int *h_overlaps);
+
+        #ifdef ENABLE_MPI
+        //! Get the distance that a particle can move along a direction before it leaves the active region
+        Scalar getActiveDistance(const vec3<Scalar>& pos,
+                                 const vec3<Scalar>& direction,
+                                 const BoxDim& box,
+                                 const Scalar3& ghost_fraction);
+
+        //! Shift the domain decomposition grid and migrate particles
+        void shiftGrid(unsigned int timestep, unsigned int round);
+        #endif
+    };
+
+//! Maximum number of consecutive lifts without displacement before a chain is considered jammed
+const unsigned int EVENT_CHAIN_MAX_ZERO_LIFTS = 1024;
+
+//! Maximum number of grid shifts per step to complete interrupted chains
+const unsigned int EVENT_CHAIN_MAX_ROUNDS = 1000;
+
+/*! \param sysdef System definition
+    \param seed Random number generator seed
+*/
+template< class Shape >
+IntegratorHPMCMonoEventChain< Shape >::IntegratorHPMCMonoEventChain(std::shared_ptr<SystemDefinition> sysdef,
+                                                                   unsigned int seed)
+    : IntegratorHPMCMono<Shape>(sysdef, seed), m_chain_length(1.0)
+    {
+    this->m_exec_conf->msg->notice(5) << "Constructing IntegratorHPMCMonoEventChain" << std::endl;
+    }
+
+//! Destructor
+template< class Shape >
+IntegratorHPMCMonoEventChain< Shape >::~IntegratorHPMCMonoEventChain()
+    {
+    this->m_exec_conf->msg->notice(5) << "Destroying IntegratorHPMCMonoEventChain" << std::endl;
+    }
+
+/*! \param i Index of the moving particle
+    \param pos_i Position of the moving particle
+    \param shape_i Shape of the moving particle
+    \param typ_i Type of the moving particle
+    \param direction Unit vector along which i moves
+    \param exclude Index of a particle to ignore (the previous particle in the chain), UINT_MAX for none
+    \param dist On input, the maximum displacement to consider. On output, the displacement up to the first collision
+    \param counters Counters to record overlap checks and errors in
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+
+    \returns Index of the particle hit first, or UINT_MAX if i can move by the full distance
+*/
+template< class Shape >
+unsigned int IntegratorHPMCMonoEventChain< Shape >::findCollision(unsigned int i,
+                                                                  const vec3<Scalar>& pos_i,
+                                                                  const Shape& shape_i,
+                                                                  unsigned int typ_i,
+                                                                  const vec3<Scalar>& direction,
+                                                                  unsigned int exclude,
+                                                                  OverlapReal& dist,
+                                                                  hpmc_counters_t& counters,
+                                                                  const Scalar4 *h_postype,
+                                                                  const Scalar4 *h_orientation,
+                                                                  const unsigned int *h_overlaps)
+    {
+    unsigned int hit = UINT_MAX;
+
+    // the volume swept by i, the direction has non-negative components
+    OverlapReal R_query = shape_i.getCircumsphereDiameter()/OverlapReal(2.0);
+    vec3<Scalar> lower(-R_query, -R_query, -R_query);
+    vec3<Scalar> upper = vec3<Scalar>(R_query, R_query, R_query) + Scalar(dist)*direction;
+
+    const unsigned int n_images = this->m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+        detail::AABB aabb(pos_i_image + lower, pos_i_image + upper);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                {
+                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // i never collides with its own images, they move along with it
+                        if (j == i || j == exclude)
+                            continue;
+
+                        Scalar4 postype_j = h_postype[j];
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        if (!h_overlaps[this->m_overlap_idx(typ_i, typ_j)])
+                            continue;
+
+                        // put particles in coordinate system of particle i
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                        Shape shape_j(quat<Scalar>(h_orientation[j]), this->m_params[typ_j]);
+
+                        counters.overlap_checks++;
+                        OverlapReal d = sweep_distance(r_ij, shape_i, shape_j, direction, dist, counters.overlap_err_count);
+                        if (d < dist)
+                            {
+                            dist = d;
+                            hit = j;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            }  // end loop over AABB nodes
+        } // end loop over images
+
+    return hit;
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+template< class Shape >
+void IntegratorHPMCMonoEventChain< Shape >::update(unsigned int timestep)
+    {
+    this->m_exec_conf->msg->notice(10) << "HPMCMonoEventChain update: " << timestep << std::endl;
+
+    if (this->m_patch && !this->m_patch_log)
+        {
+        this->m_exec_conf->msg->error() << "Event chain moves do not support patch energies" << std::endl;
+        throw std::runtime_error("Error during event chain update");
+        }
+
+    if (this->m_external)
+        {
+        this->m_exec_conf->msg->error() << "Event chain moves do not support external fields" << std::endl;
+        throw std::runtime_error("Error during event chain update");
+        }
+
+    if (this->m_hasOrientation)
+        {
+        // rotate particles with Metropolis moves, this also takes care of the counters
+        unsigned int move_ratio = this->m_move_ratio;
+        this->m_move_ratio = 0;
+        IntegratorHPMCMono<Shape>::update(timestep);
+        this->m_move_ratio = move_ratio;
+        }
+    else
+        {
+        IntegratorHPMC::update(timestep);
+        }
+
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+
+    // collisions are searched at most one nominal width ahead, so that all partners are within the image list
+    Scalar max_segment = this->m_nominal_width;
+    if (this->m_extra_image_width < max_segment)
+        {
+        this->m_extra_image_width = max_segment;
+        this->m_image_list_valid = false;
+        }
+
+    if (max_segment <= Scalar(0.0) || m_chain_length == Scalar(0.0))
+        return;
+
+    this->m_update_order.resize(this->m_pdata->getN());
+    this->m_update_order.shuffle(timestep, 1);
+
+    this->buildAABBTree();
+    this->updateImageList();
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC event chain");
+
+    // tag, previous tag, and axis of every interrupted chain
+    std::vector<unsigned int> pending_chains;
+    // remaining length of every interrupted chain
+    std::vector<Scalar> pending_remaining;
+
+        {
+        ArrayHandle<hpmc_counters_t> h_counters(this->m_count_total, access_location::host, access_mode::readwrite);
+        hpmc_counters_t& counters = h_counters.data[0];
+
+        ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(this->m_pdata->getTags(), access_location::host, access_mode::read);
+
+        const unsigned int N = this->m_pdata->getN();
+
+        for (unsigned int i_nselect = 0; i_nselect < this->m_nselect; i_nselect++)
+            {
+            for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+                {
+                unsigned int i = this->m_update_order[cur_particle];
+
+                hoomd::RandomGenerator rng_i(hoomd::RNGIdentifier::HPMCMonoEventChain,
+                                             this->m_seed,
+                                             i,
+                                             this->m_exec_conf->getRank()*this->m_nselect + i_nselect,
+                                             timestep);
+
+                // chains move along a random positive axis
+                unsigned int axis = hoomd::UniformIntDistribution(ndim-1)(rng_i);
+                vec3<Scalar> direction(0,0,0);
+                if (axis == 0)
+                    direction.x = Scalar(1.0);
+                else if (axis == 1)
+                    direction.y = Scalar(1.0);
+                else
+                    direction.z = Scalar(1.0);
+
+                unsigned int prev = UINT_MAX;
+                Scalar remaining = runChain(i,
+                                            prev,
+                                            direction,
+                                            m_chain_length,
+                                            counters,
+                                            h_postype.data,
+                                            h_orientation.data,
+                                            h_image.data,
+                                            h_overlaps.data);
+
+                if (remaining > Scalar(0.0))
+                    {
+                    pending_chains.push_back(h_tag.data[i]);
+                    pending_chains.push_back(prev == UINT_MAX ? UINT_MAX : h_tag.data[prev]);
+                    pending_chains.push_back(axis);
+                    pending_remaining.push_back(remaining);
+                    }
+                } // end loop over all particles
+            } // end loop over nselect
+        }
+
+    #ifdef ENABLE_MPI
+    if (this->m_comm)
+        {
+        for (unsigned int round = 1; ; round++)
+            {
+            // collect the interrupted chains of all ranks
+            std::vector< std::vector<unsigned int> > all_chains;
+            std::vector< std::vector<Scalar> > all_remaining;
+            all_gather_v(pending_chains, all_chains, this->m_exec_conf->getMPICommunicator());
+            all_gather_v(pending_remaining, all_remaining, this->m_exec_conf->getMPICommunicator());
+            pending_chains.clear();
+            pending_remaining.clear();
+
+            unsigned int n_pending = 0;
+            for (unsigned int rank = 0; rank < all_remaining.size(); rank++)
+                n_pending += all_remaining[rank].size();
+
+            if (n_pending == 0)
+                break;
+
+            if (round > EVENT_CHAIN_MAX_ROUNDS)
+                {
+                this->m_exec_conf->msg->error() << "Event chains did not complete after " << EVENT_CHAIN_MAX_ROUNDS
+                                                << " grid shifts" << std::endl;
+                throw std::runtime_error("Error during event chain update");
+                }
+
+            // move the domain boundaries so that the interrupted chains can continue
+            shiftGrid(timestep, round);
+            this->buildAABBTree();
+            this->updateImageList();
+
+            ArrayHandle<hpmc_counters_t> h_counters(this->m_count_total, access_location::host, access_mode::readwrite);
+            hpmc_counters_t& counters = h_counters.data[0];
+
+            ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+            ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_tag(this->m_pdata->getTags(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(this->m_pdata->getRTags(), access_location::host, access_mode::read);
+
+            const unsigned int N = this->m_pdata->getN();
+            const unsigned int N_all = N + this->m_pdata->getNGhosts();
+
+            // continue the chains whose particles are owned by this rank, in the same order on all ranks
+            for (unsigned int rank = 0; rank < all_remaining.size(); rank++)
+                {
+                for (unsigned int cur_chain = 0; cur_chain < all_remaining[rank].size(); cur_chain++)
+                    {
+                    unsigned int i = h_rtag.data[all_chains[rank][3*cur_chain]];
+                    if (i >= N)
+                        continue;
+
+                    unsigned int prev_tag = all_chains[rank][3*cur_chain+1];
+                    unsigned int prev = UINT_MAX;
+                    if (prev_tag != UINT_MAX && h_rtag.data[prev_tag] < N_all)
+                        prev = h_rtag.data[prev_tag];
+
+                    unsigned int axis = all_chains[rank][3*cur_chain+2];
+                    vec3<Scalar> direction(0,0,0);
+                    if (axis == 0)
+                        direction.x = Scalar(1.0);
+                    else if (axis == 1)
+                        direction.y = Scalar(1.0);
+                    else
+                        direction.z = Scalar(1.0);
+
+                    Scalar remaining = runChain(i,
+                                                prev,
+                                                direction,
+                                                all_remaining[rank][cur_chain],
+                                                counters,
+                                                h_postype.data,
+                                                h_orientation.data,
+                                                h_image.data,
+                                                h_overlaps.data);
+
+                    if (remaining > Scalar(0.0))
+                        {
+                        pending_chains.push_back(h_tag.data[i]);
+                        pending_chains.push_back(prev == UINT_MAX ? UINT_MAX : h_tag.data[prev]);
+                        pending_chains.push_back(axis);
+                        pending_remaining.push_back(remaining);
+                        }
+                    }
+                }
+            }
+        }
+    #endif
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    // migrate and exchange particles
+    this->communicate(true);
+
+    // all particle have been moved, the aabb tree is now invalid
+    this->m_aabb_tree_invalid = true;
+    }
+
+/*! \param i Index of the particle that starts the chain. On output, the particle that the chain continues with.
+    \param prev Index of the particle that lifted to \a i, UINT_MAX for none. On output, the particle that lifted to
+                the output \a i.
+    \param direction Unit vector along which the chain moves
+    \param remaining Length that the chain still has to move
+    \param counters Counters to record moves, overlap checks and errors in
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_image Particle images
+    \param h_overlaps Interaction matrix
+
+    \returns The length that the chain still has to move when it is interrupted at the active region, 0 when complete
+
+    Every segment moves the current particle to its first collision, or by at most the nominal width, and updates the
+    AABB tree. With domain decomposition, the chain is interrupted when its particle is outside of the active region or
+    reaches its boundary.
+*/
+template< class Shape >
+Scalar IntegratorHPMCMonoEventChain< Shape >::runChain(unsigned int& i,
+                                                       unsigned int& prev,
+                                                       const vec3<Scalar>& direction,
+                                                       Scalar remaining,
+                                                       hpmc_counters_t& counters,
+                                                       Scalar4 *h_postype,
+                                                       const Scalar4 *h_orientation,
+                                                       int3 *h_image,
+                                                       const unsigned int *h_overlaps)
+    {
+    const BoxDim& box = this->m_pdata->getBox();
+    Scalar max_segment = this->m_nominal_width;
+
+    #ifdef ENABLE_MPI
+    const unsigned int N = this->m_pdata->getN();
+    Scalar3 ghost_fraction = this->m_nominal_width / box.getNearestPlaneDistance();
+    #endif
+
+    unsigned int n_zero_lifts = 0;
+
+    while (remaining > Scalar(0.0))
+        {
+        Scalar4 postype_i = h_postype[i];
+        vec3<Scalar> pos_i(postype_i);
+        unsigned int typ_i = __scalar_as_int(postype_i.w);
+        Shape shape_i(quat<Scalar>(h_orientation[i]), this->m_params[typ_i]);
+
+        Scalar max_dist = std::min(remaining, max_segment);
+        bool at_boundary = false;
+
+        #ifdef ENABLE_MPI
+        if (this->m_comm)
+            {
+            // only particles in the active region move, the rank that owns i continues the chain after a grid shift
+            if (i >= N || !isActive(vec_to_scalar3(pos_i), box, ghost_fraction))
+                return remaining;
+
+            Scalar dist_active = getActiveDistance(pos_i, direction, box, ghost_fraction);
+            if (dist_active < max_dist)
+                {
+                max_dist = dist_active;
+                at_boundary = true;
+                }
+            }
+        #endif
+
+        OverlapReal dist = max_dist;
+        unsigned int hit = findCollision(i,
+                                         pos_i,
+                                         shape_i,
+                                         typ_i,
+                                         direction,
+                                         prev,
+                                         dist,
+                                         counters,
+                                         h_postype,
+                                         h_orientation,
+                                         h_overlaps);
+
+        vec3<Scalar> pos_new = pos_i + Scalar(dist)*direction;
+
+        // move the particle and update its position in the tree for future collision searches
+        h_postype[i] = make_scalar4(pos_new.x, pos_new.y, pos_new.z, postype_i.w);
+        box.wrap(h_postype[i], h_image[i]);
+        this->m_aabb_tree.update(i, shape_i.getAABB(vec3<Scalar>(h_postype[i])));
+
+        if (!shape_i.ignoreStatistics())
+            counters.translate_accept_count++;
+
+        remaining -= dist;
+
+        if (hit == UINT_MAX)
+            {
+            // i stopped at the boundary of the active region
+            if (at_boundary)
+                return std::max(remaining, Scalar(0.0));
+            }
+        else
+            {
+            // a chain that keeps lifting without moving is jammed and would never complete
+            if (dist > OverlapReal(0.0))
+                n_zero_lifts = 0;
+            else if (++n_zero_lifts > EVENT_CHAIN_MAX_ZERO_LIFTS)
+                {
+                this->m_exec_conf->msg->error() << "Event chain jammed after " << EVENT_CHAIN_MAX_ZERO_LIFTS
+                                                << " lifts without displacement, check for overlaps" << std::endl;
+                throw std::runtime_error("Error during event chain update");
+                }
+
+            // lift to the particle that was hit
+            prev = i;
+            i = hit;
+            }
+        }
+
+    return Scalar(0.0);
+    }
+
+#ifdef ENABLE_MPI
+/*! \param pos Position of the particle
+    \param direction Direction of the move
+    \param box Local box
+    \param ghost_fraction Width of the inactive region as a fraction of the local box
+
+    \returns The distance along \a direction at which the particle reaches the boundary of the active region
+*/
+template< class Shape >
+Scalar IntegratorHPMCMonoEventChain< Shape >::getActiveDistance(const vec3<Scalar>& pos,
+                                                                const vec3<Scalar>& direction,
+                                                                const BoxDim& box,
+                                                                const Scalar3& ghost_fraction)
+    {
+    // fractional coordinates change linearly along the direction
+    Scalar3 f = box.makeFraction(vec_to_scalar3(pos));
+    Scalar3 f_dir = box.makeFraction(vec_to_scalar3(pos + direction));
+    Scalar3 df = make_scalar3(f_dir.x - f.x, f_dir.y - f.y, f_dir.z - f.z);
+
+    // same active region as isActive()
+    Scalar f_cur[3] = {f.x, f.y, f.z};
+    Scalar df_cur[3] = {df.x, df.y, df.z};
+    Scalar f_max[3] = {Scalar(1.0) - ghost_fraction.x, Scalar(1.0) - ghost_fraction.y, Scalar(1.0) - ghost_fraction.z};
+    uchar3 periodic = box.getPeriodic();
+    bool bounded[3] = {!periodic.x, !periodic.y, !periodic.z};
+
+    Scalar dist = std::numeric_limits<Scalar>::max();
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        if (!bounded[d])
+            continue;
+
+        if (df_cur[d] > Scalar(0.0))
+            dist = std::min(dist, (f_max[d] - f_cur[d])/df_cur[d]);
+        else if (df_cur[d] < Scalar(0.0))
+            dist = std::min(dist, -f_cur[d]/df_cur[d]);
+        }
+
+    return std::max(dist, Scalar(0.0));
+    }
+
+/*! \param timestep Current time step of the simulation
+    \param round Number of the grid shift in this step
+
+    The shift is at most twice the nominal width along the normal of every domain face. Chains move along positive
+    axes, so the shift moves particles towards the upper boundaries, and half of the shifts carry a particle at the
+    boundary of the active region into the next domain. Communicator::checkBoxSize() guarantees that the shift is smaller
+    than the domain, so that particles migrate by at most one domain.
+*/
+template< class Shape >
+void IntegratorHPMCMonoEventChain< Shape >::shiftGrid(unsigned int timestep, unsigned int round)
+    {
+    const BoxDim& box = this->m_pdata->getBox();
+    const BoxDim& global_box = this->m_pdata->getGlobalBox();
+
+        {
+        ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+        // precalculate the grid shift in fractions of the global box, which are the same on every rank
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::HPMCMonoEventChainShift, this->m_seed, timestep, round);
+        hoomd::UniformDistribution<Scalar> uniform(Scalar(0.0), Scalar(2.0)*this->m_nominal_width);
+        Scalar3 npd_global = global_box.getNearestPlaneDistance();
+        Scalar3 f_shift = make_scalar3(0,0,0);
+        f_shift.x = uniform(rng)/npd_global.x;
+        f_shift.y = uniform(rng)/npd_global.y;
+        if (this->m_sysdef->getNDimensions() == 3)
+            {
+            f_shift.z = uniform(rng)/npd_global.z;
+            }
+
+        Scalar3 origin = global_box.makeCoordinates(make_scalar3(0,0,0));
+        Scalar3 shifted = global_box.makeCoordinates(f_shift);
+        Scalar3 shift = make_scalar3(shifted.x - origin.x, shifted.y - origin.y, shifted.z - origin.z);
+
+        for (unsigned int i = 0; i < this->m_pdata->getN(); i++)
+            {
+            Scalar4 postype_i = h_postype.data[i];
+            vec3<Scalar> r_i = vec3<Scalar>(postype_i) + vec3<Scalar>(shift);
+            h_postype.data[i] = vec_to_scalar4(r_i, postype_i.w);
+            box.wrap(h_postype.data[i], h_image.data[i]);
+            }
+        this->m_pdata->translateOrigin(shift);
+        }
+
+    // migrate and exchange particles
+    this->communicate(true);
+    this->m_aabb_tree_invalid = true;
+    }
+#endif
+
+//! Export the IntegratorHPMCMonoEventChain class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of IntegratorHPMCMonoEventChain<Shape> will be exported
+*/
+template < class Shape > void export_IntegratorHPMCMonoEventChain(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_<IntegratorHPMCMonoEventChain<Shape>, std::shared_ptr< IntegratorHPMCMonoEventChain<Shape> > >(m, name.c_str(),  pybind11::base< IntegratorHPMCMono<Shape> >())
+        .def(pybind11::init< std::shared_ptr<SystemDefinition>, unsigned int >())
+        .def("setChainLength", &IntegratorHPMCMonoEventChain<Shape>::setChainLength)
+        .def("getChainLength", &IntegratorHPMCMonoEventChain<Shape>::getChainLength)
+        ;
+    }
+
+} // end namespace hpmc
+
+#endif // __HPMC_MONO_EVENT_CHAIN__H__
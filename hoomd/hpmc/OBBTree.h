@@ -8,6 +8,8 @@
 #include "hoomd/VectorMath.h"
 #include <vector>
 #include <stack>
+#include <algorithm>
+#include <limits>
 
 #include "HPMCPrecisionSetup.h"
 
@@ -40,8 +42,23 @@ namespace detail
 
 const unsigned int OBB_INVALID_NODE = 0xffffffff;   //!< Invalid node index sentinel
 
+//! Strategies to split the nodes when building an OBBTree
+enum OBBTreeBuild
+    {
+    OBB_BUILD_MEAN = 0, //!< Split at the mean of the centers along the axis of largest covariance
+    OBB_BUILD_SAH,      //!< Split where the surface area heuristic is minimal
+    OBB_BUILD_BEST      //!< Build with every strategy and keep the tree with the lowest expected cost
+    };
+
 #ifndef NVCC
 
+//! Surface area of an OBB, used to estimate the probability that a query visits a node
+inline OverlapReal obb_surface_area(const OBB& obb)
+    {
+    const vec3<OverlapReal>& l = obb.lengths;
+    return OverlapReal(8.0)*(l.x*l.y + l.y*l.z + l.z*l.x);
+    }
+
 //! Node in an OBBTree
 /*! Stores data for a node in the OBB tree
 */
@@ -72,6 +89,11 @@ struct OBBNode
                O(log N) time
     - buildTree : build an efficiently arranged tree given a complete set of OBBs, one for each particle.
 
+    Nodes are either split at the mean of the centers along the axis of largest covariance, or where the surface area
+    heuristic (SAH) is minimal over the three axes of the node OBB. The SAH assumes that a query visits a node with a
+    probability proportional to its surface area. OBB_BUILD_BEST builds the tree with both strategies and keeps the
+    one with the lower expected cost, see getExpectedCost().
+
     **Implementation details**
 
     OBBTree stores all nodes in a flat array manged by std::vector. The tree is in *post-order*.
@@ -88,7 +110,7 @@ class OBBTree
     public:
         //! Construct an OBBTree
         OBBTree()
-            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_leaf_capacity(0), m_root(0)
+            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_leaf_capacity(0), m_root(0), m_build(OBB_BUILD_MEAN)
             {
             }
 
@@ -101,10 +123,21 @@ class OBBTree
 
         //! Build a tree smartly from a list of OBBs and internal coordinates
         inline void buildTree(OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
-            OverlapReal vertex_radius, unsigned int N, unsigned int leaf_capacity);
+            OverlapReal vertex_radius, unsigned int N, unsigned int leaf_capacity,
+            OBBTreeBuild build = OBB_BUILD_MEAN);
 
         //! Build a tree from a list of OBBs
-        inline void buildTree(OBB *obbs, unsigned int N, unsigned int leaf_capacity, bool sphere_tree);
+        inline void buildTree(OBB *obbs, unsigned int N, unsigned int leaf_capacity, bool sphere_tree,
+            OBBTreeBuild build = OBB_BUILD_MEAN);
+
+        //! Get the expected number of node and leaf member tests of a query that overlaps the root node
+        inline OverlapReal getExpectedCost() const;
+
+        //! Get the strategy the tree was built with
+        OBBTreeBuild getBuildStrategy() const
+            {
+            return m_build;
+            }
 
         //! Update the OBB of a particle
         inline void update(unsigned int idx, const OBB& obb);
@@ -184,16 +217,30 @@ class OBBTree
         unsigned int m_node_capacity;       //!< Capacity of the nodes array
         unsigned int m_leaf_capacity;       //!< Number of particles in leaf nodes
         unsigned int m_root;                //!< Index to the root node of the tree
+        OBBTreeBuild m_build;               //!< Strategy used to split the nodes
 
         //! Initialize the tree to hold N particles
         inline void init(unsigned int N);
 
+        //! Build the tree from the internal coordinates of every OBB
+        inline void buildTree(OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
+            std::vector< std::vector<OverlapReal> >& vertex_radii, unsigned int N, bool sphere_tree,
+            OBBTreeBuild build);
+
         //! Build a node of the tree recursively
         inline unsigned int buildNode(OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
             std::vector< std::vector<OverlapReal> >& vertex_radii, std::vector<unsigned int>& idx,
             unsigned int start, unsigned int len, unsigned int parent,
             bool sphere_tree);
 
+        //! Find the split of a node with the lowest surface area heuristic
+        inline unsigned int splitSAH(OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
+            std::vector< std::vector<OverlapReal> >& vertex_radii, std::vector<unsigned int>& idx,
+            unsigned int start, unsigned int len, const OBB& node_obb);
+
+        //! Exchange the contents with another tree
+        inline void swap(OBBTree& other);
+
         //! Allocate a new node
         inline unsigned int allocateNode();
 
@@ -219,42 +266,37 @@ inline void OBBTree::init(unsigned int N)
     \param internal_coordinates List of lists of vertex contents of OBBs
     \param vertex_radius Radius of every vertex
     \param N Number of OBBs in the list
+    \param leaf_capacity Maximum number of OBBs per leaf node
+    \param build Strategy to split the nodes
 
     Builds a balanced tree from a given list of OBBs for each particle. Data in \a obbs will be modified during
     the construction process.
 */
 inline void OBBTree::buildTree(OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
-    OverlapReal vertex_radius, unsigned int N, unsigned int leaf_capacity)
+    OverlapReal vertex_radius, unsigned int N, unsigned int leaf_capacity, OBBTreeBuild build)
     {
     m_leaf_capacity = leaf_capacity;
-    init(N);
-
-    std::vector<unsigned int> idx;
-    for (unsigned int i = 0; i < N; i++)
-        idx.push_back(i);
 
     std::vector<std::vector<OverlapReal> > vertex_radii(N);
     for (unsigned int i = 0; i < N; ++i)
         vertex_radii[i] = std::vector<OverlapReal>(internal_coordinates[i].size(), vertex_radius);
 
-    m_root = buildNode(obbs, internal_coordinates, vertex_radii, idx, 0, N, OBB_INVALID_NODE, false);
-    updateEscapeIndex(m_root,getNumNodes());
+    buildTree(obbs, internal_coordinates, vertex_radii, N, false, build);
     }
 
 /*! \param obbs List of OBBs for each particle (must be 32-byte aligned)
     \param N Number of OBBs in the list
+    \param leaf_capacity Maximum number of OBBs per leaf node
+    \param sphere_tree True if the node volumes are spheres
+    \param build Strategy to split the nodes
 
     Builds a balanced tree from a given list of OBBs for each particle. Data in \a obbs will be modified during
     the construction process.
 */
-inline void OBBTree::buildTree(OBB *obbs, unsigned int N, unsigned int leaf_capacity, bool sphere_tree)
+inline void OBBTree::buildTree(OBB *obbs, unsigned int N, unsigned int leaf_capacity, bool sphere_tree,
+    OBBTreeBuild build)
     {
     m_leaf_capacity = leaf_capacity;
-    init(N);
-
-    std::vector<unsigned int> idx;
-    for (unsigned int i = 0; i < N; i++)
-        idx.push_back(i);
 
     // initialize internal coordinates from OBB corners
     std::vector< std::vector<vec3<OverlapReal> > > internal_coordinates;
@@ -275,10 +317,205 @@ inline void OBBTree::buildTree(OBB *obbs, unsigned int N, unsigned int leaf_capa
             }
         }
 
+    buildTree(obbs, internal_coordinates, vertex_radii, N, sphere_tree, build);
+    }
+
+/*! \param obbs List of OBBs for each particle
+    \param internal_coordinates List of lists of vertex contents of OBBs
+    \param vertex_radii Radii of the vertices
+    \param N Number of OBBs in the list
+    \param sphere_tree True if the node volumes are spheres
+    \param build Strategy to split the nodes
+
+    With OBB_BUILD_BEST, the tree is built with every strategy and the one with the lowest expected cost is kept.
+*/
+inline void OBBTree::buildTree(OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
+    std::vector< std::vector<OverlapReal> >& vertex_radii, unsigned int N, bool sphere_tree, OBBTreeBuild build)
+    {
+    if (build == OBB_BUILD_BEST)
+        {
+        // buildNode reorders its input, so keep a copy for the second tree
+        std::vector<OBB> obbs_sah(obbs, obbs+N);
+        std::vector<std::vector<vec3<OverlapReal> > > internal_coordinates_sah(internal_coordinates);
+        std::vector<std::vector<OverlapReal> > vertex_radii_sah(vertex_radii);
+
+        buildTree(obbs, internal_coordinates, vertex_radii, N, sphere_tree, OBB_BUILD_MEAN);
+
+        OBBTree tree_sah;
+        tree_sah.m_leaf_capacity = m_leaf_capacity;
+        tree_sah.buildTree(&obbs_sah[0], internal_coordinates_sah, vertex_radii_sah, N, sphere_tree, OBB_BUILD_SAH);
+
+        if (tree_sah.getExpectedCost() < getExpectedCost())
+            swap(tree_sah);
+        return;
+        }
+
+    m_build = build;
+    init(N);
+
+    std::vector<unsigned int> idx;
+    for (unsigned int i = 0; i < N; i++)
+        idx.push_back(i);
+
     m_root = buildNode(obbs, internal_coordinates, vertex_radii, idx, 0, N, OBB_INVALID_NODE, sphere_tree);
     updateEscapeIndex(m_root, getNumNodes());
     }
 
+/*! A query that overlaps the root node is assumed to overlap every other node with a probability given by the ratio
+    of their surface areas. Each visited node costs one OBB test, and each visited leaf additionally costs one test
+    per member.
+
+    \returns The expected number of tests
+*/
+inline OverlapReal OBBTree::getExpectedCost() const
+    {
+    if (m_num_nodes == 0)
+        return OverlapReal(0.0);
+
+    OverlapReal root_area = obb_surface_area(m_nodes[m_root].obb);
+    OverlapReal cost(0.0);
+    for (unsigned int i = 0; i < m_num_nodes; ++i)
+        {
+        OverlapReal p = root_area > OverlapReal(0.0) ? obb_surface_area(m_nodes[i].obb)/root_area : OverlapReal(1.0);
+        cost += p*OverlapReal(1 + m_nodes[i].particles.size());
+        }
+    return cost;
+    }
+
+/*! \param obbs List of OBBs
+    \param internal_coordinates List of lists of vertex contents of OBBs
+    \param vertex_radii Radii of the vertices
+    \param idx List of indices
+    \param start Start point in obbs and idx to examine
+    \param len Number of obbs to examine
+    \param node_obb OBB of the node to split
+
+    \returns The number of OBBs in the left child. The subrange is reordered so that the left child comes first.
+
+    The OBBs are sorted by their center along each axis of the node OBB. For every split position, the children are
+    bounded by boxes aligned with the node OBB, and the split with the lowest SAH cost
+    \f$ A_L N_L + A_R N_R \f$ is chosen.
+*/
+inline unsigned int OBBTree::splitSAH(OBB *obbs,
+                                      std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
+                                      std::vector<std::vector<OverlapReal> >& vertex_radii,
+                                      std::vector<unsigned int>& idx,
+                                      unsigned int start,
+                                      unsigned int len,
+                                      const OBB& node_obb)
+    {
+    rotmat3<OverlapReal> node_axes(conj(node_obb.rotation));
+    vec3<OverlapReal> axes[3] = {node_axes.row0, node_axes.row1, node_axes.row2};
+
+    // center and half extent of every OBB in the frame of the node
+    std::vector<vec3<OverlapReal> > c(len), h(len);
+    for (unsigned int i = 0; i < len; ++i)
+        {
+        const OBB& obb = obbs[start+i];
+        rotmat3<OverlapReal> r(conj(obb.rotation));
+        vec3<OverlapReal> d = obb.center - node_obb.center;
+        c[i] = vec3<OverlapReal>(dot(d, axes[0]), dot(d, axes[1]), dot(d, axes[2]));
+        if (obb.isSphere())
+            {
+            h[i] = obb.lengths;
+            }
+        else
+            {
+            h[i].x = fabs(dot(axes[0], r.row0))*obb.lengths.x + fabs(dot(axes[0], r.row1))*obb.lengths.y
+                + fabs(dot(axes[0], r.row2))*obb.lengths.z;
+            h[i].y = fabs(dot(axes[1], r.row0))*obb.lengths.x + fabs(dot(axes[1], r.row1))*obb.lengths.y
+                + fabs(dot(axes[1], r.row2))*obb.lengths.z;
+            h[i].z = fabs(dot(axes[2], r.row0))*obb.lengths.x + fabs(dot(axes[2], r.row1))*obb.lengths.y
+                + fabs(dot(axes[2], r.row2))*obb.lengths.z;
+            }
+        }
+
+    // surface area of a box given by its lower and upper corners
+    auto area = [](const vec3<OverlapReal>& lo, const vec3<OverlapReal>& hi) -> OverlapReal
+        {
+        vec3<OverlapReal> l = hi - lo;
+        return OverlapReal(2.0)*(l.x*l.y + l.y*l.z + l.z*l.x);
+        };
+
+    OverlapReal best_cost = std::numeric_limits<OverlapReal>::max();
+    unsigned int best_axis = 0;
+    unsigned int best_split = len/2;
+    std::vector<unsigned int> best_order;
+
+    std::vector<unsigned int> order(len);
+    std::vector<OverlapReal> right_area(len);
+    for (unsigned int k = 0; k < 3; ++k)
+        {
+        for (unsigned int i = 0; i < len; ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b)
+            {
+            OverlapReal ca = (k == 0) ? c[a].x : ((k == 1) ? c[a].y : c[a].z);
+            OverlapReal cb = (k == 0) ? c[b].x : ((k == 1) ? c[b].y : c[b].z);
+            return ca < cb;
+            });
+
+        // sweep from the right to get the areas of all right children
+        vec3<OverlapReal> lo = c[order[len-1]] - h[order[len-1]];
+        vec3<OverlapReal> hi = c[order[len-1]] + h[order[len-1]];
+        for (unsigned int i = len-1; i > 0; --i)
+            {
+            unsigned int j = order[i];
+            lo = vec3<OverlapReal>(std::min(lo.x, c[j].x-h[j].x), std::min(lo.y, c[j].y-h[j].y),
+                std::min(lo.z, c[j].z-h[j].z));
+            hi = vec3<OverlapReal>(std::max(hi.x, c[j].x+h[j].x), std::max(hi.y, c[j].y+h[j].y),
+                std::max(hi.z, c[j].z+h[j].z));
+            right_area[i] = area(lo, hi);
+            }
+
+        // sweep from the left and evaluate every split
+        lo = c[order[0]] - h[order[0]];
+        hi = c[order[0]] + h[order[0]];
+        for (unsigned int i = 1; i < len; ++i)
+            {
+            unsigned int j = order[i-1];
+            lo = vec3<OverlapReal>(std::min(lo.x, c[j].x-h[j].x), std::min(lo.y, c[j].y-h[j].y),
+                std::min(lo.z, c[j].z-h[j].z));
+            hi = vec3<OverlapReal>(std::max(hi.x, c[j].x+h[j].x), std::max(hi.y, c[j].y+h[j].y),
+                std::max(hi.z, c[j].z+h[j].z));
+
+            OverlapReal cost = area(lo, hi)*OverlapReal(i) + right_area[i]*OverlapReal(len-i);
+            if (cost < best_cost)
+                {
+                best_cost = cost;
+                best_axis = k;
+                best_split = i;
+                }
+            }
+
+        if (best_axis == k)
+            best_order = order;
+        }
+
+    // reorder the subrange so that the left child comes first
+    std::vector<OBB> obbs_sorted(len);
+    std::vector<unsigned int> idx_sorted(len);
+    std::vector<std::vector<vec3<OverlapReal> > > internal_coordinates_sorted(len);
+    std::vector<std::vector<OverlapReal> > vertex_radii_sorted(len);
+    for (unsigned int i = 0; i < len; ++i)
+        {
+        unsigned int j = start + best_order[i];
+        obbs_sorted[i] = obbs[j];
+        idx_sorted[i] = idx[j];
+        internal_coordinates_sorted[i].swap(internal_coordinates[j]);
+        vertex_radii_sorted[i].swap(vertex_radii[j]);
+        }
+    for (unsigned int i = 0; i < len; ++i)
+        {
+        obbs[start+i] = obbs_sorted[i];
+        idx[start+i] = idx_sorted[i];
+        internal_coordinates[start+i].swap(internal_coordinates_sorted[i]);
+        vertex_radii[start+i].swap(vertex_radii_sorted[i]);
+        }
+
+    return best_split;
+    }
+
 
 //! Define a weak ordering on OBB centroid projections
 inline bool compare_proj(const std::pair<OverlapReal,unsigned int> &lhs, const std::pair<OverlapReal,unsigned int> &rhs)
@@ -364,6 +601,10 @@ inline unsigned int OBBTree::buildNode(OBB *obbs,
         {
         // nothing to do, already partitioned
         }
+    else if (m_build == OBB_BUILD_SAH)
+        {
+        start_right = splitSAH(obbs, internal_coordinates, vertex_radii, idx, start, len, my_obb);
+        }
     else
         {
         // the x-axis has largest covariance by construction, so split along that axis
@@ -438,6 +679,18 @@ inline void OBBTree::updateEscapeIndex(unsigned int idx, unsigned int escape)
     updateEscapeIndex(left_idx, right_idx);
     }
 
+/*! \param other Tree to exchange the contents with
+*/
+inline void OBBTree::swap(OBBTree& other)
+    {
+    std::swap(m_nodes, other.m_nodes);
+    std::swap(m_num_nodes, other.m_num_nodes);
+    std::swap(m_node_capacity, other.m_node_capacity);
+    std::swap(m_leaf_capacity, other.m_leaf_capacity);
+    std::swap(m_root, other.m_root);
+    std::swap(m_build, other.m_build);
+    }
+
 /*! Allocates a new node in the tree
 */
 inline unsigned int OBBTree::allocateNode()
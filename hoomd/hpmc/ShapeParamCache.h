@@ -0,0 +1,472 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __SHAPE_PARAM_CACHE_H__
+#define __SHAPE_PARAM_CACHE_H__
+
+/*! \file ShapeParamCache.h
+    \brief Serialization and on-disk cache of shape parameters with precomputed acceleration structures
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "ShapePolyhedron.h"
+#include "ShapeSpheropolyhedron.h"
+#include "ShapeFacetedEllipsoid.h"
+#include "ShapeUnion.h"
+#include "GPUTree.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <stdint.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*! Building the parameters of polyhedra and shape unions computes convex hulls and OBB trees, which takes a long time
+    for shapes with thousands of vertices or members. The cache stores the fully built parameter structure in a
+    binary file <cache_dir>/<key>.hpmc, where the key is a hash of the shape definition computed by the caller.
+
+    Files are written in native byte order and begin with the magic string, the format version, sizeof(OverlapReal)
+    and sizeof(param_type). A file that does not match the current build is ignored and replaced. Files are memory
+    mapped for reading and are written to a temporary file that is renamed in place, so that concurrent jobs can
+    share a cache directory.
+*/
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Magic string at the beginning of every cached shape parameter file
+const char shape_param_cache_magic[8] = {'H','P','M','C','S','H','P','C'};
+
+//! Current version of the cache format
+const uint32_t shape_param_cache_version = 1;
+
+//! Write a plain value
+/*! T must be trivially copyable. Shape parameters with dynamically allocated members have their own overloads.
+*/
+template<class T>
+inline void param_write(std::ostream& out, const T& v)
+    {
+    out.write((const char *)&v, sizeof(T));
+    }
+
+//! Read a plain value
+template<class T>
+inline void param_read(std::istream& in, T& v, bool managed)
+    {
+    in.read((char *)&v, sizeof(T));
+    if (!in)
+        throw std::runtime_error("Unexpected end of shape parameter data");
+    }
+
+//! Write a ManagedArray, preceded by its length
+template<class T>
+inline void param_write(std::ostream& out, const ManagedArray<T>& a)
+    {
+    uint32_t n = a.size();
+    param_write(out, n);
+    for (unsigned int i = 0; i < n; ++i)
+        param_write(out, a[i]);
+    }
+
+//! Read a ManagedArray
+template<class T>
+inline void param_read(std::istream& in, ManagedArray<T>& a, bool managed)
+    {
+    uint32_t n = 0;
+    param_read(in, n, managed);
+    a = ManagedArray<T>(n, managed);
+    for (unsigned int i = 0; i < n; ++i)
+        param_read(in, a[i], managed);
+    }
+
+//! Write an OBB tree
+inline void param_write(std::ostream& out, const GPUTree& tree)
+    {
+    param_write(out, tree.m_center);
+    param_write(out, tree.m_lengths);
+    param_write(out, tree.m_rotation);
+    param_write(out, tree.m_mask);
+    param_write(out, tree.m_is_sphere);
+    param_write(out, tree.m_leaf_ptr);
+    param_write(out, tree.m_leaf_obb_ptr);
+    param_write(out, tree.m_particles);
+    param_write(out, tree.m_left);
+    param_write(out, tree.m_escape);
+    param_write(out, tree.m_ancestors);
+    param_write(out, tree.m_num_nodes);
+    param_write(out, tree.m_num_leaves);
+    param_write(out, tree.m_leaf_capacity);
+    }
+
+//! Read an OBB tree
+inline void param_read(std::istream& in, GPUTree& tree, bool managed)
+    {
+    param_read(in, tree.m_center, managed);
+    param_read(in, tree.m_lengths, managed);
+    param_read(in, tree.m_rotation, managed);
+    param_read(in, tree.m_mask, managed);
+    param_read(in, tree.m_is_sphere, managed);
+    param_read(in, tree.m_leaf_ptr, managed);
+    param_read(in, tree.m_leaf_obb_ptr, managed);
+    param_read(in, tree.m_particles, managed);
+    param_read(in, tree.m_left, managed);
+    param_read(in, tree.m_escape, managed);
+    param_read(in, tree.m_ancestors, managed);
+    param_read(in, tree.m_num_nodes, managed);
+    param_read(in, tree.m_num_leaves, managed);
+    param_read(in, tree.m_leaf_capacity, managed);
+    }
+
+//! Write the vertices of a convex polyhedron
+inline void param_write(std::ostream& out, const poly3d_verts& verts)
+    {
+    param_write(out, verts.x);
+    param_write(out, verts.y);
+    param_write(out, verts.z);
+    param_write(out, verts.N);
+    param_write(out, verts.diameter);
+    param_write(out, verts.sweep_radius);
+    param_write(out, verts.ignore);
+    }
+
+//! Read the vertices of a convex polyhedron
+inline void param_read(std::istream& in, poly3d_verts& verts, bool managed)
+    {
+    param_read(in, verts.x, managed);
+    param_read(in, verts.y, managed);
+    param_read(in, verts.z, managed);
+    param_read(in, verts.N, managed);
+    param_read(in, verts.diameter, managed);
+    param_read(in, verts.sweep_radius, managed);
+    param_read(in, verts.ignore, managed);
+    }
+
+//! Write the parameters of a faceted ellipsoid
+inline void param_write(std::ostream& out, const faceted_ellipsoid_params& params)
+    {
+    param_write(out, params.verts);
+    param_write(out, params.additional_verts);
+    param_write(out, params.n);
+    param_write(out, params.offset);
+    param_write(out, params.a);
+    param_write(out, params.b);
+    param_write(out, params.c);
+    param_write(out, params.origin);
+    param_write(out, params.N);
+    param_write(out, params.ignore);
+    }
+
+//! Read the parameters of a faceted ellipsoid
+inline void param_read(std::istream& in, faceted_ellipsoid_params& params, bool managed)
+    {
+    param_read(in, params.verts, managed);
+    param_read(in, params.additional_verts, managed);
+    param_read(in, params.n, managed);
+    param_read(in, params.offset, managed);
+    param_read(in, params.a, managed);
+    param_read(in, params.b, managed);
+    param_read(in, params.c, managed);
+    param_read(in, params.origin, managed);
+    param_read(in, params.N, managed);
+    param_read(in, params.ignore, managed);
+    }
+
+//! Write the parameters of a general polyhedron
+inline void param_write(std::ostream& out, const poly3d_data& data)
+    {
+    param_write(out, data.tree);
+    param_write(out, data.convex_hull_verts);
+    param_write(out, data.verts);
+    param_write(out, data.face_offs);
+    param_write(out, data.face_verts);
+    param_write(out, data.face_overlap);
+    param_write(out, data.n_verts);
+    param_write(out, data.n_faces);
+    param_write(out, data.ignore);
+    param_write(out, data.origin);
+    param_write(out, data.hull_only);
+    param_write(out, data.sweep_radius);
+    }
+
+//! Read the parameters of a general polyhedron
+inline void param_read(std::istream& in, poly3d_data& data, bool managed)
+    {
+    param_read(in, data.tree, managed);
+    param_read(in, data.convex_hull_verts, managed);
+    param_read(in, data.verts, managed);
+    param_read(in, data.face_offs, managed);
+    param_read(in, data.face_verts, managed);
+    param_read(in, data.face_overlap, managed);
+    param_read(in, data.n_verts, managed);
+    param_read(in, data.n_faces, managed);
+    param_read(in, data.ignore, managed);
+    param_read(in, data.origin, managed);
+    param_read(in, data.hull_only, managed);
+    param_read(in, data.sweep_radius, managed);
+    }
+
+//! Write the parameters of a shape union
+template<class Shape>
+inline void param_write(std::ostream& out, const union_params<Shape>& params)
+    {
+    param_write(out, params.tree);
+    param_write(out, params.mpos);
+    param_write(out, params.morientation);
+    param_write(out, params.mparams);
+    param_write(out, params.moverlap);
+    param_write(out, params.diameter);
+    param_write(out, params.N);
+    param_write(out, params.ignore);
+    }
+
+//! Read the parameters of a shape union
+template<class Shape>
+inline void param_read(std::istream& in, union_params<Shape>& params, bool managed)
+    {
+    param_read(in, params.tree, managed);
+    param_read(in, params.mpos, managed);
+    param_read(in, params.morientation, managed);
+    param_read(in, params.mparams, managed);
+    param_read(in, params.moverlap, managed);
+    param_read(in, params.diameter, managed);
+    param_read(in, params.N, managed);
+    param_read(in, params.ignore, managed);
+    }
+
+//! Serialize shape parameters, including the file header
+template<class param_type>
+std::string serialize_shape_param(const param_type& param)
+    {
+    std::ostringstream out(std::ios::out | std::ios::binary);
+    out.write(shape_param_cache_magic, sizeof(shape_param_cache_magic));
+    param_write(out, shape_param_cache_version);
+    param_write(out, (uint32_t)sizeof(OverlapReal));
+    param_write(out, (uint32_t)sizeof(param_type));
+    param_write(out, param);
+    return out.str();
+    }
+
+//! Read-only stream buffer over a block of memory
+class memory_streambuf : public std::streambuf
+    {
+    public:
+        memory_streambuf(const char *data, size_t size)
+            {
+            char *p = const_cast<char *>(data);
+            setg(p, p, p + size);
+            }
+    };
+
+//! Deserialize shape parameters
+/*! \param data Serialized parameters, as returned by serialize_shape_param()
+    \param size Size of \a data in bytes
+    \param param Parameters to read into
+    \param managed True if the arrays are allocated in CUDA managed memory
+    \returns false if \a data was written by a different version or build
+*/
+template<class param_type>
+bool deserialize_shape_param(const char *data, size_t size, param_type& param, bool managed)
+    {
+    memory_streambuf buf(data, size);
+    std::istream in(&buf);
+
+    char magic[sizeof(shape_param_cache_magic)];
+    in.read(magic, sizeof(magic));
+    if (!in || memcmp(magic, shape_param_cache_magic, sizeof(magic)) != 0)
+        return false;
+
+    uint32_t version = 0, real_size = 0, param_size = 0;
+    param_read(in, version, managed);
+    param_read(in, real_size, managed);
+    param_read(in, param_size, managed);
+    if (version != shape_param_cache_version || real_size != sizeof(OverlapReal) || param_size != sizeof(param_type))
+        return false;
+
+    param_read(in, param, managed);
+    return true;
+    }
+
+//! Look up shape parameters in the on-disk cache
+/*! \param fname Name of the cache file
+    \param param Parameters to read into
+    \param managed True if the arrays are allocated in CUDA managed memory
+    \param blob If not NULL, set to the contents of the file
+    \returns true if the file exists and matches the current build
+*/
+template<class param_type>
+bool load_shape_param(const std::string& fname, param_type& param, bool managed, std::string *blob)
+    {
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+        close(fd);
+        return false;
+        }
+
+    size_t size = (size_t)st.st_size;
+    void *ptr = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+        return false;
+
+    bool success = false;
+    try
+        {
+        success = deserialize_shape_param((const char *)ptr, size, param, managed);
+        }
+    catch (std::runtime_error&)
+        {
+        // a truncated file is treated like a missing one
+        success = false;
+        }
+
+    if (success && blob)
+        blob->assign((const char *)ptr, size);
+
+    munmap(ptr, size);
+    return success;
+    }
+
+//! Store serialized shape parameters in the on-disk cache
+/*! \param fname Name of the cache file
+    \param blob Serialized parameters
+    \returns true on success
+
+    The data is written to a temporary file which is then renamed, so readers never see a partial file.
+*/
+inline bool store_shape_param(const std::string& fname, const std::string& blob)
+    {
+    std::ostringstream tmp_name;
+    tmp_name << fname << "." << getpid() << ".tmp";
+
+        {
+        std::ofstream out(tmp_name.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(blob.data(), blob.size());
+        out.close();
+        if (!out)
+            {
+            remove(tmp_name.str().c_str());
+            return false;
+            }
+        }
+
+    if (rename(tmp_name.str().c_str(), fname.c_str()) != 0)
+        {
+        remove(tmp_name.str().c_str());
+        return false;
+        }
+    return true;
+    }
+
+//! Build shape parameters once and share them between ranks and runs
+/*! \param cache_dir Directory of the on-disk cache, disabled when empty
+    \param key Hash of the shape definition, names the cache file
+    \param build Python callable that builds the parameters
+    \param exec_conf The execution configuration
+
+    The root rank loads the parameters from the cache, or calls \a build and stores the result. In MPI runs, the
+    serialized parameters are broadcast and the other ranks deserialize them without calling \a build. If \a build
+    fails on the root rank, every rank calls it to report the error.
+
+    \returns The shape parameters
+*/
+template<class param_type>
+param_type cache_shape_param(const std::string& cache_dir,
+                             const std::string& key,
+                             pybind11::object build,
+                             std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    bool managed = exec_conf->isCUDAEnabled();
+    std::string fname = cache_dir + "/" + key + ".hpmc";
+    bool use_cache = !cache_dir.empty() && !key.empty();
+
+    bool share = false;
+    #ifdef ENABLE_MPI
+    share = exec_conf->getNRanks() > 1;
+    #endif
+
+    param_type param;
+    std::string blob;
+    if (exec_conf->isRoot())
+        {
+        if (use_cache && load_shape_param(fname, param, managed, share ? &blob : NULL))
+            {
+            exec_conf->msg->notice(5) << "hpmc: loaded shape parameters from " << fname << std::endl;
+            }
+        else
+            {
+            bool success = true;
+            try
+                {
+                param = pybind11::cast<param_type>(build());
+                }
+            catch (...)
+                {
+                success = false;
+                if (!share)
+                    throw;
+                }
+
+            if (success && (use_cache || share))
+                blob = serialize_shape_param(param);
+
+            if (success && use_cache)
+                {
+                mkdir(cache_dir.c_str(), 0755);
+                if (store_shape_param(fname, blob))
+                    exec_conf->msg->notice(5) << "hpmc: stored shape parameters in " << fname << std::endl;
+                else
+                    exec_conf->msg->warning() << "hpmc: unable to write shape parameter cache " << fname << " ("
+                                              << strerror(errno) << ")" << std::endl;
+                }
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (share)
+        {
+        bcast(blob, 0, exec_conf->getMPICommunicator());
+
+        // the root rank failed to build, or the other ranks cannot read its data: build on every rank
+        if (blob.empty() || (!exec_conf->isRoot() &&
+            !deserialize_shape_param(blob.data(), blob.size(), param, managed)))
+            {
+            param = pybind11::cast<param_type>(build());
+            }
+        }
+    #endif
+
+    return param;
+    }
+
+} // end namespace detail
+
+} // end namespace hpmc
+
+#endif // __SHAPE_PARAM_CACHE_H__
@@ -160,6 +160,7 @@ inline ShapePolyhedron::param_type make_poly3d_data(pybind11::list verts,pybind1
                              unsigned int leaf_capacity,
                              pybind11::list origin,
                              unsigned int hull_only,
+                             unsigned int tree_build,
                              std::shared_ptr<ExecutionConfiguration> exec_conf)
     {
     ShapePolyhedron::param_type result;
@@ -263,7 +264,10 @@ inline ShapePolyhedron::param_type make_poly3d_data(pybind11::list verts,pybind1
         }
 
     OBBTree tree;
-    tree.buildTree(obbs, internal_coordinates, result.sweep_radius, len(face_offs)-1, leaf_capacity);
+    tree.buildTree(obbs, internal_coordinates, result.sweep_radius, len(face_offs)-1, leaf_capacity,
+        (OBBTreeBuild) tree_build);
+    exec_conf->msg->notice(4) << "hpmc: polyhedron OBB tree with " << tree.getNumNodes() << " nodes, expected cost "
+                              << tree.getExpectedCost() << std::endl;
     result.tree = GPUTree(tree, exec_conf->isCUDAEnabled());
     delete [] obbs;
 
@@ -389,6 +393,7 @@ typename ShapeUnion<Shape>::param_type make_union_params(pybind11::list _members
                                         pybind11::list overlap,
                                         bool ignore_stats,
                                         unsigned int leaf_capacity,
+                                        unsigned int tree_build,
                                         std::shared_ptr<ExecutionConfiguration> exec_conf)
     {
     typename ShapeUnion<Shape>::param_type result(len(_members), exec_conf->isCUDAEnabled());
@@ -445,7 +450,9 @@ typename ShapeUnion<Shape>::param_type make_union_params(pybind11::list _members
     // build tree and store GPU accessible version in parameter structure
     typedef typename ShapeUnion<Shape>::param_type::gpu_tree_type gpu_tree_type;
     OBBTree tree;
-    tree.buildTree(obbs, result.N, leaf_capacity, true);
+    tree.buildTree(obbs, result.N, leaf_capacity, true, (OBBTreeBuild) tree_build);
+    exec_conf->msg->notice(4) << "hpmc: union OBB tree with " << tree.getNumNodes() << " nodes, expected cost "
+                              << tree.getExpectedCost() << std::endl;
     delete [] obbs;
     result.tree = gpu_tree_type(tree,exec_conf->isCUDAEnabled());
 
@@ -258,6 +258,57 @@ DEVICE inline bool test_overlap<ShapeSphere, ShapeSphere>(const vec3<Scalar>& r_
         }
     }
 
+//! Define the general collision distance function
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param direction Unit vector along which *a* moves
+    \param max_dist Maximum distance of interest
+    \param err Incremented if there is an error condition. Left unchanged otherwise.
+    \returns The distance *a* can move along *direction* before it touches *b*, or *max_dist* if it does not touch
+              *b* within *max_dist*
+*/
+template <class ShapeA, class ShapeB>
+DEVICE inline OverlapReal sweep_distance(const vec3<Scalar>& r_ab, const ShapeA &a, const ShapeB& b,
+    const vec3<Scalar>& direction, OverlapReal max_dist, unsigned int& err)
+    {
+    // default implementation never lets a move, will make it obvious if something calls this
+    return OverlapReal(0.0);
+    }
+
+//! Sphere-Sphere collision distance
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param direction Unit vector along which *a* moves
+    \param max_dist Maximum distance of interest
+    \param err in/out variable incremented when error conditions occur
+    \returns The distance *a* can move along *direction* before it touches *b*, or *max_dist* if it does not touch
+              *b* within *max_dist*
+
+    \ingroup shape
+*/
+template <>
+DEVICE inline OverlapReal sweep_distance<ShapeSphere, ShapeSphere>(const vec3<Scalar>& r_ab, const ShapeSphere& a,
+    const ShapeSphere& b, const vec3<Scalar>& direction, OverlapReal max_dist, unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    vec3<OverlapReal> e(direction);
+
+    OverlapReal sigma = a.params.radius + b.params.radius;
+    OverlapReal d_parallel = dot(dr, e);
+    if (d_parallel <= OverlapReal(0.0))
+        return max_dist;
+
+    // solve |dr - t e|^2 = sigma^2 for the smaller root
+    OverlapReal disc = sigma*sigma - (dot(dr,dr) - d_parallel*d_parallel);
+    if (disc < OverlapReal(0.0))
+        return max_dist;
+
+    OverlapReal t = d_parallel - fast::sqrt(disc);
+    return detail::min(detail::max(t, OverlapReal(0.0)), max_dist);
+    }
+
 }; // end namespace hpmc
 
 #undef DEVICE
@@ -7,6 +7,7 @@
 #include "ShapeSphere.h"    //< For the base template of test_overlap
 #include "ShapeConvexPolyhedron.h"
 #include "XenoCollide3D.h"
+#include "SweepDistance3D.h"
 
 #ifndef __SHAPE_SPHEROPOLYHEDRON_H__
 #define __SHAPE_SPHEROPOLYHEDRON_H__
@@ -245,6 +246,38 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
     */
     }
 
+//! Spheropolyhedron collision distance
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param direction Unit vector along which *a* moves
+    \param max_dist Maximum distance of interest
+    \param err in/out variable incremented when error conditions occur
+    \returns The distance *a* can move along *direction* before it touches *b*, or *max_dist* if it does not touch
+              *b* within *max_dist*
+
+    \ingroup shape
+*/
+DEVICE inline OverlapReal sweep_distance(const vec3<Scalar>& r_ab,
+                                         const ShapeSpheropolyhedron& a,
+                                         const ShapeSpheropolyhedron& b,
+                                         const vec3<Scalar>& direction,
+                                         OverlapReal max_dist,
+                                         unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+
+    return detail::sweep_distance_3d(detail::SupportFuncSpheropolyhedron(a.verts),
+                                     detail::SupportFuncSpheropolyhedron(b.verts),
+                                     rotate(conj(quat<OverlapReal>(a.orientation)), dr),
+                                     conj(quat<OverlapReal>(a.orientation)) * quat<OverlapReal>(b.orientation),
+                                     rotate(conj(quat<OverlapReal>(a.orientation)), vec3<OverlapReal>(direction)),
+                                     max_dist,
+                                     DaDb/2.0,
+                                     err);
+    }
+
 }; // end namespace hpmc
 
 #undef DEVICE
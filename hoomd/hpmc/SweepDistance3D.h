@@ -0,0 +1,222 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+#include "HPMCPrecisionSetup.h"
+#include "hoomd/VectorMath.h"
+#include "MinkowskiMath.h"
+
+#ifndef __SWEEP_DISTANCE_3D_H__
+#define __SWEEP_DISTANCE_3D_H__
+
+/*! \file SweepDistance3D.h
+    \brief Implements the collision distance of two convex shapes along a direction in 3D
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+const unsigned int SWEEP_DISTANCE_3D_MAX_ITERATIONS = 1024;
+
+//! Find the point of a simplex closest to the origin
+/*! \param y Simplex vertices, relative to the point of interest
+    \param p Support points the vertices were generated from, reduced along with \a y
+    \param n Number of vertices (1 to 4). On return, the number of vertices of the face containing the closest point
+    \param v Closest point
+    \returns false when the origin is inside the tetrahedron given by four vertices
+
+    Every face of the simplex (vertex, edge, triangle) is projected onto, and the closest point with all barycentric
+    coordinates inside the face is chosen. The simplex is at most a tetrahedron, so testing all 14 faces is cheap and
+    robust against degenerate configurations.
+*/
+DEVICE inline bool closest_point_on_simplex(vec3<OverlapReal> *y,
+                                            vec3<OverlapReal> *p,
+                                            unsigned int& n,
+                                            vec3<OverlapReal>& v)
+    {
+    const OverlapReal tiny = OverlapReal(1e-12);
+
+    if (n == 4)
+        {
+        // check if the origin is inside the tetrahedron
+        vec3<OverlapReal> e1 = y[1] - y[0];
+        vec3<OverlapReal> e2 = y[2] - y[0];
+        vec3<OverlapReal> e3 = y[3] - y[0];
+        OverlapReal det = dot(e1, cross(e2, e3));
+        if (fabs(det) > tiny)
+            {
+            OverlapReal mu1 = -dot(y[0], cross(e2, e3)) / det;
+            OverlapReal mu2 = -dot(e1, cross(y[0], e3)) / det;
+            OverlapReal mu3 = -dot(e1, cross(e2, y[0])) / det;
+            if (mu1 >= 0 && mu2 >= 0 && mu3 >= 0 && mu1 + mu2 + mu3 <= 1)
+                return false;
+            }
+        }
+
+    OverlapReal best_dsq = -1;
+    unsigned int best_mask = 0;
+
+    for (unsigned int mask = 1; mask < (1u << n); mask++)
+        {
+        unsigned int idx[3];
+        unsigned int k = 0;
+        for (unsigned int i = 0; i < n && k <= 3; i++)
+            if (mask & (1u << i))
+                idx[k++] = i;
+        if (k > 3)
+            continue;
+
+        vec3<OverlapReal> c;
+        if (k == 1)
+            {
+            c = y[idx[0]];
+            }
+        else if (k == 2)
+            {
+            vec3<OverlapReal> d = y[idx[1]] - y[idx[0]];
+            OverlapReal dd = dot(d, d);
+            if (dd <= tiny)
+                continue;
+            OverlapReal mu = -dot(y[idx[0]], d) / dd;
+            if (mu <= 0 || mu >= 1)
+                continue;
+            c = y[idx[0]] + mu * d;
+            }
+        else
+            {
+            vec3<OverlapReal> e1 = y[idx[1]] - y[idx[0]];
+            vec3<OverlapReal> e2 = y[idx[2]] - y[idx[0]];
+            OverlapReal g11 = dot(e1, e1), g12 = dot(e1, e2), g22 = dot(e2, e2);
+            OverlapReal det = g11*g22 - g12*g12;
+            if (det <= tiny * g11 * g22)
+                continue;
+            OverlapReal b1 = -dot(e1, y[idx[0]]);
+            OverlapReal b2 = -dot(e2, y[idx[0]]);
+            OverlapReal mu1 = (g22*b1 - g12*b2) / det;
+            OverlapReal mu2 = (g11*b2 - g12*b1) / det;
+            if (mu1 <= 0 || mu2 <= 0 || mu1 + mu2 >= 1)
+                continue;
+            c = y[idx[0]] + mu1 * e1 + mu2 * e2;
+            }
+
+        OverlapReal dsq = dot(c, c);
+        if (best_dsq < 0 || dsq < best_dsq)
+            {
+            best_dsq = dsq;
+            best_mask = mask;
+            v = c;
+            }
+        }
+
+    // keep only the vertices of the closest face
+    unsigned int m = 0;
+    for (unsigned int i = 0; i < n; i++)
+        {
+        if (best_mask & (1u << i))
+            {
+            y[m] = y[i];
+            p[m] = p[i];
+            m++;
+            }
+        }
+    n = m;
+    return true;
+    }
+
+//! Collision distance of two convex shapes along a direction in 3D
+/*! \tparam SupportFuncA Support function class type for shape A
+    \tparam SupportFuncB Support function class type for shape B
+    \param sa Support function for shape A
+    \param sb Support function for shape B
+    \param ab_t Vector pointing from a's center to b's center, in frame A
+    \param q Orientation of shape B in frame A
+    \param dir Unit vector along which A moves, in frame A
+    \param max_dist Maximum distance of interest
+    \param R Approximate radius of Minkowski difference for scaling tolerance value
+    \param err_count Error counter to increment whenever the iteration limit is reached
+    \returns The distance A can move along \a dir before it touches B, or \a max_dist if A does not touch B within
+             \a max_dist
+
+    A moved by t * dir overlaps B when t * dir lies in the Minkowski difference B - A, so this is a ray cast against
+    B - A. It is implemented with the GJK based ray cast of G. van den Bergen (2004), using only the support functions
+    of the two shapes. The ray is only ever advanced up to separating planes of B - A, so the returned distance never
+    places A into an overlapping position. When the iteration limit is reached, the distance reached so far is
+    returned.
+
+    \ingroup minkowski
+*/
+template<class SupportFuncA, class SupportFuncB>
+DEVICE inline OverlapReal sweep_distance_3d(const SupportFuncA& sa,
+                                            const SupportFuncB& sb,
+                                            const vec3<OverlapReal>& ab_t,
+                                            const quat<OverlapReal>& q,
+                                            const vec3<OverlapReal>& dir,
+                                            OverlapReal max_dist,
+                                            OverlapReal R,
+                                            unsigned int& err_count)
+    {
+    CompositeSupportFunc3D<SupportFuncA, SupportFuncB> S(sa, sb, ab_t, q);
+    const OverlapReal tol = OverlapReal(1e-6) * R;
+
+    OverlapReal lambda = 0;
+    vec3<OverlapReal> x(0,0,0);
+
+    // simplex of support points and their offsets from x
+    vec3<OverlapReal> p[4];
+    vec3<OverlapReal> y[4];
+    unsigned int n = 0;
+
+    // start from any point in B - A
+    vec3<OverlapReal> v = x - S(-ab_t);
+
+    for (unsigned int iter = 0; iter < SWEEP_DISTANCE_3D_MAX_ITERATIONS; iter++)
+        {
+        if (dot(v, v) <= tol*tol)
+            return lambda;
+
+        vec3<OverlapReal> s = S(v);
+        vec3<OverlapReal> w = x - s;
+        OverlapReal vw = dot(v, w);
+        if (vw > 0)
+            {
+            // v is a separating axis, advance the ray to the separating plane
+            OverlapReal vr = dot(v, dir);
+            if (vr >= 0)
+                return max_dist;
+
+            lambda -= vw / vr;
+            if (lambda >= max_dist)
+                return max_dist;
+            x = lambda * dir;
+            }
+
+        p[n++] = s;
+        for (unsigned int i = 0; i < n; i++)
+            y[i] = x - p[i];
+
+        if (!closest_point_on_simplex(y, p, n, v))
+            return lambda;
+        }
+
+    err_count++;
+    return lambda;
+    }
+
+}; // end namespace detail
+
+}; // end namespace hpmc
+
+#undef DEVICE
+
+#endif // __SWEEP_DISTANCE_3D_H__
@@ -13,6 +13,8 @@
 
 #include <set>
 #include <list>
+#include <atomic>
+#include <memory>
 
 #include "Moves.h"
 #include "HPMCCounters.h"
@@ -20,7 +22,6 @@
 
 #ifdef ENABLE_TBB
 #include <tbb/tbb.h>
-#include <atomic>
 #endif
 
 namespace hpmc
@@ -29,216 +30,165 @@ namespace hpmc
 namespace detail
 {
 
-#ifdef ENABLE_TBB
-//! Wrapper around std::atomic_flag to allow use in a std::vector
-class my_atomic_flag
-    {
-    public:
-        //! Default constructor
-        my_atomic_flag()
-            {
-            f.clear();
-            }
-
-        //! Copy constructor
-        /*! \note this constructor doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag(const my_atomic_flag& other)
-            {
-            f.clear();
-            }
-
-        //! Assignment operator (non-atomic)
-        /*! \note this assignment operator doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag& operator =( const my_atomic_flag& other)
-            {
-            f.clear();
-            return *this;
-            }
-
-        //! Sets flag and returns old value
-        bool test_and_set()
-            {
-            return f.test_and_set();
-            }
+//! Connected components of an undirected graph, using a lock-free union-find
+/*! Edges are not stored. Every call to addEdge() merges the sets of its two vertices right away, so that arbitrary
+    flat edge lists can be processed in parallel without building an adjacency structure first.
 
-    private:
-        std::atomic_flag f;
-    };
-#endif
+    Sets are linked by index, the root with the larger index is always attached to the root with the smaller one.
+    Links can therefore never form cycles, and concurrent unions only need a compare-and-swap on the root being
+    attached. find() compresses paths by halving, which is safe to do concurrently because it only ever replaces a
+    parent by one of its ancestors.
 
-// Graph class represents a undirected graph
-// using adjacency list representation
+    The root of every set is its smallest vertex, so connectedComponents() returns the components in a deterministic
+    order (by smallest member) with members sorted by index, independent of the order in which edges were added.
+*/
 class Graph
     {
     public:
-        Graph() {}      //!< Default constructor
+        Graph() : m_n(0), m_capacity(0) {}      //!< Default constructor
 
         inline Graph(unsigned int V);   // Constructor
 
+        //! Reset the graph to V vertices and no edges
         inline void resize(unsigned int V);
 
+        //! Add an undirected edge (thread safe)
         inline void addEdge(unsigned int v, unsigned int w);
 
-        #ifdef ENABLE_TBB
-        inline void connectedComponents(std::vector<tbb::concurrent_vector<unsigned int> >& cc);
-        #else
-        inline void connectedComponents(std::vector<std::vector<unsigned int> >& cc);
-        #endif
+        //! Gather connected components
+        /*! \param members Vertices of all components, stored consecutively
+            \param offsets Start of every component in \a members, followed by the total number of vertices
+        */
+        inline void connectedComponents(std::vector<unsigned int>& members, std::vector<unsigned int>& offsets);
 
     private:
-        #ifndef ENABLE_TBB
-        std::multimap<unsigned int,unsigned int> adj;
-        #else
-        tbb::concurrent_unordered_multimap<unsigned int, unsigned int> adj;
-        #endif
-
-        #ifndef ENABLE_TBB
-        std::vector<unsigned int> visited;
-        #else
-        std::vector<my_atomic_flag> visited;
-        #endif
-
-        #ifndef ENABLE_TBB
-        // A function used by DFS
-        inline void DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc);
-        #endif
-
-        #ifdef ENABLE_TBB
-        class DFSTask : public tbb::task
-            {
-            public:
-                DFSTask(unsigned int _root, std::vector<my_atomic_flag>& _visited,
-                    tbb::concurrent_vector<unsigned int>& _cc,
-                    const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& _adj)
-                    : root(_root), visited(_visited), cc(_cc), adj(_adj)
-                    { }
-
-                tbb::task* execute()
-                    {
-                    cc.push_back(root);
-
-                    unsigned int count = 0;
-                    tbb::task_list list;
-
-                    auto begin = adj.equal_range(root).first;
-                    auto end = adj.equal_range(root).second;
-
-                    for (auto it = begin; it != end; ++it)
-                        {
-                        unsigned int neighbor = it->second;
-                        if (!visited[neighbor].test_and_set())
-                            {
-                            if (count++ == 0)
-                                {
-                                root = neighbor; // for task recycling
-                                continue;
-                                }
-                            list.push_back(*new(allocate_child()) DFSTask(neighbor, visited, cc, adj));
-                            }
-                        }
-
-                    if (count)
-                        {
-                        set_ref_count(count);
-                        spawn(list);
-
-                        recycle_as_safe_continuation();
-                        }
-
-                    return NULL;
-                    }
-
-            private:
-                unsigned int root;
-                std::vector<my_atomic_flag> & visited;
-                tbb::concurrent_vector<unsigned int>& cc;
-                const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& adj;
-            };
-        #endif // ENABLE_TBB
-
+        unsigned int m_n;                                       //!< Number of vertices
+        unsigned int m_capacity;                                //!< Allocated number of vertices
+        std::unique_ptr< std::atomic<unsigned int>[] > m_parent; //!< Parent of every vertex in the union-find forest
+        std::vector<unsigned int> m_root;                       //!< Root of every vertex (temporary)
+        std::vector<unsigned int> m_label;                      //!< Component index of every root (temporary)
+
+        //! Find the root of a vertex
+        inline unsigned int find(unsigned int v);
     };
 
-// Gather connected components in an undirected graph
-#ifdef ENABLE_TBB
-void Graph::connectedComponents(std::vector<tbb::concurrent_vector<unsigned int> >& cc)
-#else
-void Graph::connectedComponents(std::vector<std::vector<unsigned int> >& cc)
-#endif
+Graph::Graph(unsigned int V)
+    : m_n(0), m_capacity(0)
     {
-    #ifdef ENABLE_TBB
-    for (unsigned int v = 0; v < visited.size(); ++v)
+    resize(V);
+    }
+
+void Graph::resize(unsigned int V)
+    {
+    if (V > m_capacity)
         {
-        if (! visited[v].test_and_set())
-            {
-            tbb::concurrent_vector<unsigned int> component;
-            DFSTask& a = *new(tbb::task::allocate_root()) DFSTask(v, visited, component, adj);
-            tbb::task::spawn_root_and_wait(a);
-            cc.push_back(component);
-            }
+        m_parent.reset(new std::atomic<unsigned int>[V]);
+        m_capacity = V;
         }
-    #else
-    std::fill(visited.begin(), visited.end(), 0);
+    m_n = V;
 
-    // Depth first search
-    for (unsigned int v=0; v<visited.size(); v++)
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, V, [&](unsigned int v)
+    #else
+    for (unsigned int v = 0; v < V; ++v)
+    #endif
         {
-        if (visited[v] == false)
-            {
-            std::vector<unsigned int> cur_cc;
-            DFSUtil(v, visited, cur_cc);
-            cc.push_back(cur_cc);
-            }
+        m_parent[v].store(v, std::memory_order_relaxed);
         }
+    #ifdef ENABLE_TBB
+        );
     #endif
     }
 
-#ifndef ENABLE_TBB
-void Graph::DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc)
+unsigned int Graph::find(unsigned int v)
     {
-    visited[v] = 1;
-    cur_cc.push_back(v);
-
-    // Recur for all the vertices
-    // adjacent to this vertex
-    auto begin = adj.equal_range(v).first;
-    auto end = adj.equal_range(v).second;
-    for(auto i = begin; i != end; ++i)
+    unsigned int parent = m_parent[v].load(std::memory_order_relaxed);
+    while (parent != v)
         {
-        if(!visited[i->second])
-            DFSUtil(i->second, visited, cur_cc);
+        // path halving
+        unsigned int grandparent = m_parent[parent].load(std::memory_order_relaxed);
+        if (grandparent != parent)
+            m_parent[v].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        v = grandparent;
+        parent = m_parent[v].load(std::memory_order_relaxed);
         }
+    return v;
     }
-#endif
-Graph::Graph(unsigned int V)
+
+void Graph::addEdge(unsigned int v, unsigned int w)
     {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
-    #else
-    visited.resize(V);
-    #endif
+    assert(v < m_n && w < m_n);
+
+    while (true)
+        {
+        v = find(v);
+        w = find(w);
+        if (v == w)
+            return;
+
+        // attach the larger root to the smaller one
+        if (v < w)
+            std::swap(v, w);
+
+        // fails if v has been attached to another root in the meantime
+        unsigned int expected = v;
+        if (m_parent[v].compare_exchange_strong(expected, w))
+            return;
+        }
     }
 
-void Graph::resize(unsigned int V)
+void Graph::connectedComponents(std::vector<unsigned int>& members, std::vector<unsigned int>& offsets)
     {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
+    m_root.resize(m_n);
+    m_label.resize(m_n);
+
+    // flatten the forest
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, m_n, [&](unsigned int v)
     #else
-    visited.clear();
-    visited.resize(V);
+    for (unsigned int v = 0; v < m_n; ++v)
+    #endif
+        {
+        m_root[v] = find(v);
+        }
+    #ifdef ENABLE_TBB
+        );
     #endif
 
-    adj.clear();
-    }
+    // number the components in the order of their roots, and count their sizes
+    offsets.clear();
+    for (unsigned int v = 0; v < m_n; ++v)
+        {
+        if (m_root[v] == v)
+            {
+            m_label[v] = offsets.size();
+            offsets.push_back(0);
+            }
+        offsets[m_label[m_root[v]]]++;
+        }
 
-// method to add an undirected edge
-void Graph::addEdge(unsigned int v, unsigned int w)
-    {
-    adj.insert(std::make_pair(v,w));
-    adj.insert(std::make_pair(w,v));
+    // exclusive scan
+    unsigned int sum = 0;
+    for (unsigned int c = 0; c < offsets.size(); ++c)
+        {
+        unsigned int count = offsets[c];
+        offsets[c] = sum;
+        sum += count;
+        }
+    offsets.push_back(sum);
+
+    // scatter the vertices, in increasing order within every component
+    members.resize(m_n);
+    for (unsigned int v = 0; v < m_n; ++v)
+        {
+        unsigned int c = m_label[m_root[v]];
+        members[offsets[c]++] = v;
+        }
+
+    // restore the offsets
+    for (unsigned int c = offsets.size()-1; c > 0; --c)
+        offsets[c] = offsets[c-1];
+    offsets[0] = 0;
     }
 } // end namespace detail
 
@@ -425,11 +375,8 @@ class UpdaterClusters : public Updater
         Scalar m_swap_move_ratio;                   //!< Type swap / geometric move ratio
         Scalar m_flip_probability;                  //!< Cluster flip probability
 
-        #ifdef ENABLE_TBB
-        std::vector<tbb::concurrent_vector<unsigned int> > m_clusters; //!< Cluster components
-        #else
-        std::vector<std::vector<unsigned int> > m_clusters; //!< Cluster components
-        #endif
+        std::vector<unsigned int> m_cluster_members;   //!< Particles of all clusters, stored consecutively
+        std::vector<unsigned int> m_cluster_offsets;   //!< Start of every cluster in m_cluster_members
 
         detail::Graph m_G; //!< The graph
 
@@ -448,25 +395,25 @@ class UpdaterClusters : public Updater
         std::vector<std::pair<unsigned int, unsigned int> > m_interact_old_old;  //!< Pairs interacting old-old
         std::vector<std::pair<unsigned int, unsigned int> > m_interact_new_old;  //!< Pairs interacting new-old
 
-        std::set<std::pair<unsigned int, unsigned int> > m_interact_new_new;  //!< Pairs interacting new-old
-        std::set<unsigned int> m_local_reject;                   //!< Set of particles whose clusters moves are rejected
+        std::vector<std::pair<unsigned int, unsigned int> > m_interact_new_new;  //!< Pairs interacting new-new
+        std::vector<unsigned int> m_local_reject;                   //!< Particles whose clusters moves are rejected (may repeat)
 
         std::map<std::pair<unsigned int, unsigned int>,float > m_energy_old_old;    //!< Energy of interaction old-old
         std::map<std::pair<unsigned int, unsigned int>,float > m_energy_new_old;    //!< Energy of interaction old-old
-        std::set<unsigned int> m_ptl_reject;              //!< List of ptls that are not transformed
         #else
         tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > m_overlap;
         tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > m_interact_old_old;
         tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > m_interact_new_old;
 
-        tbb::concurrent_unordered_set<std::pair<unsigned int, unsigned int> > m_interact_new_new;
-        tbb::concurrent_unordered_set<unsigned int> m_local_reject;
+        tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > m_interact_new_new;
+        tbb::concurrent_vector<unsigned int> m_local_reject;
 
         tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>,float > m_energy_old_old;
         tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>,float > m_energy_new_old;
-        tbb::concurrent_unordered_set<unsigned int> m_ptl_reject;              //!< List of ptls that are not transformed
         #endif
 
+        std::vector<unsigned int> m_ptl_reject;        //!< Flags for particles that are not transformed (rank 0 only)
+
         #ifdef ENABLE_TBB
         tbb::concurrent_vector<vec3<Scalar> > m_random_position;
         tbb::concurrent_vector<quat<Scalar> > m_random_orientation;
@@ -487,10 +434,10 @@ class UpdaterClusters : public Updater
             \param pivot The current pivot point
             \param q The current line reflection axis
             \param line True if this is a line reflection
-            \param map Map to lookup new tag from old tag
+            \param map Lookup table from old tag to new tag
         */
         virtual void findInteractions(unsigned int timestep, vec3<Scalar> pivot, quat<Scalar> q, bool swap,
-            bool line, const std::map<unsigned int, unsigned int>& map);
+            bool line, const std::vector<unsigned int>& map);
 
         //! Helper function to get interaction range
         virtual Scalar getNominalWidth()
@@ -532,7 +479,7 @@ UpdaterClusters<Shape>::~UpdaterClusters()
 
 template< class Shape >
 void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar> pivot, quat<Scalar> q, bool swap,
-    bool line, const std::map<unsigned int, unsigned int>& map)
+    bool line, const std::vector<unsigned int>& map)
     {
     if (m_prof) m_prof->push(m_exec_conf,"Interactions");
 
@@ -638,19 +585,9 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                 if (rsq_ij <= rcut_ij*rcut_ij)
                                     {
                                     // the particle pair
-                                    unsigned int new_tag_i;
-                                        {
-                                        auto it = map.find(m_tag_backup[i]);
-                                        assert(it != map.end());
-                                        new_tag_i = it->second;
-                                        }
+                                    unsigned int new_tag_i = map[m_tag_backup[i]];
 
-                                    unsigned int new_tag_j;
-                                        {
-                                        auto it = map.find(m_tag_backup[j]);
-                                        assert(it!=map.end());
-                                        new_tag_j = it->second;
-                                        }
+                                    unsigned int new_tag_j = map[m_tag_backup[j]];
                                     auto p = std::make_pair(new_tag_i,new_tag_j);
 
                                     // if particle interacts in different image already, add to that energy
@@ -680,8 +617,8 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                     if (line && !swap && interacts_via_pbc)
                                         {
                                         // if interaction across PBC, reject cluster move
-                                        m_local_reject.insert(new_tag_i);
-                                        m_local_reject.insert(new_tag_j);
+                                        m_local_reject.push_back(new_tag_i);
+                                        m_local_reject.push_back(new_tag_j);
                                         }
                                     } // end if overlap
 
@@ -745,12 +682,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                             // read in its position and orientation
                             unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
 
-                            unsigned int new_tag_j;
-                                {
-                                auto it = map.find(m_tag_backup[j]);
-                                assert(it != map.end());
-                                new_tag_j = it->second;
-                                }
+                            unsigned int new_tag_j = map[m_tag_backup[j]];
 
                             if (h_tag.data[i] == new_tag_j && cur_image == 0) continue;
 
@@ -790,8 +722,8 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                     if (reject)
                                         {
                                         // if interaction across PBC, reject cluster move
-                                        m_local_reject.insert(h_tag.data[i]);
-                                        m_local_reject.insert(new_tag_j);
+                                        m_local_reject.push_back(h_tag.data[i]);
+                                        m_local_reject.push_back(new_tag_j);
                                         }
                                     } // end if overlap
                                 }
@@ -835,12 +767,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                 // read in its position and orientation
                                 unsigned int j = m_aabb_tree_old.getNodeParticle(cur_node_idx, cur_p);
 
-                                unsigned int new_tag_j;
-                                    {
-                                    auto it = map.find(m_tag_backup[j]);
-                                    assert(it != map.end());
-                                    new_tag_j = it->second;
-                                    }
+                                unsigned int new_tag_j = map[m_tag_backup[j]];
 
                                 if (h_tag.data[i] == new_tag_j && cur_image == 0) continue;
 
@@ -886,8 +813,8 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                     if (line && !swap && interacts_via_pbc)
                                         {
                                         // if interaction across PBC, reject cluster move
-                                        m_local_reject.insert(h_tag.data[i]);
-                                        m_local_reject.insert(new_tag_j);
+                                        m_local_reject.push_back(h_tag.data[i]);
+                                        m_local_reject.push_back(new_tag_j);
                                         }
                                     }
                                 } // end loop over AABB tree leaf
@@ -990,10 +917,10 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                     if (interacts_via_pbc)
                                         {
                                         // add to reject list
-                                        m_local_reject.insert(h_tag.data[i]);
-                                        m_local_reject.insert(h_tag.data[j]);
+                                        m_local_reject.push_back(h_tag.data[i]);
+                                        m_local_reject.push_back(h_tag.data[j]);
 
-                                        m_interact_new_new.insert(std::make_pair(h_tag.data[i],h_tag.data[j]));
+                                        m_interact_new_new.push_back(std::make_pair(h_tag.data[i],h_tag.data[j]));
                                         }
                                     } // end if overlap
 
@@ -1143,7 +1070,18 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
 
     // reset origin, so that snapshot positions match AABB tree positions
     m_pdata->resetOrigin();
-    auto map = m_pdata->takeSnapshot(snap);
+    std::vector<unsigned int> map;
+        {
+        auto snap_map = m_pdata->takeSnapshot(snap);
+
+        // flatten into a lookup table
+        if (snap_map.size())
+            {
+            map.resize(snap_map.rbegin()->first+1, UINT_MAX);
+            for (auto it = snap_map.begin(); it != snap_map.end(); ++it)
+                map[it->first] = it->second;
+            }
+        }
 
     #ifdef ENABLE_MPI
     if (m_comm)
@@ -1169,7 +1107,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
         }
 
     // reset list of rejected particles
-    m_ptl_reject.clear();
+    m_ptl_reject.assign(master ? snap.size : 0, 0);
 
     // keep a backup copy
     SnapshotParticleData<Scalar> snap_old = snap;
@@ -1201,7 +1139,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 // if the particle falls outside the active volume of global_box_nonperiodic, reject
                 if (!isActive(vec_to_scalar3(snap.pos[i]), global_box_nonperiodic, range))
                     {
-                    m_ptl_reject.insert(i);
+                    m_ptl_reject[i] = 1;
                     }
 
                 if (!line)
@@ -1220,7 +1158,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 // reject if outside active volume of box at new position
                 if (!isActive(vec_to_scalar3(snap.pos[i]), global_box_nonperiodic, range))
                     {
-                    m_ptl_reject.insert(i);
+                    m_ptl_reject[i] = 1;
                     }
 
                 // wrap particle back into box
@@ -1256,8 +1194,8 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
     std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_overlap;
     std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_interact_old_old;
     std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_interact_new_old;
-    std::vector< std::set<std::pair<unsigned int, unsigned int> > > all_interact_new_new;
-    std::vector< std::set<unsigned int> > all_local_reject;
+    std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_interact_new_new;
+    std::vector< std::vector<unsigned int> > all_local_reject;
 
     std::vector< std::map<std::pair<unsigned int, unsigned int>, float> > all_energy_old_old;
     std::vector< std::map<std::pair<unsigned int, unsigned int>, float> > all_energy_new_old;
@@ -1265,8 +1203,8 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
     std::vector< tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > > all_overlap;
     std::vector< tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > > all_interact_old_old;
     std::vector< tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > > all_interact_new_old;
-    std::vector< tbb::concurrent_unordered_set<std::pair<unsigned int, unsigned int> > > all_interact_new_new;
-    std::vector< tbb::concurrent_unordered_set<unsigned int> > all_local_reject;
+    std::vector< tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > > all_interact_new_new;
+    std::vector< tbb::concurrent_vector<unsigned int> > all_local_reject;
 
     std::vector< tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>, float> > all_energy_old_old;
     std::vector< tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>, float> > all_energy_new_old;
@@ -1313,19 +1251,26 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
             m_prof->pop();
 
 
+        // complete the list of rejected particles
         #ifdef ENABLE_MPI
         if (m_comm)
             {
-            // complete the list of rejected particles
             for (auto it_i = all_local_reject.begin(); it_i != all_local_reject.end(); ++it_i)
                 {
                 for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
                     {
-                    m_ptl_reject.insert(*it_j);
+                    m_ptl_reject[*it_j] = 1;
                     }
                 }
             }
+        else
         #endif
+            {
+            for (auto it = m_local_reject.begin(); it != m_local_reject.end(); ++it)
+                {
+                m_ptl_reject[*it] = 1;
+                }
+            }
 
         if (line && !swap)
             {
@@ -1653,31 +1598,31 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
 
         if (this->m_prof) this->m_prof->push("connected components");
         // compute connected components
-        m_clusters.clear();
-        m_G.connectedComponents(m_clusters);
+        m_G.connectedComponents(m_cluster_members, m_cluster_offsets);
         if (this->m_prof) this->m_prof->pop();
 
         if (this->m_prof) this->m_prof->push("reject");
 
         // move every cluster independently
-        m_count_total.n_clusters += m_clusters.size();
+        unsigned int n_clusters = m_cluster_offsets.size()-1;
+        m_count_total.n_clusters += n_clusters;
 
-        for (unsigned int icluster = 0; icluster < m_clusters.size(); icluster++)
+        for (unsigned int icluster = 0; icluster < n_clusters; icluster++)
             {
-            m_count_total.n_particles_in_clusters += m_clusters[icluster].size();
+            auto cluster_begin = m_cluster_members.begin() + m_cluster_offsets[icluster];
+            auto cluster_end = m_cluster_members.begin() + m_cluster_offsets[icluster+1];
+
+            m_count_total.n_particles_in_clusters += cluster_end - cluster_begin;
 
             // if any particle in the cluster is rejected, the cluster is not transformed
             bool reject = false;
-            for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+            for (auto it = cluster_begin; it != cluster_end; ++it)
                 {
-                bool mpi = false;
-                #ifdef ENABLE_MPI
-                mpi = (bool)m_comm;
-                if (mpi && m_ptl_reject.find(*it) != m_ptl_reject.end())
-                    reject = true;
-                #endif
-                if (!mpi && m_local_reject.find(*it) != m_local_reject.end())
+                if (m_ptl_reject[*it])
+                    {
                     reject = true;
+                    break;
+                    }
                 }
 
             bool flip = hoomd::detail::generate_canonical<float>(rng) <= m_flip_probability;
@@ -1688,7 +1633,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 int n_A_old = 0, n_A_new = 0;
                 int n_B_old = 0, n_B_new = 0;
 
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = cluster_begin; it != cluster_end; ++it)
                     {
                     unsigned int i = *it;
                     if (snap.type[i] == m_ab_types[0])
@@ -1710,7 +1655,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
             if (reject || !flip)
                 {
                 // revert cluster
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = cluster_begin; it != cluster_end; ++it)
                     {
                     // particle index
                     unsigned int i = *it;
@@ -1739,7 +1684,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 }
             else if (flip)
                 {
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = cluster_begin; it != cluster_end; ++it)
                     {
                     // particle index
                     unsigned int i = *it;
@@ -10,6 +10,8 @@
 #include "Moves.h"
 #include "IntegratorHPMCMono.h"
 
+#include <algorithm>
+
 #ifndef NVCC
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 #endif
@@ -85,6 +87,22 @@ class UpdaterMuVT : public Updater
             m_transfer_types = transfer_types;
             }
 
+        //! Set the cell width for cavity-biased insertion (0 disables cavity bias)
+        void setCavityBias(Scalar cavity_width)
+            {
+            if (cavity_width < Scalar(0.0))
+                {
+                throw std::runtime_error("Cavity width has to be non-negative.\n");
+                }
+            #ifdef ENABLE_MPI
+            if (cavity_width > Scalar(0.0) && m_pdata->getDomainDecomposition())
+                {
+                m_exec_conf->msg->error() << "update.muvt: Cavity-biased insertion is not supported with domain decomposition." << std::endl;
+                throw std::runtime_error("Error setting muVT parameters");
+                }
+            #endif
+            m_cavity_width = cavity_width;
+            }
 
         //! Print statistics about the muVT ensemble
         void printStats()
@@ -167,6 +185,21 @@ class UpdaterMuVT : public Updater
         GPUVector<Scalar> m_charge_backup;           //!< Backup of particle charges for volume move
         GPUVector<Scalar> m_diameter_backup;         //!< Backup of particle diameters for volume move
 
+        Scalar m_cavity_width;                       //!< Target cell width of the cavity grid (0 if disabled)
+        uint3 m_cavity_dim;                          //!< Number of cavity grid cells along each lattice vector
+        std::vector<unsigned int> m_cavity_cells;    //!< Indices of the cells that are cavities
+        std::vector<unsigned int> m_cavity_blocked;  //!< Flag per cell, set if the cell is blocked
+
+        /*! Find the cells of the cavity grid that can hold a particle
+         * \param type Type of particle to insert or remove
+         * \param exclude_tag Tag of a particle to ignore (UINT_MAX to consider all particles)
+         * \returns The number of cavity cells, also stored in m_cavity_cells
+         */
+        virtual unsigned int computeCavities(unsigned int type, unsigned int exclude_tag);
+
+        //! Get the index of the cavity grid cell containing a position
+        unsigned int getCavityCell(const vec3<Scalar>& pos);
+
         /*! Check for overlaps of a fictitious particle
          * \param timestep Current time step
          * \param type Type of particle to test
@@ -247,6 +280,7 @@ template < class Shape > void export_UpdaterMuVT(pybind11::module& m, const std:
           .def("setMoveRatio", &UpdaterMuVT<Shape>::setMoveRatio)
           .def("setTransferRatio", &UpdaterMuVT<Shape>::setTransferRatio)
           .def("setTransferTypes", &UpdaterMuVT<Shape>::setTransferTypes)
+          .def("setCavityBias", &UpdaterMuVT<Shape>::setCavityBias)
           ;
     }
 
@@ -262,7 +296,8 @@ UpdaterMuVT<Shape>::UpdaterMuVT(std::shared_ptr<SystemDefinition> sysdef,
     unsigned int seed,
     unsigned int npartition)
     : Updater(sysdef), m_mc(mc), m_seed(seed), m_npartition(npartition), m_gibbs(false),
-      m_max_vol_rescale(0.1), m_move_ratio(0.5), m_transfer_ratio(1.0), m_gibbs_other(0)
+      m_max_vol_rescale(0.1), m_move_ratio(0.5), m_transfer_ratio(1.0), m_gibbs_other(0),
+      m_cavity_width(0.0), m_cavity_dim(make_uint3(1,1,1))
     {
     // broadcast the seed from rank 0 to all other ranks.
     #ifdef ENABLE_MPI
@@ -634,7 +669,7 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                     const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = m_mc->getParams();
                     const typename Shape::param_type& param = params[type];
 
-                    // Propose a random position uniformly in the box
+                    // Propose a random position uniformly in the box, or in the cavities
                     Scalar3 f;
                     f.x = rng.template s<Scalar>();
                     f.y = rng.template s<Scalar>();
@@ -646,6 +681,31 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                         {
                         f.z = rng.template s<Scalar>();
                         }
+
+                    bool has_cavity = true;
+                    if (m_cavity_width > Scalar(0.0))
+                        {
+                        unsigned int n_cavity = computeCavities(type, UINT_MAX);
+                        unsigned int n_cells = m_cavity_dim.x*m_cavity_dim.y*m_cavity_dim.z;
+
+                        if (n_cavity)
+                            {
+                            // place the particle uniformly inside a random cavity cell
+                            Index3D ci(m_cavity_dim.x, m_cavity_dim.y, m_cavity_dim.z);
+                            uint3 cell = ci.getTriple(m_cavity_cells[rand_select(rng, n_cavity-1)]);
+                            f.x = (Scalar(cell.x) + f.x)/Scalar(m_cavity_dim.x);
+                            f.y = (Scalar(cell.y) + f.y)/Scalar(m_cavity_dim.y);
+                            if (m_sysdef->getNDimensions() != 2)
+                                f.z = (Scalar(cell.z) + f.z)/Scalar(m_cavity_dim.z);
+                            }
+                        else
+                            {
+                            has_cavity = false;
+                            }
+
+                        // proposals are restricted to the cavity volume
+                        V *= Scalar(n_cavity)/Scalar(n_cells);
+                        }
                     vec3<Scalar> pos_test = vec3<Scalar>(m_pdata->getGlobalBox().makeCoordinates(f));
 
                     Shape shape_test(quat<Scalar>(), param);
@@ -685,7 +745,8 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
 
                     // check if particle can be inserted without overlaps
                     Scalar lnb(0.0);
-                    unsigned int nonzero = tryInsertParticle(timestep, type, pos_test, shape_test.orientation, lnb);
+                    unsigned int nonzero = has_cavity &&
+                        tryInsertParticle(timestep, type, pos_test, shape_test.orientation, lnb);
 
                     if (nonzero)
                         {
@@ -823,7 +884,23 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
 
                 // acceptance probability
                 unsigned int nonzero = 1;
-                if (nptl_type)
+                if (nptl_type && m_cavity_width > Scalar(0.0))
+                    {
+                    // the reverse insertion is proposed in the cavities of the system without the particle
+                    unsigned int n_cavity = computeCavities(type, tag);
+                    unsigned int n_cells = m_cavity_dim.x*m_cavity_dim.y*m_cavity_dim.z;
+                    V *= Scalar(n_cavity)/Scalar(n_cells);
+
+                    unsigned int idx = m_pdata->getRTag(tag);
+                    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+                    unsigned int cell = getCavityCell(vec3<Scalar>(h_postype.data[idx]));
+                    if (! std::binary_search(m_cavity_cells.begin(), m_cavity_cells.end(), cell))
+                        {
+                        nonzero = 0;
+                        }
+                    }
+
+                if (nptl_type && nonzero)
                     {
                     lnboltzmann += log((Scalar)nptl_type/V);
                     }
@@ -1465,6 +1542,143 @@ bool UpdaterMuVT<Shape>::tryRemoveParticle(unsigned int timestep, unsigned int t
     }
 
 
+/*! The box is divided into a grid of cells with width close to m_cavity_width. A cell is blocked when every point
+    in it lies within the sum of the insphere radii of the inserted type and some other particle, so that inserting
+    anywhere in the cell is certain to overlap. All remaining cells are cavities.
+
+    Blocking only excludes volume where the Boltzmann weight of an insertion is zero, the acceptance criterion then
+    uses the cavity volume in place of the box volume.
+
+    Every particle marks the few cells it blocks, which costs O(N) and needs no tree queries. Cells are addressed with
+    unwrapped indices around the particle and wrapped into the grid afterwards, so periodic images are covered.
+*/
+template<class Shape>
+unsigned int UpdaterMuVT<Shape>::computeCavities(unsigned int type, unsigned int exclude_tag)
+    {
+    const BoxDim& box = m_pdata->getGlobalBox();
+    const unsigned int ndim = m_sysdef->getNDimensions();
+
+    // choose the grid dimensions
+    Scalar3 npd = box.getNearestPlaneDistance();
+    m_cavity_dim.x = std::max((unsigned int)(npd.x/m_cavity_width), 1u);
+    m_cavity_dim.y = std::max((unsigned int)(npd.y/m_cavity_width), 1u);
+    m_cavity_dim.z = (ndim == 2) ? 1 : std::max((unsigned int)(npd.z/m_cavity_width), 1u);
+    Index3D ci(m_cavity_dim.x, m_cavity_dim.y, m_cavity_dim.z);
+
+    // half of the longest diagonal of a (possibly tilted) cell
+    vec3<Scalar> a = vec3<Scalar>(box.getLatticeVector(0))/Scalar(m_cavity_dim.x);
+    vec3<Scalar> b = vec3<Scalar>(box.getLatticeVector(1))/Scalar(m_cavity_dim.y);
+    vec3<Scalar> c = (ndim == 2) ? vec3<Scalar>(0,0,0) : vec3<Scalar>(box.getLatticeVector(2))/Scalar(m_cavity_dim.z);
+    Scalar half_diag(0.0);
+    for (int sb = -1; sb <= 1; sb += 2)
+        for (int sc = -1; sc <= 1; sc += 2)
+            {
+            vec3<Scalar> d = a + Scalar(sb)*b + Scalar(sc)*c;
+            half_diag = std::max(half_diag, Scalar(0.5)*sqrt(dot(d,d)));
+            }
+
+    auto& params = m_mc->getParams();
+    OverlapReal r_in_type = Shape(quat<Scalar>(), params[type]).getInsphereRadius();
+
+    OverlapReal r_in_max(0.0);
+    std::vector<OverlapReal> r_in(m_pdata->getNTypes());
+    for (unsigned int t = 0; t < m_pdata->getNTypes(); ++t)
+        {
+        r_in[t] = Shape(quat<Scalar>(), params[t]).getInsphereRadius();
+        r_in_max = std::max(r_in_max, r_in[t]);
+        }
+
+    m_cavity_cells.clear();
+
+    // no particle is large enough to block a whole cell
+    if (m_pdata->getN() == 0 || r_in_type + r_in_max <= half_diag)
+        {
+        for (unsigned int cell = 0; cell < ci.getNumElements(); ++cell)
+            m_cavity_cells.push_back(cell);
+        return m_cavity_cells.size();
+        }
+
+    const Index2D& overlap_idx = m_mc->getOverlapIndexer();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
+
+    m_cavity_blocked.assign(ci.getNumElements(), 0);
+
+    for (unsigned int j = 0; j < m_pdata->getN(); ++j)
+        {
+        if (h_tag.data[j] == exclude_tag)
+            continue;
+
+        Scalar4 postype_j = h_postype.data[j];
+        unsigned int typ_j = __scalar_as_int(postype_j.w);
+        if (! h_overlaps.data[overlap_idx(type, typ_j)])
+            continue;
+
+        Scalar d = r_in_type + r_in[typ_j] - half_diag;
+        if (d <= Scalar(0.0))
+            continue;
+
+        // range of cell centers within d, a fractional coordinate changes by one over the nearest plane distance
+        vec3<Scalar> pos_j(postype_j);
+        Scalar3 f = box.makeFraction(vec_to_scalar3(pos_j));
+        int3 lo = make_int3(int(ceil((f.x - d/npd.x)*Scalar(m_cavity_dim.x) - Scalar(0.5))),
+                            int(ceil((f.y - d/npd.y)*Scalar(m_cavity_dim.y) - Scalar(0.5))),
+                            0);
+        int3 hi = make_int3(int(floor((f.x + d/npd.x)*Scalar(m_cavity_dim.x) - Scalar(0.5))),
+                            int(floor((f.y + d/npd.y)*Scalar(m_cavity_dim.y) - Scalar(0.5))),
+                            0);
+        if (ndim == 3)
+            {
+            lo.z = int(ceil((f.z - d/npd.z)*Scalar(m_cavity_dim.z) - Scalar(0.5)));
+            hi.z = int(floor((f.z + d/npd.z)*Scalar(m_cavity_dim.z) - Scalar(0.5)));
+            }
+
+        for (int k = lo.z; k <= hi.z; ++k)
+            for (int l = lo.y; l <= hi.y; ++l)
+                for (int m = lo.x; m <= hi.x; ++m)
+                    {
+                    Scalar3 f_cell = make_scalar3((Scalar(m)+Scalar(0.5))/Scalar(m_cavity_dim.x),
+                                                  (Scalar(l)+Scalar(0.5))/Scalar(m_cavity_dim.y),
+                                                  (Scalar(k)+Scalar(0.5))/Scalar(m_cavity_dim.z));
+                    vec3<Scalar> r_ij = pos_j - vec3<Scalar>(box.makeCoordinates(f_cell));
+                    if (dot(r_ij,r_ij) < d*d)
+                        {
+                        int3 cell = make_int3(m % int(m_cavity_dim.x), l % int(m_cavity_dim.y), k % int(m_cavity_dim.z));
+                        if (cell.x < 0) cell.x += m_cavity_dim.x;
+                        if (cell.y < 0) cell.y += m_cavity_dim.y;
+                        if (cell.z < 0) cell.z += m_cavity_dim.z;
+                        m_cavity_blocked[ci(cell.x, cell.y, cell.z)] = 1;
+                        }
+                    }
+        }
+
+    for (unsigned int cell = 0; cell < ci.getNumElements(); ++cell)
+        {
+        if (! m_cavity_blocked[cell])
+            m_cavity_cells.push_back(cell);
+        }
+
+    return m_cavity_cells.size();
+    }
+
+/*! \param pos Position in the global box
+    \returns The index of the cavity grid cell containing \a pos, for the grid of the last call to computeCavities()
+*/
+template<class Shape>
+unsigned int UpdaterMuVT<Shape>::getCavityCell(const vec3<Scalar>& pos)
+    {
+    Scalar3 f = m_pdata->getGlobalBox().makeFraction(vec_to_scalar3(pos));
+    Index3D ci(m_cavity_dim.x, m_cavity_dim.y, m_cavity_dim.z);
+
+    int3 cell = make_int3(int(f.x*Scalar(m_cavity_dim.x)), int(f.y*Scalar(m_cavity_dim.y)), int(f.z*Scalar(m_cavity_dim.z)));
+    cell.x = std::min(std::max(cell.x, 0), int(m_cavity_dim.x)-1);
+    cell.y = std::min(std::max(cell.y, 0), int(m_cavity_dim.y)-1);
+    cell.z = std::min(std::max(cell.z, 0), int(m_cavity_dim.z)-1);
+    return ci(cell.x, cell.y, cell.z);
+    }
+
 template<class Shape>
 bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int type, vec3<Scalar> pos,
     quat<Scalar> orientation, Scalar &lnboltzmann)
@@ -8,6 +8,7 @@ import hoomd
 import hoomd.hpmc
 from hoomd.hpmc import _hpmc
 import numpy
+import hashlib
 
 class param_dict(dict):
     R""" Manage shape parameters.
@@ -70,6 +71,15 @@ class param_dict(dict):
             mc.shape_param.set(['A', 'B'], diameter=2.0)
 
 
+        Polyhedra and shape unions accept *cache_dir* to store the built parameters, including their convex hulls
+        and OBB trees, in a binary file in that directory. The file is named by a hash of the shape definition, and
+        later calls with the same definition load it instead of building the parameters again. In MPI runs, only the
+        root rank builds or loads the parameters, and broadcasts them to the other ranks.
+
+        Example::
+
+            mc.shape_param.set('A', vertices=verts, faces=faces, cache_dir='shape_cache')
+
         Note:
             Single parameters can not be updated. If both *diameter* and *length* are required for a particle type,
             then executing coeff.set('A', diameter=1.5) will fail one must call coeff.set('A', diameter=1.5, length=2.0)
@@ -86,7 +96,7 @@ class param_dict(dict):
 
 class _param(object):
     def __init__(self, mc, typid):
-        self.__dict__.update(dict(_keys=['ignore_statistics'], mc=mc, typid=typid, make_fn=None, is_set=False));
+        self.__dict__.update(dict(_keys=['ignore_statistics'], mc=mc, typid=typid, make_fn=None, cache_fn=None, is_set=False));
 
     @classmethod
     def ensure_list(cls, li):
@@ -94,6 +104,15 @@ class _param(object):
         ai = numpy.array(li);
         return ai.tolist();
 
+    @classmethod
+    def tree_build_id(cls, tree_build):
+        # map the name of an OBB tree build strategy to its enum value in OBBTree.h
+        strategies = {'mean': 0, 'sah': 1, 'best': 2};
+        if not tree_build in strategies:
+            hoomd.context.msg.error("tree_build must be one of {}.\n".format(sorted(strategies.keys())));
+            raise RuntimeError('Error setting shape parameters');
+        return strategies[tree_build];
+
     def get_metadata(self):
         data = {}
         for key in self._keys:
@@ -115,7 +134,41 @@ class _param(object):
             # do not pass to C++
             params.pop('ignore_overlaps',None)
 
-        self.mc.cpp_integrator.setParam(self.typid, self.make_param(**params));
+        cache_dir = params.pop('cache_dir', None)
+        if self.cache_fn is None:
+            if cache_dir is not None:
+                hoomd.context.msg.warning("{} does not support cache_dir, ignoring.\n".format(type(self).__name__));
+            param = self.make_param(**params);
+        else:
+            # build on the root rank only, or load from the cache
+            key = '' if cache_dir is None else self.cache_key(params);
+            param = self.cache_fn('' if cache_dir is None else str(cache_dir),
+                                  key,
+                                  lambda: self.make_param(**params),
+                                  hoomd.context.current.system_definition.getParticleData().getExecConf());
+
+            # make_param may not have been called on this rank
+            if 'colors' in params:
+                self.colors = None if params['colors'] is None else self.ensure_list(params['colors']);
+
+        self.mc.cpp_integrator.setParam(self.typid, param);
+
+    @classmethod
+    def cache_key(cls, params):
+        # hash of the shape definition that names the file in the shape parameter cache
+        def canonical(v):
+            if isinstance(v, numpy.ndarray):
+                return canonical(v.tolist());
+            if isinstance(v, numpy.generic):
+                return v.item();
+            if isinstance(v, (list, tuple)):
+                return [canonical(x) for x in v];
+            if isinstance(v, dict):
+                return sorted((k, canonical(x)) for k, x in v.items());
+            return v;
+
+        definition = repr((cls.__name__, canonical(params)));
+        return hashlib.sha1(definition.encode('utf-8')).hexdigest();
 
 class sphere_params(_hpmc.sphere_param_proxy, _param):
     def __init__(self, mc, index):
@@ -224,6 +277,7 @@ class polyhedron_params(_hpmc.polyhedron_param_proxy, _param):
         _param.__init__(self, mc, index);
         self._keys += ['vertices', 'faces','overlap', 'colors', 'sweep_radius', 'capacity','origin','hull_only'];
         self.make_fn = _hpmc.make_poly3d_data;
+        self.cache_fn = _hpmc.cache_poly3d_data;
         self.__dict__.update(dict(colors=None));
 
     def __str__(self):
@@ -231,7 +285,7 @@ class polyhedron_params(_hpmc.polyhedron_param_proxy, _param):
         string = "polyhedron(vertices = {}, faces = {}, overlap = {}, colors= {}, sweep_radius = {}, capacity = {}, origin = {})".format(self.vertices, self.faces, self.overlap, self.colors, self.sweep_radius, self.capacity, self.hull_only);
         return string;
 
-    def make_param(self, vertices, faces, sweep_radius=0.0, ignore_statistics=False, origin=(0,0,0), capacity=4, hull_only=True, overlap=None, colors=None):
+    def make_param(self, vertices, faces, sweep_radius=0.0, ignore_statistics=False, origin=(0,0,0), capacity=4, hull_only=True, overlap=None, colors=None, tree_build='mean'):
         face_offs = []
         face_verts = []
         offs = 0
@@ -268,6 +322,7 @@ class polyhedron_params(_hpmc.polyhedron_param_proxy, _param):
                             capacity,
                             self.ensure_list(origin),
                             int(hull_only),
+                            self.tree_build_id(tree_build),
                             hoomd.context.current.system_definition.getParticleData().getExecConf());
 
 class faceted_ellipsoid_params(_hpmc.faceted_ellipsoid_param_proxy, _param):
@@ -360,6 +415,7 @@ class sphere_union_params(_hpmc.sphere_union_param_proxy,_param):
         self.__dict__.update(dict(colors=None));
         self._keys += ['centers', 'orientations', 'diameter', 'colors','overlap'];
         self.make_fn = _hpmc.make_sphere_union_params;
+        self.cache_fn = _hpmc.cache_sphere_union_params;
 
     def __str__(self):
         # should we put this in the c++ side?
@@ -382,7 +438,7 @@ class sphere_union_params(_hpmc.sphere_union_param_proxy,_param):
             data[key] = val;
         return data;
 
-    def make_param(self, diameters, centers, overlap=None, ignore_statistics=False, colors=None, capacity=4):
+    def make_param(self, diameters, centers, overlap=None, ignore_statistics=False, colors=None, capacity=4, tree_build='mean'):
         if overlap is None:
             overlap = [1 for c in centers]
 
@@ -397,6 +453,7 @@ class sphere_union_params(_hpmc.sphere_union_param_proxy,_param):
                             self.ensure_list(overlap),
                             ignore_statistics,
                             capacity,
+                            self.tree_build_id(tree_build),
                             hoomd.context.current.system_definition.getParticleData().getExecConf());
 
 class convex_spheropolyhedron_union_params(_hpmc.convex_polyhedron_union_param_proxy,_param):
@@ -406,6 +463,7 @@ class convex_spheropolyhedron_union_params(_hpmc.convex_polyhedron_union_param_p
         self.__dict__.update(dict(colors=None));
         self._keys += ['centers', 'orientations', 'vertices', 'colors','overlap','sweep_radii'];
         self.make_fn = _hpmc.make_convex_polyhedron_union_params;
+        self.cache_fn = _hpmc.cache_convex_polyhedron_union_params;
 
     def __str__(self):
         # should we put this in the c++ side?
@@ -430,7 +488,7 @@ class convex_spheropolyhedron_union_params(_hpmc.convex_polyhedron_union_param_p
             data[key] = val;
         return data;
 
-    def make_param(self, centers, orientations, vertices, overlap=None, sweep_radii=None, ignore_statistics=False, colors=None, capacity=4):
+    def make_param(self, centers, orientations, vertices, overlap=None, sweep_radii=None, ignore_statistics=False, colors=None, capacity=4, tree_build='mean'):
         if overlap is None:
             overlap = [1 for c in centers]
 
@@ -452,6 +510,7 @@ class convex_spheropolyhedron_union_params(_hpmc.convex_polyhedron_union_param_p
                             self.ensure_list(overlap),
                             ignore_statistics,
                             capacity,
+                            self.tree_build_id(tree_build),
                             hoomd.context.current.system_definition.getParticleData().getExecConf());
 
 class convex_polyhedron_union_params(convex_spheropolyhedron_union_params):
@@ -467,6 +526,7 @@ class faceted_ellipsoid_union_params(_hpmc.faceted_ellipsoid_union_param_proxy,_
         self.__dict__.update(dict(colors=None));
         self._keys += ['centers', 'orientations', 'vertices', 'normals', 'offsets', 'colors','overlap','a', 'b', 'c', 'origins'];
         self.make_fn = _hpmc.make_faceted_ellipsoid_union_params
+        self.cache_fn = _hpmc.cache_faceted_ellipsoid_union_params;
 
     def __str__(self):
         # should we put this in the c++ side?
@@ -503,7 +563,7 @@ class faceted_ellipsoid_union_params(_hpmc.faceted_ellipsoid_union_param_proxy,_
         return data;
 
     def make_param(self, centers, orientations, vertices, normals, offsets, axes, origins=None, overlap=None,
-        ignore_statistics=False, colors=None, capacity=4):
+        ignore_statistics=False, colors=None, capacity=4, tree_build='mean'):
         if overlap is None:
             overlap = [1 for c in centers]
 
@@ -534,4 +594,5 @@ class faceted_ellipsoid_union_params(_hpmc.faceted_ellipsoid_union_param_proxy,_
                             self.ensure_list(overlap),
                             ignore_statistics,
                             capacity,
+                            self.tree_build_id(tree_build),
                             hoomd.context.current.system_definition.getParticleData().getExecConf());
@@ -192,16 +192,36 @@ class mode_hpmc(_integrator):
     free diffusion of colloids that do not share any overlap volume with other colloids. This
     speeds up equilibration of dilute systems of colloids in a dense depletant bath. Both modes
     yield the same equilibrium statistics, but different dynamics (Glaser, to be published).
+
+    .. rubric:: Event chains
+
+    The integrators for spheres, convex polyhedra and convex spheropolyhedra support event-chain Monte Carlo with
+    the **event_chain=True** argument (CPU only). Instead of small trial displacements, each particle in turn starts a
+    chain that moves it along a random coordinate axis until it collides with another particle, which then continues
+    the move, until the total displacement reaches *chain_length* (see :py:meth:`set_params`). Translations are
+    rejection free and dense hard particle systems relax much faster than with local moves
+    (`E. P. Bernard et. al. 2009 <https://doi.org/10.1103/PhysRevE.80.056704>`_). Rotations of anisotropic
+    shapes are still performed with trial moves of size *a*; *d* and *move_ratio* are not used.
+    With MPI, chains that reach a domain boundary continue on the neighboring rank after a grid shift.
     """
 
     ## \internal
     # \brief Initialize an empty integrator
     #
     # \post the member shape_param is created
-    def __init__(self, implicit, depletant_mode=None):
+    def __init__(self, implicit, depletant_mode=None, event_chain=False):
         _integrator.__init__(self);
         self.implicit=implicit
         self.depletant_mode=depletant_mode
+        self.event_chain=event_chain
+
+        if self.event_chain:
+            if self.implicit:
+                hoomd.context.msg.error("Event chain moves do not support implicit depletants.\n");
+                raise RuntimeError("Error initializing HPMC integrator");
+            if hoomd.context.exec_conf.isCUDAEnabled():
+                hoomd.context.msg.error("Event chain moves are not supported on the GPU.\n");
+                raise RuntimeError("Error initializing HPMC integrator");
 
         # setup the shape parameters
         self.shape_param = data.param_dict(self); # must call initialize_shape_params() after the cpp_integrator is created.
@@ -236,6 +256,8 @@ class mode_hpmc(_integrator):
             shape_dict[key] = self.shape_param[key].get_metadata();
         data['shape_param'] = shape_dict;
         data['overlap_checks'] = self.overlap_checks.get_metadata()
+        if self.event_chain:
+            data['chain_length'] = self.cpp_integrator.getChainLength()
         if self.implicit:
             data['depletant_mode'] = self.depletant_mode
             data['nR'] = self.get_nR()
@@ -391,7 +413,9 @@ class mode_hpmc(_integrator):
                    nR=None,
                    depletant_type=None,
                    ntrial=None,
-                   deterministic=None):
+                   deterministic=None,
+                   chain_length=None,
+                   patch_cache=None):
         R""" Changes parameters of an existing integration mode.
 
         Args:
@@ -404,6 +428,9 @@ class mode_hpmc(_integrator):
             ntrial (int): (if set) **Implicit depletants only**: Number of re-insertion attempts per overlapping depletant.
                 (Only supported with **depletant_mode='circumsphere'**)
             deterministic (bool): (if set) Make HPMC integration deterministic on the GPU by sorting the cell list.
+            chain_length (float): (if set) **Event chains only**: Total displacement of every event chain.
+            patch_cache (bool): (if set) Cache the pair energies of every particle with its neighbors, so that a trial
+                move only evaluates the patch energy of the new configuration (CPU only, not with implicit depletants).
 
         .. note:: Simulations are only deterministic with respect to the same execution configuration (CPU or GPU) and
                   number of MPI ranks. Simulation output will not be identical if either of these is changed.
@@ -458,6 +485,18 @@ class mode_hpmc(_integrator):
         if deterministic is not None:
             self.cpp_integrator.setDeterministic(deterministic);
 
+        if chain_length is not None:
+            if self.event_chain:
+                self.cpp_integrator.setChainLength(chain_length);
+            else:
+                hoomd.context.msg.warning("chain_length is only supported with event_chain=True. Ignoring.\n")
+
+        if patch_cache is not None:
+            if self.implicit:
+                hoomd.context.msg.warning("patch_cache is not supported with implicit depletants. Ignoring.\n")
+            else:
+                self.cpp_integrator.setPatchEnergyCache(patch_cache);
+
     def map_overlaps(self):
         R""" Build an overlap map of the system
 
@@ -754,6 +793,7 @@ class sphere(mode_hpmc):
             (added in version 2.2)
         restore_state(bool): Restore internal state from initialization file when True. See :py:class:`mode_hpmc`
                              for a description of what state data restored. (added in version 2.2)
+        event_chain (bool): Flag to enable event-chain moves, see :py:class:`mode_hpmc`. (added in version 2.9)
 
     Hard particle Monte Carlo integration method for spheres.
 
@@ -775,6 +815,12 @@ class sphere(mode_hpmc):
         mc.shape_param.set('C', diameter=1.0, orientable=True)
         print('diameter = ', mc.shape_param['A'].diameter)
 
+    Event chain Example::
+
+        mc = hpmc.integrate.sphere(seed=415236, event_chain=True)
+        mc.set_params(chain_length=2.0)
+        mc.shape_param.set('A', diameter=1.0)
+
     Depletants Example::
 
         mc = hpmc.integrate.sphere(seed=415236, d=0.3, a=0.4, implicit=True, depletant_mode='circumsphere')
@@ -783,15 +829,17 @@ class sphere(mode_hpmc):
         mc.shape_param.set('B', diameter=.1)
     """
 
-    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere',restore_state=False):
+    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere',restore_state=False, event_chain=False):
         hoomd.util.print_status_line();
 
         # initialize base class
-        mode_hpmc.__init__(self,implicit, depletant_mode);
+        mode_hpmc.__init__(self,implicit, depletant_mode, event_chain);
 
         # initialize the reflected c++ class
         if not hoomd.context.exec_conf.isCUDAEnabled():
-            if(implicit):
+            if event_chain:
+                self.cpp_integrator = _hpmc.IntegratorHPMCMonoEventChainSphere(hoomd.context.current.system_definition, seed);
+            elif(implicit):
                 # In C++ mode circumsphere = 0 and mode overlap_regions = 1
                 if depletant_mode_circumsphere(depletant_mode):
                     self.cpp_integrator = _hpmc.IntegratorHPMCMonoImplicitSphere(hoomd.context.current.system_definition, seed, 0)
@@ -1182,6 +1230,17 @@ class polyhedron(mode_hpmc):
 
         * .. versionadded:: 2.2
 
+    * *tree_build* (**default: 'mean'**) - strategy to build the tree of faces. 'mean' splits nodes at the mean
+      of the face centers, 'sah' splits nodes where the surface area heuristic is minimal, and 'best' builds both
+      trees and keeps the one with the lower expected traversal cost. The cost is reported at notice level 4.
+
+        * .. versionadded:: 2.9
+
+    * *cache_dir* (**default: None**) - directory to cache the built shape parameters in, see
+      :py:meth:`hoomd.hpmc.data.param_dict.set`. Shape unions also accept this parameter.
+
+        * .. versionadded:: 2.9
+
     * *origin* (**default: (0,0,0)**) - a point strictly inside the shape, needed for correctness of overlap checks
 
         * .. versionadded:: 2.2
@@ -1310,6 +1369,7 @@ class convex_polyhedron(mode_hpmc):
         max_verts (int): Set the maximum number of vertices in a polyhedron. (deprecated in version 2.2)
         restore_state(bool): Restore internal state from initialization file when True. See :py:class:`mode_hpmc`
                              for a description of what state data restored. (added in version 2.2)
+        event_chain (bool): Flag to enable event-chain moves, see :py:class:`mode_hpmc`. (added in version 2.9)
 
     Convex polyhedron parameters:
 
@@ -1342,18 +1402,20 @@ class convex_polyhedron(mode_hpmc):
         mc.shape_param.set('A', vertices=[(0.5, 0.5, 0.5), (0.5, -0.5, -0.5), (-0.5, 0.5, -0.5), (-0.5, -0.5, 0.5)]);
         mc.shape_param.set('B', vertices=[(0.05, 0.05, 0.05), (0.05, -0.05, -0.05), (-0.05, 0.05, -0.05), (-0.05, -0.05, 0.05)]);
     """
-    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere', max_verts=None, restore_state=False):
+    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere', max_verts=None, restore_state=False, event_chain=False):
         hoomd.util.print_status_line();
 
         if max_verts is not None:
             hoomd.context.msg.warning("max_verts is deprecated. Ignoring.\n")
 
         # initialize base class
-        mode_hpmc.__init__(self,implicit, depletant_mode);
+        mode_hpmc.__init__(self,implicit, depletant_mode, event_chain);
 
         # initialize the reflected c++ class
         if not hoomd.context.exec_conf.isCUDAEnabled():
-            if(implicit):
+            if event_chain:
+                self.cpp_integrator = _hpmc.IntegratorHPMCMonoEventChainConvexPolyhedron(hoomd.context.current.system_definition, seed);
+            elif(implicit):
                 # In C++ mode circumsphere = 0 and mode overlap_regions = 1
                 if depletant_mode_circumsphere(depletant_mode):
                     self.cpp_integrator = _hpmc.IntegratorHPMCMonoImplicitConvexPolyhedron(hoomd.context.current.system_definition, seed, 0);
@@ -1748,6 +1810,7 @@ class convex_spheropolyhedron(mode_hpmc):
         max_verts (int): Set the maximum number of vertices in a polyhedron. (deprecated in version 2.2)
         restore_state(bool): Restore internal state from initialization file when True. See :py:class:`mode_hpmc`
                              for a description of what state data restored. (added in version 2.2)
+        event_chain (bool): Flag to enable event-chain moves, see :py:class:`mode_hpmc`. (added in version 2.9)
 
     A spheropolyhedron can also represent spheres (0 or 1 vertices), and spherocylinders (2 vertices).
 
@@ -1787,18 +1850,20 @@ class convex_spheropolyhedron(mode_hpmc):
         mc.shape_param['SphericalDepletant'].set(vertices=[], sweep_radius=0.1);
     """
 
-    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere', max_verts=None, restore_state=False):
+    def __init__(self, seed, d=0.1, a=0.1, move_ratio=0.5, nselect=4, implicit=False, depletant_mode='circumsphere', max_verts=None, restore_state=False, event_chain=False):
         hoomd.util.print_status_line();
 
         if max_verts is not None:
             hoomd.context.msg.warning("max_verts is deprecated. Ignoring.\n")
 
         # initialize base class
-        mode_hpmc.__init__(self,implicit, depletant_mode);
+        mode_hpmc.__init__(self,implicit, depletant_mode, event_chain);
 
         # initialize the reflected c++ class
         if not hoomd.context.exec_conf.isCUDAEnabled():
-            if(implicit):
+            if event_chain:
+                self.cpp_integrator = _hpmc.IntegratorHPMCMonoEventChainSpheropolyhedron(hoomd.context.current.system_definition, seed);
+            elif(implicit):
                 # In C++ mode circumsphere = 0 and mode overlap_regions = 1
                 if depletant_mode_circumsphere(depletant_mode):
                     self.cpp_integrator = _hpmc.IntegratorHPMCMonoImplicitSpheropolyhedron(hoomd.context.current.system_definition, seed, 0)
@@ -2005,6 +2070,9 @@ class sphere_union(mode_hpmc):
              Replaced by :py:class:`interaction_matrix`.
     * *capacity* (**default: 4**) - set to the maximum number of particles per leaf node for better performance
         * .. versionadded:: 2.2
+    * *tree_build* (**default: 'mean'**) - strategy to build the tree of constituent particles, either 'mean',
+      'sah' or 'best' (see :py:class:`polyhedron`)
+        * .. versionadded:: 2.9
 
     Example::
 
@@ -2116,6 +2184,11 @@ class convex_spheropolyhedron_union(mode_hpmc):
 
         * .. versionadded:: 2.4
 
+    * *tree_build* (**default: 'mean'**) - strategy to build the tree of constituent particles, either 'mean',
+      'sah' or 'best' (see :py:class:`polyhedron`)
+
+        * .. versionadded:: 2.9
+
     * *ignore_statistics* (**default: False**) - set to True to disable ignore for statistics tracking.
     * *ignore_overlaps* (**default: False**) - set to True to disable overlap checks between this and other types with *ignore_overlaps=True*
 
@@ -2296,6 +2369,11 @@ class faceted_ellipsoid_union(mode_hpmc):
     * *vertices* (**required**) - list of list list of vertices for intersection polyhedron
     * *origin* (**required**) - list of origin vectors
 
+    * *tree_build* (**default: 'mean'**) - strategy to build the tree of constituent particles, either 'mean',
+      'sah' or 'best' (see :py:class:`polyhedron`)
+
+        * .. versionadded:: 2.9
+
     * *ignore_statistics* (**default: False**) - set to True to disable ignore for statistics tracking.
     * *ignore_overlaps* (**default: False**) - set to True to disable overlap checks between this and other types with *ignore_overlaps=True*
 
@@ -22,6 +22,7 @@
 #include "UpdaterClusters.h"
 
 #include "ShapeProxy.h"
+#include "ShapeParamCache.h"
 
 #include "GPUTree.h"
 
@@ -102,6 +103,10 @@ PYBIND11_MODULE(_hpmc, m)
     m.def("make_convex_polyhedron_union_params", &make_union_params<ShapeSpheropolyhedron>);
     m.def("make_faceted_ellipsoid_union_params", &make_union_params<ShapeFacetedEllipsoid>);
     m.def("make_sphere_union_params", &make_union_params<ShapeSphere>);
+    m.def("cache_poly3d_data", &cache_shape_param<poly3d_data>);
+    m.def("cache_convex_polyhedron_union_params", &cache_shape_param<ShapeUnion<ShapeSpheropolyhedron>::param_type>);
+    m.def("cache_faceted_ellipsoid_union_params", &cache_shape_param<ShapeUnion<ShapeFacetedEllipsoid>::param_type>);
+    m.def("cache_sphere_union_params", &cache_shape_param<ShapeUnion<ShapeSphere>::param_type>);
     m.def("make_overlapreal3", &make_overlapreal3);
     m.def("make_overlapreal4", &make_overlapreal4);
 
@@ -339,5 +339,36 @@ class patch_alpha_user_union(unittest.TestCase):
         del self.patch
         context.initialize();
 
+class patch_energy_cache(unittest.TestCase):
+
+    def setUp(self):
+        # square well energies are exactly representable, so cached and recomputed energies agree to the last bit
+        self.square_well = """float rsq = dot(r_ij, r_ij);
+                              if (rsq < 1.5f*1.5f)
+                                  return -1.0f;
+                              else
+                                  return 0.0f;
+                           """
+
+    def run_fluid(self, patch_cache):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=5);
+        mc = hpmc.integrate.sphere(seed=123, d=0.1);
+        mc.shape_param.set('A', diameter=1.0);
+        mc.set_params(patch_cache=patch_cache);
+        patch = jit.patch.user(mc=mc, r_cut=1.5, code=self.square_well);
+        log = analyze.log(filename=None, quantities=['hpmc_patch_energy'], period=1, overwrite=True);
+        hoomd.run(20, quiet=True);
+        energy = log.query('hpmc_patch_energy');
+        snap = system.take_snapshot();
+        context.initialize();
+        return energy, snap.particles.position
+
+    # the cache must not change the trajectory
+    def test_cache_trajectory(self):
+        energy, pos = self.run_fluid(False);
+        energy_cache, pos_cache = self.run_fluid(True);
+        self.assertEqual(energy, energy_cache);
+        np.testing.assert_array_equal(pos, pos_cache);
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
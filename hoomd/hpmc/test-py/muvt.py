@@ -32,6 +32,33 @@ class muvt_updater_test(unittest.TestCase):
 
         run(100)
 
+    @unittest.skipIf(comm.get_num_ranks() > 1, 'cavity-biased insertion requires a single rank')
+    def test_spheres_cavity_bias(self):
+        self.mc = hpmc.integrate.sphere(seed=123)
+        self.mc.set_params(deterministic=True)
+        self.mc.set_params(d=0.1)
+
+        self.mc.shape_param.set('A', diameter=1.0)
+
+        self.muvt=hpmc.update.muvt(mc=self.mc,seed=456,transfer_types=['A'])
+        self.muvt.set_fugacity('A', 100)
+        self.muvt.set_params(cavity_width=0.5)
+
+        run(100)
+
+        # particles are inserted and there are no overlaps
+        self.assertGreater(len(self.system.particles), 1000)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def test_cavity_bias_unsupported(self):
+        self.mc = hpmc.integrate.ellipsoid(seed=123)
+        self.mc.shape_param.set('A', a=0.5, b=0.5, c=0.5)
+
+        self.muvt=hpmc.update.muvt(mc=self.mc,seed=456,transfer_types=['A'])
+
+        # only spheres define an insphere radius
+        self.assertRaises(RuntimeError, self.muvt.set_params, cavity_width=0.5)
+
     def test_convex_polyhedron(self):
         self.mc = hpmc.integrate.convex_polyhedron(seed=10);
         self.mc.set_params(deterministic=True)
@@ -140,6 +167,22 @@ class muvt_updater_test_2d(unittest.TestCase):
 
         run(100)
 
+    @unittest.skipIf(comm.get_num_ranks() > 1, 'cavity-biased insertion requires a single rank')
+    def test_spheres_cavity_bias(self):
+        self.mc = hpmc.integrate.sphere(seed=0)
+        self.mc.set_params(deterministic=True)
+        self.mc.set_params(d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+
+        self.muvt=hpmc.update.muvt(mc=self.mc, seed=456, transfer_types=['A'])
+        self.muvt.set_fugacity('A', 100)
+        self.muvt.set_params(cavity_width=0.5)
+
+        run(100)
+
+        self.assertGreater(len(self.system.particles), 100)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
     def test_convex_polygon(self):
         self.mc = hpmc.integrate.convex_polygon(seed=0)
         self.mc.set_params(deterministic=True)
@@ -167,5 +210,52 @@ class muvt_updater_test_2d(unittest.TestCase):
 
         run(100)
 
+# check that cavity-biased insertion samples the same grand canonical ensemble as uniform insertion
+@unittest.skipIf(comm.get_num_ranks() > 1, 'cavity-biased insertion requires a single rank')
+class muvt_cavity_bias_test(unittest.TestCase):
+    def sample_n(self, cavity_width):
+        context.initialize()
+        snap = data.make_snapshot(N=1, box=data.boxdim(L=6), particle_types=['A'])
+        system = init.read_snapshot(snap)
+
+        mc = hpmc.integrate.sphere(seed=123, d=0.2)
+        mc.shape_param.set('A', diameter=1.0)
+
+        muvt = hpmc.update.muvt(mc=mc, seed=456, transfer_types=['A'])
+        muvt.set_fugacity('A', 1.5)
+        if cavity_width > 0:
+            muvt.set_params(cavity_width=cavity_width)
+
+        run(2000)
+
+        n = []
+        for i in range(400):
+            run(10)
+            n.append(len(system.particles))
+
+        self.assertEqual(mc.count_overlaps(), 0)
+        del muvt, mc, system
+        context.initialize()
+        return n
+
+    # mean and standard error from 10 blocks of correlated samples
+    def block_average(self, samples):
+        nblocks = 10
+        size = len(samples) // nblocks
+        blocks = [sum(samples[i*size:(i+1)*size])/float(size) for i in range(nblocks)]
+        mean = sum(blocks)/nblocks
+        var = sum((b-mean)**2 for b in blocks)/(nblocks-1)
+        return mean, math.sqrt(var/nblocks)
+
+    def test_mean_n(self):
+        mean_uniform, err_uniform = self.block_average(self.sample_n(0))
+        mean_cavity, err_cavity = self.block_average(self.sample_n(0.3))
+
+        # the system is neither empty nor jammed
+        self.assertGreater(mean_uniform, 20)
+
+        err = math.sqrt(err_uniform**2 + err_cavity**2)
+        self.assertLess(abs(mean_uniform - mean_cavity), 4*err + 1.0)
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
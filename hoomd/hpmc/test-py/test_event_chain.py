@@ -0,0 +1,140 @@
+from __future__ import division
+from __future__ import print_function
+
+import hoomd
+from hoomd import context, init, lattice
+from hoomd import hpmc
+
+import math
+import numpy
+import os
+import tempfile
+import unittest
+
+context.initialize()
+
+class event_chain_sphere_test(unittest.TestCase):
+
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sc(a=1.1), n=5)
+
+    def tearDown(self):
+        del self.system
+        context.initialize()
+
+    def test_no_overlaps(self):
+        mc = hpmc.integrate.sphere(seed=10, event_chain=True)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_params(chain_length=2.0)
+        self.assertAlmostEqual(mc.cpp_integrator.getChainLength(), 2.0)
+
+        snap_old = self.system.take_snapshot()
+        hoomd.run(20)
+        snap_new = self.system.take_snapshot()
+
+        self.assertEqual(mc.count_overlaps(), 0)
+
+        # every translation in an event chain is accepted
+        counters = mc.get_counters()
+        self.assertGreater(counters['translate_accept_count'], 0)
+
+        if hoomd.comm.get_rank() == 0:
+            moved = sum(1 for p_old, p_new in zip(snap_old.particles.position, snap_new.particles.position)
+                        if any(abs(a - b) > 1e-3 for a, b in zip(p_old, p_new)))
+            self.assertGreater(moved, 0)
+
+    def test_no_chains(self):
+        mc = hpmc.integrate.sphere(seed=10, event_chain=True)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_params(chain_length=0.0)
+
+        snap_old = self.system.take_snapshot()
+        hoomd.run(5)
+        snap_new = self.system.take_snapshot()
+
+        if hoomd.comm.get_rank() == 0:
+            for p_old, p_new in zip(snap_old.particles.position, snap_new.particles.position):
+                for a, b in zip(p_old, p_new):
+                    self.assertAlmostEqual(a, b, places=5)
+
+    def test_implicit(self):
+        with self.assertRaises(RuntimeError):
+            hpmc.integrate.sphere(seed=10, event_chain=True, implicit=True)
+
+class event_chain_pressure_test(unittest.TestCase):
+
+    def setUp(self):
+        # hard spheres at packing fraction 0.3
+        self.eta = 0.3
+        a = (math.pi/(6*self.eta))**(1/3)
+        self.system = init.create_lattice(unitcell=lattice.sc(a=a), n=6)
+
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.hpmc-test-event-chain-sdf')
+            self.tmp_file = tmp[1]
+        else:
+            self.tmp_file = "invalid"
+
+    def tearDown(self):
+        del self.system
+        context.initialize()
+
+        if hoomd.comm.get_rank() == 0:
+            os.remove(self.tmp_file)
+
+    def test_carnahan_starling(self):
+        mc = hpmc.integrate.sphere(seed=10, event_chain=True)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_params(chain_length=2.0)
+
+        # equilibrate, then sample the scale distribution function
+        hoomd.run(1000)
+        self.assertEqual(mc.count_overlaps(), 0)
+
+        xmax = 0.02
+        dx = 1e-3
+        hpmc.analyze.sdf(mc=mc, filename=self.tmp_file, xmax=xmax, dx=dx, navg=100, period=10)
+        hoomd.run(3000)
+
+        if hoomd.comm.get_rank() == 0:
+            r = numpy.loadtxt(self.tmp_file, ndmin=2)
+            s = numpy.mean(r[:, 1:], axis=0)
+
+            # beta P / rho = 1 + s(0+)/(2d), extrapolate s to contact
+            x = (numpy.arange(s.size) + 0.5)*dx
+            s0 = numpy.polyval(numpy.polyfit(x, s, 2), 0.0)
+            betaP_rho = 1 + s0/6
+
+            eta = self.eta
+            betaP_rho_cs = (1 + eta + eta**2 - eta**3)/(1 - eta)**3
+            self.assertLess(abs(betaP_rho - betaP_rho_cs)/betaP_rho_cs, 0.05)
+
+class event_chain_polyhedron_test(unittest.TestCase):
+
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sc(a=1.6), n=4)
+        self.verts = [(-0.5,-0.5,-0.5), (0.5,-0.5,-0.5), (0.5,0.5,-0.5), (-0.5,0.5,-0.5),
+                      (-0.5,-0.5,0.5), (0.5,-0.5,0.5), (0.5,0.5,0.5), (-0.5,0.5,0.5)]
+
+    def tearDown(self):
+        del self.system
+        context.initialize()
+
+    def test_convex_polyhedron(self):
+        mc = hpmc.integrate.convex_polyhedron(seed=10, a=0.1, event_chain=True)
+        mc.shape_param.set('A', vertices=self.verts)
+        hoomd.run(20)
+        self.assertEqual(mc.count_overlaps(), 0)
+
+        counters = mc.get_counters()
+        self.assertGreater(counters['translate_accept_count'], 0)
+        self.assertGreater(counters['rotate_accept_count'], 0)
+
+    def test_convex_spheropolyhedron(self):
+        mc = hpmc.integrate.convex_spheropolyhedron(seed=10, a=0.1, event_chain=True)
+        mc.shape_param.set('A', vertices=self.verts, sweep_radius=0.1)
+        hoomd.run(20)
+        self.assertEqual(mc.count_overlaps(), 0)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
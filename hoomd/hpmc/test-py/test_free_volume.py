@@ -0,0 +1,46 @@
+from __future__ import print_function
+from __future__ import division
+from hoomd import *
+from hoomd import hpmc
+import math
+import unittest
+
+context.initialize()
+
+# the free volume around a single particle is known exactly
+class free_volume_test(unittest.TestCase):
+    def tearDown(self):
+        del self.free_volume
+        del self.log
+        del self.mc
+        del self.system
+        context.initialize();
+
+    def setup_system(self, dimensions):
+        L = 10
+        snap = data.make_snapshot(N=1, box=data.boxdim(L=L, dimensions=dimensions), particle_types=['A','B'])
+        self.system = init.read_snapshot(snap)
+
+        self.mc = hpmc.integrate.sphere(seed=123)
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.shape_param.set('B', diameter=1.0)
+
+        self.free_volume = hpmc.compute.free_volume(mc=self.mc, seed=987, nsample=100000, test_type='B')
+        self.log = analyze.log(filename=None, quantities=['hpmc_free_volume'], period=1)
+
+    def test_sphere(self):
+        self.setup_system(3)
+        run(1)
+
+        V_free = self.log.query('hpmc_free_volume')
+        self.assertAlmostEqual(V_free, 1000 - 4*math.pi/3, delta=1.0)
+
+    def test_disk(self):
+        self.setup_system(2)
+        run(1)
+
+        V_free = self.log.query('hpmc_free_volume')
+        self.assertAlmostEqual(V_free, 100 - math.pi, delta=0.5)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -4,6 +4,8 @@ from hoomd import hpmc
 import unittest
 import os
 import numpy
+import shutil
+import tempfile
 
 context.initialize()
 
@@ -33,6 +35,37 @@ class polyhedron_test(unittest.TestCase):
         # verify that the spheres are overlapping
         self.assertEqual(self.mc.count_overlaps(), 1);
 
+    # shape parameters are loaded from the cache
+    def test_cache_dir(self):
+        self.system.particles[0].position = (0,0,0)
+        self.system.particles[0].orientation = (1,0,0,0)
+        self.system.particles[1].position = (0.9,0,0)
+        self.system.particles[1].orientation = (1,0,0,0)
+
+        cache_dir = tempfile.mkdtemp()
+        try:
+            cube_verts = [(-0.5,-0.5,-0.5),(-0.5,-0.5,0.5),(-0.5,0.5,-0.5),(-0.5,0.5,0.5),
+                          (0.5,-0.5,-0.5),(0.5,-0.5,0.5),(0.5,0.5,-0.5),(0.5,0.5,0.5)]
+            cube_faces = [[0,2,6],[6,4,0],[5,0,4],[5,1,0],[5,4,6],[5,6,7],
+                          [3,2,0],[3,0,1],[3,6,2],[3,7,6],[3,1,5],[3,5,7]]
+
+            # the first call builds and stores the parameters, the second loads them
+            for i in range(2):
+                self.mc.shape_param.set('A', vertices=cube_verts, faces=cube_faces, cache_dir=cache_dir)
+                run(1)
+                self.assertEqual(self.mc.count_overlaps(), 1);
+                if comm.get_rank() == 0:
+                    self.assertEqual(len(os.listdir(cache_dir)), 1)
+
+            # a different shape gets its own entry
+            self.mc.shape_param.set('A', vertices=cube_verts, faces=cube_faces, sweep_radius=0.01,
+                                    cache_dir=cache_dir)
+            if comm.get_rank() == 0:
+                self.assertEqual(len(os.listdir(cache_dir)), 2)
+        finally:
+            if comm.get_rank() == 0:
+                shutil.rmtree(cache_dir)
+
     def tearDown(self):
         del self.mc
         del self.system
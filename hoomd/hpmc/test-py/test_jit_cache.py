@@ -0,0 +1,69 @@
+from __future__ import division
+from __future__ import print_function
+
+import hoomd
+from hoomd import context, data, init, analyze
+from hoomd import hpmc, jit
+from hoomd.jit import _jit
+
+import os
+import shutil
+import tempfile
+import unittest
+
+context.initialize();
+
+class jit_cache_test(unittest.TestCase):
+    def setUp(self):
+        self.cache_dir = tempfile.mkdtemp(suffix='.hpmc-test-jit-cache');
+        self.lj = """float rsq = dot(r_ij, r_ij);
+                     if (rsq < 6.25f)
+                         {
+                         float r6inv = 1.0f / (rsq*rsq*rsq);
+                         return 4.0f * r6inv * (r6inv - 1.0f);
+                         }
+                     else
+                         return 0.0f;
+                  """;
+
+    def tearDown(self):
+        shutil.rmtree(self.cache_dir);
+        context.initialize();
+
+    # build the patch on a fresh system and return its energy
+    def patch_energy(self):
+        context.initialize();
+        snapshot = data.make_snapshot(N=2, box=data.boxdim(L=10, dimensions=3), particle_types=['A']);
+        snapshot.particles.position[0,:] = (0,0,0);
+        snapshot.particles.position[1,:] = (1.2,0,0);
+        init.read_snapshot(snapshot);
+
+        mc = hpmc.integrate.sphere(seed=10, d=0);
+        mc.shape_param.set('A', diameter=1);
+        patch = jit.patch.user(mc=mc, r_cut=2.5, code=self.lj, cache_dir=self.cache_dir);
+        log = analyze.log(filename=None, quantities=['hpmc_patch_energy'], period=None, overwrite=True);
+        hoomd.run(1, quiet=True);
+        return log.query('hpmc_patch_energy');
+
+    def test_reuse(self):
+        if not _jit.isObjectCacheSupported():
+            self.skipTest('The object cache requires LLVM 5 or newer');
+
+        energy = self.patch_energy();
+        objects = [f for f in os.listdir(self.cache_dir) if f.endswith('.o')];
+        self.assertEqual(len(objects), 1);
+        stat = os.stat(os.path.join(self.cache_dir, objects[0]));
+
+        # the second build loads the object instead of writing a new one
+        energy2 = self.patch_energy();
+        self.assertEqual(sorted(os.listdir(self.cache_dir)), objects);
+        stat2 = os.stat(os.path.join(self.cache_dir, objects[0]));
+        self.assertEqual(stat.st_ino, stat2.st_ino);
+        self.assertEqual(stat.st_mtime, stat2.st_mtime);
+
+        self.assertEqual(energy, energy2);
+        r6inv = 1/1.2**6;
+        self.assertAlmostEqual(energy, 4*r6inv*(r6inv - 1), places=5);
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
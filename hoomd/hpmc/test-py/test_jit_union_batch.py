@@ -0,0 +1,87 @@
+from __future__ import division
+from __future__ import print_function
+
+import hoomd
+from hoomd import context, data, init, analyze
+from hoomd import hpmc, jit
+
+import math
+import os
+import re
+import tempfile
+import unittest
+
+context.initialize();
+
+class jit_union_batch_test(unittest.TestCase):
+    def setUp(self):
+        self.lj = """float rsq = dot(r_ij, r_ij);
+                     if (rsq < 6.25f)
+                         {
+                         float r6inv = 1.0f / (rsq*rsq*rsq);
+                         return 4.0f * r6inv * (r6inv - 1.0f);
+                         }
+                     else
+                         return 0.0f;
+                  """;
+
+        # eight constituents in leaves of two, so that many pairs are evaluated in every batch
+        self.positions = [(-0.5,0,0), (0.5,0,0), (0,-0.5,0), (0,0.5,0),
+                          (0,0,-0.5), (0,0,0.5), (0.3,0.3,0.3), (-0.3,-0.3,-0.3)];
+        self.separation = 2.2;
+
+    def tearDown(self):
+        context.initialize();
+
+    # compute the energy of two unions with the given constituent IR, also return the patch
+    def union_energy(self, **kwargs):
+        context.initialize();
+        snapshot = data.make_snapshot(N=2, box=data.boxdim(L=20, dimensions=3), particle_types=['A']);
+        snapshot.particles.position[0,:] = (0,0,0);
+        snapshot.particles.position[1,:] = (self.separation,0,0);
+        init.read_snapshot(snapshot);
+
+        mc = hpmc.integrate.sphere(seed=10, d=0);
+        mc.shape_param.set('A', diameter=0);
+        patch = jit.patch.user_union(mc=mc, r_cut=2.5, **kwargs);
+        patch.set_params('A', positions=self.positions, typeids=[0]*len(self.positions), leaf_capacity=2);
+        log = analyze.log(filename=None, quantities=['hpmc_patch_energy'], period=None, overwrite=True);
+        hoomd.run(1, quiet=True);
+        return log.query('hpmc_patch_energy'), patch;
+
+    # the same energy summed over all constituent pairs in python
+    def reference_energy(self):
+        energy = 0;
+        for a in self.positions:
+            for b in self.positions:
+                r = math.sqrt((b[0] + self.separation - a[0])**2 + (b[1] - a[1])**2 + (b[2] - a[2])**2);
+                if r < 2.5:
+                    energy += 4 * r**-6 * (r**-6 - 1);
+        return energy;
+
+    def test_batch_and_scalar(self):
+        # code is compiled with eval_batch
+        energy_batch, patch = self.union_energy(code=self.lj);
+
+        # remove eval_batch from the IR to evaluate every pair with eval
+        llvm_ir = patch.compile_user(1, 1, self.lj, 'clang');
+        self.assertIn('@eval_batch(', llvm_ir);
+        llvm_ir = re.sub(r'\ndefine [^\n]*@eval_batch\(.*?\n}\n', '\n', llvm_ir, flags=re.DOTALL);
+        self.assertNotIn('@eval_batch(', llvm_ir);
+
+        fd, fn = tempfile.mkstemp(suffix='.ll');
+        with os.fdopen(fd, 'w') as f:
+            f.write(llvm_ir);
+        try:
+            energy_scalar, patch = self.union_energy(llvm_ir_file=fn);
+        finally:
+            os.remove(fn);
+
+        reference = self.reference_energy();
+        self.assertNotEqual(reference, 0);
+        self.assertAlmostEqual(energy_batch, reference, places=4);
+        self.assertAlmostEqual(energy_scalar, reference, places=4);
+        self.assertAlmostEqual(energy_batch, energy_scalar, places=5);
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
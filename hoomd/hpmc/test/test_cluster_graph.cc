@@ -0,0 +1,85 @@
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/UpdaterClusters.h"
+
+#include <vector>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Check that the components are the given ones, in order
+void check_components(const std::vector<unsigned int>& members,
+                      const std::vector<unsigned int>& offsets,
+                      const std::vector< std::vector<unsigned int> >& expected)
+    {
+    CHECK_EQUAL_UINT(offsets.size(), expected.size()+1);
+    for (unsigned int c = 0; c < expected.size(); ++c)
+        {
+        CHECK_EQUAL_UINT(offsets[c+1] - offsets[c], expected[c].size());
+        for (unsigned int k = 0; k < expected[c].size(); ++k)
+            UP_ASSERT_EQUAL(members[offsets[c]+k], expected[c][k]);
+        }
+    }
+
+UP_TEST( no_edges )
+    {
+    Graph G(4);
+    std::vector<unsigned int> members, offsets;
+    G.connectedComponents(members, offsets);
+
+    check_components(members, offsets, {{0}, {1}, {2}, {3}});
+    }
+
+UP_TEST( components )
+    {
+    Graph G(8);
+    G.addEdge(5,2);
+    G.addEdge(7,3);
+    G.addEdge(2,6);
+    G.addEdge(6,5);
+    G.addEdge(3,7);
+    G.addEdge(4,4);
+    G.addEdge(1,6);
+
+    std::vector<unsigned int> members, offsets;
+    G.connectedComponents(members, offsets);
+
+    check_components(members, offsets, {{0}, {1,2,5,6}, {3,7}, {4}});
+    }
+
+UP_TEST( resize )
+    {
+    Graph G(3);
+    G.addEdge(0,2);
+
+    // resizing removes all edges
+    G.resize(5);
+    G.addEdge(4,1);
+
+    std::vector<unsigned int> members, offsets;
+    G.connectedComponents(members, offsets);
+
+    check_components(members, offsets, {{0}, {1,4}, {2}, {3}});
+    }
+
+UP_TEST( chain )
+    {
+    // a long chain, with edges added from both ends
+    const unsigned int n = 10000;
+    Graph G(n);
+    for (unsigned int i = 0; i < n/2; ++i)
+        {
+        G.addEdge(i, i+1);
+        G.addEdge(n-i-1, n-i-2);
+        }
+
+    std::vector<unsigned int> members, offsets;
+    G.connectedComponents(members, offsets);
+
+    CHECK_EQUAL_UINT(offsets.size(), 2);
+    UP_ASSERT_EQUAL(offsets[1], n);
+    for (unsigned int i = 0; i < n; ++i)
+        UP_ASSERT_EQUAL(members[i], i);
+    }
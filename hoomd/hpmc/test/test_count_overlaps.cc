@@ -0,0 +1,159 @@
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/SnapshotSystemData.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <memory>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Sphere integrator that gives the tests access to the overlap hints
+class IntegratorHPMCMonoSphereHints : public IntegratorHPMCMono<ShapeSphere>
+    {
+    public:
+        //! Constructor
+        IntegratorHPMCMonoSphereHints(std::shared_ptr<SystemDefinition> sysdef, unsigned int seed)
+            : IntegratorHPMCMono<ShapeSphere>(sysdef, seed)
+            {
+            }
+
+        //! Get the tags of the particles in the most recently found overlaps
+        std::vector<unsigned int>& getOverlapHints()
+            {
+            return m_overlap_hint;
+            }
+    };
+
+//! Build a simple cubic lattice of 216 unit spheres that do not overlap
+/*!
+ * Particle i is at lattice site (i % 6, (i/6) % 6, i/36), so particles i and i+1 are neighbors along x
+ * unless i % 6 == 5.
+ */
+std::shared_ptr<IntegratorHPMCMonoSphereHints> make_lattice(std::shared_ptr<SystemDefinition>& sysdef)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    #ifdef ENABLE_TBB
+    // scan with several threads so that the threads cancel each other
+    exec_conf->setNumThreads(4);
+    #endif
+
+    const unsigned int n = 6;
+    const Scalar a = 1.2;
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(n*a);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(n*n*n);
+    for (unsigned int i=0; i < n*n*n; ++i)
+        {
+        snap->particle_data.pos[i] = vec3<Scalar>(a*(i % n) - 0.5*n*a + 0.5*a,
+                                                  a*((i/n) % n) - 0.5*n*a + 0.5*a,
+                                                  a*(i/(n*n)) - 0.5*n*a + 0.5*a);
+        }
+    sysdef = std::shared_ptr<SystemDefinition>(new SystemDefinition(snap, exec_conf));
+
+    std::shared_ptr<IntegratorHPMCMonoSphereHints> mc(new IntegratorHPMCMonoSphereHints(sysdef, 123));
+    sph_params params;
+    params.radius = 0.5;
+    params.ignore = 0;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    mc->prepRun(0);
+    return mc;
+    }
+
+//! Move a particle along x from its lattice site
+void shift_particle(std::shared_ptr<SystemDefinition> sysdef,
+                    std::shared_ptr<IntegratorHPMCMonoSphereHints> mc,
+                    unsigned int tag,
+                    Scalar dx)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    const Scalar3 pos = pdata->getPosition(tag);
+    pdata->setPosition(tag, make_scalar3(pos.x + dx, pos.y, pos.z), false);
+    mc->invalidateAABBTree();
+    }
+
+//! Get the overlap hints in increasing order
+std::vector<unsigned int> sorted_hints(std::shared_ptr<IntegratorHPMCMonoSphereHints> mc, unsigned int n)
+    {
+    std::vector<unsigned int> hints(mc->getOverlapHints().begin(), mc->getOverlapHints().begin() + n);
+    std::sort(hints.begin(), hints.end());
+    return hints;
+    }
+
+//! Test that the early exit finds overlaps, checking the most recent overlaps first
+UP_TEST( count_overlaps_early_exit )
+    {
+    std::shared_ptr<SystemDefinition> sysdef;
+    std::shared_ptr<IntegratorHPMCMonoSphereHints> mc = make_lattice(sysdef);
+
+    // the lattice does not overlap
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 0);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), 0);
+    UP_ASSERT(mc->getOverlapHints().empty());
+
+    // one overlapping pair is found by the parallel scan and becomes the hint
+    shift_particle(sysdef, mc, 100, 0.5);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), 1);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+    UP_ASSERT_EQUAL(mc->getOverlapHints().size(), 2);
+    UP_ASSERT(sorted_hints(mc, 2) == std::vector<unsigned int>({100,101}));
+
+    // with a second pair, the hinted pair is still found first
+    shift_particle(sysdef, mc, 200, 0.5);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), 2);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+    UP_ASSERT_EQUAL(mc->getOverlapHints().size(), 2);
+    UP_ASSERT(sorted_hints(mc, 2) == std::vector<unsigned int>({100,101}));
+
+    // once the hinted pair is resolved, the scan finds the other pair and puts it in front
+    shift_particle(sysdef, mc, 100, -0.5);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), 1);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+    UP_ASSERT_EQUAL(mc->getOverlapHints().size(), 4);
+    UP_ASSERT(sorted_hints(mc, 2) == std::vector<unsigned int>({200,201}));
+
+    // no overlaps are left, and the stale hints are harmless
+    shift_particle(sysdef, mc, 200, -0.5);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 0);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), 0);
+    }
+
+//! Test that hints of removed particles are skipped or dropped
+UP_TEST( count_overlaps_hints_removed )
+    {
+    std::shared_ptr<SystemDefinition> sysdef;
+    std::shared_ptr<IntegratorHPMCMonoSphereHints> mc = make_lattice(sysdef);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    shift_particle(sysdef, mc, 214, 0.5);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+    UP_ASSERT(sorted_hints(mc, 2) == std::vector<unsigned int>({214,215}));
+
+    // hints beyond the end of the reverse tag array are skipped
+    mc->getOverlapHints().insert(mc->getOverlapHints().begin(), pdata->getRTags().getNumElements() + 100);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+
+    // removing a particle drops all hints
+    pdata->removeParticle(215);
+    UP_ASSERT(mc->getOverlapHints().empty());
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 0);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), 0);
+
+    // hints of removed particles that are still in the reverse tag array are skipped
+    mc->getOverlapHints().push_back(215);
+    shift_particle(sysdef, mc, 0, 0.5);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+    UP_ASSERT(sorted_hints(mc, 2) == std::vector<unsigned int>({0,1}));
+    }
@@ -0,0 +1,148 @@
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/OBBTree.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Random triangles in a slab, as an elongated stand-in for the faces of a polyhedron
+std::vector<std::vector<vec3<OverlapReal> > > random_triangles(unsigned int N, unsigned int seed)
+    {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<OverlapReal> pos(-1.0, 1.0);
+    std::uniform_real_distribution<OverlapReal> offset(-0.1, 0.1);
+
+    std::vector<std::vector<vec3<OverlapReal> > > triangles(N);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        vec3<OverlapReal> c(4*pos(rng), pos(rng), OverlapReal(0.25)*pos(rng));
+        for (unsigned int k = 0; k < 3; ++k)
+            triangles[i].push_back(c + vec3<OverlapReal>(offset(rng), offset(rng), offset(rng)));
+        }
+    return triangles;
+    }
+
+//! Build a tree of the given triangles
+void build_tree(OBBTree& tree, const std::vector<std::vector<vec3<OverlapReal> > >& triangles, OBBTreeBuild build)
+    {
+    unsigned int N = triangles.size();
+    std::vector<OBB> obbs(N);
+    std::vector<std::vector<vec3<OverlapReal> > > internal_coordinates(triangles);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        std::vector<OverlapReal> vertex_radii(3, 0.0);
+        obbs[i] = compute_obb(triangles[i], vertex_radii, false);
+        }
+    tree.buildTree(&obbs[0], internal_coordinates, 0.0, N, 4, build);
+    }
+
+//! Collect the members of all leaves overlapping the query
+void query(const OBBTree& tree, unsigned int node, const OBB& obb, std::vector<unsigned int>& hits)
+    {
+    if (!overlap(tree.getNodeOBB(node), obb))
+        return;
+
+    if (tree.isNodeLeaf(node))
+        {
+        for (unsigned int j = 0; j < tree.getNodeNumParticles(node); ++j)
+            hits.push_back(tree.getNodeParticle(node, j));
+        }
+    else
+        {
+        query(tree, tree.getNodeLeft(node), obb, hits);
+        query(tree, tree.getNode(node).right, obb, hits);
+        }
+    }
+
+//! Check that every triangle is stored once, in a leaf of at most the leaf capacity
+void check_members(const OBBTree& tree, unsigned int N)
+    {
+    std::vector<unsigned int> members;
+    for (unsigned int i = 0; i < tree.getNumNodes(); ++i)
+        {
+        if (tree.isNodeLeaf(i))
+            {
+            UP_ASSERT(tree.getNodeNumParticles(i) <= tree.getLeafNodeCapacity());
+            for (unsigned int j = 0; j < tree.getNodeNumParticles(i); ++j)
+                members.push_back(tree.getNodeParticle(i, j));
+            }
+        }
+    std::sort(members.begin(), members.end());
+    UP_ASSERT_EQUAL(members.size(), N);
+    for (unsigned int i = 0; i < members.size(); ++i)
+        UP_ASSERT_EQUAL(members[i], i);
+    }
+
+//! Trees built with all strategies store every member once
+UP_TEST( build_strategies )
+    {
+    const unsigned int N = 500;
+    std::vector<std::vector<vec3<OverlapReal> > > triangles = random_triangles(N, 123);
+
+    OBBTree tree_mean, tree_sah, tree_best;
+    build_tree(tree_mean, triangles, OBB_BUILD_MEAN);
+    build_tree(tree_sah, triangles, OBB_BUILD_SAH);
+    build_tree(tree_best, triangles, OBB_BUILD_BEST);
+
+    check_members(tree_mean, N);
+    check_members(tree_sah, N);
+    check_members(tree_best, N);
+
+    UP_ASSERT_EQUAL(tree_mean.getBuildStrategy(), OBB_BUILD_MEAN);
+    UP_ASSERT_EQUAL(tree_sah.getBuildStrategy(), OBB_BUILD_SAH);
+
+    // the best tree is the cheaper one
+    OverlapReal cost_mean = tree_mean.getExpectedCost();
+    OverlapReal cost_sah = tree_sah.getExpectedCost();
+    UP_ASSERT(cost_mean > 0);
+    UP_ASSERT(cost_sah > 0);
+    MY_CHECK_CLOSE(tree_best.getExpectedCost(), std::min(cost_mean, cost_sah), tol);
+    }
+
+//! All strategies find the same overlapping members
+UP_TEST( query_equivalence )
+    {
+    const unsigned int N = 300;
+    std::vector<std::vector<vec3<OverlapReal> > > triangles = random_triangles(N, 456);
+
+    std::vector<OBB> obbs(N);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        std::vector<OverlapReal> vertex_radii(3, 0.0);
+        obbs[i] = compute_obb(triangles[i], vertex_radii, false);
+        }
+
+    OBBTree tree_mean, tree_sah;
+    build_tree(tree_mean, triangles, OBB_BUILD_MEAN);
+    build_tree(tree_sah, triangles, OBB_BUILD_SAH);
+
+    std::mt19937 rng(789);
+    std::uniform_real_distribution<OverlapReal> pos(-1.0, 1.0);
+    for (unsigned int q = 0; q < 100; ++q)
+        {
+        OBB query_obb(vec3<OverlapReal>(4*pos(rng), pos(rng), pos(rng)), OverlapReal(0.3));
+        query_obb.is_sphere = 0;
+
+        std::vector<unsigned int> expected;
+        for (unsigned int i = 0; i < N; ++i)
+            if (overlap(obbs[i], query_obb))
+                expected.push_back(i);
+
+        std::vector<unsigned int> hits_mean, hits_sah;
+        query(tree_mean, 0, query_obb, hits_mean);
+        query(tree_sah, 0, query_obb, hits_sah);
+
+        // the tree queries return candidates, which must include every overlapping member
+        for (unsigned int i = 0; i < expected.size(); ++i)
+            {
+            UP_ASSERT(std::find(hits_mean.begin(), hits_mean.end(), expected[i]) != hits_mean.end());
+            UP_ASSERT(std::find(hits_sah.begin(), hits_sah.end(), expected[i]) != hits_sah.end());
+            }
+        }
+    }
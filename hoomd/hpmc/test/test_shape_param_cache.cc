@@ -0,0 +1,122 @@
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/ShapeParamCache.h"
+
+#include <iostream>
+#include <string>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <memory>
+
+using namespace hpmc;
+using namespace std;
+using namespace hpmc::detail;
+
+//! Build a union of spheres on a line
+ShapeUnion<ShapeSpheropolyhedron>::param_type make_union(unsigned int N)
+    {
+    ShapeUnion<ShapeSpheropolyhedron>::param_type data(N, false);
+    OBB *obbs = new OBB[N];
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        data.mparams[i] = poly3d_verts(1, false);
+        data.mparams[i].x[0] = data.mparams[i].y[0] = data.mparams[i].z[0] = 0;
+        data.mparams[i].sweep_radius = 0.5;
+        data.mparams[i].diameter = 1.0;
+        data.mpos[i] = vec3<OverlapReal>(OverlapReal(i), 0, 0);
+        data.morientation[i] = quat<OverlapReal>();
+        data.moverlap[i] = i;
+        obbs[i] = OBB(data.mpos[i], 0.5);
+        }
+    data.diameter = OverlapReal(N);
+    data.ignore = 0;
+
+    OBBTree tree;
+    tree.buildTree(obbs, N, 4, true);
+    delete [] obbs;
+    data.tree = GPUTree(tree);
+    return data;
+    }
+
+//! Serialized parameters read back identically
+UP_TEST( round_trip )
+    {
+    const unsigned int N = 25;
+    ShapeUnion<ShapeSpheropolyhedron>::param_type data = make_union(N);
+
+    std::string blob = serialize_shape_param(data);
+
+    ShapeUnion<ShapeSpheropolyhedron>::param_type copy;
+    UP_ASSERT(deserialize_shape_param(blob.data(), blob.size(), copy, false));
+
+    UP_ASSERT_EQUAL(copy.N, N);
+    UP_ASSERT_EQUAL(copy.diameter, data.diameter);
+    UP_ASSERT_EQUAL(copy.mparams.size(), N);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        UP_ASSERT_EQUAL(copy.mpos[i].x, data.mpos[i].x);
+        UP_ASSERT_EQUAL(copy.moverlap[i], data.moverlap[i]);
+        UP_ASSERT_EQUAL(copy.mparams[i].N, data.mparams[i].N);
+        UP_ASSERT_EQUAL(copy.mparams[i].sweep_radius, data.mparams[i].sweep_radius);
+        UP_ASSERT_EQUAL(copy.mparams[i].x.size(), data.mparams[i].x.size());
+        }
+
+    UP_ASSERT_EQUAL(copy.tree.getNumNodes(), data.tree.getNumNodes());
+    UP_ASSERT_EQUAL(copy.tree.getNumLeaves(), data.tree.getNumLeaves());
+    for (unsigned int i = 0; i < data.tree.getNumNodes(); ++i)
+        {
+        UP_ASSERT_EQUAL(copy.tree.getLeftChild(i), data.tree.getLeftChild(i));
+        UP_ASSERT_EQUAL(copy.tree.getEscapeIndex(i), data.tree.getEscapeIndex(i));
+        UP_ASSERT_EQUAL(copy.tree.getNumParticles(i), data.tree.getNumParticles(i));
+        }
+
+    // the copy behaves like the original
+    ShapeUnion<ShapeSpheropolyhedron> a(quat<Scalar>(), data);
+    ShapeUnion<ShapeSpheropolyhedron> b(quat<Scalar>(), copy);
+    unsigned int err = 0;
+    UP_ASSERT(test_overlap(vec3<Scalar>(0, 0.9, 0), a, b, err));
+    UP_ASSERT(!test_overlap(vec3<Scalar>(0, 1.1, 0), a, b, err));
+    }
+
+//! Data from a different format version is rejected
+UP_TEST( version_mismatch )
+    {
+    ShapeUnion<ShapeSpheropolyhedron>::param_type data = make_union(3);
+    std::string blob = serialize_shape_param(data);
+
+    ShapeUnion<ShapeSpheropolyhedron>::param_type copy;
+    std::string bad_magic(blob);
+    bad_magic[0] = 'X';
+    UP_ASSERT(!deserialize_shape_param(bad_magic.data(), bad_magic.size(), copy, false));
+
+    std::string bad_version(blob);
+    bad_version[sizeof(shape_param_cache_magic)] += 1;
+    UP_ASSERT(!deserialize_shape_param(bad_version.data(), bad_version.size(), copy, false));
+
+    // truncated data
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ deserialize_shape_param(blob.data(), blob.size()/2, copy, false); });
+    }
+
+//! Parameters are stored in and loaded from files
+UP_TEST( files )
+    {
+    ShapeUnion<ShapeSpheropolyhedron>::param_type data = make_union(10);
+    std::string blob = serialize_shape_param(data);
+
+    std::string fname("test_shape_param_cache.hpmc");
+    UP_ASSERT(store_shape_param(fname, blob));
+
+    ShapeUnion<ShapeSpheropolyhedron>::param_type copy;
+    std::string file_blob;
+    UP_ASSERT(load_shape_param(fname, copy, false, &file_blob));
+    UP_ASSERT(file_blob == blob);
+    UP_ASSERT_EQUAL(copy.N, data.N);
+    UP_ASSERT_EQUAL(copy.tree.getNumNodes(), data.tree.getNumNodes());
+    remove(fname.c_str());
+
+    UP_ASSERT(!load_shape_param(fname, copy, false, NULL));
+    }
@@ -722,13 +722,21 @@ class muvt(_updater):
         fugacity_variant = hoomd.variant._setup_variant_input(fugacity);
         self.cpp_updater.setFugacity(type_id, fugacity_variant.cpp_variant);
 
-    def set_params(self, dV=None, move_ratio=None, transfer_ratio=None):
+    def set_params(self, dV=None, move_ratio=None, transfer_ratio=None, cavity_width=None):
         R""" Set muVT parameters.
 
         Args:
             dV (float): (if set) Set volume rescaling factor (dimensionless)
             move_ratio (float): (if set) Set the ratio between volume and exchange/transfer moves (applies to Gibbs ensemble)
             transfer_ratio (float): (if set) Set the ratio between transfer and exchange moves
+            cavity_width (float): (if set) Cell width for cavity-biased insertion, 0 to insert uniformly in the box
+
+        With cavity-biased insertion, the box is divided into cells of roughly *cavity_width*. Cells in which
+        every insertion is certain to overlap, judged from the insphere radii of the shapes, are excluded and
+        particles are only inserted into the remaining cavities. The acceptance criterion is corrected by the
+        fraction of the volume that is cavity. This raises the insertion acceptance in dense systems. Cavity-biased
+        insertion is only supported for spheres, the other shapes do not define an insphere radius. It is not
+        supported with domain decomposition.
 
         Example::
 
@@ -736,6 +744,7 @@ class muvt(_updater):
             muvt.set_params(dV=0.1)
             muvt.set_params(n_trial=2)
             muvt.set_params(move_ratio=0.05)
+            muvt.set_params(cavity_width=0.5)
 
         """
         hoomd.util.print_status_line();
@@ -752,6 +761,11 @@ class muvt(_updater):
             self.cpp_updater.setMaxVolumeRescale(float(dV))
         if transfer_ratio is not None:
             self.cpp_updater.setTransferRatio(float(transfer_ratio))
+        if cavity_width is not None:
+            if cavity_width > 0 and not isinstance(self.mc, integrate.sphere):
+                hoomd.context.msg.error("update.muvt: Cavity-biased insertion is only supported for spheres.\n");
+                raise RuntimeError("Error setting muVT parameters");
+            self.cpp_updater.setCavityBias(float(cavity_width))
 
 class remove_drift(_updater):
     R""" Remove the center of mass drift from a system restrained on a lattice.
@@ -250,7 +250,7 @@ def read_snapshot(snapshot):
     _perform_common_init_tasks();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
-def read_gsd(filename, restart = None, frame = 0, time_step = None):
+def read_gsd(filename, restart = None, frame = 0, time_step = None, mmap = False):
     R""" Read initial system state from an GSD file.
 
     Args:
@@ -258,6 +258,7 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
         restart (str): If it exists, read the file *restart* instead of *filename*.
         frame (int): Index of the frame to read from the GSD file. Negative values index from the end of the file.
         time_step (int): (if specified) Time step number to initialize instead of the one stored in the GSD file.
+        mmap (bool): Memory map the file and copy data chunks from the mapping.
 
     All particles, bonds, angles, dihedrals, impropers, constraints, and box information
     are read from the given GSD file at the given frame index. To read and write GSD files
@@ -270,6 +271,10 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     step of the simulation instead of the one read from the GSD file *filename*.
     *time_step* is not applied when the file *restart* is read.
 
+    Set *mmap* to True to map the file into memory instead of reading each data chunk with a separate system
+    call. The data chunks are still copied from the mapping into the snapshot. The mapping is kept open while the reader restores the state of other
+    objects (such as HPMC shape parameters) after initialization.
+
     The result of :py:func:`hoomd.init.read_gsd` can be saved in a variable and later used to read and/or
     change particle properties later in the script. See :py:mod:`hoomd.data` for more information.
 
@@ -288,10 +293,10 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     restart = _hoomd.mpi_bcast_str(restart, hoomd.context.exec_conf);
 
     if restart is not None and os.path.exists(restart):
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0, mmap);
         time_step = reader.getTimeStep();
     else:
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0, mmap);
         if time_step is None:
             time_step = reader.getTimeStep();
 
@@ -314,6 +319,47 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     hoomd.context.current.state_reader.clearSnapshot();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
+def read_checkpoint(filename):
+    R""" Restore the system state from a native checkpoint.
+
+    Args:
+        filename (str): Base file name of the checkpoint written by :py:class:`hoomd.dump.checkpoint`.
+
+    All particles, bonded groups, the box, the domain decomposition, and the integrator variables are restored from
+    the checkpoint. Each MPI rank reads only the data it owned when the checkpoint was written, so no data is
+    gathered or scattered. The simulation must run on the same number of ranks that wrote the checkpoint, and any
+    ``decomposition`` set in the script is ignored in favor of the stored one.
+
+    Integrators read their thermostat and barostat state back when they are created in the same order as in the
+    script that wrote the checkpoint.
+
+    The result of :py:func:`hoomd.init.read_checkpoint` can be saved in a variable and later used to read and/or
+    change particle properties later in the script. See :py:mod:`hoomd.data` for more information.
+
+    See Also:
+        :py:class:`hoomd.dump.checkpoint`
+
+    .. versionadded:: 2.9
+    """
+    hoomd.context._verify_init();
+    hoomd.util.print_status_line();
+
+    # check if initialization has already occurred
+    if is_initialized():
+        hoomd.context.msg.error("Cannot initialize more than once\n");
+        raise RuntimeError("Error initializing");
+
+    filename = _hoomd.mpi_bcast_str(filename, hoomd.context.exec_conf);
+
+    reader = _hoomd.CheckpointReader(hoomd.context.exec_conf, filename);
+    hoomd.context.current.system_definition = reader.getSystemDefinition();
+
+    # initialize the system
+    hoomd.context.current.system = _hoomd.System(hoomd.context.current.system_definition, reader.getTimeStep());
+
+    _perform_common_init_tasks();
+    return hoomd.data.system_data(hoomd.context.current.system_definition);
+
 def restore_getar(filename, modes={'any': 'any'}):
     """Restore a subset of the current system's parameters from a
     trajectory archive (.tar, .zip, .sqlite) file. For a detailed
@@ -0,0 +1,72 @@
+#ifndef _COMPILE_JIT_H_
+#define _COMPILE_JIT_H_
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "JITObjectCache.h"
+
+#ifdef ENABLE_MPI
+#include "hoomd/HOOMDMPI.h"
+#endif
+
+#include <memory>
+#include <string>
+
+//! Construct an evaluator factory for LLVM IR
+/*! \param exec_conf The execution configuration
+    \param llvm_ir Contents of the LLVM IR to load
+    \param cache_dir Directory of the on-disk object cache, disabled when empty
+    \tparam Factory EvalFactory or ExternalFieldEvalFactory
+
+    In MPI runs, only the root rank compiles the IR (or loads it from the object cache). The object code is broadcast
+    and the other ranks load it without compiling. The object is compiled for the CPU of the root rank, so this is
+    only done when all ranks run on the same type of CPU. Otherwise, every rank compiles the IR for its own CPU.
+*/
+template<class Factory>
+std::shared_ptr<Factory> compileJIT(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                    const std::string& llvm_ir,
+                                    const std::string& cache_dir)
+    {
+    if (!cache_dir.empty() && !JITObjectCache::isSupported())
+        exec_conf->msg->warning() << "JIT: cache_dir requires LLVM 5 or newer, compiled objects are not cached" << std::endl;
+
+    #ifdef ENABLE_MPI
+    // check that the object of the root rank runs on all ranks
+    bool same_target = false;
+    if (exec_conf->getNRanks() > 1)
+        {
+        std::string host_target = JITObjectCache::getHostTarget();
+        std::string root_target = host_target;
+        bcast(root_target, 0, exec_conf->getMPICommunicator());
+
+        int same = (host_target == root_target);
+        MPI_Allreduce(MPI_IN_PLACE, &same, 1, MPI_INT, MPI_MIN, exec_conf->getMPICommunicator());
+        same_target = same;
+
+        if (!same_target)
+            exec_conf->msg->notice(2) << "JIT: ranks run on different CPUs, compiling on every rank" << std::endl;
+        }
+
+    if (same_target)
+        {
+        std::shared_ptr<Factory> factory;
+        std::string object;
+        if (exec_conf->isRoot())
+            {
+            factory = std::shared_ptr<Factory>(new Factory(llvm_ir, cache_dir));
+            object = factory->getObject();
+            }
+
+        bcast(object, 0, exec_conf->getMPICommunicator());
+
+        // if the root rank failed, every rank compiles and reports the error
+        if (!exec_conf->isRoot())
+            factory = std::shared_ptr<Factory>(new Factory(llvm_ir, "", object));
+
+        return factory;
+        }
+    #endif
+
+    return std::shared_ptr<Factory>(new Factory(llvm_ir, cache_dir));
+    }
+
+#endif // _COMPILE_JIT_H_
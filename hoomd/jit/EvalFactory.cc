@@ -18,10 +18,15 @@
 #include "llvm/Support/raw_os_ostream.h"
 
 //! C'tor
-EvalFactory::EvalFactory(const std::string& llvm_ir)
+/*! \param llvm_ir Contents of the LLVM IR to load
+    \param cache_dir Directory of the on-disk object cache, disabled when empty
+    \param object Compiled object of \a llvm_ir, compile the IR when empty
+*/
+EvalFactory::EvalFactory(const std::string& llvm_ir, const std::string& cache_dir, const std::string& object)
     {
     // set to null pointer
     m_eval = NULL;
+    m_eval_batch = NULL;
 
     // initialize LLVM
     std::ostringstream sstream;
@@ -58,8 +63,10 @@ EvalFactory::EvalFactory(const std::string& llvm_ir)
         return;
         }
 
-    // Build the JIT
-    m_jit = std::unique_ptr<llvm::orc::KaleidoscopeJIT>(new llvm::orc::KaleidoscopeJIT());
+    // Build the JIT, previously compiled objects are looked up by a key of the IR and the target
+    m_cache = std::unique_ptr<JITObjectCache>(new JITObjectCache(cache_dir, object));
+    m_jit = std::unique_ptr<llvm::orc::KaleidoscopeJIT>(new llvm::orc::KaleidoscopeJIT(m_cache.get()));
+    Mod->setModuleIdentifier(JITObjectCache::getKey(llvm_ir, m_jit->getTargetMachine()));
 
     // Add the module, look up main and run it.
     m_jit->addModule(std::move(Mod));
@@ -72,6 +79,9 @@ EvalFactory::EvalFactory(const std::string& llvm_ir)
         return;
         }
 
+    // the batch evaluator is optional, IR compiled outside of HOOMD may only provide eval
+    auto eval_batch = m_jit->findSymbol("eval_batch");
+
     auto alpha = m_jit->findSymbol("alpha_iso");
 
     if (!alpha)
@@ -90,10 +100,14 @@ EvalFactory::EvalFactory(const std::string& llvm_ir)
 
     #if defined LLVM_VERSION_MAJOR && LLVM_VERSION_MAJOR >= 5
     m_eval = (EvalFnPtr)(long unsigned int)(cantFail(eval.getAddress()));
+    if (eval_batch)
+        m_eval_batch = (EvalBatchFnPtr)(long unsigned int)(cantFail(eval_batch.getAddress()));
     m_alpha = (float *)(cantFail(alpha.getAddress()));
     m_alpha_union = (float *)(cantFail(alpha_union.getAddress()));
     #else
     m_eval = (EvalFnPtr) eval.getAddress();
+    if (eval_batch)
+        m_eval_batch = (EvalBatchFnPtr) eval_batch.getAddress();
     m_alpha = (float *) alpha.getAddress();
     m_alpha_union = (float *) alpha_union.getAddress();
     #endif
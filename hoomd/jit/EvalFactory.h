@@ -6,6 +6,7 @@
 #include "hoomd/VectorMath.h"
 
 #include "KaleidoscopeJIT.h"
+#include "JITObjectCache.h"
 
 class EvalFactory
     {
@@ -20,8 +21,20 @@ class EvalFactory
             float d_j,
             float charge_j);
 
+        typedef void (*EvalBatchFnPtr)(unsigned int n,
+            const vec3<float> *r_ij,
+            const unsigned int *type_i,
+            const quat<float> *q_i,
+            const float *d_i,
+            const float *charge_i,
+            const unsigned int *type_j,
+            const quat<float> *q_j,
+            const float *d_j,
+            const float *charge_j,
+            float *energy);
+
         //! Constructor
-        EvalFactory(const std::string& llvm_ir);
+        EvalFactory(const std::string& llvm_ir, const std::string& cache_dir="", const std::string& object="");
 
         //! Return the evaluator
         EvalFnPtr getEval()
@@ -29,6 +42,18 @@ class EvalFactory
             return m_eval;
             }
 
+        //! Return the batch evaluator, NULL if the module does not provide one
+        EvalBatchFnPtr getEvalBatch()
+            {
+            return m_eval_batch;
+            }
+
+        //! Get the compiled object code, to share it with other ranks
+        std::string getObject()
+            {
+            return m_cache ? m_cache->getObjectData() : std::string();
+            }
+
         //! Get the error message from initialization
         const std::string& getError()
             {
@@ -48,8 +73,10 @@ class EvalFactory
             }
 
     private:
+        std::unique_ptr<JITObjectCache> m_cache;          //!< Cache of the compiled object, outlives the JIT engine
         std::unique_ptr<llvm::orc::KaleidoscopeJIT> m_jit; //!< The persistent JIT engine
         EvalFnPtr m_eval;         //!< Function pointer to evaluator
+        EvalBatchFnPtr m_eval_batch; //!< Function pointer to batch evaluator
         float * m_alpha;         // Pointer to alpha array
         float * m_alpha_union;   // Pointer to alpha array for union
         std::string m_error_msg; //!< The error message if initialization fails
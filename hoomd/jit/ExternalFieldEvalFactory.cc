@@ -18,7 +18,11 @@
 #include "llvm/Support/raw_os_ostream.h"
 
 //! C'tor
-ExternalFieldEvalFactory::ExternalFieldEvalFactory(const std::string& llvm_ir)
+/*! \param llvm_ir Contents of the LLVM IR to load
+    \param cache_dir Directory of the on-disk object cache, disabled when empty
+    \param object Compiled object of \a llvm_ir, compile the IR when empty
+*/
+ExternalFieldEvalFactory::ExternalFieldEvalFactory(const std::string& llvm_ir, const std::string& cache_dir, const std::string& object)
     {
     // set to null pointer
     m_eval = NULL;
@@ -58,8 +62,10 @@ ExternalFieldEvalFactory::ExternalFieldEvalFactory(const std::string& llvm_ir)
         return;
         }
 
-    // Build the JIT
-    m_jit = std::unique_ptr<llvm::orc::KaleidoscopeJIT>(new llvm::orc::KaleidoscopeJIT());
+    // Build the JIT, previously compiled objects are looked up by a key of the IR and the target
+    m_cache = std::unique_ptr<JITObjectCache>(new JITObjectCache(cache_dir, object));
+    m_jit = std::unique_ptr<llvm::orc::KaleidoscopeJIT>(new llvm::orc::KaleidoscopeJIT(m_cache.get()));
+    Mod->setModuleIdentifier(JITObjectCache::getKey(llvm_ir, m_jit->getTargetMachine()));
 
     // Add the module, look up main and run it.
     m_jit->addModule(std::move(Mod));
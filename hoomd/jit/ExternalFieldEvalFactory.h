@@ -6,6 +6,7 @@
 #include "hoomd/VectorMath.h"
 
 #include "KaleidoscopeJIT.h"
+#include "JITObjectCache.h"
 
 // Forward declare box class
 class BoxDim;
@@ -22,7 +23,7 @@ class ExternalFieldEvalFactory
             );
 
         //! Constructor
-        ExternalFieldEvalFactory(const std::string& llvm_ir);
+        ExternalFieldEvalFactory(const std::string& llvm_ir, const std::string& cache_dir="", const std::string& object="");
 
         //! Return the evaluator
         ExternalFieldEvalFnPtr getEval()
@@ -30,6 +31,12 @@ class ExternalFieldEvalFactory
             return m_eval;
             }
 
+        //! Get the compiled object code, to share it with other ranks
+        std::string getObject()
+            {
+            return m_cache ? m_cache->getObjectData() : std::string();
+            }
+
         //! Get the error message from initialization
         const std::string& getError()
             {
@@ -37,6 +44,7 @@ class ExternalFieldEvalFactory
             }
 
     private:
+        std::unique_ptr<JITObjectCache> m_cache;          //!< Cache of the compiled object, outlives the JIT engine
         std::unique_ptr<llvm::orc::KaleidoscopeJIT> m_jit; //!< The persistent JIT engine
         ExternalFieldEvalFnPtr m_eval;         //!< Function pointer to evaluator
 
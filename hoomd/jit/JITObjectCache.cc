@@ -0,0 +1,102 @@
+#include "JITObjectCache.h"
+
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+/*! \param llvm_ir Contents of the LLVM IR
+    \param tm Target machine that compiles the module
+    \returns A hexadecimal hash that identifies the compiled object
+*/
+std::string JITObjectCache::getKey(const std::string& llvm_ir, const llvm::TargetMachine& tm)
+    {
+    llvm::MD5 hash;
+    hash.update(llvm_ir);
+    hash.update(LLVM_VERSION_STRING);
+    hash.update(tm.getTargetTriple().str());
+    hash.update(tm.getTargetCPU());
+
+    llvm::MD5::MD5Result result;
+    hash.final(result);
+
+    llvm::SmallString<32> key;
+    llvm::MD5::stringifyResult(result, key);
+    return std::string(key.begin(), key.end());
+    }
+
+/*! \returns True if SimpleCompiler uses the object cache, which requires LLVM 5 or newer
+*/
+bool JITObjectCache::isSupported()
+    {
+    #if defined LLVM_VERSION_MAJOR && LLVM_VERSION_MAJOR >= 5
+    return true;
+    #else
+    return false;
+    #endif
+    }
+
+/*! \returns The target triple and CPU name of the host, objects compiled for it may not run on other CPUs
+*/
+std::string JITObjectCache::getHostTarget()
+    {
+    return llvm::sys::getProcessTriple() + " " + llvm::sys::getHostCPUName().str();
+    }
+
+/*! \param M Module that was compiled
+    \param Obj The compiled object
+*/
+void JITObjectCache::notifyObjectCompiled(const llvm::Module *M, llvm::MemoryBufferRef Obj)
+    {
+    m_object = Obj.getBuffer().str();
+
+    if (m_cache_dir.empty())
+        return;
+
+    // write to a unique temporary file, then move it in place
+    if (llvm::sys::fs::create_directories(m_cache_dir))
+        return;
+
+    int fd;
+    llvm::SmallString<128> tmp_name;
+    if (llvm::sys::fs::createUniqueFile(getFileName(M->getModuleIdentifier()) + "-%%%%%%.tmp", fd, tmp_name))
+        return;
+
+        {
+        llvm::raw_fd_ostream out(fd, true);
+        out << Obj.getBuffer();
+        out.close();
+        if (out.has_error())
+            {
+            out.clear_error();
+            llvm::sys::fs::remove(tmp_name);
+            return;
+            }
+        }
+
+    if (llvm::sys::fs::rename(tmp_name, getFileName(M->getModuleIdentifier())))
+        llvm::sys::fs::remove(tmp_name);
+    }
+
+/*! \param M Module to compile
+    \returns The object of the module, or nullptr to compile the module
+*/
+std::unique_ptr<llvm::MemoryBuffer> JITObjectCache::getObject(const llvm::Module* M)
+    {
+    // use the object given on construction
+    if (!m_object.empty())
+        return llvm::MemoryBuffer::getMemBufferCopy(m_object, M->getModuleIdentifier());
+
+    if (m_cache_dir.empty())
+        return nullptr;
+
+    auto buffer = llvm::MemoryBuffer::getFile(getFileName(M->getModuleIdentifier()));
+    if (!buffer)
+        return nullptr;
+
+    m_object = (*buffer)->getBuffer().str();
+    return llvm::MemoryBuffer::getMemBufferCopy(m_object, M->getModuleIdentifier());
+    }
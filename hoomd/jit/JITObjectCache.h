@@ -0,0 +1,67 @@
+#pragma once
+
+// do not include python headers
+#define HOOMD_LLVMJIT_BUILD
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Target/TargetMachine.h"
+
+#include <string>
+
+//! Object cache for JIT compiled modules
+/*! Compiling IR to machine code with full optimization takes seconds for large modules. JITObjectCache stores the
+    compiled object of a module in a directory and returns it when the same module is compiled again, so repeated runs
+    skip code generation.
+
+    Modules are identified by a key computed with getKey() from the IR, the LLVM version, the target triple and CPU.
+    The JIT selects the target by CPU name only, so the CPU name determines the features used in the object. The key
+    must be set as the module identifier before the module is added to the JIT. Objects are written to a temporary
+    file and renamed, so concurrent jobs can share the same directory.
+
+    Every JIT uses its own cache for a single module. The compiled object is kept in memory (getObjectData()), and an
+    object given to the constructor is returned instead of compiling the module. This lets MPI ranks compile once and
+    share the result.
+*/
+class JITObjectCache : public llvm::ObjectCache
+    {
+    public:
+        //! Constructor
+        /*! \param cache_dir Directory to store objects in, the on-disk cache is disabled when empty
+            \param object Object to return for the module, compile the module when empty
+        */
+        JITObjectCache(const std::string& cache_dir, const std::string& object)
+            : m_cache_dir(cache_dir), m_object(object)
+            {
+            }
+
+        //! Compute the key of a module
+        static std::string getKey(const std::string& llvm_ir, const llvm::TargetMachine& tm);
+
+        //! Check if compiled objects can be cached with this version of LLVM
+        static bool isSupported();
+
+        //! Get the target triple and CPU name of the host that modules are compiled for
+        static std::string getHostTarget();
+
+        //! Store a compiled object
+        virtual void notifyObjectCompiled(const llvm::Module *M, llvm::MemoryBufferRef Obj);
+
+        //! Look up the object of a module
+        virtual std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* M);
+
+        //! Get the compiled object
+        const std::string& getObjectData() const
+            {
+            return m_object;
+            }
+
+    private:
+        std::string m_cache_dir; //!< Directory of the on-disk cache
+        std::string m_object;    //!< Compiled object
+
+        //! Get the file name of the object with the given key
+        std::string getFileName(const std::string& key) const
+            {
+            return m_cache_dir + "/" + key + ".o";
+            }
+    };
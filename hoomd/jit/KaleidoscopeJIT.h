@@ -17,6 +17,7 @@
 #include "llvm/Config/llvm-config.h"
 
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/RTDyldMemoryManager.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
@@ -32,6 +33,7 @@
 
 #include "llvm/IR/Mangler.h"
 #include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/Host.h"
 
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
 
@@ -64,7 +66,7 @@ public:
   typedef RTDYLDOBJECTLINKINGLAYER ObjLayerT;
   typedef IRCOMPILELAYER<ObjLayerT, SimpleCompiler> CompileLayerT;
   typedef VModuleKey ModuleHandleT;
-  KaleidoscopeJIT()
+  KaleidoscopeJIT(ObjectCache *Cache = nullptr)
       : Resolver(createLegacyLookupResolver(
             ES,
             [this](const std::string &Name) -> JITSymbol {
@@ -78,13 +80,13 @@ public:
               return nullptr;
             },
             [](Error Err) { cantFail(std::move(Err), "lookupFlags failed"); })),
-        TM(EngineBuilder().selectTarget()), DL(TM->createDataLayout()),
+        TM(EngineBuilder().setMCPU(llvm::sys::getHostCPUName()).selectTarget()), DL(TM->createDataLayout()),
         ObjectLayer(ES,
                     [this](VModuleKey) {
                       return RTDYLDOBJECTLINKINGLAYER::Resources{
                           std::make_shared<SectionMemoryManager>(), Resolver};
                     }),
-        CompileLayer(ObjectLayer, SimpleCompiler(*TM)),
+        CompileLayer(ObjectLayer, SimpleCompiler(*TM, Cache)),
         CXXRuntimeOverrides(
             [this](const std::string &S) { return mangle(S); })
         {
@@ -123,10 +125,10 @@ public:
   typedef IRCompileLayer<ObjLayerT, SimpleCompiler> CompileLayerT;
   typedef CompileLayerT::ModuleHandleT ModuleHandleT;
 
-  KaleidoscopeJIT()
-      : TM(EngineBuilder().selectTarget()), DL(TM->createDataLayout()),
+  KaleidoscopeJIT(ObjectCache *Cache = nullptr)
+      : TM(EngineBuilder().setMCPU(llvm::sys::getHostCPUName()).selectTarget()), DL(TM->createDataLayout()),
         ObjectLayer([]() { return std::make_shared<SectionMemoryManager>(); }),
-        CompileLayer(ObjectLayer, SimpleCompiler(*TM)),
+        CompileLayer(ObjectLayer, SimpleCompiler(*TM, Cache)),
         CXXRuntimeOverrides(
             [this](const std::string &S) { return mangle(S); })
         {
@@ -178,8 +180,9 @@ public:
   typedef IRCompileLayer<ObjLayerT> CompileLayerT;
   typedef CompileLayerT::ModuleSetHandleT ModuleHandleT;
 
-  KaleidoscopeJIT()
-      : TM(EngineBuilder().selectTarget()), DL(TM->createDataLayout()),
+  // SimpleCompiler does not support an object cache before LLVM 5
+  KaleidoscopeJIT(ObjectCache *Cache = nullptr)
+      : TM(EngineBuilder().setMCPU(llvm::sys::getHostCPUName()).selectTarget()), DL(TM->createDataLayout()),
         CompileLayer(ObjectLayer, SimpleCompiler(*TM)),
         CXXRuntimeOverrides(
             [this](const std::string &S) { return mangle(S); })
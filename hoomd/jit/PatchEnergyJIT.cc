@@ -1,22 +1,26 @@
 #include "PatchEnergyJIT.h"
 #include "EvalFactory.h"
+#include "CompileJIT.h"
 
 #include <sstream>
 
 /*! \param exec_conf The execution configuration (used for messages and MPI communication)
     \param llvm_ir Contents of the LLVM IR to load
     \param r_cut Center to center distance beyond which the patch energy is 0
+    \param array_size Size of the array of adjustable parameters
+    \param cache_dir Directory of the on-disk object cache, disabled when empty
 
     After construction, the LLVM IR is loaded, compiled, and the energy() method is ready to be called.
 */
 PatchEnergyJIT::PatchEnergyJIT(std::shared_ptr<ExecutionConfiguration> exec_conf, const std::string& llvm_ir, Scalar r_cut,
-                const unsigned int array_size) : m_r_cut(r_cut), m_alpha_size(array_size)
+                const unsigned int array_size, const std::string& cache_dir) : m_r_cut(r_cut), m_alpha_size(array_size)
     {
     // build the JIT.
-    m_factory = std::shared_ptr<EvalFactory>(new EvalFactory(llvm_ir));
+    m_factory = compileJIT<EvalFactory>(exec_conf, llvm_ir, cache_dir);
 
     // get the evaluator
     m_eval = m_factory->getEval();
+    m_eval_batch = m_factory->getEvalBatch();
 
     m_alpha = m_factory->getAlphaArray();
 
@@ -36,7 +40,8 @@ void export_PatchEnergyJIT(pybind11::module &m)
             .def(pybind11::init< std::shared_ptr<ExecutionConfiguration>,
                                  const std::string&,
                                  Scalar,
-                                 const unsigned int >())
+                                 const unsigned int,
+                                 const std::string& >())
             .def("getRCut", &PatchEnergyJIT::getRCut)
             .def("energy", &PatchEnergyJIT::energy)
             .def_property_readonly("alpha_iso",&PatchEnergyJIT::getAlphaNP)
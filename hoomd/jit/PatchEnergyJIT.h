@@ -28,6 +28,10 @@
     code and memory used in the module is deleted. KaleidoscopeJIT takes care of destructing C++ static members inside the
     module.
 
+    Modules compiled from user code also contain a function 'eval_batch', a loop over 'eval' that clang vectorizes for
+    the host CPU. HPMC passes all candidate neighbors of a particle to energyBatch(), which evaluates them with a single
+    call into the JIT module.
+
     LLVM JIT is capable of calling any function in the hosts address space. PatchEnergyJIT does not take advantage of
     that, limiting the user to a very specific API for computing the energy between a pair of particles.
 */
@@ -36,7 +40,7 @@ class PYBIND11_EXPORT PatchEnergyJIT : public hpmc::PatchEnergy
     public:
         //! Constructor
         PatchEnergyJIT(std::shared_ptr<ExecutionConfiguration> exec_conf, const std::string& llvm_ir, Scalar r_cut,
-                       const unsigned int array_size);
+                       const unsigned int array_size, const std::string& cache_dir);
 
         //! Get the maximum r_ij radius beyond which energies are always 0
         virtual Scalar getRCut()
@@ -76,6 +80,28 @@ class PYBIND11_EXPORT PatchEnergyJIT : public hpmc::PatchEnergy
             return m_eval(r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j);
             }
 
+        //! evaluate the energies of a batch of pairs
+        /*! \param batch Pairs to evaluate, batch.energy is set to the energy of every pair
+
+            All pairs are evaluated with a single call to the vectorized loop in the JIT module.
+        */
+        virtual void energyBatch(hpmc::PatchEnergyBatch& batch)
+            {
+            if (!m_eval_batch)
+                {
+                hpmc::PatchEnergy::energyBatch(batch);
+                return;
+                }
+
+            unsigned int n = batch.size();
+            batch.energy.resize(n);
+            if (n == 0)
+                return;
+
+            m_eval_batch(n, &batch.r_ij[0], &batch.type_i[0], &batch.q_i[0], &batch.d_i[0], &batch.charge_i[0],
+                &batch.type_j[0], &batch.q_j[0], &batch.d_j[0], &batch.charge_j[0], &batch.energy[0]);
+            }
+
         static pybind11::object getAlphaNP(pybind11::object self)
             {
             auto self_cpp = self.cast<PatchEnergyJIT *>();
@@ -88,6 +114,7 @@ class PYBIND11_EXPORT PatchEnergyJIT : public hpmc::PatchEnergy
         Scalar m_r_cut;                             //!< Cutoff radius
         std::shared_ptr<EvalFactory> m_factory;       //!< The factory for the evaluator function
         EvalFactory::EvalFnPtr m_eval;                //!< Pointer to evaluator function inside the JIT module
+        EvalFactory::EvalBatchFnPtr m_eval_batch;     //!< Pointer to batch evaluator function, may be NULL
         float * m_alpha;                            //!< Array containing adjustable elements
         unsigned int m_alpha_size;                  //!< Size of array
     };
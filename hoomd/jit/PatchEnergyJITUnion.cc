@@ -89,15 +89,24 @@ void PatchEnergyJITUnion::setParam(unsigned int type,
     m_tree[type] = hpmc::detail::GPUTree(tree,false);
     }
 
-float PatchEnergyJITUnion::compute_leaf_leaf_energy(vec3<float> dr,
+/*! \param dr Vector pointing from the center of union a to the center of union b
+    \param type_a Type of union a
+    \param type_b Type of union b
+    \param orientation_a Orientation of union a
+    \param orientation_b Orientation of union b
+    \param cur_node_a Leaf node of union a
+    \param cur_node_b Leaf node of union b
+    \param batch Batch to append the interacting constituent pairs to
+*/
+void PatchEnergyJITUnion::collect_leaf_leaf_pairs(vec3<float> dr,
                              unsigned int type_a,
                              unsigned int type_b,
                              const quat<float>& orientation_a,
                              const quat<float>& orientation_b,
                              unsigned int cur_node_a,
-                             unsigned int cur_node_b)
+                             unsigned int cur_node_b,
+                             hpmc::PatchEnergyBatch& batch)
     {
-    float energy = 0.0;
     vec3<float> r_ab = rotate(conj(quat<float>(orientation_b)),vec3<float>(dr));
 
     // loop through leaf particles of cur_node_a
@@ -124,8 +133,7 @@ float PatchEnergyJITUnion::compute_leaf_leaf_energy(vec3<float> dr,
             float rsq = dot(r_ij,r_ij);
             if (rsq <= m_rcut_union*m_rcut_union)
                 {
-                // evaluate energy via JIT function
-                energy += m_eval_union(r_ij,
+                batch.push_back(r_ij,
                     type_i,
                     orientation_i,
                     m_diameter[type_a][ileaf],
@@ -133,10 +141,48 @@ float PatchEnergyJITUnion::compute_leaf_leaf_energy(vec3<float> dr,
                     type_j,
                     orientation_j,
                     m_diameter[type_b][jleaf],
-                    m_charge[type_b][jleaf]);
+                    m_charge[type_b][jleaf],
+                    jleaf);
                 }
             }
         }
+    }
+
+/*! \param batch Constituent pairs to evaluate
+    \returns The total energy of all pairs
+*/
+float PatchEnergyJITUnion::compute_union_energy(hpmc::PatchEnergyBatch& batch)
+    {
+    unsigned int n = batch.size();
+    batch.energy.resize(n);
+    if (n == 0)
+        return 0.0;
+
+    if (m_eval_union_batch)
+        {
+        // evaluate all pairs with the vectorized loop in the JIT module
+        m_eval_union_batch(n, &batch.r_ij[0], &batch.type_i[0], &batch.q_i[0], &batch.d_i[0], &batch.charge_i[0],
+            &batch.type_j[0], &batch.q_j[0], &batch.d_j[0], &batch.charge_j[0], &batch.energy[0]);
+        }
+    else
+        {
+        for (unsigned int k = 0; k < n; k++)
+            {
+            batch.energy[k] = m_eval_union(batch.r_ij[k],
+                batch.type_i[k],
+                batch.q_i[k],
+                batch.d_i[k],
+                batch.charge_i[k],
+                batch.type_j[k],
+                batch.q_j[k],
+                batch.d_j[k],
+                batch.charge_j[k]);
+            }
+        }
+
+    float energy = 0.0;
+    for (unsigned int k = 0; k < n; k++)
+        energy += batch.energy[k];
     return energy;
     }
 
@@ -166,8 +212,12 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
         energy += tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, tree_a.getNumLeaves()),
             0.0f,
             [&](const tbb::blocked_range<unsigned int>& r, float energy)->float {
+            hpmc::PatchEnergyBatch& batch = m_batch.local();
+            batch.clear();
             for (unsigned int cur_leaf_a = r.begin(); cur_leaf_a != r.end(); ++cur_leaf_a)
         #else
+        hpmc::PatchEnergyBatch& batch = m_batch;
+        batch.clear();
         for (unsigned int cur_leaf_a = 0; cur_leaf_a < tree_a.getNumLeaves(); cur_leaf_a ++)
         #endif
             {
@@ -187,12 +237,14 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
                 {
                 unsigned int query_node = cur_node_b;
                 if (tree_b.queryNode(obb_a, cur_node_b))
-                    energy += compute_leaf_leaf_energy(r_ij, type_i, type_j, q_i, q_j, cur_node_a, query_node);
+                    collect_leaf_leaf_pairs(r_ij, type_i, type_j, q_i, q_j, cur_node_a, query_node, batch);
                 }
             }
         #ifdef ENABLE_TBB
-        return energy;
+        return energy + compute_union_energy(batch);
         }, [](float x, float y)->float { return x+y; } );
+        #else
+        energy += compute_union_energy(batch);
         #endif
         }
     else
@@ -201,8 +253,12 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
         energy += tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, tree_b.getNumLeaves()),
             0.0f,
             [&](const tbb::blocked_range<unsigned int>& r, float energy)->float {
+            hpmc::PatchEnergyBatch& batch = m_batch.local();
+            batch.clear();
             for (unsigned int cur_leaf_b = r.begin(); cur_leaf_b != r.end(); ++cur_leaf_b)
         #else
+        hpmc::PatchEnergyBatch& batch = m_batch;
+        batch.clear();
         for (unsigned int cur_leaf_b = 0; cur_leaf_b < tree_b.getNumLeaves(); cur_leaf_b ++)
         #endif
             {
@@ -222,12 +278,14 @@ float PatchEnergyJITUnion::energy(const vec3<float>& r_ij,
                 {
                 unsigned int query_node = cur_node_a;
                 if (tree_a.queryNode(obb_b, cur_node_a))
-                    energy += compute_leaf_leaf_energy(-r_ij, type_j, type_i, q_j, q_i, cur_node_b, query_node);
+                    collect_leaf_leaf_pairs(-r_ij, type_j, type_i, q_j, q_i, cur_node_b, query_node, batch);
                 }
             }
         #ifdef ENABLE_TBB
-        return energy;
+        return energy + compute_union_energy(batch);
         }, [](float x, float y)->float { return x+y; } );
+        #else
+        energy += compute_union_energy(batch);
         #endif
         }
 
@@ -240,7 +298,8 @@ void export_PatchEnergyJITUnion(pybind11::module &m)
             .def(pybind11::init< std::shared_ptr<SystemDefinition>,
                                  std::shared_ptr<ExecutionConfiguration>,
                                  const std::string&, Scalar, const unsigned int,
-                                 const std::string&, Scalar, const unsigned int >())
+                                 const std::string&, Scalar, const unsigned int,
+                                 const std::string& >())
             .def("setParam",&PatchEnergyJITUnion::setParam)
             .def_property_readonly("alpha_union",&PatchEnergyJITUnion::getAlphaUnionNP)
             ;
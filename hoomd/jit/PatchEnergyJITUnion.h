@@ -2,9 +2,14 @@
 #define _PATCH_ENERGY_JIT_UNION_H_
 
 #include "PatchEnergyJIT.h"
+#include "CompileJIT.h"
 #include "hoomd/hpmc/GPUTree.h"
 #include "hoomd/SystemDefinition.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 //! Evaluate patch energies via runtime generated code, using a tree accelerator structure for unions of particles
 class PatchEnergyJITUnion : public PatchEnergyJIT
     {
@@ -16,15 +21,17 @@ class PatchEnergyJITUnion : public PatchEnergyJIT
             const std::string& llvm_ir_iso, Scalar r_cut_iso,
             const unsigned int array_size_iso,
             const std::string& llvm_ir_union, Scalar r_cut_union,
-            const unsigned int array_size_union)
-            : PatchEnergyJIT(exec_conf, llvm_ir_iso, r_cut_iso, array_size_iso), m_sysdef(sysdef),
+            const unsigned int array_size_union,
+            const std::string& cache_dir)
+            : PatchEnergyJIT(exec_conf, llvm_ir_iso, r_cut_iso, array_size_iso, cache_dir), m_sysdef(sysdef),
             m_rcut_union(r_cut_union), m_alpha_size_union(array_size_union)
             {
             // build the JIT.
-            m_factory_union = std::shared_ptr<EvalFactory>(new EvalFactory(llvm_ir_union));
+            m_factory_union = compileJIT<EvalFactory>(exec_conf, llvm_ir_union, cache_dir);
 
             // get the evaluator
             m_eval_union = m_factory_union->getEval();
+            m_eval_union_batch = m_factory_union->getEvalBatch();
 
             m_alpha_union = m_factory_union->getAlphaUnionArray();
 
@@ -111,6 +118,16 @@ class PatchEnergyJITUnion : public PatchEnergyJIT
             float d_j,
             float charge_j);
 
+        //! evaluate the energies of a batch of pairs
+        /*! \param batch Pairs to evaluate, batch.energy is set to the energy of every pair
+
+            Every pair of unions is evaluated with energy(), which batches the constituent pairs.
+        */
+        virtual void energyBatch(hpmc::PatchEnergyBatch& batch)
+            {
+            hpmc::PatchEnergy::energyBatch(batch);
+            }
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -140,20 +157,31 @@ class PatchEnergyJITUnion : public PatchEnergyJIT
         std::vector< std::vector<float> > m_charge;               // The charges of the constituent particles
         std::vector< std::vector<unsigned int> > m_type;          // The type identifiers of the constituent particles
 
-        //! Compute the energy of two overlapping leaf nodes
-        float compute_leaf_leaf_energy(vec3<float> dr,
+        //! Collect the interacting constituent pairs of two overlapping leaf nodes
+        void collect_leaf_leaf_pairs(vec3<float> dr,
                                      unsigned int type_a,
                                      unsigned int type_b,
                                      const quat<float>& orientation_a,
                                      const quat<float>& orientation_b,
                                      unsigned int cur_node_a,
-                                     unsigned int cur_node_b);
+                                     unsigned int cur_node_b,
+                                     hpmc::PatchEnergyBatch& batch);
+
+        //! Evaluate a batch of constituent pairs and return their total energy
+        float compute_union_energy(hpmc::PatchEnergyBatch& batch);
 
         std::shared_ptr<EvalFactory> m_factory_union;            //!< The factory for the evaluator function, for constituent ptls
         EvalFactory::EvalFnPtr m_eval_union;                     //!< Pointer to evaluator function inside the JIT module
+        EvalFactory::EvalBatchFnPtr m_eval_union_batch;          //!< Pointer to batch evaluator function, may be NULL
         Scalar m_rcut_union;                                     //!< Cutoff on constituent particles
         float *  m_alpha_union;                                     //!< Cutoff on constituent particles
         unsigned int m_alpha_size_union;
+
+        #ifdef ENABLE_TBB
+        tbb::enumerable_thread_specific<hpmc::PatchEnergyBatch> m_batch; //!< Constituent pairs of every thread, reused across calls
+        #else
+        hpmc::PatchEnergyBatch m_batch;                                  //!< Constituent pairs, reused across calls
+        #endif
     };
 
 //! Exports the PatchEnergyJITUnion class to python
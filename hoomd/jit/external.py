@@ -21,6 +21,7 @@ class user(field._external):
         code (str): C++ code to compile
         llvm_ir_fname (str): File name of the llvm IR file to load.
         clang_exec (str): The Clang executable to use
+        cache_dir (str): Directory to store compiled objects in, compiled code is reused when it is unchanged. (added in version 2.9)
 
     Potentials in jit.external behave similarly to external fields assigned via
     hpmc.field.callback. Potentials added using external.user are added to the total
@@ -86,7 +87,7 @@ class user(field._external):
 
     .. versionadded:: 2.5
     '''
-    def __init__(self, mc, code=None, llvm_ir_file=None, clang_exec=None):
+    def __init__(self, mc, code=None, llvm_ir_file=None, clang_exec=None, cache_dir=None):
         super(user, self).__init__()
 
         # raise an error if this run is on the GPU
@@ -140,7 +141,7 @@ class user(field._external):
 
         self.compute_name = "external_field_jit"
         self.cpp_compute = cls(hoomd.context.current.system_definition,
-            hoomd.context.exec_conf, llvm_ir);
+            hoomd.context.exec_conf, llvm_ir, cache_dir if cache_dir is not None else '');
         hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name)
 
         self.mc = mc
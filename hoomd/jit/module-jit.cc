@@ -3,6 +3,7 @@
 
 #include "PatchEnergyJIT.h"
 #include "PatchEnergyJITUnion.h"
+#include "JITObjectCache.h"
 
 //#include "hoomd/hpmc/IntegratorHPMC.h"
 //#include "hoomd/hpmc/IntegratorHPMCMono.h"
@@ -36,6 +37,8 @@ PYBIND11_MODULE(_jit, m)
     export_PatchEnergyJIT(m);
     export_PatchEnergyJITUnion(m);
 
+    m.def("isObjectCacheSupported", &JITObjectCache::isSupported);
+
     export_ExternalFieldJIT<ShapeSphere>(m, "ExternalFieldJITSphere");
     export_ExternalFieldJIT<ShapeConvexPolygon>(m, "ExternalFieldJITConvexPolygon");
     export_ExternalFieldJIT<ShapePolyhedron>(m, "ExternalFieldJITPolyhedron");
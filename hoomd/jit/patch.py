@@ -21,6 +21,7 @@ class user(object):
         llvm_ir_fname (str): File name of the llvm IR file to load.
         clang_exec (str): The Clang executable to use
         array_size (int): Size of array with adjustable elements. (added in version 2.8)
+        cache_dir (str): Directory to store compiled objects in, compiled code is reused when it is unchanged. (added in version 2.9)
 
     Attributes:
         alpha_iso (numpy.ndarray, float): Length array_size numpy array containing dynamically adjustable elements
@@ -127,9 +128,29 @@ class user(object):
     Compile the file with clang: ``clang -O3 --std=c++11 -DHOOMD_LLVMJIT_BUILD -I /path/to/hoomd/include -S -emit-llvm code.cc`` to produce
     the LLVM IR in ``code.ll``.
 
+    The file may also contain an extern "C" function ``eval_batch`` that evaluates *n* pairs at once. Each argument of
+    ``eval`` is passed as an array with one element per pair, and the energies are written to the last argument:
+
+    .. code::
+
+        void eval_batch(unsigned int n,
+                        const vec3<float> *r_ij,
+                        const unsigned int *type_i,
+                        const quat<float> *q_i,
+                        const float *d_i,
+                        const float *charge_i,
+                        const unsigned int *type_j,
+                        const quat<float> *q_j,
+                        const float *d_j,
+                        const float *charge_j,
+                        float *energy)
+
+    HPMC evaluates all neighbors of a particle with one call to ``eval_batch`` when it is present. Code given in *code*
+    is compiled with an ``eval_batch`` loop that clang vectorizes for the host CPU.
+
     .. versionadded:: 2.3
     '''
-    def __init__(self, mc, r_cut, array_size=1, code=None, llvm_ir_file=None, clang_exec=None):
+    def __init__(self, mc, r_cut, array_size=1, code=None, llvm_ir_file=None, clang_exec=None, cache_dir=None):
         hoomd.util.print_status_line();
 
         # check if initialization has occurred
@@ -155,7 +176,8 @@ class user(object):
                 llvm_ir = f.read()
 
         self.compute_name = "patch"
-        self.cpp_evaluator = _jit.PatchEnergyJIT(hoomd.context.exec_conf, llvm_ir, r_cut, array_size);
+        self.cpp_evaluator = _jit.PatchEnergyJIT(hoomd.context.exec_conf, llvm_ir, r_cut, array_size,
+            cache_dir if cache_dir is not None else '');
         mc.set_PatchEnergyEvaluator(self);
 
         self.mc = mc
@@ -199,6 +221,24 @@ float eval(const vec3<float>& r_ij,
         cpp_function += code
         cpp_function += """
     }
+
+// evaluate a batch of pairs in one call, clang inlines eval and vectorizes the loop for the host CPU
+void eval_batch(unsigned int n,
+    const vec3<float> *r_ij,
+    const unsigned int *type_i,
+    const quat<float> *q_i,
+    const float *d_i,
+    const float *charge_i,
+    const unsigned int *type_j,
+    const quat<float> *q_j,
+    const float *d_j,
+    const float *charge_j,
+    float *energy)
+    {
+    #pragma clang loop vectorize(enable) interleave(enable)
+    for (unsigned int k = 0; k < n; k++)
+        energy[k] = eval(r_ij[k], type_i[k], q_i[k], d_i[k], charge_i[k], type_j[k], q_j[k], d_j[k], charge_j[k]);
+    }
 }
 """
 
@@ -211,9 +251,9 @@ float eval(const vec3<float>& r_ij,
             clang = 'clang';
 
         if fn is not None:
-            cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o',fn,'-']
+            cmd = [clang, '-O3', '-march=native', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o',fn,'-']
         else:
-            cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o','-','-']
+            cmd = [clang, '-O3', '-march=native', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o','-','-']
         p = subprocess.Popen(cmd,stdin=subprocess.PIPE,stdout=subprocess.PIPE,stderr=subprocess.PIPE)
 
         # pass C++ function to stdin
@@ -267,6 +307,7 @@ class user_union(user):
         llvm_ir_fname_iso (str, **optional**): File name of the llvm IR file to load for isotropic interaction
         array_size (int): Size of array with adjustable elements. (added in version 2.8)
         array_size_iso (int): Size of array with adjustable elements for the isotropic part. (added in version 2.8)
+        cache_dir (str): Directory to store compiled objects in, compiled code is reused when it is unchanged. (added in version 2.9)
 
     Attributes:
         alpha_union (numpy.ndarray, float): Length array_size numpy array containing dynamically adjustable elements
@@ -319,7 +360,7 @@ class user_union(user):
     .. versionadded:: 2.3
     '''
     def __init__(self, mc, r_cut, array_size=1, code=None, llvm_ir_file=None, r_cut_iso=None, code_iso=None,
-        llvm_ir_file_iso=None, array_size_iso=1, clang_exec=None):
+        llvm_ir_file_iso=None, array_size_iso=1, clang_exec=None, cache_dir=None):
 
         hoomd.util.print_status_line();
 
@@ -355,7 +396,8 @@ class user_union(user):
 
         self.compute_name = "patch_union"
         self.cpp_evaluator = _jit.PatchEnergyJITUnion(hoomd.context.current.system_definition, hoomd.context.exec_conf,
-            llvm_ir_iso, r_cut_iso, array_size_iso, llvm_ir, r_cut,  array_size);
+            llvm_ir_iso, r_cut_iso, array_size_iso, llvm_ir, r_cut,  array_size,
+            cache_dir if cache_dir is not None else '');
         mc.set_PatchEnergyEvaluator(self);
 
         self.mc = mc
@@ -393,6 +393,17 @@ void IntegratorTwoStep::prepRun(unsigned int timestep)
     // accelerations only need to be calculated if the accelerations have not yet been set
     if (!m_pdata->isAccelSet())
         {
+        // a force that is evaluated every few steps misses its first impulse if the run does not start on its step
+        for (unsigned int i = 0; i < m_forces.size(); ++i)
+            {
+            if (!isForceDue(i, timestep))
+                {
+                m_exec_conf->msg->warning() << "integrate.mode_standard: The run does not start on a multiple of the "
+                    "multiple time step period, the first slow force impulse is skipped" << endl;
+                break;
+                }
+            }
+
         computeAccelerations(timestep);
         m_pdata->notifyAccelSet();
         }
@@ -304,6 +304,7 @@ NeighborList::~NeighborList()
         m_comm->getMigrateSignal().disconnect<NeighborList, &NeighborList::peekUpdate>(this);
         m_comm->getCommFlagsRequestSignal().disconnect<NeighborList, &NeighborList::getRequestedCommFlags>(this);
         m_comm->getGhostLayerWidthRequestSignal().disconnect<NeighborList, &NeighborList::getGhostLayerWidth>(this);
+        m_comm->getGhostLayerWidthUpdateSignal().disconnect<NeighborList, &NeighborList::updateGhostLayerDiameters>(this);
         }
 #endif
 
@@ -1592,11 +1593,43 @@ void NeighborList::setCommunicator(std::shared_ptr<Communicator> comm)
         comm->getMigrateSignal().connect<NeighborList, &NeighborList::peekUpdate>(this);
         comm->getCommFlagsRequestSignal().connect<NeighborList, &NeighborList::getRequestedCommFlags>(this);
         comm->getGhostLayerWidthRequestSignal().connect<NeighborList, &NeighborList::getGhostLayerWidth>(this);
+        comm->getGhostLayerWidthUpdateSignal().connect<NeighborList, &NeighborList::updateGhostLayerDiameters>(this);
         }
 
     Compute::setCommunicator(comm);
     }
 
+/*! With diameter shifting, the ghost layer width of a type only needs to cover the largest diameter of the
+    particles of that type, not d_max. In mixtures of large and small particles, this keeps the ghost layer of the
+    small particles thin. The maxima are reduced over all ranks, so this must be called collectively.
+ */
+void NeighborList::updateGhostLayerDiameters()
+    {
+    m_d_max_type.assign(m_pdata->getNTypes(), Scalar(0.0));
+
+    if (!m_diameter_shift)
+        return;
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+            {
+            unsigned int type = __scalar_as_int(h_pos.data[i].w);
+            m_d_max_type[type] = std::max(m_d_max_type[type], h_diameter.data[i]);
+            }
+        }
+
+    if (m_pdata->getNTypes() > 0)
+        MPI_Allreduce(MPI_IN_PLACE,
+                      &m_d_max_type.front(),
+                      m_pdata->getNTypes(),
+                      MPI_HOOMD_SCALAR,
+                      MPI_MAX,
+                      m_exec_conf->getMPICommunicator());
+    }
+
 //! Returns true if the particle migration criterion is fulfilled
 /*! \note The criterion for when to request particle migration is the same as the one for neighbor list
     rebuilds, which is implemented in needsUpdating().
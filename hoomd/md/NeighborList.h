@@ -401,7 +401,15 @@ class PYBIND11_EXPORT NeighborList : public Compute
 
                 // diameter shifting requires to communicate a larger rlist
                 if (m_diameter_shift)
-                    rmax += m_d_max - Scalar(1.0);
+                    {
+                    #ifdef ENABLE_MPI
+                    // the shift (d_i + d_j)/2 - 1 is bounded by the largest diameter of this type for d_i
+                    if (type < m_d_max_type.size())
+                        rmax += (m_d_max_type[type] + m_d_max)/Scalar(2.0) - Scalar(1.0);
+                    else
+                    #endif
+                        rmax += m_d_max - Scalar(1.0);
+                    }
                 return rmax;
                 }
             else
@@ -441,6 +449,9 @@ class PYBIND11_EXPORT NeighborList : public Compute
         /*! \param timestep The current timestep
          */
         bool peekUpdate(unsigned int timestep);
+
+        //! Compute the largest diameter of every type ahead of the ghost layer width requests
+        void updateGhostLayerDiameters();
 #endif
 
         //! Return true if the neighbor list has been updated this time step
@@ -589,6 +600,10 @@ class PYBIND11_EXPORT NeighborList : public Compute
             m_need_reallocate_exlist = true;
             }
 
+        #ifdef ENABLE_MPI
+        std::vector<Scalar> m_d_max_type; //!< Largest diameter of each type, for the ghost layer width
+        #endif
+
         #ifdef ENABLE_CUDA
         GPUPartition m_last_gpu_partition; //!< The partition at the time of the last memory hints
         #endif
@@ -94,6 +94,9 @@ class mode_standard(_integrator):
         self.aniso = aniso
         self.metadata_fields = ['dt', 'aniso']
 
+        # number of time steps between evaluations of each force
+        self.respa_periods = {};
+
         # initialize the reflected c++ class
         self.cpp_integrator = _md.IntegratorTwoStep(hoomd.context.current.system_definition, dt);
         self.supports_methods = True;
@@ -159,6 +162,89 @@ class mode_standard(_integrator):
         self.check_initialization();
         self.cpp_integrator.initializeIntegrationMethods();
 
+    def set_respa(self, levels, substeps):
+        R""" Evaluate forces at multiple time steps (r-RESPA).
+
+        Args:
+            levels (dict): Level of each force, where level 0 is the outermost level.
+            substeps (list): Number of steps of each level in one step of the next outer level.
+
+        .. versionadded:: 2.9
+
+        With r-RESPA, forces that vary slowly are evaluated less often than stiff forces. There are
+        ``len(substeps) + 1`` levels. The innermost level advances by *dt* and level *l* advances by *dt* times the
+        product of ``substeps[l:]``. A force at level *l* is only evaluated on the time steps that are a multiple
+        of its step, and its force and torque are then applied as an impulse over the whole step. For :py:class:`nve`,
+        this is the reversible r-RESPA integrator of `Tuckerman et al. 1992 <http://dx.doi.org/10.1063/1.463137>`_.
+        Forces that are not listed in *levels* are evaluated at the innermost level.
+
+        Typically, stiff bonded forces are placed at the innermost level, short-ranged pair forces at a middle level,
+        and the long-ranged part of the electrostatics at the outermost level::
+
+            integrator_mode = integrate.mode_standard(dt=0.002)
+            integrator_mode.set_respa(levels={harmonic: 2, lj: 1, ewald: 0, pppm: 0}, substeps=[2, 2])
+
+        Here, the bond forces are evaluated at every step, the pair forces every 2 steps, and the PPPM forces every 4
+        steps.
+
+        Call ``set_respa(levels={}, substeps=[])`` to evaluate all forces at every step again.
+
+        Warning:
+            The energy and virial of a force are only included in the logged thermodynamic quantities (for example,
+            *potential_energy* and *pressure*) on the time steps where it is evaluated. Log these quantities on
+            multiples of the outermost step. Runs should start on a multiple of the outermost step.
+
+        Integration methods that use the pressure, :py:class:`npt` and :py:class:`nph`, cannot be combined with forces
+        evaluated less often than every step. Doing so raises an error.
+        """
+        hoomd.util.print_status_line();
+        self.check_initialization();
+
+        substeps = list(substeps);
+        for n in substeps:
+            if int(n) != n or n < 1:
+                hoomd.context.msg.error("integrate.mode_standard: The number of substeps must be a positive integer.\n");
+                raise ValueError("Error setting r-RESPA parameters.");
+
+        # steps of the innermost level in one step of each level
+        periods = [1];
+        for n in reversed(substeps):
+            periods.insert(0, periods[0] * int(n));
+
+        respa_periods = {};
+        for f, level in levels.items():
+            if f not in hoomd.context.current.forces:
+                hoomd.context.msg.error("integrate.mode_standard: r-RESPA levels can only be set for forces.\n");
+                raise ValueError("Error setting r-RESPA parameters.");
+            if int(level) != level or level < 0 or level >= len(periods):
+                hoomd.context.msg.error("integrate.mode_standard: r-RESPA level {} does not exist.\n".format(level));
+                raise ValueError("Error setting r-RESPA parameters.");
+            respa_periods[f] = periods[int(level)];
+
+        self._check_respa_methods(respa_periods);
+        self.respa_periods = respa_periods;
+
+    ## \internal
+    # \brief Checks that no pressure-coupled method is used with forces that are not evaluated every step
+    def _check_respa_methods(self, respa_periods):
+        if not any(period > 1 for period in respa_periods.values()):
+            return;
+
+        for m in hoomd.context.current.integration_methods:
+            if isinstance(m, npt):
+                hoomd.context.msg.error("integrate.mode_standard: npt and nph cannot be used with r-RESPA, the pressure is only complete on the outermost steps.\n");
+                raise RuntimeError("Error setting r-RESPA parameters.");
+
+    ## \internal
+    # \brief Updates the forces in the reflected c++ class and sets their r-RESPA periods
+    def update_forces(self):
+        _integrator.update_forces(self);
+        self._check_respa_methods(self.respa_periods);
+
+        for f, period in self.respa_periods.items():
+            if f.enabled and f in hoomd.context.current.forces:
+                self.cpp_integrator.setForcePeriod(f.cpp_force, period);
+
 
 class nvt(_integration_method):
     R""" NVT Integration via the Nosé-Hoover thermostat.
@@ -0,0 +1,104 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import md;
+context.initialize()
+import unittest
+import os
+import numpy
+
+# unit tests for r-RESPA in md.integrate.mode_standard
+class integrate_respa_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        self.s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
+        self.const = md.force.constant(fx=0.1, fy=0.2, fz=0.3)
+
+        context.current.sorter.set_params(grid=8)
+
+    # test that a constant force gives the same momentum on the outer steps
+    def test_constant_force(self):
+        mode = md.integrate.mode_standard(dt=0.005);
+        mode.set_respa(levels={self.const: 0}, substeps=[4]);
+        md.integrate.nve(group=group.all());
+        run(8);
+
+        snap = self.s.take_snapshot()
+        if comm.get_rank() == 0:
+            for v in snap.particles.velocity:
+                self.assertAlmostEqual(v[0], 8*0.005*0.1, 5)
+                self.assertAlmostEqual(v[1], 8*0.005*0.2, 5)
+                self.assertAlmostEqual(v[2], 8*0.005*0.3, 5)
+
+    # test that pair forces can run at multiple levels
+    def test_pair(self):
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=2.5, nlist=nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+
+        # random velocities so that the particles collide
+        snap = self.s.take_snapshot()
+        if comm.get_rank() == 0:
+            numpy.random.seed(42);
+            snap.particles.velocity[:] = numpy.random.normal(0.0, 1.0, size=(snap.particles.N, 3));
+        self.s.restore_snapshot(snap);
+        N = len(self.s.particles);
+
+        # sample the total energy on the outer steps, when every force has been evaluated
+        mode = md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group=group.all());
+        log = analyze.log(filename=None, quantities=['potential_energy', 'kinetic_energy'], period=2);
+        energy = [];
+        analyze.callback(callback=lambda step: energy.append(log.query('potential_energy') + log.query('kinetic_energy')), period=2);
+        run(100);
+        E_single = list(energy);
+
+        # the constant force at the outer level gives the same energies as the single step run
+        self.s.restore_snapshot(snap);
+        del energy[:];
+        mode.set_respa(levels={lj: 1, self.const: 0}, substeps=[2]);
+        run(100);
+        self.assertEqual(len(energy), len(E_single));
+        for E_respa, E in zip(energy, E_single):
+            self.assertAlmostEqual(E_respa / N, E / N, 3);
+
+        mode.set_respa(levels={lj: 1, self.const: 0}, substeps=[2, 2]);
+        run(20);
+
+        # disabling r-RESPA
+        mode.set_respa(levels={}, substeps=[]);
+        run(20);
+
+    # test error handling
+    def test_errors(self):
+        mode = md.integrate.mode_standard(dt=0.005);
+        nve = md.integrate.nve(group=group.all());
+        self.assertRaises(ValueError, mode.set_respa, levels={self.const: 2}, substeps=[2]);
+        self.assertRaises(ValueError, mode.set_respa, levels={self.const: -1}, substeps=[2]);
+        self.assertRaises(ValueError, mode.set_respa, levels={self.const: 0}, substeps=[0]);
+        self.assertRaises(ValueError, mode.set_respa, levels={nve: 0}, substeps=[2]);
+
+    # test that pressure-coupled methods are rejected
+    def test_npt(self):
+        mode = md.integrate.mode_standard(dt=0.005);
+        npt = md.integrate.npt(group=group.all(), kT=1.0, tau=0.5, P=1.0, tauP=0.5);
+        self.assertRaises(RuntimeError, mode.set_respa, levels={self.const: 0}, substeps=[2]);
+
+        # all forces at every step are fine
+        mode.set_respa(levels={self.const: 0}, substeps=[]);
+        run(1);
+
+        # methods attached after set_respa are checked on run()
+        npt.disable();
+        mode.set_respa(levels={self.const: 0}, substeps=[2]);
+        npt.enable();
+        self.assertRaises(RuntimeError, run, 2);
+
+    def tearDown(self):
+        del self.s, self.const
+        context.initialize();
+
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -70,6 +70,23 @@ class PYBIND11_EXPORT CellCommunicator
         template<typename T, class PackOpT>
         void finalize(const GPUArray<T>& props, const PackOpT op);
 
+        //! Advance communication of the grid
+        /*!
+         * \returns True if no communication is outstanding
+         *
+         * Many MPI implementations only move nonblocking messages forward inside MPI calls. Calling
+         * this method periodically between begin() and finalize() lets the exchange proceed while
+         * other work is done.
+         */
+        bool progress()
+            {
+            if (!m_communicating) return true;
+
+            int done = 0;
+            MPI_Testall(m_reqs.size(), m_reqs.data(), &done, MPI_STATUSES_IGNORE);
+            return done;
+            }
+
         //! Get the number of unique cells with communication
         unsigned int getNCells()
             {
@@ -4,6 +4,9 @@
 // Maintainer: mphoward
 
 #include "CellList.h"
+#include "ThreadingUtilities.h"
+
+#include <algorithm>
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
@@ -19,7 +22,10 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
                          std::shared_ptr<mpcd::ParticleData> mpcd_pdata)
         : Compute(sysdef), m_mpcd_pdata(mpcd_pdata),
           m_cell_size(1.0), m_cell_np_max(4), m_cell_np(m_exec_conf), m_cell_list(m_exec_conf),
-          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf), m_needs_compute_dim(true),
+          m_cell_offsets(m_exec_conf), m_occupied_cells(m_exec_conf), m_num_occupied(0), m_compact(false),
+          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf), m_num_cell_counter(0),
+          m_prebin_requested(false), m_prebinned(false), m_prebin_timestep(0), m_prebin_N(0),
+          m_prebin_overflow(0), m_prebin_failed(0), m_needs_compute_dim(true),
           m_particles_sorted(false), m_virtual_change(false)
     {
     assert(m_mpcd_pdata);
@@ -32,6 +38,7 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
     m_grid_shift = make_scalar3(0.0,0.0,0.0);
     m_max_grid_shift = 0.5 * m_cell_size;
     m_origin_idx = make_int3(0,0,0);
+    m_prebin_shift = m_grid_shift;
 
     resetConditions();
 
@@ -60,6 +67,11 @@ void mpcd::CellList::compute(unsigned int timestep)
     {
     if (m_prof) m_prof->push(m_exec_conf, "MPCD cell list");
 
+    // particles binned during streaming can only be used for the build they were requested for
+    m_prebin_requested = false;
+    if (m_prebinned && timestep != m_prebin_timestep)
+        m_prebinned = false;
+
     if (m_virtual_change)
         {
         m_virtual_change = false;
@@ -126,10 +138,57 @@ void mpcd::CellList::compute(unsigned int timestep)
 
 void mpcd::CellList::reallocate()
     {
-    m_exec_conf->msg->notice(6) << "Allocating MPCD cell list, " << m_cell_np_max
-                                << " particles in " << m_cell_indexer.getNumElements() << " cells." << std::endl;
-    m_cell_list_indexer = Index2D(m_cell_np_max, m_cell_indexer.getNumElements());
-    m_cell_list.resize(m_cell_list_indexer.getNumElements());
+    const unsigned int num_cells = m_cell_indexer.getNumElements();
+    m_cell_list_indexer = Index2D(m_cell_np_max, num_cells);
+    m_cell_offsets.resize(num_cells);
+    if (m_compact)
+        {
+        // the members are sized when the cell list is built
+        m_exec_conf->msg->notice(6) << "Allocating compact MPCD cell list, " << num_cells << " cells." << std::endl;
+        m_occupied_cells.resize(num_cells);
+        }
+    else
+        {
+        m_exec_conf->msg->notice(6) << "Allocating MPCD cell list, " << m_cell_np_max
+                                    << " particles in " << num_cells << " cells." << std::endl;
+        m_cell_list.resize(m_cell_list_indexer.getNumElements());
+
+        // every cell has room for the same number of members
+        ArrayHandle<unsigned int> h_cell_offsets(m_cell_offsets, access_location::host, access_mode::overwrite);
+        for (unsigned int cur_cell=0; cur_cell < num_cells; ++cur_cell)
+            {
+            h_cell_offsets.data[cur_cell] = m_cell_list_indexer(0, cur_cell);
+            }
+        }
+
+    // any particles binned during streaming used the old layout
+    m_prebinned = false;
+    }
+
+/*!
+ * \returns Binning parameters for the current dimensions and grid shift
+ */
+mpcd::detail::CellBinner mpcd::CellList::getBinner()
+    {
+    mpcd::detail::CellBinner binner;
+    binner.grid_shift = m_grid_shift;
+    binner.global_lo = m_pdata->getGlobalBox().getLo();
+    binner.cell_size = m_cell_size;
+    binner.periodic = m_pdata->getBox().getPeriodic();
+
+    // total effective number of cells in the global box, optionally padded by
+    // extra cells in MPI simulations
+    binner.n_global_cells = m_global_cell_dim;
+    #ifdef ENABLE_MPI
+    if (isCommunicating(mpcd::detail::face::east)) binner.n_global_cells.x += 2*m_num_extra;
+    if (isCommunicating(mpcd::detail::face::north)) binner.n_global_cells.y += 2*m_num_extra;
+    if (isCommunicating(mpcd::detail::face::up)) binner.n_global_cells.z += 2*m_num_extra;
+    #endif // ENABLE_MPI
+
+    binner.origin_idx = m_origin_idx;
+    binner.cell_dim = m_cell_dim;
+    binner.cell_indexer = m_cell_indexer;
+    return binner;
     }
 
 void mpcd::CellList::updateGlobalBox()
@@ -491,25 +550,131 @@ bool mpcd::CellList::isCommunicating(mpcd::detail::face dir)
     }
 #endif // ENABLE_MPI
 
+/*!
+ * \param compact If true, use the compact layout
+ *
+ * In the (default) dense layout, every cell has room for the same number of
+ * particles, which is grown when a cell overflows. In the compact layout, the
+ * members of the cells are stored back to back after a counting sort, so only
+ * the particles take up memory in the cell list. The occupied cells are also
+ * listed so that the cell loops on the CPU can skip the empty cells, which make
+ * up most of the box in confined geometries. The compact layout is not supported
+ * on the GPU.
+ */
+void mpcd::CellList::setCompact(bool compact)
+    {
+    if (compact && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "mpcd: compact cell list is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Compact MPCD cell list not supported on the GPU");
+        }
+    if (compact == m_compact) return;
+
+    // release the members in the previous layout and resize on the next build
+    m_compact = compact;
+    m_num_occupied = 0;
+    GPUVector<unsigned int> cell_list(m_exec_conf);
+    m_cell_list.swap(cell_list);
+    m_needs_compute_dim = true;
+    }
+
+/*!
+ * \returns True if the particles should be binned with prebinParticle() while they are streamed
+ *
+ * Binning is only started if it was requested with requestPrebin(). The caller must call endPrebin()
+ * once all particles have been binned.
+ */
+bool mpcd::CellList::beginPrebin()
+    {
+    m_prebinned = false;
+    if (!m_prebin_requested)
+        return false;
+    m_prebin_requested = false;
+
+    // the cell list must be sized before binning into it
+    computeDimensions();
+
+    // zero the cell counters
+    const unsigned int num_cells = m_cell_indexer.getNumElements();
+    if (num_cells > m_num_cell_counter)
+        {
+        m_cell_counter.reset(new std::atomic<unsigned int>[num_cells]);
+        m_num_cell_counter = num_cells;
+        }
+    std::atomic<unsigned int>* cell_counter = m_cell_counter.get();
+    mpcd::detail::parallel_for(0, num_cells, [&](unsigned int cur_cell)
+        {
+        cell_counter[cur_cell].store(0, std::memory_order_relaxed);
+        });
+
+    m_prebin_binner = getBinner();
+    m_prebin_shift = m_grid_shift;
+    m_prebin_N = m_mpcd_pdata->getN();
+    m_prebin_overflow.store(0);
+    m_prebin_failed.store(0);
+    if (!m_compact)
+        m_prebin_cell_list.reset(new ArrayHandle<unsigned int>(m_cell_list, access_location::host, access_mode::overwrite));
+
+    return true;
+    }
+
+/*!
+ * The binned particles are used by the next build of the cell list at the requested
+ * timestep, as long as the MPCD particles have not been reordered and the cell list
+ * dimensions and grid shift are unchanged.
+ */
+void mpcd::CellList::endPrebin()
+    {
+    m_prebin_cell_list.reset();
+    m_prebinned = (m_prebin_failed.load() == 0);
+    }
+
 /*!
  * \param timestep Current simulation timestep
  */
 void mpcd::CellList::buildCellList()
     {
-    const BoxDim& box = m_pdata->getBox();
-    const uchar3 periodic = box.getPeriodic();
+    // only use particles binned during streaming if nothing has changed since
+    const bool prebinned = m_prebinned &&
+                           m_prebin_N == m_mpcd_pdata->getN() &&
+                           m_prebin_shift.x == m_grid_shift.x &&
+                           m_prebin_shift.y == m_grid_shift.y &&
+                           m_prebin_shift.z == m_grid_shift.z;
+    m_prebinned = false;
+
+    unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
+    unsigned int N_tot = N_mpcd;
+    if (m_embed_group)
+        N_tot += m_embed_group->getNumMembers();
 
-    ArrayHandle<unsigned int> h_cell_list(m_cell_list, access_location::host, access_mode::overwrite);
+    // the compact layout holds every particle exactly once
+    if (m_compact && N_tot > m_cell_list.size())
+        m_cell_list.resize(N_tot);
+
+    const bool keep_members = prebinned && !m_compact;
+    ArrayHandle<unsigned int> h_cell_list(m_cell_list, access_location::host, keep_members ? access_mode::readwrite : access_mode::overwrite);
     ArrayHandle<unsigned int> h_cell_np(m_cell_np, access_location::host, access_mode::overwrite);
-    // zero the cell counter
-    memset(h_cell_np.data, 0, sizeof(unsigned int) * m_cell_indexer.getNumElements());
 
-    uint3 conditions = make_uint3(0,0,0);
+    // zero the cell counters, unless they already hold the binned particles
+    const unsigned int num_cells = m_cell_indexer.getNumElements();
+    if (num_cells > m_num_cell_counter)
+        {
+        m_cell_counter.reset(new std::atomic<unsigned int>[num_cells]);
+        m_num_cell_counter = num_cells;
+        }
+    std::atomic<unsigned int>* cell_counter = m_cell_counter.get();
+    if (!prebinned)
+        {
+        mpcd::detail::parallel_for(0, num_cells, [&](unsigned int cur_cell)
+            {
+            cell_counter[cur_cell].store(0, std::memory_order_relaxed);
+            });
+        }
+
+    std::atomic<unsigned int> overflow(prebinned ? m_prebin_overflow.load() : 0), nan_particle(0), out_particle(0);
 
     ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
-    unsigned int N_tot = N_mpcd;
 
     // we can't modify the velocity of embedded particles, so we only read their position
     std::unique_ptr< ArrayHandle<unsigned int> > h_embed_cell_ids;
@@ -520,21 +685,13 @@ void mpcd::CellList::buildCellList()
         h_embed_cell_ids.reset(new ArrayHandle<unsigned int>(m_embed_cell_ids, access_location::host, access_mode::overwrite));
         h_pos_embed.reset(new ArrayHandle<Scalar4>(m_pdata->getPositions(), access_location::host, access_mode::read));
         h_embed_member_idx.reset(new ArrayHandle<unsigned int>(m_embed_group->getIndexArray(), access_location::host, access_mode::read));
-        N_tot += m_embed_group->getNumMembers();
         }
 
-    // total effective number of cells in the global box, optionally padded by
-    // extra cells in MPI simulations
-    uint3 n_global_cells = m_global_cell_dim;
-    #ifdef ENABLE_MPI
-    if (isCommunicating(mpcd::detail::face::east)) n_global_cells.x += 2*m_num_extra;
-    if (isCommunicating(mpcd::detail::face::north)) n_global_cells.y += 2*m_num_extra;
-    if (isCommunicating(mpcd::detail::face::up)) n_global_cells.z += 2*m_num_extra;
-    #endif // ENABLE_MPI
+    const mpcd::detail::CellBinner binner = getBinner();
 
-    const Scalar3 global_lo = m_pdata->getGlobalBox().getLo();
-
-    for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+    // first pass: bin and count the particles, skipping MPCD particles that are already binned
+    const unsigned int first_p = prebinned ? m_mpcd_pdata->getN() : 0;
+    mpcd::detail::parallel_for(first_p, N_tot, [&](unsigned int cur_p)
         {
         Scalar4 postype_i;
         if (cur_p < N_mpcd)
@@ -549,65 +706,31 @@ void mpcd::CellList::buildCellList()
 
         if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
             {
-            conditions.y = cur_p + 1;
-            continue;
-            }
-
-        // bin particle assuming orthorhombic box (already validated)
-        const Scalar3 delta = (pos_i - m_grid_shift) - global_lo;
-        int3 global_bin = make_int3(std::floor(delta.x / m_cell_size),
-                                    std::floor(delta.y / m_cell_size),
-                                    std::floor(delta.z / m_cell_size));
-
-        // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
-        // this is done using periodic from the "local" box, since this will be periodic
-        // only when there is one rank along the dimension
-        if (periodic.x)
-            {
-            if (global_bin.x == (int)n_global_cells.x)
-                global_bin.x = 0;
-            else if (global_bin.x == -1)
-                global_bin.x = n_global_cells.x - 1;
-            }
-        if (periodic.y)
-            {
-            if (global_bin.y == (int)n_global_cells.y)
-                global_bin.y = 0;
-            else if (global_bin.y == -1)
-                global_bin.y = n_global_cells.y - 1;
-            }
-        if (periodic.z)
-            {
-            if (global_bin.z == (int)n_global_cells.z)
-                global_bin.z = 0;
-            else if (global_bin.z == -1)
-                global_bin.z = n_global_cells.z - 1;
+            mpcd::detail::atomic_max(nan_particle, cur_p + 1);
+            return;
             }
 
-        // compute the local cell
-        int3 bin = make_int3(global_bin.x - m_origin_idx.x,
-                             global_bin.y - m_origin_idx.y,
-                             global_bin.z - m_origin_idx.z);
-
         // validate and make sure no particles blew out of the box
-        if ((bin.x < 0 || bin.x >= (int)m_cell_dim.x) ||
-            (bin.y < 0 || bin.y >= (int)m_cell_dim.y) ||
-            (bin.z < 0 || bin.z >= (int)m_cell_dim.z))
+        const unsigned int bin_idx = binner(pos_i);
+        if (bin_idx == mpcd::detail::NO_CELL)
             {
-            conditions.z = cur_p + 1;
-            continue;
+            mpcd::detail::atomic_max(out_particle, cur_p + 1);
+            return;
             }
 
-        unsigned int bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
-        unsigned int offset = h_cell_np.data[bin_idx];
-        if (offset < m_cell_np_max)
-            {
-            h_cell_list.data[m_cell_list_indexer(offset, bin_idx)] = cur_p;
-            }
-        else
+        // increment the counter always, and claim a slot in the cell right away in the dense layout
+        unsigned int offset = cell_counter[bin_idx].fetch_add(1, std::memory_order_relaxed);
+        if (!m_compact)
             {
-            // overflow
-            conditions.x = std::max(conditions.x, offset+1);
+            if (offset < m_cell_np_max)
+                {
+                h_cell_list.data[m_cell_list_indexer(offset, bin_idx)] = cur_p;
+                }
+            else
+                {
+                // overflow
+                mpcd::detail::atomic_max(overflow, offset+1);
+                }
             }
 
         // stash the current particle bin into the velocity array
@@ -619,13 +742,71 @@ void mpcd::CellList::buildCellList()
             {
             h_embed_cell_ids->data[cur_p - N_mpcd] = bin_idx;
             }
+        });
+
+    if (m_compact)
+        {
+        // particles that could not be binned are reported from the conditions instead
+        if (nan_particle.load() == 0 && out_particle.load() == 0)
+            {
+            ArrayHandle<unsigned int> h_cell_offsets(m_cell_offsets, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_occupied_cells(m_occupied_cells, access_location::host, access_mode::overwrite);
 
-        // increment the counter always
-        ++h_cell_np.data[bin_idx];
+            // second pass: write the counts and scan them into the offsets, collecting the occupied cells
+            unsigned int num_members = 0, num_occupied = 0, np_max = 0;
+            for (unsigned int cur_cell=0; cur_cell < num_cells; ++cur_cell)
+                {
+                const unsigned int np = cell_counter[cur_cell].load(std::memory_order_relaxed);
+                h_cell_np.data[cur_cell] = np;
+                h_cell_offsets.data[cur_cell] = num_members;
+                cell_counter[cur_cell].store(num_members, std::memory_order_relaxed);
+                if (np > 0)
+                    {
+                    h_occupied_cells.data[num_occupied++] = cur_cell;
+                    np_max = std::max(np, np_max);
+                    }
+                num_members += np;
+                }
+            m_num_occupied = num_occupied;
+            if (np_max > 0)
+                m_cell_np_max = np_max;
+
+            // third pass: place the particles using the bins stashed in the first pass
+            mpcd::detail::parallel_for(0, N_tot, [&](unsigned int cur_p)
+                {
+                const unsigned int bin_idx = (cur_p < N_mpcd) ? __scalar_as_int(h_vel.data[cur_p].w)
+                                                              : h_embed_cell_ids->data[cur_p - N_mpcd];
+                h_cell_list.data[cell_counter[bin_idx].fetch_add(1, std::memory_order_relaxed)] = cur_p;
+                });
+
+            #ifdef ENABLE_TBB
+            // order the particles in every cell by index as in a serial build
+            mpcd::detail::parallel_for(0, num_occupied, [&](unsigned int i)
+                {
+                const unsigned int cur_cell = h_occupied_cells.data[i];
+                unsigned int *first = h_cell_list.data + h_cell_offsets.data[cur_cell];
+                std::sort(first, first + h_cell_np.data[cur_cell]);
+                });
+            #endif // ENABLE_TBB
+            }
+        }
+    else
+        {
+        // second pass: write the counts, and order the particles in every cell by index as in a serial build
+        mpcd::detail::parallel_for(0, num_cells, [&](unsigned int cur_cell)
+            {
+            const unsigned int np = cell_counter[cur_cell].load(std::memory_order_relaxed);
+            h_cell_np.data[cur_cell] = np;
+
+            #ifdef ENABLE_TBB
+            unsigned int *first = h_cell_list.data + m_cell_list_indexer(0, cur_cell);
+            std::sort(first, first + std::min(np, m_cell_np_max));
+            #endif // ENABLE_TBB
+            });
         }
 
     // write out the conditions
-    m_conditions.resetFlags(conditions);
+    m_conditions.resetFlags(make_uint3(overflow.load(), nan_particle.load(), out_particle.load()));
     }
 
 /*!
@@ -637,6 +818,9 @@ void mpcd::CellList::sort(unsigned int timestep,
                           const GPUArray<unsigned int>& order,
                           const GPUArray<unsigned int>& rorder)
     {
+    // particles binned during streaming refer to the old order
+    m_prebinned = false;
+
     // no need to do any sorting if we can still be called at the current timestep
     if (peekCompute(timestep)) return;
 
@@ -653,19 +837,23 @@ void mpcd::CellList::sort(unsigned int timestep,
     ArrayHandle<unsigned int> h_rorder(rorder, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_cell_np(m_cell_np, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_cell_list(m_cell_list, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_cell_offsets(m_cell_offsets, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_occupied_cells(m_occupied_cells, access_location::host, access_mode::read);
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
 
-    for (unsigned int idx=0; idx < getNCells(); ++idx)
+    const unsigned int num_cells = (m_compact) ? m_num_occupied : getNCells();
+    for (unsigned int i=0; i < num_cells; ++i)
         {
+        const unsigned int idx = (m_compact) ? h_occupied_cells.data[i] : i;
         const unsigned int np = h_cell_np.data[idx];
+        unsigned int *members = h_cell_list.data + h_cell_offsets.data[idx];
         for (unsigned int offset = 0; offset < np; ++offset)
             {
-            const unsigned int cl_idx = m_cell_list_indexer(offset,idx);
-            const unsigned int pid = h_cell_list.data[cl_idx];
+            const unsigned int pid = members[offset];
             // only update indexes of MPCD particles, not virtual or embedded particles
             if (pid < N_mpcd)
                 {
-                h_cell_list.data[cl_idx] = h_rorder.data[pid];
+                members[offset] = h_rorder.data[pid];
                 }
             }
         }
@@ -858,6 +1046,7 @@ void mpcd::detail::export_CellList(pybind11::module& m)
     py::class_<mpcd::CellList, std::shared_ptr<mpcd::CellList> >(m, "CellList", py::base<Compute>())
         .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<mpcd::ParticleData> >())
         .def_property("cell_size", &mpcd::CellList::getCellSize, &mpcd::CellList::setCellSize)
+        .def_property("compact", &mpcd::CellList::isCompact, &mpcd::CellList::setCompact)
         .def("setEmbeddedGroup", &mpcd::CellList::setEmbeddedGroup)
         .def("removeEmbeddedGroup", &mpcd::CellList::removeEmbeddedGroup)
         ;
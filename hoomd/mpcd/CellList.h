@@ -17,6 +17,7 @@
 
 #include "ParticleData.h"
 #include "CommunicatorUtilities.h"
+#include "ThreadingUtilities.h"
 
 #include "hoomd/Compute.h"
 #include "hoomd/GPUFlags.h"
@@ -26,10 +27,87 @@
 #include "hoomd/extern/pybind/include/pybind11/pybind11.h"
 
 #include <array>
+#include <atomic>
+#include <memory>
 
 namespace mpcd
 {
 
+namespace detail
+{
+//! Bins positions into the local cells of an orthorhombic MPCD cell list
+/*!
+ * The binning parameters are captured once so that they can be used inside
+ * tight particle loops. Positions are shifted by the grid shift, wrapped back
+ * through periodic boundaries, and converted to a local cell index.
+ */
+struct CellBinner
+    {
+    Scalar3 grid_shift;     //!< Grid shift of the cell list
+    Scalar3 global_lo;      //!< Lower corner of the global box
+    Scalar cell_size;       //!< MPCD cell width
+    uchar3 periodic;        //!< Periodic flags of the local box
+    uint3 n_global_cells;   //!< Number of global cells, including any padding
+    int3 origin_idx;        //!< Global index of the first local cell
+    uint3 cell_dim;         //!< Number of local cells
+    Index3D cell_indexer;   //!< Indexer of the local cells
+
+    //! Compute the local cell of a position
+    /*!
+     * \param pos Position to bin
+     * \returns The local cell index of \a pos, or mpcd::detail::NO_CELL if it lies outside the local cells
+     */
+    unsigned int operator()(const Scalar3& pos) const
+        {
+        // bin particle assuming orthorhombic box (already validated)
+        const Scalar3 delta = (pos - grid_shift) - global_lo;
+        int3 global_bin = make_int3(std::floor(delta.x / cell_size),
+                                    std::floor(delta.y / cell_size),
+                                    std::floor(delta.z / cell_size));
+
+        // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
+        // this is done using periodic from the "local" box, since this will be periodic
+        // only when there is one rank along the dimension
+        if (periodic.x)
+            {
+            if (global_bin.x == (int)n_global_cells.x)
+                global_bin.x = 0;
+            else if (global_bin.x == -1)
+                global_bin.x = n_global_cells.x - 1;
+            }
+        if (periodic.y)
+            {
+            if (global_bin.y == (int)n_global_cells.y)
+                global_bin.y = 0;
+            else if (global_bin.y == -1)
+                global_bin.y = n_global_cells.y - 1;
+            }
+        if (periodic.z)
+            {
+            if (global_bin.z == (int)n_global_cells.z)
+                global_bin.z = 0;
+            else if (global_bin.z == -1)
+                global_bin.z = n_global_cells.z - 1;
+            }
+
+        // compute the local cell
+        const int3 bin = make_int3(global_bin.x - origin_idx.x,
+                                   global_bin.y - origin_idx.y,
+                                   global_bin.z - origin_idx.z);
+
+        // validate and make sure no particles blew out of the box
+        if ((bin.x < 0 || bin.x >= (int)cell_dim.x) ||
+            (bin.y < 0 || bin.y >= (int)cell_dim.y) ||
+            (bin.z < 0 || bin.z >= (int)cell_dim.z))
+            {
+            return mpcd::detail::NO_CELL;
+            }
+
+        return cell_indexer(bin.x, bin.y, bin.z);
+        }
+    };
+} // end namespace detail
+
 //! Computes the MPCD cell list on the CPU
 class PYBIND11_EXPORT CellList : public Compute
     {
@@ -78,11 +156,48 @@ class PYBIND11_EXPORT CellList : public Compute
             }
 
         //! Get the cell list indexer
+        /*!
+         * \note The indexer is only valid for the dense layout of the cell list.
+         */
         const Index2D& getCellListIndexer() const
             {
             return m_cell_list_indexer;
             }
 
+        //! Get the offset of the first member of each cell in the cell list
+        /*!
+         * The members of a cell are stored contiguously starting from this offset,
+         * in both the dense and the compact layout.
+         */
+        const GPUArray<unsigned int>& getCellOffsets() const
+            {
+            return m_cell_offsets;
+            }
+
+        //! Get the cells that hold particles, in increasing order
+        /*!
+         * \note The occupied cells are only determined for the compact layout.
+         */
+        const GPUArray<unsigned int>& getOccupiedCells() const
+            {
+            return m_occupied_cells;
+            }
+
+        //! Get the number of cells that hold particles
+        unsigned int getNOccupiedCells() const
+            {
+            return m_num_occupied;
+            }
+
+        //! Use the compact layout for the cell list
+        void setCompact(bool compact);
+
+        //! Check if the cell list uses the compact layout
+        bool isCompact() const
+            {
+            return m_compact;
+            }
+
         //! Get the number of cells in each dimension
         const uint3& getDim() const
             {
@@ -200,6 +315,55 @@ class PYBIND11_EXPORT CellList : public Compute
             return m_grid_shift;
             }
 
+        //! Request that the next streaming step bins the MPCD particles
+        /*!
+         * \param timestep Timestep of the cell list build that uses the binned particles
+         *
+         * The grid shift for \a timestep must already be set. The request is dropped
+         * if it is not taken up before the next call to compute().
+         */
+        void requestPrebin(unsigned int timestep)
+            {
+            m_prebin_requested = true;
+            m_prebin_timestep = timestep;
+            }
+
+        //! Start binning the MPCD particles while they are streamed
+        bool beginPrebin();
+
+        //! Bin a streamed MPCD particle
+        /*!
+         * \param idx Index of the MPCD particle
+         * \param pos Final (wrapped) position of the particle
+         * \returns The local cell of the particle, to be cached in the last element of its velocity
+         *
+         * This method may be called concurrently for different particles between beginPrebin() and endPrebin().
+         */
+        unsigned int prebinParticle(unsigned int idx, const Scalar3& pos)
+            {
+            const unsigned int bin = m_prebin_binner(pos);
+            if (bin == mpcd::detail::NO_CELL)
+                {
+                // leave the error handling to a regular build
+                m_prebin_failed.store(1, std::memory_order_relaxed);
+                return bin;
+                }
+
+            // in the compact layout, the particles are only counted and are placed during the build
+            const unsigned int offset = m_cell_counter[bin].fetch_add(1, std::memory_order_relaxed);
+            if (m_compact)
+                return bin;
+
+            if (offset < m_cell_np_max)
+                m_prebin_cell_list->data[m_cell_list_indexer(offset, bin)] = idx;
+            else
+                mpcd::detail::atomic_max(m_prebin_overflow, offset+1);
+            return bin;
+            }
+
+        //! Finish binning the MPCD particles
+        void endPrebin();
+
         //! Calculate current cell occupancy statistics
         virtual void getCellStatistics() const;
 
@@ -247,6 +411,9 @@ class PYBIND11_EXPORT CellList : public Compute
         //! Allocates internal data arrays
         virtual void reallocate();
 
+        //! Get the binning parameters for the current grid shift
+        mpcd::detail::CellBinner getBinner();
+
         Scalar m_cell_size;                         //!< MPCD cell width
         uint3 m_cell_dim;                           //!< Number of cells in each direction
         uint3 m_global_cell_dim;                    //!< Number of cells in each direction of global simulation box
@@ -256,8 +423,24 @@ class PYBIND11_EXPORT CellList : public Compute
         unsigned int m_cell_np_max;                 //!< Maximum number of particles per cell
         GPUVector<unsigned int> m_cell_np;          //!< Number of particles per cell
         GPUVector<unsigned int> m_cell_list;        //!< Cell list of particles
+        GPUVector<unsigned int> m_cell_offsets;     //!< Offset of the first member of each cell
+        GPUVector<unsigned int> m_occupied_cells;   //!< Cells holding particles (compact layout only)
+        unsigned int m_num_occupied;                //!< Number of cells holding particles
+        bool m_compact;                             //!< True if the compact layout is used
         GPUVector<unsigned int> m_embed_cell_ids;   //!< Cell ids of the embedded particles
         GPUFlags<uint3> m_conditions;               //!< Detect conditions that might fail building cell list
+        std::unique_ptr< std::atomic<unsigned int>[] > m_cell_counter; //!< Particles counted per cell on the CPU
+        unsigned int m_num_cell_counter;            //!< Number of cells in m_cell_counter
+
+        bool m_prebin_requested;                    //!< True if the next streaming step should bin the particles
+        bool m_prebinned;                           //!< True if the MPCD particles were binned during streaming
+        unsigned int m_prebin_timestep;             //!< Timestep of the build that the binned particles are for
+        unsigned int m_prebin_N;                    //!< Number of MPCD particles that were binned
+        Scalar3 m_prebin_shift;                     //!< Grid shift that the particles were binned with
+        mpcd::detail::CellBinner m_prebin_binner;   //!< Binning parameters while streaming
+        std::unique_ptr< ArrayHandle<unsigned int> > m_prebin_cell_list; //!< Cell list access while streaming
+        std::atomic<unsigned int> m_prebin_overflow;    //!< Largest cell occupancy that overflowed while streaming
+        std::atomic<unsigned int> m_prebin_failed;      //!< Nonzero if a streamed particle could not be binned
 
         int3 m_origin_idx;                  //!< Origin as a global index
 
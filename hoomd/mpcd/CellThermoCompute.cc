@@ -10,6 +10,10 @@
 
 #include "CellThermoCompute.h"
 #include "ReductionOperators.h"
+#include "ThreadingUtilities.h"
+
+#include <algorithm>
+#include <vector>
 
 /*!
  * \param sysdata MPCD system data
@@ -36,11 +40,15 @@ mpcd::CellThermoCompute::CellThermoCompute(std::shared_ptr<mpcd::SystemData> sys
         m_use_mpi = true;
         m_vel_comm = std::make_shared<mpcd::CellCommunicator>(m_sysdef, m_cl);
         m_energy_comm = std::make_shared<mpcd::CellCommunicator>(m_sysdef, m_cl);
+
+        GPUVector<mpcd::detail::cell_thermo_sum> outer_sum(m_exec_conf);
+        m_outer_sum.swap(outer_sum);
         }
     else
         {
         m_use_mpi = false;
         }
+    m_outer_uniform_mass = false;
     #endif // ENABLE_MPI
 
     // the thermo properties need to be recomputed if the virtual particles change
@@ -79,19 +87,30 @@ void mpcd::CellThermoCompute::compute(unsigned int timestep)
 
 void mpcd::CellThermoCompute::computeCellProperties(unsigned int timestep)
     {
+    /*
+     * The compact cell list only visits occupied cells, so all cells are zeroed
+     * first to leave the empty cells without mass, energy, or particles.
+     */
+    if (m_cl->isCompact())
+        {
+        ArrayHandle<double4> h_cell_vel(m_cell_vel, access_location::host, access_mode::overwrite);
+        std::fill(h_cell_vel.data, h_cell_vel.data + m_ncells_alloc, make_double4(0.0, 0.0, 0.0, 0.0));
+        if (m_flags[mpcd::detail::thermo_options::energy])
+            {
+            ArrayHandle<double3> h_cell_energy(m_cell_energy, access_location::host, access_mode::overwrite);
+            std::fill(h_cell_energy.data, h_cell_energy.data + m_ncells_alloc, make_double3(0.0, 0.0, __int_as_double(0)));
+            }
+        }
+
     /*
      * In MPI simulations, begin by calculating the velocities and energies of
-     * cells that lie along the boundaries. These values will then be communicated
-     * while calculations proceed on the inner cells.
+     * cells that lie along the boundaries, and start communicating them. The
+     * communication proceeds while calculations are done on the inner cells.
      */
     #ifdef ENABLE_MPI
     if (m_use_mpi)
         {
         beginOuterCellProperties();
-
-        m_vel_comm->begin(m_cell_vel, mpcd::detail::CellVelocityPackOp());
-        if (m_flags[mpcd::detail::thermo_options::energy])
-            m_energy_comm->begin(m_cell_energy, mpcd::detail::CellEnergyPackOp());
         }
     #endif // ENABLE_MPI
 
@@ -114,10 +133,6 @@ void mpcd::CellThermoCompute::computeCellProperties(unsigned int timestep)
     #ifdef ENABLE_MPI
     if (m_use_mpi)
         {
-        if (m_flags[mpcd::detail::thermo_options::energy])
-            m_energy_comm->finalize(m_cell_energy, mpcd::detail::CellEnergyPackOp());
-        m_vel_comm->finalize(m_cell_vel, mpcd::detail::CellVelocityPackOp());
-
         finishOuterCellProperties();
         }
     #endif // ENABLE_MPI
@@ -139,7 +154,7 @@ struct CellPropertySum
     /*!
      * \param cell_list_ Cell list
      * \param cell_np_ Number of particles per cell
-     * \param cli_ Cell list indexer
+     * \param cell_offsets_ Offset of the first member of each cell
      * \param vel_ MPCD particle velocities
      * \param mass_ MPCD mass
      * \param embed_vel_ Embedded particle velocities
@@ -148,13 +163,13 @@ struct CellPropertySum
      */
     CellPropertySum(const unsigned int *cell_list_,
                     const unsigned int *cell_np_,
-                    const Index2D& cli_,
+                    const unsigned int *cell_offsets_,
                     const Scalar4 *vel_,
                     const Scalar mass_,
                     const Scalar4 *embed_vel_,
                     const unsigned int *embed_idx_,
                     const unsigned int N_mpcd_)
-        : cell_list(cell_list_), cell_np(cell_np_), cli(cli_), vel(vel_), mass(mass_),
+        : cell_list(cell_list_), cell_np(cell_np_), cell_offsets(cell_offsets_), vel(vel_), mass(mass_),
           embed_vel(embed_vel_), embed_idx(embed_idx_), N_mpcd(N_mpcd_)
         {}
 
@@ -166,16 +181,17 @@ struct CellPropertySum
      * \param cell Index of cell to evaluate
      * \param energy If true, then the kinetic energy is evaluated into \a ke
      */
-    inline void compute(double4& momentum, double& ke, unsigned int& np, const unsigned int cell, const bool energy)
+    inline void compute(double4& momentum, double& ke, unsigned int& np, const unsigned int cell, const bool energy) const
         {
         momentum = make_double4(0.0, 0.0, 0.0, 0.0);
         ke = 0.0;
         np = cell_np[cell];
 
+        const unsigned int *members = cell_list + cell_offsets[cell];
         for (unsigned int offset = 0; offset < np; ++offset)
             {
             // Load particle data
-            const unsigned int cur_p = cell_list[cli(offset, cell)];
+            const unsigned int cur_p = members[offset];
             double3 vel_i;
             double mass_i;
             if (cur_p < N_mpcd)
@@ -205,7 +221,7 @@ struct CellPropertySum
 
     const unsigned int *cell_list;  //!< Cell list
     const unsigned int *cell_np;    //!< Number of particles per cell
-    const Index2D cli;              //!< Cell list indexer
+    const unsigned int *cell_offsets; //!< Offset of the first member of each cell
 
     const Scalar4 *vel;             //!< MPCD particle velocities
     const Scalar mass;              //!< MPCD particle mass
@@ -222,7 +238,7 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
     // Cell list
     ArrayHandle<unsigned int> h_cell_list(m_cl->getCellList(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_cell_np(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
-    const Index2D& cli = m_cl->getCellListIndexer();
+    ArrayHandle<unsigned int> h_cell_offsets(m_cl->getCellOffsets(), access_location::host, access_mode::read);
 
     // MPCD particle data
     ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
@@ -239,51 +255,110 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
         }
 
     // Cell properties
-    ArrayHandle<double4> h_cell_vel(m_cell_vel, access_location::host, access_mode::overwrite);
-    ArrayHandle<double3> h_cell_energy(m_cell_energy, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_cells(m_vel_comm->getCells(), access_location::host, access_mode::read);
     mpcd::detail::CellPropertySum summer(h_cell_list.data,
                                          h_cell_np.data,
-                                         cli,
+                                         h_cell_offsets.data,
                                          h_vel.data,
                                          mpcd_mass,
                                          (m_cl->getEmbeddedGroup()) ? h_embed_vel->data : NULL,
                                          (m_cl->getEmbeddedGroup()) ? h_embed_member_idx->data : NULL,
                                          N_mpcd);
 
-    // Loop over all outer cells and compute total momentum, mass, energy
+    /*
+     * Loop over all outer cells and compute total momentum, mass, energy. If the energy is needed, all sums
+     * are staged so that they can be sent in one message. Otherwise, only the velocity sums are sent.
+     */
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
-    for (unsigned int idx=0; idx < m_vel_comm->getNCells(); ++idx)
+    if (need_energy)
         {
-        const unsigned int cur_cell = h_cells.data[idx];
+            {
+            ArrayHandle<mpcd::detail::cell_thermo_sum> h_outer_sum(m_outer_sum, access_location::host, access_mode::overwrite);
+            for (unsigned int idx=0; idx < m_vel_comm->getNCells(); ++idx)
+                {
+                const unsigned int cur_cell = h_cells.data[idx];
 
-        // compute the cell properties
-        double4 momentum; double ke(0.0); unsigned int np(0);
-        summer.compute(momentum, ke, np, cur_cell, need_energy);
+                double4 momentum; double ke(0.0); unsigned int np(0);
+                summer.compute(momentum, ke, np, cur_cell, true);
+
+                mpcd::detail::cell_thermo_sum sum;
+                sum.momentum = make_double3(momentum.x, momentum.y, momentum.z);
+                sum.mass = momentum.w;
+                sum.energy = ke;
+                sum.np = np;
+                h_outer_sum.data[cur_cell] = sum;
+                }
+            }
 
-        h_cell_vel.data[cur_cell] = make_double4(momentum.x, momentum.y, momentum.z, momentum.w);
-        if (need_energy)
-            h_cell_energy.data[cur_cell] = make_double3(ke, 0.0, __int_as_double(np));
+        // without embedded particles, the cell mass follows from the number of particles
+        m_outer_uniform_mass = !m_cl->getEmbeddedGroup();
+        if (m_outer_uniform_mass)
+            m_vel_comm->begin(m_outer_sum, mpcd::detail::CellUniformMassThermoPackOp(mpcd_mass));
+        else
+            m_vel_comm->begin(m_outer_sum, mpcd::detail::CellThermoPackOp());
+        }
+    else
+        {
+            {
+            ArrayHandle<double4> h_cell_vel(m_cell_vel, access_location::host, access_mode::overwrite);
+            for (unsigned int idx=0; idx < m_vel_comm->getNCells(); ++idx)
+                {
+                const unsigned int cur_cell = h_cells.data[idx];
+
+                double4 momentum; double ke(0.0); unsigned int np(0);
+                summer.compute(momentum, ke, np, cur_cell, false);
+
+                h_cell_vel.data[cur_cell] = make_double4(momentum.x, momentum.y, momentum.z, momentum.w);
+                }
+            }
+
+        m_vel_comm->begin(m_cell_vel, mpcd::detail::CellVelocityPackOp());
         }
     }
 
 void mpcd::CellThermoCompute::finishOuterCellProperties()
     {
+    const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
+    if (need_energy)
+        {
+        const Scalar mpcd_mass = m_mpcd_pdata->getMass();
+        if (m_outer_uniform_mass)
+            m_vel_comm->finalize(m_outer_sum, mpcd::detail::CellUniformMassThermoPackOp(mpcd_mass));
+        else
+            m_vel_comm->finalize(m_outer_sum, mpcd::detail::CellThermoPackOp());
+        }
+    else
+        {
+        m_vel_comm->finalize(m_cell_vel, mpcd::detail::CellVelocityPackOp());
+        }
+
     ArrayHandle<double4> h_cell_vel(m_cell_vel, access_location::host, access_mode::readwrite);
     ArrayHandle<double3> h_cell_energy(m_cell_energy, access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::detail::cell_thermo_sum> h_outer_sum(m_outer_sum, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_cells(m_vel_comm->getCells(), access_location::host, access_mode::read);
 
     // Loop over all outer cells and normalize the summed quantities
-    const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
     for (unsigned int idx=0; idx < m_vel_comm->getNCells(); ++idx)
         {
         const unsigned int cur_cell = h_cells.data[idx];
 
-        // average cell properties if the cell has mass
-        const double4 cell_vel = h_cell_vel.data[cur_cell];
-        double3 vel_cm = make_double3(cell_vel.x, cell_vel.y, cell_vel.z);
-        const double mass = cell_vel.w;
+        // sums were either staged or reduced directly into the cell velocity
+        double3 vel_cm;
+        double mass;
+        if (need_energy)
+            {
+            const mpcd::detail::cell_thermo_sum sum = h_outer_sum.data[cur_cell];
+            vel_cm = sum.momentum;
+            mass = sum.mass;
+            }
+        else
+            {
+            const double4 cell_vel = h_cell_vel.data[cur_cell];
+            vel_cm = make_double3(cell_vel.x, cell_vel.y, cell_vel.z);
+            mass = cell_vel.w;
+            }
 
+        // average cell properties if the cell has mass
         if (mass > 0.)
             {
             // average velocity is only defined when there is some mass in the cell
@@ -293,10 +368,10 @@ void mpcd::CellThermoCompute::finishOuterCellProperties()
 
         if (need_energy)
             {
-            const double3 cell_energy = h_cell_energy.data[cur_cell];
-            const double ke = cell_energy.x;
+            const mpcd::detail::cell_thermo_sum& sum = h_outer_sum.data[cur_cell];
+            const double ke = sum.energy;
             double temp(0.0);
-            const unsigned int np = __double_as_int(cell_energy.z);
+            const unsigned int np = sum.np;
             // temperature is only defined for 2 or more particles
             if (np > 1)
                 {
@@ -307,14 +382,43 @@ void mpcd::CellThermoCompute::finishOuterCellProperties()
             }
         }
     }
+
+void mpcd::CellThermoCompute::progressOuterCellProperties()
+    {
+    if (!m_use_mpi) return;
+
+    m_vel_comm->progress();
+    m_energy_comm->progress();
+    }
 #endif // ENABLE_MPI
 
+/*!
+ * \param n Number of iterations
+ * \param num_batches Number of batches to split the iterations into
+ * \param f Function to call for every iteration
+ *
+ * Each batch is processed with mpcd::detail::parallel_for, and the outer cell communication is advanced
+ * after every batch.
+ */
+template<class Function>
+void mpcd::CellThermoCompute::batchedFor(unsigned int n, unsigned int num_batches, const Function& f)
+    {
+    const unsigned int batch_size = (n + num_batches - 1) / num_batches;
+    for (unsigned int first=0; first < n; first += batch_size)
+        {
+        mpcd::detail::parallel_for(first, std::min(first + batch_size, n), f);
+        #ifdef ENABLE_MPI
+        progressOuterCellProperties();
+        #endif // ENABLE_MPI
+        }
+    }
+
 void mpcd::CellThermoCompute::calcInnerCellProperties()
     {
     // Cell list
-    const Index2D& cli = m_cl->getCellListIndexer();
     ArrayHandle<unsigned int> h_cell_list(m_cl->getCellList(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_cell_np(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_offsets(m_cl->getCellOffsets(), access_location::host, access_mode::read);
 
     // MPCD particle data
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
@@ -335,7 +439,7 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
     ArrayHandle<double3> h_cell_energy(m_cell_energy, access_location::host, access_mode::readwrite);
     mpcd::detail::CellPropertySum summer(h_cell_list.data,
                                          h_cell_np.data,
-                                         cli,
+                                         h_cell_offsets.data,
                                          h_vel.data,
                                          mpcd_mass,
                                          (m_cl->getEmbeddedGroup()) ? h_embed_vel->data : NULL,
@@ -363,43 +467,79 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
         hi = m_cl->getDim();
         }
 
-    // iterate over all of the inner cells and compute average velocity, energy, temperature
+    // compute average velocity, energy, temperature of a cell
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
-    for (unsigned int k=lo.z; k < hi.z; ++k)
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    auto calc_cell = [&](unsigned int cur_cell)
         {
-        for (unsigned int j=lo.y; j < hi.y; ++j)
+        // compute the cell properties
+        double4 momentum; double ke(0.0); unsigned int np(0);
+        summer.compute(momentum, ke, np, cur_cell, need_energy);
+
+        const double mass = momentum.w;
+        double3 vel_cm = make_double3(0.0,0.0,0.0);
+        if (mass > 0.)
             {
-            for (unsigned int i=lo.x; i < hi.x; ++i)
-                {
-                const unsigned int cur_cell = ci(i,j,k);
+            vel_cm.x = momentum.x / mass;
+            vel_cm.y = momentum.y / mass;
+            vel_cm.z = momentum.z / mass;
+            }
 
-                // compute the cell properties
-                double4 momentum; double ke(0.0); unsigned int np(0);
-                summer.compute(momentum, ke, np, cur_cell, need_energy);
+        h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
+        if (need_energy)
+            {
+            double temp(0.0);
+            if (np > 1)
+                {
+                const double ke_cm = 0.5 * mass * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
+                temp = 2. * (ke - ke_cm) / (ndim * (np-1));
+                }
+            h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
+            }
+        };
 
-                const double mass = momentum.w;
-                double3 vel_cm = make_double3(0.0,0.0,0.0);
-                if (mass > 0.)
-                    {
-                    vel_cm.x = momentum.x / mass;
-                    vel_cm.y = momentum.y / mass;
-                    vel_cm.z = momentum.z / mass;
-                    }
+    /*
+     * In MPI simulations, the inner cells are processed in batches, and the outer cell communication is
+     * advanced between them. Many MPI libraries only progress nonblocking messages inside MPI calls,
+     * so this lets the exchange actually overlap with the calculation.
+     */
+    unsigned int num_batches = 1;
+    #ifdef ENABLE_MPI
+    if (m_use_mpi)
+        num_batches = 16;
+    #endif // ENABLE_MPI
 
-                h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
-                if (need_energy)
-                    {
-                    double temp(0.0);
-                    if (np > 1)
-                        {
-                        const double ke_cm = 0.5 * mass * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
-                        temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np-1));
-                        }
-                    h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
-                    }
-                } // i
-            } //j
-        } // k
+    if (m_cl->isCompact())
+        {
+        // only the occupied inner cells are visited, since the other cells have already been zeroed
+        ArrayHandle<unsigned int> h_occupied_cells(m_cl->getOccupiedCells(), access_location::host, access_mode::read);
+        batchedFor(m_cl->getNOccupiedCells(), num_batches, [&](unsigned int idx)
+            {
+            const unsigned int cur_cell = h_occupied_cells.data[idx];
+            const uint3 cell = ci.getTriple(cur_cell);
+            if (cell.x >= lo.x && cell.x < hi.x &&
+                cell.y >= lo.y && cell.y < hi.y &&
+                cell.z >= lo.z && cell.z < hi.z)
+                {
+                calc_cell(cur_cell);
+                }
+            });
+        }
+    else
+        {
+        // iterate over all of the inner cells, every row of cells along x is processed independently
+        const unsigned int num_rows_y = hi.y - lo.y;
+        const unsigned int num_rows = num_rows_y * (hi.z - lo.z);
+        batchedFor(num_rows, num_batches, [&](unsigned int row)
+            {
+            const unsigned int j = lo.y + row % num_rows_y;
+            const unsigned int k = lo.z + row / num_rows_y;
+            for (unsigned int i=lo.x; i < hi.x; ++i)
+                {
+                calc_cell(ci(i,j,k));
+                }
+            });
+        }
     }
 
 void mpcd::CellThermoCompute::computeNetProperties()
@@ -426,37 +566,110 @@ void mpcd::CellThermoCompute::computeNetProperties()
 
         const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
 
-        double3 net_momentum = make_double3(0,0,0);
-        double energy(0.0), temp(0.0);
-        for (unsigned int k=0; k < upper.z; ++k)
+        // sum every plane of cells separately, then add up the planes in order so that the result
+        // does not depend on the number of threads
+        std::vector<double3> plane_momentum(upper.z, make_double3(0,0,0));
+        std::vector<double> plane_energy(upper.z, 0.0), plane_temp(upper.z, 0.0);
+        std::vector<unsigned int> plane_temp_cells(upper.z, 0);
+        const bool compact = m_cl->isCompact();
+        ArrayHandle<unsigned int> h_occupied_cells(m_cl->getOccupiedCells(), access_location::host, access_mode::read);
+        const unsigned int *occupied_begin = h_occupied_cells.data;
+        const unsigned int *occupied_end = occupied_begin + m_cl->getNOccupiedCells();
+
+        // the owned communicated cells hold reduced values even when they have no local particles
+        std::vector<unsigned int> comm_cells;
+        #ifdef ENABLE_MPI
+        if (compact && m_use_mpi)
+            {
+            ArrayHandle<unsigned int> h_cells(m_vel_comm->getCells(), access_location::host, access_mode::read);
+            for (unsigned int idx=0; idx < m_vel_comm->getNCells(); ++idx)
+                {
+                const unsigned int cell_idx = h_cells.data[idx];
+                const uint3 cell = ci.getTriple(cell_idx);
+                if (cell.x < upper.x && cell.y < upper.y && cell.z < upper.z &&
+                    !std::binary_search(occupied_begin, occupied_end, cell_idx))
+                    {
+                    comm_cells.push_back(cell_idx);
+                    }
+                }
+            std::sort(comm_cells.begin(), comm_cells.end());
+            }
+        #endif // ENABLE_MPI
+        const unsigned int *comm_begin = comm_cells.data();
+        const unsigned int *comm_end = comm_begin + comm_cells.size();
+        mpcd::detail::parallel_for(0, upper.z, [&](unsigned int k)
             {
-            for (unsigned int j=0; j < upper.y; ++j)
+            double3 net_momentum = make_double3(0,0,0);
+            double energy(0.0), temp(0.0);
+            unsigned int n_temp(0);
+            auto add_cell = [&](unsigned int idx)
                 {
-                for (unsigned int i=0; i < upper.x; ++i)
+                const double4 cell_vel_mass = h_cell_vel.data[idx];
+                const double3 cell_vel = make_double3(cell_vel_mass.x, cell_vel_mass.y, cell_vel_mass.z);
+                const double cell_mass = cell_vel_mass.w;
+
+                net_momentum.x += cell_mass * cell_vel.x;
+                net_momentum.y += cell_mass * cell_vel.y;
+                net_momentum.z += cell_mass * cell_vel.z;
+
+                if (need_energy)
                     {
-                    const unsigned int idx = ci(i,j,k);
+                    const double3 cell_energy = h_cell_energy.data[idx];
+                    energy += cell_energy.x;
 
-                    const double4 cell_vel_mass = h_cell_vel.data[idx];
-                    const double3 cell_vel = make_double3(cell_vel_mass.x, cell_vel_mass.y, cell_vel_mass.z);
-                    const double cell_mass = cell_vel_mass.w;
+                    if (__double_as_int(cell_energy.z) > 1)
+                        {
+                        temp += cell_energy.y;
+                        ++n_temp;
+                        }
+                    }
+                };
 
-                    net_momentum.x += cell_mass * cell_vel.x;
-                    net_momentum.y += cell_mass * cell_vel.y;
-                    net_momentum.z += cell_mass * cell_vel.z;
+            if (compact)
+                {
+                // empty cells add nothing, and the occupied cells of the plane are contiguous and in the same order
+                const unsigned int *first = std::lower_bound(occupied_begin, occupied_end, ci(0,0,k));
+                const unsigned int *last = std::lower_bound(first, occupied_end, ci(0,0,k+1));
+                for (; first != last; ++first)
+                    {
+                    const uint3 cell = ci.getTriple(*first);
+                    if (cell.x < upper.x && cell.y < upper.y)
+                        add_cell(*first);
+                    }
 
-                    if (need_energy)
+                first = std::lower_bound(comm_begin, comm_end, ci(0,0,k));
+                last = std::lower_bound(first, comm_end, ci(0,0,k+1));
+                for (; first != last; ++first)
+                    {
+                    add_cell(*first);
+                    }
+                }
+            else
+                {
+                for (unsigned int j=0; j < upper.y; ++j)
+                    {
+                    for (unsigned int i=0; i < upper.x; ++i)
                         {
-                        const double3 cell_energy = h_cell_energy.data[idx];
-                        energy += cell_energy.x;
-
-                        if (__double_as_int(cell_energy.z) > 1)
-                            {
-                            temp += cell_energy.y;
-                            ++n_temp_cells;
-                            }
+                        add_cell(ci(i,j,k));
                         }
                     }
                 }
+            plane_momentum[k] = net_momentum;
+            plane_energy[k] = energy;
+            plane_temp[k] = temp;
+            plane_temp_cells[k] = n_temp;
+            });
+
+        double3 net_momentum = make_double3(0,0,0);
+        double energy(0.0), temp(0.0);
+        for (unsigned int k=0; k < upper.z; ++k)
+            {
+            net_momentum.x += plane_momentum[k].x;
+            net_momentum.y += plane_momentum[k].y;
+            net_momentum.z += plane_momentum[k].z;
+            energy += plane_energy[k];
+            temp += plane_temp[k];
+            n_temp_cells += plane_temp_cells[k];
             }
 
         ArrayHandle<double> h_net_properties(m_net_properties, access_location::host, access_mode::overwrite);
@@ -513,6 +726,11 @@ void mpcd::CellThermoCompute::reallocate(unsigned int ncells)
     // Grow arrays to match the size if necessary
     m_cell_vel.resize(ncells);
     m_cell_energy.resize(ncells);
+    #ifdef ENABLE_MPI
+    // only the CPU stages the outer cell sums for a combined message
+    if (m_use_mpi && !m_exec_conf->isCUDAEnabled())
+        m_outer_sum.resize(ncells);
+    #endif // ENABLE_MPI
 
     m_ncells_alloc = ncells;
     }
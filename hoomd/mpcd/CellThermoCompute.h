@@ -149,6 +149,9 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
 
         //! Finish the calculation of outer cell properties
         virtual void finishOuterCellProperties();
+
+        //! Advance communication of the outer cell properties
+        void progressOuterCellProperties();
         #endif // ENABLE_MPI
 
         //! Calculate the inner cell properties
@@ -163,6 +166,8 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
         bool m_use_mpi;                                         //!< Flag if communication is required
         std::shared_ptr<CellCommunicator> m_vel_comm;           //!< Cell velocity communicator
         std::shared_ptr<CellCommunicator> m_energy_comm;        //!< Cell energy communicator
+        GPUVector<mpcd::detail::cell_thermo_sum> m_outer_sum;   //!< Summed outer cell properties for one message
+        bool m_outer_uniform_mass;                              //!< Flag if cell mass is sent implicitly by np
         #endif // ENABLE_MPI
 
         bool m_needs_net_reduce;            //!< Flag if a net reduction is necessary
@@ -183,6 +188,10 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
         //! Allocate memory per cell
         void reallocate(unsigned int ncells);
 
+        //! Loop over a range in batches, advancing the outer cell communication between them
+        template<class Function>
+        void batchedFor(unsigned int n, unsigned int num_batches, const Function& f);
+
         //! Slot for the number of virtual particles changing
         /*!
          * All thermo properties should be recomputed if the number of virtual particles changes.
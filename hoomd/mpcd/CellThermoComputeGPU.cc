@@ -41,6 +41,16 @@ mpcd::CellThermoComputeGPU::~CellThermoComputeGPU()
 
 #ifdef ENABLE_MPI
 void mpcd::CellThermoComputeGPU::beginOuterCellProperties()
+    {
+    sumOuterCellProperties();
+
+    // start the communication, which proceeds while the inner cells are calculated
+    m_vel_comm->begin(m_cell_vel, mpcd::detail::CellVelocityPackOp());
+    if (m_flags[mpcd::detail::thermo_options::energy])
+        m_energy_comm->begin(m_cell_energy, mpcd::detail::CellEnergyPackOp());
+    }
+
+void mpcd::CellThermoComputeGPU::sumOuterCellProperties()
     {
     ArrayHandle<double4> d_cell_vel(m_cell_vel, access_location::device, access_mode::overwrite);
     ArrayHandle<double3> d_cell_energy(m_cell_energy, access_location::device, access_mode::overwrite);
@@ -111,6 +121,10 @@ void mpcd::CellThermoComputeGPU::beginOuterCellProperties()
 
 void mpcd::CellThermoComputeGPU::finishOuterCellProperties()
     {
+    if (m_flags[mpcd::detail::thermo_options::energy])
+        m_energy_comm->finalize(m_cell_energy, mpcd::detail::CellEnergyPackOp());
+    m_vel_comm->finalize(m_cell_vel, mpcd::detail::CellVelocityPackOp());
+
     ArrayHandle<double4> d_cell_vel(m_cell_vel, access_location::device, access_mode::readwrite);
     ArrayHandle<double3> d_cell_energy(m_cell_energy, access_location::device, access_mode::readwrite);
     ArrayHandle<unsigned int> d_cells(m_vel_comm->getCells(), access_location::device, access_mode::read);
@@ -826,5 +826,43 @@ template cudaError_t unpack_cell_buffer(double3 *d_props,
                                         const unsigned int num_cells,
                                         const unsigned int block_size);
 
+//! Explicit template instantiation of pack for combined cell properties
+template cudaError_t pack_cell_buffer(typename mpcd::detail::CellThermoPackOp::element *d_send_buf,
+                                      const mpcd::detail::cell_thermo_sum *d_props,
+                                      const unsigned int *d_send_idx,
+                                      const mpcd::detail::CellThermoPackOp op,
+                                      const unsigned int num_send,
+                                      unsigned int block_size);
+
+//! Explicit template instantiation of pack for combined cell properties with uniform mass
+template cudaError_t pack_cell_buffer(typename mpcd::detail::CellUniformMassThermoPackOp::element *d_send_buf,
+                                      const mpcd::detail::cell_thermo_sum *d_props,
+                                      const unsigned int *d_send_idx,
+                                      const mpcd::detail::CellUniformMassThermoPackOp op,
+                                      const unsigned int num_send,
+                                      unsigned int block_size);
+
+//! Explicit template instantiation of unpack for combined cell properties
+template cudaError_t unpack_cell_buffer(mpcd::detail::cell_thermo_sum *d_props,
+                                        const unsigned int *d_cells,
+                                        const unsigned int *d_recv,
+                                        const unsigned int *d_recv_begin,
+                                        const unsigned int *d_recv_end,
+                                        const typename mpcd::detail::CellThermoPackOp::element *d_recv_buf,
+                                        const mpcd::detail::CellThermoPackOp op,
+                                        const unsigned int num_cells,
+                                        const unsigned int block_size);
+
+//! Explicit template instantiation of unpack for combined cell properties with uniform mass
+template cudaError_t unpack_cell_buffer(mpcd::detail::cell_thermo_sum *d_props,
+                                        const unsigned int *d_cells,
+                                        const unsigned int *d_recv,
+                                        const unsigned int *d_recv_begin,
+                                        const unsigned int *d_recv_end,
+                                        const typename mpcd::detail::CellUniformMassThermoPackOp::element *d_recv_buf,
+                                        const mpcd::detail::CellUniformMassThermoPackOp op,
+                                        const unsigned int num_cells,
+                                        const unsigned int block_size);
+
 } // end namespace gpu
 } // end namespace mpcd
@@ -74,6 +74,11 @@ class PYBIND11_EXPORT CellThermoComputeGPU : public mpcd::CellThermoCompute
         virtual void computeNetProperties();
 
     private:
+        #ifdef ENABLE_MPI
+        //! Sum the outer cell properties on the GPU
+        void sumOuterCellProperties();
+        #endif // ENABLE_MPI
+
         std::unique_ptr<Autotuner> m_begin_tuner;   //!< Tuner for cell begin kernel
         std::unique_ptr<Autotuner> m_end_tuner;     //!< Tuner for cell end kernel
         std::unique_ptr<Autotuner> m_inner_tuner;   //!< Tuner for inner cell compute kernel
@@ -16,6 +16,7 @@
 #endif
 
 #include "StreamingMethod.h"
+#include "ThreadingUtilities.h"
 #include "hoomd/extern/pybind/include/pybind11/pybind11.h"
 
 namespace mpcd
@@ -103,7 +104,8 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
 
     if (m_prof) m_prof->push("MPCD stream");
 
-    const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
+    std::shared_ptr<mpcd::CellList> cl = m_mpcd_sys->getCellList();
+    const BoxDim& box = cl->getCoverageBox();
 
     ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
@@ -112,7 +114,14 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
     // acquire polymorphic pointer to the external field
     const mpcd::ExternalField* field = (m_field) ? m_field->get(access_location::host) : nullptr;
 
-    for (unsigned int cur_p = 0; cur_p < m_mpcd_pdata->getN(); ++cur_p)
+    // optionally bin the particles for the next cell list build while they are in cache
+    const bool prebin = cl->beginPrebin();
+    mpcd::CellList& cell_list = *cl;
+
+    // every particle streams independently
+    const Geometry& geom = *m_geom;
+    const Scalar dt = m_mpcd_dt;
+    mpcd::detail::parallel_for(0, m_mpcd_pdata->getN(), [&](unsigned int cur_p)
         {
         const Scalar4 postype = h_pos.data[cur_p];
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
@@ -123,33 +132,37 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
         // estimate next velocity based on current acceleration
         if (field)
             {
-            vel += Scalar(0.5) * m_mpcd_dt * field->evaluate(pos) / mass;
+            vel += Scalar(0.5) * dt * field->evaluate(pos) / mass;
             }
 
         // propagate the particle to its new position ballistically
-        Scalar dt_remain = m_mpcd_dt;
+        Scalar dt_remain = dt;
         bool collide = true;
         do
             {
             pos += dt_remain * vel;
-            collide = m_geom->detectCollision(pos, vel, dt_remain);
+            collide = geom.detectCollision(pos, vel, dt_remain);
             }
         while (dt_remain > 0 && collide);
         // finalize velocity update
         if (field)
             {
-            vel += Scalar(0.5) * m_mpcd_dt * field->evaluate(pos) / mass;
+            vel += Scalar(0.5) * dt * field->evaluate(pos) / mass;
             }
 
         // wrap and update the position
         int3 image = make_int3(0,0,0);
         box.wrap(pos, image);
 
+        const unsigned int cell = (prebin) ? cell_list.prebinParticle(cur_p, pos) : mpcd::detail::NO_CELL;
+
         h_pos.data[cur_p] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
-        h_vel.data[cur_p] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
-        }
+        h_vel.data[cur_p] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(cell));
+        });
 
-    // particles have moved, so the cell cache is no longer valid
+    // particles have moved, so the cell cache is no longer valid until the cell list is built
+    if (prebin)
+        cl->endPrebin();
     m_mpcd_pdata->invalidateCellCache();
     if (m_prof) m_prof->pop();
     }
@@ -119,6 +119,20 @@ void mpcd::Integrator::update(unsigned int timestep)
     // execute the MPCD streaming step now that MD particles are communicated onto their final domains
     if (m_stream)
         {
+        // bin the particles into the cell list while streaming if they collide before they stream again
+        if (m_collide && m_stream->peekStream(timestep))
+            {
+            for (unsigned int next = timestep+1; next <= timestep + m_stream->getPeriod(); ++next)
+                {
+                if (m_collide->peekCollide(next))
+                    {
+                    m_collide->drawGridShift(next);
+                    m_mpcd_sys->getCellList()->requestPrebin(next);
+                    break;
+                    }
+                }
+            }
+
         m_stream->stream(timestep);
         }
 
@@ -629,20 +629,28 @@ void mpcd::ParticleData::allocate(unsigned int N_max)
     #endif // ENABLE_MPI
 
     // Allocate the alternate data
-    GPUArray<Scalar4> pos_alt(N_max, m_exec_conf);
-    m_pos_alt.swap(pos_alt);
-
+    // the alternate velocities are scratch space for collision methods, the other arrays are only needed
+    // to sort on the GPU since the CPU sorts in place
     GPUArray<Scalar4> vel_alt(N_max, m_exec_conf);
     m_vel_alt.swap(vel_alt);
 
-    GPUArray<unsigned int> tag_alt(N_max, m_exec_conf);
-    m_tag_alt.swap(tag_alt);
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        GPUArray<Scalar4> pos_alt(N_max, m_exec_conf);
+        m_pos_alt.swap(pos_alt);
+
+        GPUArray<unsigned int> tag_alt(N_max, m_exec_conf);
+        m_tag_alt.swap(tag_alt);
+        }
 
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        GPUArray<unsigned int> comm_flags_alt(N_max, m_exec_conf);
-        m_comm_flags_alt.swap(comm_flags_alt);
+        if (m_exec_conf->isCUDAEnabled())
+            {
+            GPUArray<unsigned int> comm_flags_alt(N_max, m_exec_conf);
+            m_comm_flags_alt.swap(comm_flags_alt);
+            }
 
         GPUArray<unsigned int> remove_ids(N_max, m_exec_conf);
         m_remove_ids.swap(remove_ids);
@@ -682,13 +690,17 @@ void mpcd::ParticleData::reallocate(unsigned int N_max)
     #endif // ENABLE_MPI
 
     // Reallocate the alternate data
-    m_pos_alt.resize(N_max);
     m_vel_alt.resize(N_max);
-    m_tag_alt.resize(N_max);
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        m_pos_alt.resize(N_max);
+        m_tag_alt.resize(N_max);
+        }
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        m_comm_flags_alt.resize(N_max);
+        if (m_exec_conf->isCUDAEnabled())
+            m_comm_flags_alt.resize(N_max);
         m_remove_ids.resize(N_max);
 
         #ifdef ENABLE_CUDA
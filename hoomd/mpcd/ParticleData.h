@@ -230,6 +230,10 @@ class PYBIND11_EXPORT ParticleData
         //! \name swap methods
         //@{
         //! Get alternate array of MPCD particle positions
+        /*!
+         * \note The alternate positions, tags, and communication flags are only allocated when CUDA is enabled.
+         *       They are empty on the CPU, which sorts in place.
+         */
         const GPUArray<Scalar4>& getAltPositions() const
             {
             return m_pos_alt;
@@ -254,6 +258,9 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Get alternate array of MPCD particle tags
+        /*!
+         * \note The array is empty when CUDA is not enabled, see getAltPositions().
+         */
         const GPUArray<unsigned int>& getAltTags() const
             {
             return m_tag_alt;
@@ -393,6 +400,9 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Get the alternate MPCD particle communication flags
+        /*!
+         * \note The array is empty when CUDA is not enabled, see getAltPositions().
+         */
         const GPUArray<unsigned int>& getAltCommFlags() const
             {
             return m_comm_flags_alt;
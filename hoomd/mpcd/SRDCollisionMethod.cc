@@ -9,6 +9,7 @@
  */
 
 #include "SRDCollisionMethod.h"
+#include "ThreadingUtilities.h"
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
@@ -73,49 +74,67 @@ void mpcd::SRDCollisionMethod::drawRotationVectors(unsigned int timestep)
         T_set = m_T->getValue(timestep);
         }
 
-    for (unsigned int k=0; k < ci.getD(); ++k)
+    // every cell has its own random number stream, so the cells are independent
+    auto draw_cell = [&](const uint3& cell)
         {
-        for (unsigned int j=0; j < ci.getH(); ++j)
-            {
-            for (unsigned int i=0; i < ci.getW(); ++i)
-                {
-                const int3 global_cell = m_cl->getGlobalCell(make_int3(i,j,k));
-                const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
-                const unsigned int idx = ci(i,j,k);
+        const unsigned int idx = ci(cell.x, cell.y, cell.z);
+        const int3 global_cell = m_cl->getGlobalCell(make_int3(cell.x,cell.y,cell.z));
+        const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
 
-                // Initialize the PRNG using the current cell index, timestep, and seed for the hash
-                hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SRDCollisionMethod, m_seed, global_idx, timestep);
+        // Initialize the PRNG using the current cell index, timestep, and seed for the hash
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SRDCollisionMethod, m_seed, global_idx, timestep);
 
-                // draw rotation vector off the surface of the sphere
-                double3 rotvec;
-                hoomd::SpherePointGenerator<double> sphgen;
-                sphgen(rng, rotvec);
-                h_rotvec.data[idx] = rotvec;
+        // draw rotation vector off the surface of the sphere
+        double3 rotvec;
+        hoomd::SpherePointGenerator<double> sphgen;
+        sphgen(rng, rotvec);
+        h_rotvec.data[idx] = rotvec;
+
+        if (use_thermostat)
+            {
+            const double3 cell_energy = h_cell_energy->data[idx];
+            const unsigned int np = __double_as_int(cell_energy.z);
+            double factor = 1.0;
+            if (np > 1)
+                {
+                // the total number of degrees of freedom in the cell divided by 2
+                const double alpha = m_sysdef->getNDimensions()*(np-1)/(double)2.;
+
+                // draw a random kinetic energy for the cell at the set temperature
+                hoomd::GammaDistribution<double> gamma_gen(alpha,T_set);
+                const double rand_ke = gamma_gen(rng);
+
+                // generate the scale factor from the current temperature
+                // (don't use the kinetic energy of this cell, since this
+                // is total not relative to COM)
+                const double cur_ke = alpha * cell_energy.y;
+                factor = (cur_ke > 0.) ? fast::sqrt(rand_ke/cur_ke) : 1.;
+                }
+            h_factors->data[idx] = factor;
+            }
+        };
 
-                if (use_thermostat)
+    if (m_cl->isCompact())
+        {
+        // the rotation vectors of empty cells are never used
+        ArrayHandle<unsigned int> h_occupied_cells(m_cl->getOccupiedCells(), access_location::host, access_mode::read);
+        mpcd::detail::parallel_for(0, m_cl->getNOccupiedCells(), [&](unsigned int i)
+            {
+            draw_cell(ci.getTriple(h_occupied_cells.data[i]));
+            });
+        }
+    else
+        {
+        mpcd::detail::parallel_for(0, ci.getD(), [&](unsigned int k)
+            {
+            for (unsigned int j=0; j < ci.getH(); ++j)
+                {
+                for (unsigned int i=0; i < ci.getW(); ++i)
                     {
-                    const double3 cell_energy = h_cell_energy->data[idx];
-                    const unsigned int np = __double_as_int(cell_energy.z);
-                    double factor = 1.0;
-                    if (np > 1)
-                        {
-                        // the total number of degrees of freedom in the cell divided by 2
-                        const double alpha = m_sysdef->getNDimensions()*(np-1)/(double)2.;
-
-                        // draw a random kinetic energy for the cell at the set temperature
-                        hoomd::GammaDistribution<double> gamma_gen(alpha,T_set);
-                        const double rand_ke = gamma_gen(rng);
-
-                        // generate the scale factor from the current temperature
-                        // (don't use the kinetic energy of this cell, since this
-                        // is total not relative to COM)
-                        const double cur_ke = alpha * cell_energy.y;
-                        factor = (cur_ke > 0.) ? fast::sqrt(rand_ke/cur_ke) : 1.;
-                        }
-                    h_factors->data[idx] = factor;
+                    draw_cell(make_uint3(i,j,k));
                     }
                 }
-            }
+            });
         }
     }
 
@@ -154,7 +173,8 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         h_factors.reset(new ArrayHandle<double>(m_factors, access_location::host, access_mode::read));
         }
 
-    for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+    // every particle is rotated independently
+    mpcd::detail::parallel_for(0, N_tot, [&](unsigned int cur_p)
         {
         double3 vel;
         unsigned int cell;
@@ -221,7 +241,7 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
             {
             h_vel_embed->data[idx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, mass);
             }
-        }
+        });
     }
 
 /*!
@@ -9,6 +9,9 @@
  */
 
 #include "Sorter.h"
+#include "ThreadingUtilities.h"
+
+#include <vector>
 
 /*!
  * \param sysdata MPCD system data
@@ -24,7 +27,7 @@ mpcd::Sorter::Sorter(std::shared_ptr<mpcd::SystemData> sysdata,
       m_cl(m_mpcd_sys->getCellList()),
       m_order(m_exec_conf),
       m_rorder(m_exec_conf),
-      m_period(period)
+      m_period(period), m_tolerance(0.0), m_scatter(0.0)
     {
     assert(m_mpcd_sys);
     m_exec_conf->msg->notice(5) << "Constructing MPCD Sorter" << std::endl;
@@ -52,8 +55,19 @@ void mpcd::Sorter::update(unsigned int timestep)
     m_order.resize(m_mpcd_pdata->getN());
     m_rorder.resize(m_mpcd_pdata->getN());
 
-    // generate and apply the sorted order
+    // generate the sorted order
     computeOrder(timestep);
+
+    // skip the sort if particles are still ordered well enough
+    m_scatter = computeScatter();
+    if (m_tolerance > Scalar(0.0) && m_scatter <= m_tolerance)
+        {
+        m_exec_conf->msg->notice(6) << "MPCD Sorter: skipping sort, scattered fraction " << m_scatter << std::endl;
+        if (m_prof) m_prof->pop(m_exec_conf);
+        return;
+        }
+
+    // apply the sorted order
     applyOrder();
 
     // trigger the sort signal for ParticleData callbacks using the current sortings
@@ -78,19 +92,24 @@ void mpcd::Sorter::computeOrder(unsigned int timestep)
 
     ArrayHandle<unsigned int> h_cell_list(m_cl->getCellList(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_cell_np(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
-    const Index2D& cli = m_cl->getCellListIndexer();
+    ArrayHandle<unsigned int> h_cell_offsets(m_cl->getCellOffsets(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_occupied_cells(m_cl->getOccupiedCells(), access_location::host, access_mode::read);
 
     // loop through the cell list to generate the sorting order for MPCD particles
     ArrayHandle<unsigned int> h_order(m_order, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_rorder(m_rorder, access_location::host, access_mode::overwrite);
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
+    const bool compact = m_cl->isCompact();
+    const unsigned int num_cells = (compact) ? m_cl->getNOccupiedCells() : m_cl->getNCells();
     unsigned int cur_p = 0;
-    for (unsigned int idx=0; idx < m_cl->getNCells(); ++idx)
+    for (unsigned int i=0; i < num_cells; ++i)
         {
+        const unsigned int idx = (compact) ? h_occupied_cells.data[i] : i;
         const unsigned int np = h_cell_np.data[idx];
+        const unsigned int *members = h_cell_list.data + h_cell_offsets.data[idx];
         for (unsigned int offset = 0; offset < np; ++offset)
             {
-            const unsigned int pid = h_cell_list.data[cli(offset, idx)];
+            const unsigned int pid = members[offset];
             // only count MPCD particles, and skip embedded particles
             if (pid < N_mpcd)
                 {
@@ -107,47 +126,90 @@ void mpcd::Sorter::computeOrder(unsigned int timestep)
  * intentionally broken out from computeOrder() so that other sorting rules could
  * be implemented without having to duplicate the application of the sort.
  *
- * The sorted order is applied by swapping out the alternate per-particle data
- * arrays. The communication flags are \b not sorted in MPI because by design,
- * the caller is responsible for clearing out any old flags before using them.
+ * The sorted order is applied in place by following the cycles of the permutation,
+ * so no alternate per-particle data arrays are needed. The cycles are found first
+ * from the order alone, and then the particle data on different cycles is permuted
+ * in parallel. Virtual particles are left where they are. The communication flags
+ * are \b not sorted in MPI because by design, the caller is responsible for clearing
+ * out any old flags before using them.
  */
 void mpcd::Sorter::applyOrder() const
     {
-    // apply the sorted order
-        {
-        ArrayHandle<unsigned int> h_order(m_order, access_location::host, access_mode::read);
-
-        ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_order(m_order, access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
-        ArrayHandle<unsigned int> h_tag_alt(m_mpcd_pdata->getAltTags(), access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::readwrite);
 
-        for (unsigned int idx=0; idx < m_mpcd_pdata->getN(); ++idx)
+    // find the first particle of every cycle, skipping particles that stay in place
+    const unsigned int N = m_mpcd_pdata->getN();
+    std::vector<unsigned int> cycles;
+        {
+        std::vector<bool> visited(N, false);
+        for (unsigned int start=0; start < N; ++start)
             {
-            const unsigned int old_idx = h_order.data[idx];
-            h_pos_alt.data[idx] = h_pos.data[old_idx];
-            h_vel_alt.data[idx] = h_vel.data[old_idx];
-            h_tag_alt.data[idx] = h_tag.data[old_idx];
+            if (visited[start] || h_order.data[start] == start) continue;
+
+            cycles.push_back(start);
+            for (unsigned int idx = start; !visited[idx]; idx = h_order.data[idx])
+                visited[idx] = true;
             }
+        }
+
+    // every cycle is independent
+    mpcd::detail::parallel_for(0, cycles.size(), [&](unsigned int cur_cycle)
+        {
+        const unsigned int start = cycles[cur_cycle];
+
+        // hold the first particle of the cycle, then pull every particle into its sorted position
+        const Scalar4 pos = h_pos.data[start];
+        const Scalar4 vel = h_vel.data[start];
+        const unsigned int tag = h_tag.data[start];
 
-        // copy virtual particle data if it exists
-        if (m_mpcd_pdata->getNVirtual() > 0)
+        unsigned int idx = start;
+        unsigned int old_idx = h_order.data[idx];
+        while (old_idx != start)
             {
-            const unsigned int N = m_mpcd_pdata->getN();
-            const unsigned int Ntot = N + m_mpcd_pdata->getNVirtual();
-            std::copy(h_pos.data + N, h_pos.data + Ntot, h_pos_alt.data + N);
-            std::copy(h_vel.data + N, h_vel.data + Ntot, h_vel_alt.data + N);
-            std::copy(h_tag.data + N, h_tag.data + Ntot, h_tag_alt.data + N);
+            h_pos.data[idx] = h_pos.data[old_idx];
+            h_vel.data[idx] = h_vel.data[old_idx];
+            h_tag.data[idx] = h_tag.data[old_idx];
+
+            idx = old_idx;
+            old_idx = h_order.data[idx];
             }
+
+        h_pos.data[idx] = pos;
+        h_vel.data[idx] = vel;
+        h_tag.data[idx] = tag;
+        });
+    }
+
+/*!
+ * \returns Fraction of MPCD particles that is scattered in memory
+ *
+ * The order computed by computeOrder() lists the particles in cell list order. A particle is
+ * scattered if its index differs from the index of the particle before it in this order by more
+ * than the width of one cell in the cell list, i.e., it is not stored near its neighbors.
+ */
+Scalar mpcd::Sorter::computeScatter()
+    {
+    const unsigned int N = m_mpcd_pdata->getN();
+    if (N < 2) return Scalar(0.0);
+
+    ArrayHandle<unsigned int> h_order(m_order, access_location::host, access_mode::read);
+    const unsigned int window = m_cl->getNmax();
+
+    unsigned int num_scattered = 0;
+    for (unsigned int i=1; i < N; ++i)
+        {
+        const unsigned int prev = h_order.data[i-1];
+        const unsigned int cur = h_order.data[i];
+        const unsigned int stride = (cur > prev) ? cur - prev : prev - cur;
+        if (stride > window)
+            ++num_scattered;
         }
 
-    // swap out sorted data
-    m_mpcd_pdata->swapPositions();
-    m_mpcd_pdata->swapVelocities();
-    m_mpcd_pdata->swapTags();
+    return Scalar(num_scattered) / Scalar(N-1);
     }
 
 bool mpcd::Sorter::peekSort(unsigned int timestep) const
@@ -178,5 +240,7 @@ void mpcd::detail::export_Sorter(pybind11::module& m)
     py::class_<mpcd::Sorter, std::shared_ptr<mpcd::Sorter> >(m, "Sorter")
         .def(py::init<std::shared_ptr<mpcd::SystemData>, unsigned int, unsigned int>())
         .def("setPeriod", &mpcd::Sorter::setPeriod)
+        .def("setTolerance", &mpcd::Sorter::setTolerance)
+        .def("getScatter", &mpcd::Sorter::getScatter)
         ;
     }
@@ -35,6 +35,12 @@ namespace mpcd
  * the virtual particles and leave them in place at the end of the arrays. This is
  * because they cannot be removed easily if they are sorted with the rest of the particles,
  * and the performance gains from doing a separate (segmented) sort on them is probably small.
+ *
+ * When a tolerance is set with setTolerance(), update() first measures how scattered the
+ * particles are in memory and only applies the new order if the scattered fraction exceeds the
+ * tolerance. A particle is scattered if it is stored further from the particle preceding it in
+ * cell list order than the width of one cell in the cell list. The scattered fraction is measured
+ * on every sorting step, also without a tolerance, and can be read with getScatter().
  */
 class PYBIND11_EXPORT Sorter
     {
@@ -75,6 +81,27 @@ class PYBIND11_EXPORT Sorter
             m_next_timestep = multiple * m_period;
             }
 
+        //! Set the scatter tolerance for adaptive sorting
+        /*!
+         * \param tolerance Sort only when more than this fraction of particles is scattered in memory
+         * \note A value of 0 sorts on every call to update()
+         */
+        void setTolerance(Scalar tolerance)
+            {
+            if (tolerance < Scalar(0.0) || tolerance >= Scalar(1.0))
+                {
+                m_exec_conf->msg->error() << "mpcd.sort: tolerance must be in [0,1)" << std::endl;
+                throw std::runtime_error("Error setting MPCD sorter parameters");
+                }
+            m_tolerance = tolerance;
+            }
+
+        //! Get the fraction of particles that was scattered in memory before the last sorting step
+        Scalar getScatter() const
+            {
+            return m_scatter;
+            }
+
     protected:
         std::shared_ptr<mpcd::SystemData> m_mpcd_sys;       //!< MPCD system data
         std::shared_ptr<SystemDefinition> m_sysdef;         //!< HOOMD system definition
@@ -90,6 +117,8 @@ class PYBIND11_EXPORT Sorter
 
         unsigned int m_period;          //!< Sorting period
         unsigned int m_next_timestep;   //!< Next step to apply sorting
+        Scalar m_tolerance;             //!< Scatter tolerance for adaptive sorting (0 to always sort)
+        Scalar m_scatter;               //!< Scattered fraction of particles before the last sorting step
 
         //! Compute the sorting order at the current timestep
         virtual void computeOrder(unsigned int timestep);
@@ -97,6 +126,9 @@ class PYBIND11_EXPORT Sorter
         //! Apply the sorting order
         virtual void applyOrder() const;
 
+        //! Measure the fraction of particles that is scattered in memory
+        Scalar computeScatter();
+
     private:
         bool shouldSort(unsigned int timestep);
     };
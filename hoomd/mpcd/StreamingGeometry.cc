@@ -50,5 +50,39 @@ void export_SlitPoreGeometry(pybind11::module& m)
         .def("getBoundaryCondition", &SlitPoreGeometry::getBoundaryCondition);
     }
 
+/*!
+ * \param vertices List of (x,y,z) tuples for the vertices
+ * \param triangles List of (i,j,k) tuples of vertex indexes for the triangles
+ * \param bc Boundary condition at the wall
+ */
+static std::shared_ptr<TriangleMeshGeometry> make_TriangleMeshGeometry(pybind11::list vertices,
+                                                                       pybind11::list triangles,
+                                                                       boundary bc)
+    {
+    namespace py = pybind11;
+    std::vector<Scalar3> verts(len(vertices));
+    for (unsigned int i=0; i < verts.size(); ++i)
+        {
+        py::tuple v = py::cast<py::tuple>(vertices[i]);
+        verts[i] = make_scalar3(py::cast<Scalar>(v[0]), py::cast<Scalar>(v[1]), py::cast<Scalar>(v[2]));
+        }
+    std::vector<uint3> tris(len(triangles));
+    for (unsigned int i=0; i < tris.size(); ++i)
+        {
+        py::tuple t = py::cast<py::tuple>(triangles[i]);
+        tris[i] = make_uint3(py::cast<unsigned int>(t[0]), py::cast<unsigned int>(t[1]), py::cast<unsigned int>(t[2]));
+        }
+    return std::make_shared<TriangleMeshGeometry>(verts, tris, bc);
+    }
+
+void export_TriangleMeshGeometry(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<TriangleMeshGeometry, std::shared_ptr<TriangleMeshGeometry> >(m, "TriangleMeshGeometry")
+        .def(py::init(&make_TriangleMeshGeometry))
+        .def("getNumTriangles", &TriangleMeshGeometry::getNumTriangles)
+        .def("getBoundaryCondition", &TriangleMeshGeometry::getBoundaryCondition);
+    }
+
 } // end namespace detail
 } // end namespace mpcd
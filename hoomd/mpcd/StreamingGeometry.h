@@ -17,6 +17,7 @@
 #include "SlitPoreGeometry.h"
 
 #ifndef NVCC
+#include "TriangleMeshGeometry.h"
 #include "hoomd/extern/pybind/include/pybind11/pybind11.h"
 
 namespace mpcd
@@ -35,6 +36,9 @@ void export_SlitGeometry(pybind11::module& m);
 //! Export SlitPoreGeometry to python
 void export_SlitPoreGeometry(pybind11::module& m);
 
+//! Export TriangleMeshGeometry to python
+void export_TriangleMeshGeometry(pybind11::module& m);
+
 } // end namespace detail
 } // end namespace mpcd
 
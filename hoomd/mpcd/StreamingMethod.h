@@ -97,6 +97,12 @@ class PYBIND11_EXPORT StreamingMethod
         //! Set the period of the streaming method
         void setPeriod(unsigned int cur_timestep, unsigned int period);
 
+        //! Get the period of the streaming method
+        unsigned int getPeriod() const
+            {
+            return m_period;
+            }
+
     protected:
         std::shared_ptr<mpcd::SystemData> m_mpcd_sys;                   //!< MPCD system data
         std::shared_ptr<SystemDefinition> m_sysdef;                     //!< HOOMD system definition
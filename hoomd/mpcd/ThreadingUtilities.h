@@ -0,0 +1,71 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#ifndef MPCD_THREADING_UTILITIES_H_
+#define MPCD_THREADING_UTILITIES_H_
+
+/*!
+ * \file mpcd/ThreadingUtilities.h
+ * \brief Helpers for multithreaded loops in the CPU implementations of MPCD
+ *
+ * The loops are parallelized with TBB when it is available, and run serially
+ * otherwise. The number of threads is set by the ExecutionConfiguration.
+ */
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
+#include <atomic>
+
+namespace mpcd
+{
+namespace detail
+{
+//! Apply a function to every index in a range
+/*!
+ * \param begin First index
+ * \param end One past the last index
+ * \param f Function to call as f(i) for every index i
+ *
+ * The calls may be made concurrently and in any order, so \a f must only
+ * write to memory that belongs to index i.
+ */
+template<class Function>
+inline void parallel_for(unsigned int begin, unsigned int end, const Function& f)
+    {
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(begin, end),
+        [&f](const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                f(i);
+            });
+    #else
+    for (unsigned int i = begin; i < end; ++i)
+        f(i);
+    #endif // ENABLE_TBB
+    }
+
+//! Atomically raise a value to at least \a val
+/*!
+ * \param target Value to update
+ * \param val Lower bound for \a target
+ */
+inline void atomic_max(std::atomic<unsigned int>& target, unsigned int val)
+    {
+    unsigned int cur = target.load(std::memory_order_relaxed);
+    while (cur < val && !target.compare_exchange_weak(cur, val, std::memory_order_relaxed))
+        { }
+    }
+
+} // end namespace detail
+} // end namespace mpcd
+
+#endif // MPCD_THREADING_UTILITIES_H_
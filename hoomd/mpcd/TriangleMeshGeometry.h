@@ -0,0 +1,506 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/TriangleMeshGeometry.h
+ * \brief Definition of the MPCD triangle mesh geometry
+ */
+
+#ifndef MPCD_TRIANGLE_MESH_GEOMETRY_H_
+#define MPCD_TRIANGLE_MESH_GEOMETRY_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "BoundaryCondition.h"
+
+// AABBTree.h relies on these being included before it
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/AABBTree.h"
+
+namespace mpcd
+{
+namespace detail
+{
+
+//! Arbitrary wall geometry described by a triangulated surface
+/*!
+ * This class defines a confining geometry from a surface mesh of triangles. The vertices of each triangle
+ * are ordered so that the normal \f$(\mathbf{b}-\mathbf{a}) \times (\mathbf{c}-\mathbf{a})\f$ points into the
+ * fluid. The mesh does not need to be closed, but it must partition space into a fluid and a solid side
+ * consistently (e.g., an open channel whose ends pass through periodic faces of the box).
+ *
+ * A collision is detected by intersecting the segment traversed by the particle during the streaming step
+ * with the triangles that face it. The triangles are stored in a bounding volume hierarchy
+ * (hpmc::detail::AABBTree) so that only the triangles near the segment are tested. The first triangle hit
+ * is used to apply the bounce-back rule, as for the analytic geometries.
+ *
+ * A point is outside the geometry if it lies on the solid side of the mesh. This is determined by casting a
+ * ray along the Cartesian axes and checking the orientation of the closest triangle that is hit. If no
+ * triangle is hit in any direction, the point is inside.
+ *
+ * The mesh is not replicated through the periodic boundaries. If it extends through a face of the box, it
+ * must extend past that face by at least the distance a particle travels during one streaming step so that
+ * particles leaving the box before they are wrapped back are still confined.
+ *
+ * The mesh is stored on the host only, so this geometry is not supported on the GPU.
+ */
+class __attribute__((visibility("default"))) TriangleMeshGeometry
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param vertices Vertices of the mesh
+         * \param triangles Indexes of the three vertices of each triangle
+         * \param bc Boundary condition at the wall (slip or no-slip)
+         */
+        TriangleMeshGeometry(const std::vector<Scalar3>& vertices,
+                             const std::vector<uint3>& triangles,
+                             boundary bc)
+            : m_triangles(triangles), m_bc(bc)
+            {
+            if (triangles.empty())
+                {
+                throw std::runtime_error("Triangle mesh geometry requires at least one triangle");
+                }
+
+            m_vertices.reserve(vertices.size());
+            for (unsigned int i=0; i < vertices.size(); ++i)
+                {
+                m_vertices.push_back(vec3<Scalar>(vertices[i]));
+                }
+
+            // compute the bounds of the mesh
+            m_lo = m_hi = m_vertices.empty() ? vec3<Scalar>(0,0,0) : m_vertices[0];
+            for (unsigned int i=0; i < m_vertices.size(); ++i)
+                {
+                const vec3<Scalar>& v = m_vertices[i];
+                m_lo = vec3<Scalar>(std::min(m_lo.x,v.x), std::min(m_lo.y,v.y), std::min(m_lo.z,v.z));
+                m_hi = vec3<Scalar>(std::max(m_hi.x,v.x), std::max(m_hi.y,v.y), std::max(m_hi.z,v.z));
+                }
+            const vec3<Scalar> extent = m_hi - m_lo;
+            m_diameter = slow::sqrt(dot(extent,extent));
+
+            // pad boxes slightly so that planar triangles aligned with an axis are not missed due to roundoff
+            const Scalar pad = Scalar(1e-6) * m_diameter;
+            const vec3<Scalar> vpad(pad,pad,pad);
+
+            m_normals.resize(m_triangles.size());
+            std::vector<hpmc::detail::AABB> aabbs(m_triangles.size());
+            for (unsigned int i=0; i < m_triangles.size(); ++i)
+                {
+                const uint3 tri = m_triangles[i];
+                if (tri.x >= m_vertices.size() || tri.y >= m_vertices.size() || tri.z >= m_vertices.size())
+                    {
+                    throw std::runtime_error("Triangle mesh geometry references a vertex that does not exist");
+                    }
+                const vec3<Scalar>& a = m_vertices[tri.x];
+                const vec3<Scalar>& b = m_vertices[tri.y];
+                const vec3<Scalar>& c = m_vertices[tri.z];
+
+                const vec3<Scalar> n = cross(b-a, c-a);
+                const Scalar nsq = dot(n,n);
+                if (nsq == Scalar(0))
+                    {
+                    throw std::runtime_error("Triangle mesh geometry has a degenerate triangle");
+                    }
+                m_normals[i] = fast::rsqrt(nsq) * n;
+
+                const vec3<Scalar> lo(std::min(a.x,std::min(b.x,c.x)),
+                                      std::min(a.y,std::min(b.y,c.y)),
+                                      std::min(a.z,std::min(b.z,c.z)));
+                const vec3<Scalar> hi(std::max(a.x,std::max(b.x,c.x)),
+                                      std::max(a.y,std::max(b.y,c.y)),
+                                      std::max(a.z,std::max(b.z,c.z)));
+                aabbs[i] = hpmc::detail::AABB(lo - vpad, hi + vpad);
+                }
+            m_tree.buildTree(&aabbs[0], aabbs.size());
+            }
+
+        //! Detect collision between the particle and the boundary
+        /*!
+         * \param pos Proposed particle position
+         * \param vel Proposed particle velocity
+         * \param dt Integration time remaining (inout).
+         *
+         * \returns True if a collision occurred, and false otherwise
+         *
+         * \post The particle position \a pos is moved to the point of reflection, the velocity \a vel is updated
+         *       according to the appropriate bounce back rule, and the integration time \a dt is decreased to the
+         *       amount of time remaining.
+         *
+         * The passed value of \a dt must be the time taken to arrive at pos. The returned value of \a dt will be
+         * less than this time.
+         */
+        bool detectCollision(Scalar3& pos, Scalar3& vel, Scalar& dt) const
+            {
+            // segment traversed during the step, only counting triangles the particle moves into
+            const vec3<Scalar> v(vel);
+            const vec3<Scalar> d = dt * v;
+            const vec3<Scalar> start = vec3<Scalar>(pos) - d;
+            Scalar s(1);
+            const unsigned int hit = intersect(start, d, true, s);
+            if (hit == NO_TRIANGLE)
+                {
+                dt = Scalar(0);
+                return false;
+                }
+
+            // backtrack the particle for the time remaining to get to point of contact
+            dt *= (Scalar(1) - s);
+            pos -= vel*dt;
+
+            // update velocity according to boundary conditions
+            // no-slip requires reflection of the tangential components
+            const Scalar3 n = vec_to_scalar3(m_normals[hit]);
+            const Scalar3 vn = dot(n,vel)*n;
+            if (m_bc == boundary::no_slip)
+                {
+                const Scalar3 vt = vel - vn;
+                vel += Scalar(-2) * vt;
+                }
+            // always reflect normal component for no-penetration
+            vel += Scalar(-2) * vn;
+
+            return true;
+            }
+
+        //! Check if a particle is out of bounds
+        /*!
+         * \param pos Current particle position
+         * \returns True if particle is out of bounds, and false otherwise
+         */
+        bool isOutside(const Scalar3& pos) const
+            {
+            const vec3<Scalar> p(pos);
+
+            // ray length guaranteed to leave the mesh bounds from p
+            const vec3<Scalar> dr = p - Scalar(0.5)*(m_lo + m_hi);
+            const Scalar length = slow::sqrt(dot(dr,dr)) + m_diameter + Scalar(1);
+
+            const vec3<Scalar> dirs[6] = {vec3<Scalar>(0,0,1), vec3<Scalar>(0,0,-1),
+                                          vec3<Scalar>(0,1,0), vec3<Scalar>(0,-1,0),
+                                          vec3<Scalar>(1,0,0), vec3<Scalar>(-1,0,0)};
+            for (unsigned int i=0; i < 6; ++i)
+                {
+                Scalar s(1);
+                const unsigned int hit = intersect(p, length*dirs[i], false, s);
+                if (hit != NO_TRIANGLE)
+                    {
+                    // leaving the solid through the closest face means the normal points along the ray
+                    return (dot(m_normals[hit], dirs[i]) > Scalar(0));
+                    }
+                }
+
+            return false;
+            }
+
+        //! Validate that the simulation box is large enough for the geometry
+        /*!
+         * \param box Global simulation box
+         * \param cell_size Size of MPCD cell
+         *
+         * In each direction, the mesh must either be padded by at least one cell from the faces of the box so
+         * that cells do not interact through the boundary, or span the entire box so that it continues through
+         * the periodic boundary.
+         */
+        bool validateBox(const BoxDim& box, Scalar cell_size) const
+            {
+            const Scalar3 hi = box.getHi();
+            const Scalar3 lo = box.getLo();
+
+            const bool ok_x = ((hi.x-m_hi.x) >= cell_size && (m_lo.x-lo.x) >= cell_size) ||
+                              (m_lo.x <= lo.x && m_hi.x >= hi.x);
+            const bool ok_y = ((hi.y-m_hi.y) >= cell_size && (m_lo.y-lo.y) >= cell_size) ||
+                              (m_lo.y <= lo.y && m_hi.y >= hi.y);
+            const bool ok_z = ((hi.z-m_hi.z) >= cell_size && (m_lo.z-lo.z) >= cell_size) ||
+                              (m_lo.z <= lo.z && m_hi.z >= hi.z);
+            return (ok_x && ok_y && ok_z);
+            }
+
+        //! Get the number of triangles in the mesh
+        unsigned int getNumTriangles() const
+            {
+            return m_triangles.size();
+            }
+
+        //! Get the vertices of the mesh
+        std::vector<Scalar3> getVertices() const
+            {
+            std::vector<Scalar3> vertices(m_vertices.size());
+            for (unsigned int i=0; i < m_vertices.size(); ++i)
+                {
+                vertices[i] = vec_to_scalar3(m_vertices[i]);
+                }
+            return vertices;
+            }
+
+        //! Get the vertex indexes of the triangles
+        const std::vector<uint3>& getTriangles() const
+            {
+            return m_triangles;
+            }
+
+        //! Get the lower and upper bounds of a triangle
+        /*!
+         * \param i Index of the triangle
+         * \param lo Lower bound of the triangle (output)
+         * \param hi Upper bound of the triangle (output)
+         */
+        void getTriangleBounds(unsigned int i, Scalar3& lo, Scalar3& hi) const
+            {
+            const uint3 tri = m_triangles[i];
+            const vec3<Scalar>& a = m_vertices[tri.x];
+            const vec3<Scalar>& b = m_vertices[tri.y];
+            const vec3<Scalar>& c = m_vertices[tri.z];
+            lo = make_scalar3(std::min(a.x,std::min(b.x,c.x)),
+                              std::min(a.y,std::min(b.y,c.y)),
+                              std::min(a.z,std::min(b.z,c.z)));
+            hi = make_scalar3(std::max(a.x,std::max(b.x,c.x)),
+                              std::max(a.y,std::max(b.y,c.y)),
+                              std::max(a.z,std::max(b.z,c.z)));
+            }
+
+        //! Get the distance from a point to a triangle
+        /*!
+         * \param i Index of the triangle
+         * \param pos Point
+         *
+         * \returns Euclidean distance from \a pos to the closest point on the triangle.
+         *
+         * The closest point is found from the Voronoi regions of the triangle (Ericson, Real-Time Collision
+         * Detection, 5.1.5).
+         */
+        Scalar getDistanceToTriangle(unsigned int i, const Scalar3& pos) const
+            {
+            const uint3 tri = m_triangles[i];
+            const vec3<Scalar>& a = m_vertices[tri.x];
+            const vec3<Scalar>& b = m_vertices[tri.y];
+            const vec3<Scalar>& c = m_vertices[tri.z];
+            const vec3<Scalar> p(pos);
+            const vec3<Scalar> ab = b - a;
+            const vec3<Scalar> ac = c - a;
+
+            // vertex region of a
+            const vec3<Scalar> ap = p - a;
+            const Scalar d1 = dot(ab, ap);
+            const Scalar d2 = dot(ac, ap);
+            if (d1 <= Scalar(0) && d2 <= Scalar(0))
+                return fast::sqrt(dot(ap, ap));
+
+            // vertex region of b
+            const vec3<Scalar> bp = p - b;
+            const Scalar d3 = dot(ab, bp);
+            const Scalar d4 = dot(ac, bp);
+            if (d3 >= Scalar(0) && d4 <= d3)
+                return fast::sqrt(dot(bp, bp));
+
+            // edge region of ab
+            vec3<Scalar> q;
+            const Scalar vc = d1*d4 - d3*d2;
+            if (vc <= Scalar(0) && d1 >= Scalar(0) && d3 <= Scalar(0))
+                {
+                q = a + (d1 / (d1 - d3)) * ab;
+                }
+            else
+                {
+                // vertex region of c
+                const vec3<Scalar> cp = p - c;
+                const Scalar d5 = dot(ab, cp);
+                const Scalar d6 = dot(ac, cp);
+                if (d6 >= Scalar(0) && d5 <= d6)
+                    return fast::sqrt(dot(cp, cp));
+
+                const Scalar vb = d5*d2 - d1*d6;
+                const Scalar va = d3*d6 - d5*d4;
+                if (vb <= Scalar(0) && d2 >= Scalar(0) && d6 <= Scalar(0))
+                    {
+                    // edge region of ac
+                    q = a + (d2 / (d2 - d6)) * ac;
+                    }
+                else if (va <= Scalar(0) && (d4 - d3) >= Scalar(0) && (d5 - d6) >= Scalar(0))
+                    {
+                    // edge region of bc
+                    q = b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+                    }
+                else
+                    {
+                    // face region
+                    const Scalar denom = Scalar(1) / (va + vb + vc);
+                    q = a + (vb * denom) * ab + (vc * denom) * ac;
+                    }
+                }
+            const vec3<Scalar> dr = p - q;
+            return fast::sqrt(dot(dr, dr));
+            }
+
+        //! Get the wall boundary condition
+        /*!
+         * \returns Boundary condition at wall
+         */
+        boundary getBoundaryCondition() const
+            {
+            return m_bc;
+            }
+
+        //! Get the unique name of this geometry
+        static std::string getName()
+            {
+            return std::string("TriangleMesh");
+            }
+
+    private:
+        std::vector< vec3<Scalar> > m_vertices; //!< Vertices of the mesh
+        std::vector<uint3> m_triangles;         //!< Vertex indexes of each triangle
+        std::vector< vec3<Scalar> > m_normals;  //!< Unit normal of each triangle (into the fluid)
+        hpmc::detail::AABBTree m_tree;          //!< Bounding volume hierarchy of the triangles
+        vec3<Scalar> m_lo;                      //!< Lower bound of the mesh
+        vec3<Scalar> m_hi;                      //!< Upper bound of the mesh
+        Scalar m_diameter;                      //!< Length of the diagonal of the mesh bounds
+        const boundary m_bc;                    //!< Boundary condition
+
+        static const unsigned int NO_TRIANGLE = 0xffffffff; //!< Sentinel for no intersection
+
+        //! Find the first triangle hit by a segment
+        /*!
+         * \param start Start of the segment
+         * \param d Displacement along the segment
+         * \param facing If true, only consider triangles whose normals oppose \a d
+         * \param s Fraction of the segment to search (inout). On return, the fraction to the hit.
+         *
+         * \returns Index of the first triangle hit, or NO_TRIANGLE if there is none.
+         *
+         * The tree is traversed without a stack, and nodes are pruned by the closest hit found so far.
+         */
+        unsigned int intersect(const vec3<Scalar>& start, const vec3<Scalar>& d, bool facing, Scalar& s) const
+            {
+            unsigned int hit = NO_TRIANGLE;
+            const unsigned int num_nodes = m_tree.getNumNodes();
+            for (unsigned int node=0; node < num_nodes; ++node)
+                {
+                const hpmc::detail::AABB& aabb = m_tree.getNodeAABB(node);
+                if (!overlapSegment(aabb.getLower(), aabb.getUpper(), start, d, s))
+                    {
+                    node += m_tree.getNodeSkip(node);
+                    continue;
+                    }
+
+                if (m_tree.isNodeLeaf(node))
+                    {
+                    for (unsigned int j=0; j < m_tree.getNodeNumParticles(node); ++j)
+                        {
+                        const unsigned int tri = m_tree.getNodeParticle(node, j);
+                        if (facing && dot(m_normals[tri], d) >= Scalar(0))
+                            continue;
+
+                        // a particle sitting on the wall after a collision is not hit again, which would stall it
+                        Scalar s_tri;
+                        if (intersectTriangle(tri, start, d, s_tri) && s_tri < s && (!facing || s_tri > Scalar(0)))
+                            {
+                            s = s_tri;
+                            hit = tri;
+                            }
+                        }
+                    }
+                }
+            return hit;
+            }
+
+        //! Test if a segment overlaps a box
+        /*!
+         * \param lo Lower bound of the box
+         * \param hi Upper bound of the box
+         * \param start Start of the segment
+         * \param d Displacement along the segment
+         * \param s_max Largest fraction of the segment to consider
+         *
+         * \returns True if any part of the segment in [0, \a s_max] lies in the box.
+         */
+        static bool overlapSegment(const vec3<Scalar>& lo,
+                                   const vec3<Scalar>& hi,
+                                   const vec3<Scalar>& start,
+                                   const vec3<Scalar>& d,
+                                   Scalar s_max)
+            {
+            const Scalar los[3] = {lo.x, lo.y, lo.z};
+            const Scalar his[3] = {hi.x, hi.y, hi.z};
+            const Scalar p[3] = {start.x, start.y, start.z};
+            const Scalar dp[3] = {d.x, d.y, d.z};
+
+            Scalar s_min(0);
+            for (unsigned int dim=0; dim < 3; ++dim)
+                {
+                if (dp[dim] == Scalar(0))
+                    {
+                    if (p[dim] < los[dim] || p[dim] > his[dim])
+                        return false;
+                    }
+                else
+                    {
+                    const Scalar inv = Scalar(1) / dp[dim];
+                    Scalar s1 = (los[dim] - p[dim]) * inv;
+                    Scalar s2 = (his[dim] - p[dim]) * inv;
+                    if (s1 > s2) std::swap(s1,s2);
+                    s_min = std::max(s_min, s1);
+                    s_max = std::min(s_max, s2);
+                    if (s_min > s_max)
+                        return false;
+                    }
+                }
+            return true;
+            }
+
+        //! Intersect a segment with a triangle
+        /*!
+         * \param i Index of the triangle
+         * \param start Start of the segment
+         * \param d Displacement along the segment
+         * \param s Fraction of the segment to the intersection (output)
+         *
+         * \returns True if the segment intersects the triangle for \a s in [0,1].
+         *
+         * This is the Moller-Trumbore algorithm.
+         */
+        bool intersectTriangle(unsigned int i, const vec3<Scalar>& start, const vec3<Scalar>& d, Scalar& s) const
+            {
+            const uint3 tri = m_triangles[i];
+            const vec3<Scalar>& a = m_vertices[tri.x];
+            const vec3<Scalar> e1 = m_vertices[tri.y] - a;
+            const vec3<Scalar> e2 = m_vertices[tri.z] - a;
+
+            const vec3<Scalar> pvec = cross(d, e2);
+            const Scalar det = dot(e1, pvec);
+            // segment is parallel to the plane of the triangle
+            if (det == Scalar(0))
+                return false;
+            const Scalar inv_det = Scalar(1) / det;
+
+            const vec3<Scalar> tvec = start - a;
+            const Scalar u = dot(tvec, pvec) * inv_det;
+            if (u < Scalar(0) || u > Scalar(1))
+                return false;
+
+            const vec3<Scalar> qvec = cross(tvec, e1);
+            const Scalar v = dot(d, qvec) * inv_det;
+            if (v < Scalar(0) || u + v > Scalar(1))
+                return false;
+
+            s = dot(e2, qvec) * inv_det;
+            return (s >= Scalar(0) && s <= Scalar(1));
+            }
+    };
+
+} // end namespace detail
+} // end namespace mpcd
+
+#endif // MPCD_TRIANGLE_MESH_GEOMETRY_H_
@@ -0,0 +1,234 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/TriangleMeshGeometryFiller.cc
+ * \brief Definition of mpcd::TriangleMeshGeometryFiller
+ */
+
+#include "TriangleMeshGeometryFiller.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/RNGIdentifiers.h"
+
+#include <algorithm>
+
+mpcd::TriangleMeshGeometryFiller::TriangleMeshGeometryFiller(std::shared_ptr<mpcd::SystemData> sysdata,
+                                                             Scalar density,
+                                                             unsigned int type,
+                                                             std::shared_ptr<::Variant> T,
+                                                             unsigned int seed,
+                                                             std::shared_ptr<const mpcd::detail::TriangleMeshGeometry> geom)
+    : mpcd::VirtualParticleFiller(sysdata, density, type, T, seed),
+      m_voxel_lo(m_exec_conf), m_voxel_hi(m_exec_conf), m_ranges(m_exec_conf)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing MPCD TriangleMeshGeometryFiller" << std::endl;
+
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "mpcd: triangle mesh geometry filler is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Triangle mesh geometry filler is not supported on the GPU");
+        }
+
+    setGeometry(geom);
+
+    // unphysical values in cache to always force recompute
+    m_needs_recompute = true;
+    m_recompute_cache = make_scalar2(-1,-1);
+    m_pdata->getBoxChangeSignal().connect<mpcd::TriangleMeshGeometryFiller, &mpcd::TriangleMeshGeometryFiller::notifyRecompute>(this);
+    }
+
+mpcd::TriangleMeshGeometryFiller::~TriangleMeshGeometryFiller()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying MPCD TriangleMeshGeometryFiller" << std::endl;
+    m_pdata->getBoxChangeSignal().disconnect<mpcd::TriangleMeshGeometryFiller, &mpcd::TriangleMeshGeometryFiller::notifyRecompute>(this);
+    }
+
+void mpcd::TriangleMeshGeometryFiller::computeNumFill()
+    {
+    const Scalar cell_size = m_cl->getCellSize();
+
+    // check if fill-relevant variables have changed (can't use signal because cell list build may not have triggered yet)
+    m_needs_recompute |= (m_recompute_cache.x != cell_size ||
+                          m_recompute_cache.y != m_density);
+
+    // only recompute if needed
+    if (!m_needs_recompute) return;
+
+    // as a precaution, validate the global box with the current cell list
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    if (!m_geom->validateBox(global_box, cell_size))
+        {
+        m_exec_conf->msg->error() << "Invalid triangle mesh geometry for global box, cannot fill virtual particles." << std::endl;
+        throw std::runtime_error("Invalid triangle mesh geometry for global box");
+        }
+
+    // local box and voxel grid, which is aligned with the global cell grid (before shifting)
+    const BoxDim& box = m_pdata->getBox();
+    const Scalar3 lo = box.getLo();
+    const Scalar3 hi = box.getHi();
+    const Scalar3 global_lo = global_box.getLo();
+    const Scalar h = cell_size / Scalar(VOXELS_PER_CELL);
+    const int3 first = make_int3(static_cast<int>(std::floor((lo.x-global_lo.x)/h)),
+                                 static_cast<int>(std::floor((lo.y-global_lo.y)/h)),
+                                 static_cast<int>(std::floor((lo.z-global_lo.z)/h)));
+    const int3 last = make_int3(static_cast<int>(std::ceil((hi.x-global_lo.x)/h)),
+                                static_cast<int>(std::ceil((hi.y-global_lo.y)/h)),
+                                static_cast<int>(std::ceil((hi.z-global_lo.z)/h)));
+    const Index3D voxel_indexer(last.x-first.x, last.y-first.y, last.z-first.z);
+
+    /*
+     * Collect the voxels that could be overlapped by a cell cut by the mesh. Regardless of the grid shift, a cell
+     * can reach at most one cell size away along each axis from any point on a triangle it intersects, so the
+     * triangle bounds are expanded by this amount and clipped to the local domain. Within the bounds, a voxel is
+     * only kept if its center is close enough to the triangle for some point of the voxel to be within this
+     * reach. The per-axis reach and the half voxel are at most sqrt(3) times longer in Euclidean distance.
+     */
+    const Scalar reach = cell_size;
+    const Scalar max_dist = fast::sqrt(Scalar(3)) * (reach + Scalar(0.5)*h);
+    std::vector<unsigned int> candidates;
+    for (unsigned int i=0; i < m_geom->getNumTriangles(); ++i)
+        {
+        Scalar3 tri_lo, tri_hi;
+        m_geom->getTriangleBounds(i, tri_lo, tri_hi);
+        tri_lo = make_scalar3(std::max(tri_lo.x-reach,lo.x), std::max(tri_lo.y-reach,lo.y), std::max(tri_lo.z-reach,lo.z));
+        tri_hi = make_scalar3(std::min(tri_hi.x+reach,hi.x), std::min(tri_hi.y+reach,hi.y), std::min(tri_hi.z+reach,hi.z));
+        if (tri_lo.x >= tri_hi.x || tri_lo.y >= tri_hi.y || tri_lo.z >= tri_hi.z)
+            continue;
+
+        const int3 vlo = make_int3(std::max(static_cast<int>(std::floor((tri_lo.x-global_lo.x)/h)), first.x),
+                                   std::max(static_cast<int>(std::floor((tri_lo.y-global_lo.y)/h)), first.y),
+                                   std::max(static_cast<int>(std::floor((tri_lo.z-global_lo.z)/h)), first.z));
+        const int3 vhi = make_int3(std::min(static_cast<int>(std::ceil((tri_hi.x-global_lo.x)/h)), last.x),
+                                   std::min(static_cast<int>(std::ceil((tri_hi.y-global_lo.y)/h)), last.y),
+                                   std::min(static_cast<int>(std::ceil((tri_hi.z-global_lo.z)/h)), last.z));
+        for (int k=vlo.z; k < vhi.z; ++k)
+            for (int j=vlo.y; j < vhi.y; ++j)
+                for (int ii=vlo.x; ii < vhi.x; ++ii)
+                    {
+                    const Scalar3 center = global_lo + h * make_scalar3(ii + Scalar(0.5),
+                                                                        j + Scalar(0.5),
+                                                                        k + Scalar(0.5));
+                    if (m_geom->getDistanceToTriangle(i, center) <= max_dist)
+                        candidates.push_back(voxel_indexer(ii-first.x, j-first.y, k-first.z));
+                    }
+        }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // keep the voxels in the solid, clamped to the local domain
+    m_voxel_lo.resize(candidates.size());
+    m_voxel_hi.resize(candidates.size());
+    m_ranges.resize(candidates.size());
+    ArrayHandle<Scalar3> h_voxel_lo(m_voxel_lo, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_voxel_hi(m_voxel_hi, access_location::host, access_mode::overwrite);
+    ArrayHandle<uint2> h_ranges(m_ranges, access_location::host, access_mode::overwrite);
+    unsigned int num_voxels = 0;
+    Scalar volume = 0;
+    m_N_fill = 0;
+    for (unsigned int i=0; i < candidates.size(); ++i)
+        {
+        const uint3 v = voxel_indexer.getTriple(candidates[i]);
+        const Scalar3 vlo = global_lo + h * make_scalar3(v.x + first.x, v.y + first.y, v.z + first.z);
+        const Scalar3 center = vlo + make_scalar3(0.5*h, 0.5*h, 0.5*h);
+        if (!m_geom->isOutside(center))
+            continue;
+
+        const Scalar3 clamp_lo = make_scalar3(std::max(vlo.x,lo.x), std::max(vlo.y,lo.y), std::max(vlo.z,lo.z));
+        const Scalar3 clamp_hi = make_scalar3(std::min(vlo.x+h,hi.x), std::min(vlo.y+h,hi.y), std::min(vlo.z+h,hi.z));
+        volume += (clamp_hi.x-clamp_lo.x)*(clamp_hi.y-clamp_lo.y)*(clamp_hi.z-clamp_lo.z);
+
+        // round the cumulative volume so that small voxels do not each round to zero particles
+        const unsigned int N_fill = std::round(volume * m_density);
+        if (N_fill != m_N_fill)
+            {
+            h_voxel_lo.data[num_voxels] = clamp_lo;
+            h_voxel_hi.data[num_voxels] = clamp_hi;
+            h_ranges.data[num_voxels] = make_uint2(m_N_fill, N_fill);
+            ++num_voxels;
+
+            m_N_fill = N_fill;
+            }
+        }
+
+    // size is now updated, cache the cell dimensions used
+    m_needs_recompute = false;
+    m_recompute_cache = make_scalar2(cell_size, m_density);
+    }
+
+/*!
+ * \param timestep Current timestep to draw particles
+ */
+void mpcd::TriangleMeshGeometryFiller::drawParticles(unsigned int timestep)
+    {
+    // quit early if not filling to ensure we don't access any memory that hasn't been set
+    if (m_N_fill == 0) return;
+
+    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::readwrite);
+    const Scalar vel_factor = fast::sqrt(m_T->getValue(timestep) / m_mpcd_pdata->getMass());
+
+    // voxels for filling
+    ArrayHandle<Scalar3> h_voxel_lo(m_voxel_lo, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_voxel_hi(m_voxel_hi, access_location::host, access_mode::read);
+    ArrayHandle<uint2> h_ranges(m_ranges, access_location::host, access_mode::read);
+    // set these counters so that they get filled on the first pass
+    int voxelid = -1;
+    unsigned int voxellast = 0;
+    Scalar3 lo = make_scalar3(0,0,0);
+    Scalar3 hi = make_scalar3(0,0,0);
+
+    // index to start filling from
+    const unsigned int first_idx = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual() - m_N_fill;
+    for (unsigned int i=0; i < m_N_fill; ++i)
+        {
+        const unsigned int tag = m_first_tag + i;
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::TriangleMeshGeometryFiller, m_seed, tag, timestep);
+
+        // advanced past end of this voxel range, take the next
+        if (i >= voxellast)
+            {
+            ++voxelid;
+            voxellast = h_ranges.data[voxelid].y;
+            lo = h_voxel_lo.data[voxelid];
+            hi = h_voxel_hi.data[voxelid];
+            }
+
+        const unsigned int pidx = first_idx + i;
+        h_pos.data[pidx] = make_scalar4(hoomd::UniformDistribution<Scalar>(lo.x,hi.x)(rng),
+                                        hoomd::UniformDistribution<Scalar>(lo.y,hi.y)(rng),
+                                        hoomd::UniformDistribution<Scalar>(lo.z,hi.z)(rng),
+                                        __int_as_scalar(m_type));
+
+        hoomd::NormalDistribution<Scalar> gen(vel_factor, 0.0);
+        Scalar3 vel;
+        gen(vel.x, vel.y, rng);
+        vel.z = gen(rng);
+        h_vel.data[pidx] = make_scalar4(vel.x,
+                                        vel.y,
+                                        vel.z,
+                                        __int_as_scalar(mpcd::detail::NO_CELL));
+        h_tag.data[pidx] = tag;
+        }
+    }
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_TriangleMeshGeometryFiller(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<mpcd::TriangleMeshGeometryFiller, std::shared_ptr<mpcd::TriangleMeshGeometryFiller>>
+        (m, "TriangleMeshGeometryFiller", py::base<mpcd::VirtualParticleFiller>())
+        .def(py::init<std::shared_ptr<mpcd::SystemData>,
+                      Scalar,
+                      unsigned int,
+                      std::shared_ptr<::Variant>,
+                      unsigned int,
+                      std::shared_ptr<const mpcd::detail::TriangleMeshGeometry>>())
+        .def("setGeometry", &mpcd::TriangleMeshGeometryFiller::setGeometry)
+        ;
+    }
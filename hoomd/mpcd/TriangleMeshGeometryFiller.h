@@ -0,0 +1,82 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/TriangleMeshGeometryFiller.h
+ * \brief Definition of virtual particle filler for mpcd::detail::TriangleMeshGeometry.
+ */
+
+#ifndef MPCD_TRIANGLE_MESH_GEOMETRY_FILLER_H_
+#define MPCD_TRIANGLE_MESH_GEOMETRY_FILLER_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "VirtualParticleFiller.h"
+#include "TriangleMeshGeometry.h"
+
+#include "hoomd/GPUVector.h"
+#include "hoomd/extern/pybind/include/pybind11/pybind11.h"
+
+namespace mpcd
+{
+
+//! Adds virtual particles to the MPCD particle data for TriangleMeshGeometry
+/*!
+ * Particles are added to the volume outside the mesh that could be overlapped by a cell that is cut by the mesh,
+ * for any grid shift. This volume is found by dividing space near the triangles into voxels that are a fraction
+ * of the cell size. A voxel is filled if its center is outside the geometry and it lies within one cell size of
+ * the bounds of a triangle. Voxels are clamped to the local domain, and the number of particles in each voxel is
+ * rounded cumulatively so that the total fill density is correct.
+ */
+class PYBIND11_EXPORT TriangleMeshGeometryFiller : public mpcd::VirtualParticleFiller
+    {
+    public:
+        TriangleMeshGeometryFiller(std::shared_ptr<mpcd::SystemData> sysdata,
+                                   Scalar density,
+                                   unsigned int type,
+                                   std::shared_ptr<::Variant> T,
+                                   unsigned int seed,
+                                   std::shared_ptr<const mpcd::detail::TriangleMeshGeometry> geom);
+
+        virtual ~TriangleMeshGeometryFiller();
+
+        void setGeometry(std::shared_ptr<const mpcd::detail::TriangleMeshGeometry> geom)
+            {
+            m_geom = geom;
+            notifyRecompute();
+            }
+
+    protected:
+        std::shared_ptr<const mpcd::detail::TriangleMeshGeometry> m_geom;
+
+        const static unsigned int VOXELS_PER_CELL = 4;  //!< Number of voxels per cell edge
+        GPUVector<Scalar3> m_voxel_lo;  //!< Lower corners of voxels to fill
+        GPUVector<Scalar3> m_voxel_hi;  //!< Upper corners of voxels to fill
+        GPUVector<uint2> m_ranges;      //!< Particle tag ranges for filling
+
+        //! Compute the total number of particles to fill
+        virtual void computeNumFill();
+
+        //! Draw particles within the fill volume
+        virtual void drawParticles(unsigned int timestep);
+
+    private:
+        bool m_needs_recompute;
+        Scalar2 m_recompute_cache;
+        void notifyRecompute()
+            {
+            m_needs_recompute = true;
+            }
+    };
+
+namespace detail
+{
+//! Export TriangleMeshGeometryFiller to python
+void export_TriangleMeshGeometryFiller(pybind11::module& m);
+} // end namespace detail
+} // end namespace mpcd
+#endif // MPCD_TRIANGLE_MESH_GEOMETRY_FILLER_H_
@@ -242,11 +242,12 @@ class system(hoomd.meta._metadata):
 
         self.data.initializeFromSnapshot(snapshot.sys_snap)
 
-    def set_params(self, cell=None):
+    def set_params(self, cell=None, compact=None):
         R""" Set parameters of the MPCD system
 
         Args:
             cell (float): Edge length of an MPCD cell.
+            compact (bool): If True, store only the particles in the cell list.
 
         Every MPCD system is given a cell list for binning particles (see
         :py:mod:`.mpcd.collide`). The size of the cell list sets the length
@@ -256,10 +257,25 @@ class system(hoomd.meta._metadata):
         has a different fundamental unit of length, you can adjust the
         cell size, but be aware that this will also change the fluid properties.
 
+        By default, the cell list reserves room for the same number of particles
+        in every cell. In confined geometries (see :py:mod:`.mpcd.stream`),
+        many cells never hold particles, and setting *compact* to True stores
+        the particles of all cells back to back instead. The cell calculations
+        then only visit the cells that hold particles. The compact cell list is
+        only supported on the CPU.
+
+        Examples::
+
+            mpcd_sys.set_params(cell=1.0)
+            mpcd_sys.set_params(compact=True)
+
         """
         if cell is not None:
             self.cell.cell_size = cell
 
+        if compact is not None:
+            self.cell.compact = compact
+
     def take_snapshot(self, particles=True):
         R""" Takes a snapshot of the current state of the MPCD system
 
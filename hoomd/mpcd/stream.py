@@ -567,3 +567,162 @@ class slit_pore(_streaming_method):
         self._cpp.geometry = _mpcd.SlitPoreGeometry(self.H,self.L,bc)
         if self._filler is not None:
             self._filler.setGeometry(self._cpp.geometry)
+
+class triangle_mesh(_streaming_method):
+    r""" Streaming geometry bounded by a triangulated surface.
+
+    Args:
+        vertices (list): (x,y,z) coordinates of the mesh vertices
+        triangles (list): (i,j,k) indexes into *vertices* for each triangle
+        boundary (str): boundary condition at wall ("slip" or "no_slip"")
+        period (int): Number of integration steps between collisions
+
+    The triangle mesh geometry confines the fluid by an arbitrary surface, such
+    as the walls of a microfluidic channel. The vertices of each triangle must
+    be ordered so that the normal :math:`(\mathbf{b}-\mathbf{a}) \times (\mathbf{c}-\mathbf{a})`
+    points into the fluid. The mesh does not need to be closed, but it must
+    consistently separate the fluid from the solid.
+
+    The "inside" of the :py:class:`triangle_mesh` is the fluid side of the
+    surface. A particle is reflected from the first triangle it moves into
+    during a streaming step. The triangles are searched using a bounding
+    volume hierarchy, so large meshes can be used.
+
+    The mesh is not replicated through the periodic boundaries. In each
+    direction, the mesh must either be padded by at least one cell from the
+    faces of the simulation box, or extend through the box. If it extends
+    through the box, it should extend past the faces of the box by at least the
+    distance a particle can travel during one streaming step.
+
+    Examples::
+
+        # slit channel with walls at z = -5 and z = +5 in a box with L = 20
+        verts = [(-12,-12,-5),(12,-12,-5),(12,12,-5),(-12,12,-5),
+                 (-12,-12,5),(12,-12,5),(12,12,5),(-12,12,5)]
+        tris = [(0,1,2),(0,2,3),(4,6,5),(4,7,6)]
+        stream.triangle_mesh(vertices=verts, triangles=tris, period=10)
+
+    .. note::
+
+        The triangle mesh geometry is currently only supported on the CPU.
+
+    .. versionadded:: 2.9
+
+    """
+    def __init__(self, vertices, triangles, boundary="no_slip", period=1):
+        hoomd.util.print_status_line()
+
+        _streaming_method.__init__(self, period)
+
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error('mpcd.stream: triangle_mesh is not supported on the GPU.\n')
+            raise RuntimeError('Triangle mesh streaming geometry not supported on the GPU')
+
+        self.metadata_fields += ['boundary']
+        self.vertices = vertices
+        self.triangles = triangles
+        self.boundary = boundary
+
+        self._cpp = _mpcd.ConfinedStreamingMethodTriangleMesh(hoomd.context.current.mpcd.data,
+                                                              hoomd.context.current.system.getCurrentTimeStep(),
+                                                              self.period,
+                                                              0,
+                                                              self._make_geometry())
+
+    def set_filler(self, density, kT, seed, type='A'):
+        r""" Add virtual particles outside the triangle mesh.
+
+        Args:
+            density (float): Density of virtual particles.
+            kT (float): Temperature of virtual particles.
+            seed (int): Seed to pseudo-random number generator for virtual particles.
+            type (str): Type of the MPCD particles to fill with.
+
+        The virtual particle filler draws particles within the volume on the solid
+        side of the mesh that could be overlapped by any cell that is cut by the mesh.
+        This volume is found by dividing the space near the triangles into voxels
+        one quarter of the cell size. The particles are drawn from the velocity
+        distribution consistent with *kT* and with the given *density*. The mean of
+        the distribution is zero in *x*, *y*, and *z*. Typically, the virtual particle
+        density and temperature are set to the same conditions as the solvent.
+
+        The virtual particles will act as a weak thermostat on the fluid, and so energy
+        is no longer conserved. Momentum will also be sunk into the walls.
+
+        Example::
+
+            mesh.set_filler(density=5.0, kT=1.0, seed=42)
+
+        """
+        hoomd.util.print_status_line()
+
+        type_id = hoomd.context.current.mpcd.particles.getTypeByName(type)
+        T = hoomd.variant._setup_variant_input(kT)
+
+        if self._filler is None:
+            self._filler = _mpcd.TriangleMeshGeometryFiller(hoomd.context.current.mpcd.data,
+                                                            density,
+                                                            type_id,
+                                                            T.cpp_variant,
+                                                            seed,
+                                                            self._cpp.geometry)
+        else:
+            self._filler.setDensity(density)
+            self._filler.setType(type_id)
+            self._filler.setTemperature(T.cpp_variant)
+            self._filler.setSeed(seed)
+
+    def remove_filler(self):
+        """ Remove the virtual particle filler.
+
+        Example::
+
+            mesh.remove_filler()
+
+        """
+        hoomd.util.print_status_line()
+
+        self._filler = None
+
+    def set_params(self, vertices=None, triangles=None, boundary=None):
+        """ Set parameters for the triangle mesh geometry.
+
+        Args:
+            vertices (list): (x,y,z) coordinates of the mesh vertices
+            triangles (list): (i,j,k) indexes into *vertices* for each triangle
+            boundary (str): boundary condition at wall ("slip" or "no_slip"")
+
+        Changing any of these parameters will require the geometry to be
+        constructed and validated, so do not change these too often.
+
+        Examples::
+
+            mesh.set_params(boundary="slip")
+            mesh.set_params(vertices=new_verts)
+
+        """
+        hoomd.util.print_status_line()
+
+        if vertices is not None:
+            self.vertices = vertices
+
+        if triangles is not None:
+            self.triangles = triangles
+
+        if boundary is not None:
+            self.boundary = boundary
+
+        self._cpp.geometry = self._make_geometry()
+        if self._filler is not None:
+            self._filler.setGeometry(self._cpp.geometry)
+
+    def _make_geometry(self):
+        """ Make the C++ geometry from the current parameters.
+        """
+        bc = self._process_boundary(self.boundary)
+        verts = [tuple(float(x) for x in v) for v in self.vertices]
+        tris = [tuple(int(i) for i in t) for t in self.triangles]
+        if any(len(v) != 3 for v in verts) or any(len(t) != 3 for t in tris):
+            hoomd.context.msg.error('mpcd.stream.triangle_mesh: vertices and triangles must have 3 entries each.\n')
+            raise ValueError('Invalid triangle mesh')
+        return _mpcd.TriangleMeshGeometry(verts, tris, bc)
@@ -18,6 +18,16 @@ class mpcd_snapshot(unittest.TestCase):
 
         s.set_params(cell=1.5)
 
+        # compact cell list is only supported on the CPU
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            with self.assertRaises(RuntimeError):
+                s.set_params(compact=True)
+        else:
+            s.set_params(compact=True)
+            self.assertTrue(s.cell.compact)
+            s.set_params(compact=False)
+            self.assertFalse(s.cell.compact)
+
     def test_snapshot(self):
         s = mpcd.init.make_random(N=3, kT=1.0, seed=7)
         snap = s.take_snapshot()
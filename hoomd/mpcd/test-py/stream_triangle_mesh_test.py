@@ -0,0 +1,212 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: mphoward
+
+import unittest
+import numpy as np
+import hoomd
+from hoomd import md
+from hoomd import mpcd
+
+# slit channel with walls at z = -H and z = +H that extend through the box in x and y
+def make_slit(H, L=7.):
+    verts = [(-L,-L,-H),(L,-L,-H),(L,L,-H),(-L,L,-H),
+             (-L,-L,H),(L,-L,H),(L,L,H),(-L,L,H)]
+    tris = [(0,1,2),(0,2,3),(4,6,5),(4,7,6)]
+    return verts, tris
+
+# unit tests for mpcd triangle mesh streaming geometry
+class mpcd_stream_triangle_mesh_test(unittest.TestCase):
+    def setUp(self):
+        # establish the simulation context
+        hoomd.context.initialize()
+
+        # set the decomposition in z for mpi builds
+        if hoomd.comm.get_num_ranks() > 1:
+            hoomd.comm.decomposition(nz=2)
+
+        # default testing configuration
+        hoomd.init.read_snapshot(hoomd.data.make_snapshot(N=0, box=hoomd.data.boxdim(L=10.)))
+
+        # initialize the system from the starting snapshot
+        snap = mpcd.data.make_snapshot(N=3)
+        snap.particles.position[:] = [[ 1.,-2., 3.95],
+                                      [-1., 2.,-3.95],
+                                      [ 0., 0., 0.]]
+        snap.particles.velocity[:] = [[ 1.,-1., 1.],
+                                      [-1., 1.,-1.],
+                                      [ 1., 1., 1.]]
+        self.s = mpcd.init.read_snapshot(snap)
+
+        mpcd.integrator(dt=0.1)
+
+    # test creation can happen (with all parameters set), but only on the CPU
+    def test_create(self):
+        verts, tris = make_slit(4.)
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            with self.assertRaises(RuntimeError):
+                mpcd.stream.triangle_mesh(vertices=verts, triangles=tris, boundary="no_slip", period=2)
+        else:
+            mpcd.stream.triangle_mesh(vertices=verts, triangles=tris, boundary="no_slip", period=2)
+
+    # test for setting parameters
+    def test_set_params(self):
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            return
+
+        verts, tris = make_slit(4.)
+        mesh = mpcd.stream.triangle_mesh(vertices=verts, triangles=tris)
+        self.assertEqual(mesh.boundary, "no_slip")
+        self.assertEqual(mesh._cpp.geometry.getNumTriangles(), 4)
+        self.assertEqual(mesh._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.no_slip)
+
+        # change BCs
+        mesh.set_params(boundary="slip")
+        self.assertEqual(mesh.boundary, "slip")
+        self.assertEqual(mesh._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.slip)
+
+        # change the mesh to only the lower wall
+        mesh.set_params(vertices=verts[:4], triangles=tris[:2])
+        self.assertEqual(mesh._cpp.geometry.getNumTriangles(), 2)
+        self.assertEqual(mesh._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.slip)
+
+        # triangles must have three vertices that exist
+        with self.assertRaises(ValueError):
+            mesh.set_params(triangles=[(0,1)])
+        with self.assertRaises(RuntimeError):
+            mesh.set_params(triangles=[(0,1,8)])
+
+        # invalid boundary conditions
+        with self.assertRaises(ValueError):
+            mesh.set_params(triangles=tris[:2], boundary="invalid")
+
+    # test basic stepping behavior with no slip boundary conditions
+    def test_step_noslip(self):
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            return
+
+        verts, tris = make_slit(4.)
+        mpcd.stream.triangle_mesh(vertices=verts, triangles=tris)
+
+        # take one step, and the first two particles should collide and bounce back
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [ 1.,-2., 3.95])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [-1., 1.,-1.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-1., 2.,-3.95])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [ 1.,-1., 1.])
+            np.testing.assert_array_almost_equal(snap.particles.position[2], [ 0.1, 0.1, 0.1])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[2], [ 1., 1., 1.])
+
+        # take another step where nothing hits now
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [ 0.9,-1.9, 3.85])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-0.9, 1.9,-3.85])
+            np.testing.assert_array_almost_equal(snap.particles.position[2], [ 0.2, 0.2, 0.2])
+
+    # test basic stepping behavior with slip boundary conditions
+    def test_step_slip(self):
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            return
+
+        verts, tris = make_slit(4.)
+        mpcd.stream.triangle_mesh(vertices=verts, triangles=tris, boundary="slip")
+
+        # take one step, and the first two particles should only reflect in z
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [ 1.1,-2.1, 3.95])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [ 1.,-1.,-1.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-1.1, 2.1,-3.95])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [-1., 1., 1.])
+            np.testing.assert_array_almost_equal(snap.particles.position[2], [ 0.1, 0.1, 0.1])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[2], [ 1., 1., 1.])
+
+    # test that an invalid mesh for the box raises an error
+    def test_validate_box(self):
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            return
+
+        # zero velocities to stop particles moving during testing
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            snap.particles.velocity[:] = 0.
+        self.s.restore_snapshot(snap)
+
+        # walls are too close to the box in z
+        verts, tris = make_slit(4.5)
+        mesh = mpcd.stream.triangle_mesh(vertices=verts, triangles=tris)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(1)
+
+        # walls do not extend through the box, and are too close in x and y
+        verts, tris = make_slit(4., L=4.5)
+        mesh.set_params(vertices=verts, triangles=tris)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(2)
+
+        # now it should be valid
+        verts, tris = make_slit(4.)
+        mesh.set_params(vertices=verts, triangles=tris)
+        hoomd.run(3)
+
+    # test that particles out of bounds can be caught
+    def test_out_of_bounds(self):
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            return
+
+        verts, tris = make_slit(3.8)
+        mesh = mpcd.stream.triangle_mesh(vertices=verts, triangles=tris)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(1)
+
+        verts, tris = make_slit(4.)
+        mesh.set_params(vertices=verts, triangles=tris)
+        hoomd.run(1)
+
+    # test that virtual particle filler can be attached, removed, and updated
+    def test_filler(self):
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            return
+
+        # initialization of a filler
+        verts, tris = make_slit(4.)
+        mesh = mpcd.stream.triangle_mesh(vertices=verts, triangles=tris)
+        mesh.set_filler(density=5., kT=1.0, seed=42, type='A')
+        self.assertTrue(mesh._filler is not None)
+
+        # run should be able to setup the filler, although this all happens silently
+        hoomd.run(1)
+
+        # changing the geometry should still be OK with a run
+        mesh.set_params(boundary="slip")
+        hoomd.run(1)
+
+        # changing filler should be allowed
+        mesh.set_filler(density=10., kT=1.5, seed=7)
+        self.assertTrue(mesh._filler is not None)
+        hoomd.run(1)
+
+        # assert an error is raised if we set a bad particle type
+        with self.assertRaises(RuntimeError):
+            mesh.set_filler(density=5., kT=1.0, seed=42, type='B')
+
+        # assert an error is raised if we set a bad density
+        with self.assertRaises(RuntimeError):
+            mesh.set_filler(density=-1.0, kT=1.0, seed=42)
+
+        # removing the filler should still allow a run
+        mesh.remove_filler()
+        self.assertTrue(mesh._filler is None)
+        hoomd.run(1)
+
+    def tearDown(self):
+        del self.s
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -37,6 +37,16 @@ class mpcd_update_sort_test(unittest.TestCase):
         self.s.sorter.set_period(period=25)
         self.assertEqual(self.s.sorter.period, 25)
 
+    # test setting the adaptive sorting tolerance
+    def test_set_params(self):
+        self.assertEqual(self.s.sorter.tolerance, 0.0)
+        self.s.sorter.set_params(tolerance=0.1)
+        self.assertAlmostEqual(self.s.sorter.tolerance, 0.1)
+        hoomd.run(1)
+
+        with self.assertRaises(RuntimeError):
+            self.s.sorter.set_params(tolerance=1.5)
+
     # test enabling / disabling sorter
     def test_disable(self):
         # disabling sorter should remove it from list
@@ -60,9 +60,11 @@ void cell_communicator_reduce_test(std::shared_ptr<ExecutionConfiguration> exec_
     const Index3D& ci = cl->getCellIndexer();
     GPUArray<double3> props(ci.getNumElements(), exec_conf);
     GPUArray<double3> ref_props(ci.getNumElements(), exec_conf);
+    GPUArray<mpcd::detail::cell_thermo_sum> thermo_props(ci.getNumElements(), exec_conf);
         {
         ArrayHandle<double3> h_props(props, access_location::host, access_mode::overwrite);
         ArrayHandle<double3> h_ref_props(ref_props, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::cell_thermo_sum> h_thermo_props(thermo_props, access_location::host, access_mode::overwrite);
         for (unsigned int k=0; k < ci.getD(); ++k)
             {
             for (unsigned int j=0; j < ci.getH(); ++j)
@@ -74,6 +76,14 @@ void cell_communicator_reduce_test(std::shared_ptr<ExecutionConfiguration> exec_
 
                     h_props.data[ci(i,j,k)] = make_double3(global_cell.x, global_cell.y, __int_as_double(global_cell.z));
                     h_ref_props.data[ci(i,j,k)] = make_double3(global_cell.x, global_cell.y, __int_as_double(global_cell.z));
+
+                    // the mass is deliberately wrong, since it should be recomputed from the number of particles
+                    mpcd::detail::cell_thermo_sum sum;
+                    sum.momentum = make_double3(global_cell.x, global_cell.y, global_cell.z);
+                    sum.mass = -1.0;
+                    sum.energy = global_cell.y;
+                    sum.np = global_cell.z;
+                    h_thermo_props.data[ci(i,j,k)] = sum;
                     }
                 }
             }
@@ -82,10 +92,18 @@ void cell_communicator_reduce_test(std::shared_ptr<ExecutionConfiguration> exec_
     // on summing, all communicated cells should simply increase by a multiple of the ranks they overlap
     mpcd::CellCommunicator comm(sysdef, cl);
     comm.communicate(props, mpcd::detail::CellEnergyPackOp());
+
+    // the combined properties should be summed the same way, while the communication is progressed
+    mpcd::detail::CellUniformMassThermoPackOp thermo_op(2.0);
+    comm.begin(thermo_props, thermo_op);
+    while (!comm.progress()) { }
+    comm.finalize(thermo_props, thermo_op);
+
     auto num_comm_cells = cl->getNComm();
         {
         ArrayHandle<double3> h_props(props, access_location::host, access_mode::read);
         ArrayHandle<double3> h_ref_props(ref_props, access_location::host, access_mode::read);
+        ArrayHandle<mpcd::detail::cell_thermo_sum> h_thermo_props(thermo_props, access_location::host, access_mode::read);
         for (unsigned int k=0; k < ci.getD(); ++k)
             {
             for (unsigned int j=0; j < ci.getH(); ++j)
@@ -114,6 +132,18 @@ void cell_communicator_reduce_test(std::shared_ptr<ExecutionConfiguration> exec_
                     UP_ASSERT_EQUAL(h_props.data[ci(i,j,k)].x, h_ref_props.data[ci(i,j,k)].x * noverlap);
                     UP_ASSERT_EQUAL(h_props.data[ci(i,j,k)].y, h_ref_props.data[ci(i,j,k)].y); // energy packing doesn't touch y element
                     UP_ASSERT_EQUAL(__double_as_int(h_props.data[ci(i,j,k)].z), __double_as_int(h_ref_props.data[ci(i,j,k)].z) * noverlap);
+
+                    // only cells that were communicated have their mass recomputed
+                    const mpcd::detail::cell_thermo_sum sum = h_thermo_props.data[ci(i,j,k)];
+                    const double3 ref = h_ref_props.data[ci(i,j,k)];
+                    UP_ASSERT_EQUAL(sum.momentum.x, ref.x * noverlap);
+                    UP_ASSERT_EQUAL(sum.momentum.y, ref.y * noverlap);
+                    UP_ASSERT_EQUAL(sum.energy, ref.y * noverlap);
+                    UP_ASSERT_EQUAL(sum.np, __double_as_int(ref.z) * noverlap);
+                    if (noverlap > 1)
+                        UP_ASSERT_EQUAL(sum.mass, 2.0 * sum.np);
+                    else
+                        UP_ASSERT_EQUAL(sum.mass, -1.0);
                     }
                 }
             }
@@ -8,9 +8,13 @@
 #include "hoomd/mpcd/CellListGPU.h"
 #endif // ENABLE_CUDA
 
+#include "hoomd/RandomNumbers.h"
 #include "hoomd/SnapshotSystemData.h"
 #include "hoomd/test/upp11_config.h"
 
+#include <algorithm>
+#include <functional>
+
 HOOMD_UP_MAIN()
 
 //! Test for correct calculation of MPCD grid dimensions
@@ -592,6 +596,214 @@ void celllist_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         }
     }
 
+//! Test that the compact layout holds the same cells as the dense layout
+void celllist_compact_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // embedded particles of type B share cells with the MPCD particles
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(4.0);
+        {
+        SnapshotParticleData<Scalar>& pdata_snap = snap->particle_data;
+        pdata_snap.type_mapping.push_back("A");
+        pdata_snap.type_mapping.push_back("B");
+        pdata_snap.resize(3);
+        pdata_snap.pos[0] = vec3<Scalar>(-1.5, -1.5, -1.5);
+        pdata_snap.pos[1] = vec3<Scalar>( 1.5,  0.5, -0.5);
+        pdata_snap.pos[2] = vec3<Scalar>( 0.5,  0.5,  1.5);
+        pdata_snap.type[0] = 1;
+        pdata_snap.type[1] = 0;
+        pdata_snap.type[2] = 1;
+        }
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // the MPCD particles only fill a few of the 64 cells
+    std::shared_ptr<mpcd::ParticleData> pdata_7;
+        {
+        auto mpcd_snap = std::make_shared<mpcd::ParticleDataSnapshot>(7);
+        mpcd_snap->position[0] = vec3<Scalar>( 0.5,  0.5,  1.5);
+        mpcd_snap->position[1] = vec3<Scalar>(-1.5, -1.5, -1.5);
+        mpcd_snap->position[2] = vec3<Scalar>( 0.4,  0.6,  1.4);
+        mpcd_snap->position[3] = vec3<Scalar>( 1.5, -0.5,  0.5);
+        mpcd_snap->position[4] = vec3<Scalar>( 0.6,  0.4,  1.6);
+        mpcd_snap->position[5] = vec3<Scalar>(-1.4, -1.6, -1.5);
+        mpcd_snap->position[6] = vec3<Scalar>( 1.5, -0.5,  0.6);
+        pdata_7 = std::make_shared<mpcd::ParticleData>(mpcd_snap, snap->global_box, exec_conf);
+        }
+
+    std::shared_ptr<ParticleSelector> selector_B(new ParticleSelectorType(sysdef, 1, 1));
+    std::shared_ptr<ParticleGroup> group_B(new ParticleGroup(sysdef, selector_B));
+
+    std::shared_ptr<mpcd::CellList> cl(new mpcd::CellList(sysdef, pdata_7));
+    cl->setEmbeddedGroup(group_B);
+    UP_ASSERT(!cl->isCompact());
+    cl->compute(0);
+
+    // get the sorted members of every cell
+    auto get_members = [&]()
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_list(cl->getCellList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_offsets(cl->getCellOffsets(), access_location::host, access_mode::read);
+        std::vector< std::vector<unsigned int> > members(cl->getNCells());
+        for (unsigned int cell=0; cell < cl->getNCells(); ++cell)
+            {
+            const unsigned int *first = h_cell_list.data + h_cell_offsets.data[cell];
+            members[cell].assign(first, first + h_cell_np.data[cell]);
+            std::sort(members[cell].begin(), members[cell].end());
+            }
+        return members;
+        };
+    const std::vector< std::vector<unsigned int> > dense_members = get_members();
+        {
+        Index3D ci = cl->getCellIndexer();
+        UP_ASSERT_EQUAL(dense_members[ci(2,2,3)], std::vector<unsigned int>({0,2,4,8}));
+        UP_ASSERT_EQUAL(dense_members[ci(0,0,0)], std::vector<unsigned int>({1,5,7}));
+        UP_ASSERT_EQUAL(dense_members[ci(3,1,2)], std::vector<unsigned int>({3,6}));
+        }
+
+    // switching the layout forces a rebuild with the same members
+    cl->setCompact(true);
+    UP_ASSERT(cl->isCompact());
+    cl->compute(0);
+    UP_ASSERT(get_members() == dense_members);
+    CHECK_EQUAL_UINT(cl->getNmax(), 4);
+
+    // only the occupied cells are listed, in order, and their members are packed
+        {
+        Index3D ci = cl->getCellIndexer();
+        CHECK_EQUAL_UINT(cl->getNOccupiedCells(), 3);
+        ArrayHandle<unsigned int> h_occupied_cells(cl->getOccupiedCells(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT(h_occupied_cells.data[0], ci(0,0,0));
+        CHECK_EQUAL_UINT(h_occupied_cells.data[1], ci(3,1,2));
+        CHECK_EQUAL_UINT(h_occupied_cells.data[2], ci(2,2,3));
+
+        ArrayHandle<unsigned int> h_cell_offsets(cl->getCellOffsets(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT(h_cell_offsets.data[ci(0,0,0)], 0);
+        CHECK_EQUAL_UINT(h_cell_offsets.data[ci(3,1,2)], 3);
+        CHECK_EQUAL_UINT(h_cell_offsets.data[ci(2,2,3)], 5);
+        UP_ASSERT(cl->getCellList().getNumElements() >= 9);
+
+        // the particles in each cell are still ordered by index
+        ArrayHandle<unsigned int> h_cell_list(cl->getCellList(), access_location::host, access_mode::read);
+        UP_ASSERT_EQUAL(std::vector<unsigned int>(h_cell_list.data, h_cell_list.data + 9),
+                        std::vector<unsigned int>({1,5,7,3,6,0,2,4,8}));
+
+        // the cells are still stashed in the velocities
+        ArrayHandle<Scalar4> h_vel(pdata_7->getVelocities(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT(__scalar_as_int(h_vel.data[3].w), ci(3,1,2));
+        ArrayHandle<unsigned int> h_embed_cell_ids(cl->getEmbeddedGroupCellIds(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT(h_embed_cell_ids.data[0], ci(0,0,0));
+        CHECK_EQUAL_UINT(h_embed_cell_ids.data[1], ci(2,2,3));
+        }
+
+    // switching back to the dense layout gives the same members again
+    cl->setCompact(false);
+    cl->compute(1);
+    UP_ASSERT(get_members() == dense_members);
+    }
+
+//! Test that the threaded build of the cell list gives the same cells as the serial build
+void celllist_threads_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    hoomd::RandomGenerator rng(7, 7, 91);
+    hoomd::UniformDistribution<Scalar> uniform(-4.0, 4.0);
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(8.0);
+        {
+        SnapshotParticleData<Scalar>& pdata_snap = snap->particle_data;
+        pdata_snap.type_mapping.push_back("A");
+        pdata_snap.resize(200);
+        for (unsigned int i=0; i < 200; ++i)
+            {
+            pdata_snap.pos[i] = vec3<Scalar>(uniform(rng), uniform(rng), uniform(rng));
+            }
+        }
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // many more particles than cells, so that the threads claim slots in the same cells
+    std::shared_ptr<mpcd::ParticleData> pdata;
+        {
+        auto mpcd_snap = std::make_shared<mpcd::ParticleDataSnapshot>(4000);
+        for (unsigned int i=0; i < 4000; ++i)
+            {
+            mpcd_snap->position[i] = vec3<Scalar>(uniform(rng), uniform(rng), uniform(rng));
+            }
+        pdata = std::make_shared<mpcd::ParticleData>(mpcd_snap, snap->global_box, exec_conf);
+        }
+
+    std::shared_ptr<ParticleSelector> selector_A(new ParticleSelectorType(sysdef, 0, 0));
+    std::shared_ptr<ParticleGroup> group_A(new ParticleGroup(sysdef, selector_A));
+
+    std::shared_ptr<mpcd::CellList> cl(new mpcd::CellList(sysdef, pdata));
+    cl->setEmbeddedGroup(group_A);
+
+    // get the members of every cell in the order they are stored
+    auto get_members = [&]() -> std::vector< std::vector<unsigned int> >
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_list(cl->getCellList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_offsets(cl->getCellOffsets(), access_location::host, access_mode::read);
+        std::vector< std::vector<unsigned int> > members(cl->getNCells());
+        for (unsigned int cell=0; cell < cl->getNCells(); ++cell)
+            {
+            const unsigned int *first = h_cell_list.data + h_cell_offsets.data[cell];
+            members[cell].assign(first, first + h_cell_np.data[cell]);
+            }
+        return members;
+        };
+
+    // get the cell stashed for every MPCD and embedded particle
+    auto get_particle_cells = [&]() -> std::vector<unsigned int>
+        {
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_embed_cell_ids(cl->getEmbeddedGroupCellIds(), access_location::host, access_mode::read);
+        std::vector<unsigned int> cells(pdata->getN() + group_A->getNumMembers());
+        for (unsigned int i=0; i < pdata->getN(); ++i)
+            cells[i] = __scalar_as_int(h_vel.data[i].w);
+        for (unsigned int i=0; i < group_A->getNumMembers(); ++i)
+            cells[pdata->getN() + i] = h_embed_cell_ids.data[i];
+        return cells;
+        };
+
+    unsigned int timestep = 0;
+    for (unsigned int compact=0; compact < 2; ++compact)
+        {
+        cl->setCompact(compact);
+
+        // serial reference build
+        #ifdef ENABLE_TBB
+        exec_conf->setNumThreads(1);
+        #endif
+        cl->compute(timestep++);
+        const std::vector< std::vector<unsigned int> > serial_members = get_members();
+        const std::vector<unsigned int> serial_cells = get_particle_cells();
+
+        // every particle is listed once, in the cell it is stashed with, and the cells are in index order
+        unsigned int num_members = 0;
+        for (unsigned int cell=0; cell < serial_members.size(); ++cell)
+            {
+            const std::vector<unsigned int>& members = serial_members[cell];
+            num_members += members.size();
+            UP_ASSERT(std::adjacent_find(members.begin(), members.end(), std::greater_equal<unsigned int>()) == members.end());
+            for (unsigned int j=0; j < members.size(); ++j)
+                CHECK_EQUAL_UINT(serial_cells[members[j]], cell);
+            }
+        CHECK_EQUAL_UINT(num_members, 4200);
+
+        // threaded builds give the same cells in the same order
+        #ifdef ENABLE_TBB
+        exec_conf->setNumThreads(4);
+        #endif
+        for (unsigned int rep=0; rep < 5; ++rep)
+            {
+            cl->compute(timestep++);
+            UP_ASSERT(get_members() == serial_members);
+            UP_ASSERT(get_particle_cells() == serial_cells);
+            }
+        }
+    }
+
 //! dimension test case for MPCD CellList class
 UP_TEST( mpcd_cell_list_dimensions )
     {
@@ -616,6 +828,18 @@ UP_TEST( mpcd_cell_list_embed_test )
     celllist_embed_test<mpcd::CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! compact layout test case for MPCD CellList class
+UP_TEST( mpcd_cell_list_compact_test )
+    {
+    celllist_compact_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! threaded build test case for MPCD CellList class
+UP_TEST( mpcd_cell_list_threads_test )
+    {
+    celllist_threads_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! dimension test case for MPCD CellListGPU class
 UP_TEST( mpcd_cell_list_gpu_dimensions )
@@ -328,6 +328,69 @@ void sorter_virtual_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         }
     }
 
+//! Test for adaptive MPCD sorting
+template<class T>
+void sorter_tolerance_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(2.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // place eight mpcd particles, one per cell, so that the cell list order is 0 5 1 6 2 7 3 4
+    const unsigned int cell_order[] = {0, 5, 1, 6, 2, 7, 3, 4};
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(8);
+        for (unsigned int cell=0; cell < 8; ++cell)
+            {
+            mpcd_snap->position[cell_order[cell]] = vec3<Scalar>(-0.5 + (cell & 1), -0.5 + ((cell >> 1) & 1), -0.5 + ((cell >> 2) & 1));
+            }
+        }
+
+    // without a tolerance, the particles are always sorted, and the scattered fraction is still measured
+        {
+        auto always_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+        std::shared_ptr<mpcd::Sorter> sorter = std::make_shared<T>(always_sys, 0, 1);
+        sorter->update(0);
+        CHECK_CLOSE(sorter->getScatter(), 3.0/7.0, tol_small);
+        ArrayHandle<unsigned int> h_tag(always_sys->getParticleData()->getTags(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < 8; ++i)
+            UP_ASSERT_EQUAL(h_tag.data[i], cell_order[i]);
+        }
+
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+
+    // three of the seven neighbors in cell list order are further apart than a cell (4 particles)
+    std::shared_ptr<mpcd::Sorter> sorter = std::make_shared<T>(mpcd_sys, 0, 1);
+    sorter->setTolerance(0.5);
+    sorter->update(0);
+    CHECK_CLOSE(sorter->getScatter(), 3.0/7.0, tol_small);
+        {
+        ArrayHandle<unsigned int> h_tag(mpcd_sys->getParticleData()->getTags(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < 8; ++i)
+            UP_ASSERT_EQUAL(h_tag.data[i], i);
+        }
+
+    // with a lower tolerance, the particles are sorted
+    sorter->setTolerance(0.25);
+    sorter->update(1);
+        {
+        ArrayHandle<unsigned int> h_tag(mpcd_sys->getParticleData()->getTags(), access_location::host, access_mode::read);
+        for (unsigned int i=0; i < 8; ++i)
+            UP_ASSERT_EQUAL(h_tag.data[i], cell_order[i]);
+        }
+
+    // once sorted, nothing is scattered
+    sorter->update(2);
+    CHECK_SMALL(sorter->getScatter(), tol_small);
+
+    // invalid tolerances are rejected
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ sorter->setTolerance(-0.1); });
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ sorter->setTolerance(1.0); });
+    }
+
 //! basic test case for MPCD sorter
 UP_TEST( mpcd_sorter_test )
     {
@@ -338,6 +401,11 @@ UP_TEST( mpcd_sorter_virtual_test )
     {
     sorter_virtual_test<mpcd::Sorter>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! test case for adaptive MPCD sorter
+UP_TEST( mpcd_sorter_tolerance_test )
+    {
+    sorter_tolerance_test<mpcd::Sorter>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 #ifdef ENABLE_CUDA
 UP_TEST( mpcd_sorter_test_gpu )
     {
@@ -105,12 +105,115 @@ void streaming_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec_co
         }
     }
 
+//! Check that two cell lists hold the same particles in the same order
+void check_same_cell_list(std::shared_ptr<mpcd::SystemData> sys_a, std::shared_ptr<mpcd::SystemData> sys_b)
+    {
+    std::shared_ptr<mpcd::CellList> cl_a = sys_a->getCellList();
+    std::shared_ptr<mpcd::CellList> cl_b = sys_b->getCellList();
+    CHECK_EQUAL_UINT(cl_a->getNmax(), cl_b->getNmax());
+    CHECK_EQUAL_UINT(cl_a->getNCells(), cl_b->getNCells());
+
+    ArrayHandle<unsigned int> h_np_a(cl_a->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_np_b(cl_b->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cl_a(cl_a->getCellList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cl_b(cl_b->getCellList(), access_location::host, access_mode::read);
+    const Index2D& cli = cl_a->getCellListIndexer();
+    for (unsigned int cell=0; cell < cl_a->getNCells(); ++cell)
+        {
+        CHECK_EQUAL_UINT(h_np_a.data[cell], h_np_b.data[cell]);
+        for (unsigned int offset=0; offset < h_np_a.data[cell]; ++offset)
+            {
+            CHECK_EQUAL_UINT(h_cl_a.data[cli(offset,cell)], h_cl_b.data[cli(offset,cell)]);
+            }
+        }
+
+    ArrayHandle<Scalar4> h_vel_a(sys_a->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel_b(sys_b->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int i=0; i < sys_a->getParticleData()->getN(); ++i)
+        {
+        CHECK_EQUAL_UINT(__scalar_as_int(h_vel_a.data[i].w), __scalar_as_int(h_vel_b.data[i].w));
+        }
+    }
+
+//! Test that binning the particles while streaming gives the same cell list as a separate build
+template<class SM>
+void streaming_method_prebin_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(4.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // 9 particles, 6 of which end up in the same cell to overflow the default cell list size
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(9);
+        for (unsigned int i=0; i < 6; ++i)
+            {
+            mpcd_snap->position[i] = vec3<Scalar>(0.1 + 0.05*i, 0.2, 0.3);
+            mpcd_snap->velocity[i] = vec3<Scalar>(1.0, 0.0, 0.0);
+            }
+        mpcd_snap->position[6] = vec3<Scalar>(-1.95, 1.5, -0.5);
+        mpcd_snap->velocity[6] = vec3<Scalar>(-1.0, 1.0, 0.0);
+        mpcd_snap->position[7] = vec3<Scalar>(1.9, -1.9, 1.9);
+        mpcd_snap->velocity[7] = vec3<Scalar>(1.0, -1.0, 1.0);
+        mpcd_snap->position[8] = vec3<Scalar>(-0.5, -0.5, -1.5);
+        mpcd_snap->velocity[8] = vec3<Scalar>(0.0, 0.0, -1.0);
+        }
+    auto sys_a = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    auto sys_b = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+
+    auto geom = std::make_shared<const mpcd::detail::BulkGeometry>();
+    std::shared_ptr<mpcd::StreamingMethod> stream_a = std::make_shared<SM>(sys_a, 0, 1, -1, geom);
+    std::shared_ptr<mpcd::StreamingMethod> stream_b = std::make_shared<SM>(sys_b, 0, 1, -1, geom);
+    stream_a->setDeltaT(0.1);
+    stream_b->setDeltaT(0.1);
+
+    const Scalar3 shift = make_scalar3(0.1, -0.2, 0.3);
+    sys_a->getCellList()->setGridShift(shift);
+    sys_b->getCellList()->setGridShift(shift);
+
+    // bin while streaming for the next step, and compare to a separate build
+    sys_a->getCellList()->requestPrebin(1);
+    stream_a->stream(0);
+    stream_b->stream(0);
+    sys_a->getCellList()->compute(1);
+    sys_b->getCellList()->compute(1);
+    check_same_cell_list(sys_a, sys_b);
+    UP_ASSERT(sys_a->getCellList()->getNmax() >= 6);
+
+    // particles binned for a different step must not be used
+    sys_a->getCellList()->requestPrebin(5);
+    stream_a->stream(1);
+    stream_b->stream(1);
+    sys_a->getCellList()->compute(2);
+    sys_b->getCellList()->compute(2);
+    check_same_cell_list(sys_a, sys_b);
+
+    // particles binned with a different grid shift must not be used
+    sys_a->getCellList()->requestPrebin(3);
+    stream_a->stream(2);
+    stream_b->stream(2);
+    sys_a->getCellList()->setGridShift(-shift);
+    sys_b->getCellList()->setGridShift(-shift);
+    sys_a->getCellList()->compute(3);
+    sys_b->getCellList()->compute(3);
+    check_same_cell_list(sys_a, sys_b);
+    }
+
 //! basic test case for MPCD StreamingMethod class
 UP_TEST( mpcd_streaming_method_basic )
     {
     typedef mpcd::ConfinedStreamingMethod<mpcd::detail::BulkGeometry> method;
     streaming_method_basic_test<method>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
     }
+//! binning test case for MPCD StreamingMethod class
+UP_TEST( mpcd_streaming_method_prebin )
+    {
+    typedef mpcd::ConfinedStreamingMethod<mpcd::detail::BulkGeometry> method;
+    streaming_method_prebin_test<method>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
+    }
 #ifdef ENABLE_CUDA
 //! basic test case for MPCD StreamingMethod class
 UP_TEST( mpcd_streaming_method_setup )
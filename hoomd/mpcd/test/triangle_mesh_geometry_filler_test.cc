@@ -0,0 +1,199 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#include "hoomd/mpcd/TriangleMeshGeometryFiller.h"
+
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN()
+
+//! Make a slit channel from two square walls at z = -H and z = +H
+/*!
+ * \param H Channel half-width
+ * \param L Half-length of the walls in x and y
+ * \param bc Boundary condition
+ */
+std::shared_ptr<const mpcd::detail::TriangleMeshGeometry> make_slit_mesh(Scalar H, Scalar L, mpcd::detail::boundary bc)
+    {
+    std::vector<Scalar3> vertices = {make_scalar3(-L,-L,-H), make_scalar3(L,-L,-H),
+                                     make_scalar3(L,L,-H), make_scalar3(-L,L,-H),
+                                     make_scalar3(-L,-L,H), make_scalar3(L,-L,H),
+                                     make_scalar3(L,L,H), make_scalar3(-L,L,H)};
+    // lower wall normal points in +z, upper wall normal points in -z
+    std::vector<uint3> triangles = {make_uint3(0,1,2), make_uint3(0,2,3),
+                                    make_uint3(4,6,5), make_uint3(4,7,6)};
+    return std::make_shared<const mpcd::detail::TriangleMeshGeometry>(vertices, triangles, bc);
+    }
+
+//! Test collisions and bounds for the triangle mesh geometry
+UP_TEST( triangle_mesh_geometry )
+    {
+    auto slit = make_slit_mesh(2.0, 6.0, mpcd::detail::boundary::no_slip);
+    UP_ASSERT_EQUAL(slit->getNumTriangles(), 4);
+    UP_ASSERT_EQUAL(slit->getName(), "TriangleMesh");
+
+    // inside the channel and outside either wall
+    UP_ASSERT(!slit->isOutside(make_scalar3(0.1,-0.3,0.5)));
+    UP_ASSERT(slit->isOutside(make_scalar3(1.0,1.0,2.5)));
+    UP_ASSERT(slit->isOutside(make_scalar3(1.0,1.0,-2.5)));
+
+    // no collision inside the channel
+        {
+        Scalar3 pos = make_scalar3(0.3,0.2,1.5);
+        Scalar3 vel = make_scalar3(1.0,-1.0,1.0);
+        Scalar dt = 1.0;
+        UP_ASSERT(!slit->detectCollision(pos, vel, dt));
+        CHECK_SMALL(dt, tol_small);
+        }
+
+    // collide with the upper wall, no-slip reverses the velocity
+        {
+        Scalar3 pos = make_scalar3(0.3,0.2,2.5);
+        Scalar3 vel = make_scalar3(1.0,-1.0,1.0);
+        Scalar dt = 1.0;
+        UP_ASSERT(slit->detectCollision(pos, vel, dt));
+        CHECK_CLOSE(pos.x, -0.2, tol_small);
+        CHECK_CLOSE(pos.y, 0.7, tol_small);
+        CHECK_CLOSE(pos.z, 2.0, tol_small);
+        CHECK_CLOSE(vel.x, -1.0, tol_small);
+        CHECK_CLOSE(vel.y, 1.0, tol_small);
+        CHECK_CLOSE(vel.z, -1.0, tol_small);
+        CHECK_CLOSE(dt, 0.5, tol_small);
+
+        // streaming away from the wall does not collide again
+        pos += dt*vel;
+        UP_ASSERT(!slit->detectCollision(pos, vel, dt));
+        }
+
+    // collide with the lower wall, slip only reflects the normal velocity
+    auto slip = make_slit_mesh(2.0, 6.0, mpcd::detail::boundary::slip);
+        {
+        Scalar3 pos = make_scalar3(0.3,0.2,-2.5);
+        Scalar3 vel = make_scalar3(1.0,-1.0,-1.0);
+        Scalar dt = 1.0;
+        UP_ASSERT(slip->detectCollision(pos, vel, dt));
+        CHECK_CLOSE(pos.x, -0.2, tol_small);
+        CHECK_CLOSE(pos.y, 0.7, tol_small);
+        CHECK_CLOSE(pos.z, -2.0, tol_small);
+        CHECK_CLOSE(vel.x, 1.0, tol_small);
+        CHECK_CLOSE(vel.y, -1.0, tol_small);
+        CHECK_CLOSE(vel.z, 1.0, tol_small);
+        CHECK_CLOSE(dt, 0.5, tol_small);
+        }
+
+    // distance to the lower triangle (0,1,2) in the face, edge, and vertex regions
+    CHECK_CLOSE(slit->getDistanceToTriangle(0, make_scalar3(2.0,-1.0,-1.0)), 1.0, tol_small);
+    CHECK_CLOSE(slit->getDistanceToTriangle(0, make_scalar3(2.0,-7.0,-2.0)), 1.0, tol_small);
+    CHECK_CLOSE(slit->getDistanceToTriangle(0, make_scalar3(-1.0,1.0,-2.0)), std::sqrt(2.0), tol_small);
+    CHECK_CLOSE(slit->getDistanceToTriangle(0, make_scalar3(7.0,8.0,-4.0)), 3.0, tol_small);
+    CHECK_SMALL(slit->getDistanceToTriangle(0, make_scalar3(-6.0,-6.0,-2.0)), tol_small);
+
+    // walls span the box in x and y and are padded in z
+    UP_ASSERT(slit->validateBox(BoxDim(10.0), 1.0));
+    UP_ASSERT(!slit->validateBox(BoxDim(10.0,10.0,4.5), 1.0));
+    UP_ASSERT(!slit->validateBox(BoxDim(13.0), 1.0));
+    }
+
+//! Test filling virtual particles outside a slit made from a triangle mesh
+UP_TEST( triangle_mesh_fill_basic )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(20.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        std::shared_ptr<mpcd::ParticleDataSnapshot> mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(1);
+
+        mpcd_snap->position[0] = vec3<Scalar>(1,-2,3);
+        mpcd_snap->velocity[0] = vec3<Scalar>(123, 456, 789);
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    auto pdata = mpcd_sys->getParticleData();
+    mpcd_sys->getCellList()->setCellSize(2.0);
+    UP_ASSERT_EQUAL(pdata->getNVirtual(), 0);
+
+    // slit channel with half width 5, with walls extending through the periodic boundaries
+    auto slit = make_slit_mesh(5.0, 12.0, mpcd::detail::boundary::no_slip);
+    std::shared_ptr<::Variant> kT = std::make_shared<::VariantConst>(1.5);
+    auto filler = std::make_shared<mpcd::TriangleMeshGeometryFiller>(mpcd_sys, 2.0, 1, kT, 42, slit);
+
+    /*
+     * Test basic filling up for this cell list
+     */
+    filler->fill(0);
+    // volume to fill is from 5->7 (2) on + side, with cross section of 20^2, mirrored on bottom
+    UP_ASSERT_EQUAL(pdata->getNVirtual(), 2*(2*20*20)*2);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+
+        // ensure first particle did not get overwritten
+        CHECK_CLOSE(h_pos.data[0].x,  1, tol_small);
+        CHECK_CLOSE(h_pos.data[0].y, -2, tol_small);
+        CHECK_CLOSE(h_pos.data[0].z,  3, tol_small);
+        UP_ASSERT_EQUAL(h_tag.data[0], 0);
+
+        unsigned int N_lo(0), N_hi(0);
+        for (unsigned int i=pdata->getN(); i < pdata->getN() + pdata->getNVirtual(); ++i)
+            {
+            // tag should equal index on one rank with one filler
+            UP_ASSERT_EQUAL(h_tag.data[i], i);
+            // type should be set
+            UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[i].w), 1);
+
+            const Scalar z = h_pos.data[i].z;
+            if (z < Scalar(-5.0) && z >= Scalar(-7.0))
+                ++N_lo;
+            else if (z >= Scalar(5.0) && z < Scalar(7.0))
+                ++N_hi;
+            }
+        UP_ASSERT_EQUAL(N_lo, 2*(2*20*20));
+        UP_ASSERT_EQUAL(N_hi, 2*(2*20*20));
+        }
+
+    /*
+     * Change the cell size, which shrinks the fill volume
+     */
+    pdata->removeVirtualParticles();
+    mpcd_sys->getCellList()->setCellSize(1.0);
+    filler->fill(1);
+    UP_ASSERT_EQUAL(pdata->getNVirtual(), 2*(20*20)*2);
+
+    /*
+     * Test the average properties of the virtual particles.
+     */
+    mpcd_sys->getCellList()->setCellSize(2.0);
+    unsigned int N(0);
+    Scalar3 v_avg = make_scalar3(0,0,0);
+    Scalar T_avg(0);
+    for (unsigned int t=0; t < 100; ++t)
+        {
+        pdata->removeVirtualParticles();
+        filler->fill(2+t);
+
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        for (unsigned int i=pdata->getN(); i < pdata->getN() + pdata->getNVirtual(); ++i)
+            {
+            const Scalar4 vel_cell = h_vel.data[i];
+            const Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
+            v_avg += vel;
+            T_avg += dot(vel,vel);
+            ++N;
+            }
+        }
+    UP_ASSERT_EQUAL(N, 100*2*(2*20*20)*2);
+    v_avg /= N; T_avg /= (3*(N-1));
+
+    CHECK_SMALL(v_avg.x, tol);
+    CHECK_SMALL(v_avg.y, tol);
+    CHECK_SMALL(v_avg.z, tol);
+    CHECK_CLOSE(T_avg, 1.5, tol);
+    }
@@ -36,6 +36,12 @@ class sort(hoomd.meta._metadata):
         The *period* should be no smaller than the MPCD collision period, or unnecessary
         cell list builds will occur.
 
+    The sorter can also sort adaptively. With *tolerance* set in :py:meth:`set_params()`,
+    it measures the fraction of particles that are stored far from their neighbors in the
+    cell list every *period* time steps, and only reorders the particles once that fraction
+    exceeds *tolerance*. The *period* can then be set to the collision period instead of
+    being tuned.
+
     Essentially all MPCD systems benefit from sorting, and so a sorter is created by
     default with the MPCD system. To disable it or modify parameters, save the system
     and access the sorter through it::
@@ -65,8 +71,9 @@ class sort(hoomd.meta._metadata):
             cpp_class = _mpcd.SorterGPU
         self._cpp = cpp_class(system.data, hoomd.context.current.system.getCurrentTimeStep(), period)
 
-        self.metadata_fields = ['period','enabled']
+        self.metadata_fields = ['period','tolerance','enabled']
         self.period = period
+        self.tolerance = 0.0
         self.enabled = True
 
     def disable(self):
@@ -98,6 +105,28 @@ class sort(hoomd.meta._metadata):
         self.period = period
         self._cpp.setPeriod(hoomd.context.current.system.getCurrentTimeStep(), self.period)
 
+    def set_params(self, tolerance=None):
+        """ Set parameters for the sorter.
+
+        Args:
+            tolerance (float): Sort only when more than this fraction of particles is scattered
+                in memory, or 0 to sort every *period* time steps.
+
+        A particle is scattered when it is stored further from the particle before it in cell
+        list order than the width of one cell in the cell list.
+
+        Examples::
+
+            sorter.set_params(tolerance=0.1)
+            sorter.set_period(period=10)
+
+        """
+        hoomd.util.print_status_line()
+
+        if tolerance is not None:
+            self._cpp.setTolerance(tolerance)
+            self.tolerance = tolerance
+
     def tune(self, start, stop, step, tsteps, quiet=False):
         """ Tune the sorting period.
 
@@ -0,0 +1,105 @@
+# -*- coding: iso-8859-1 -*-
+
+from hoomd import *
+import hoomd;
+import unittest
+import os
+import numpy
+import tempfile
+
+# unit tests for dump.checkpoint and init.read_checkpoint
+class checkpoint_tests (unittest.TestCase):
+    def setUp(self):
+        context.initialize()
+        if comm.get_rank() == 0:
+            self.tmp_dir = tempfile.mkdtemp();
+            self.tmp_file = os.path.join(self.tmp_dir, 'test.ckp');
+        else:
+            self.tmp_file = "invalid";
+
+        self.snapshot = data.make_snapshot(N=4, box=data.boxdim(Lx=10, Ly=20, Lz=30, xy=0.5), particle_types=['A', 'B'], bond_types=['bondA'], dtype='double');
+        if comm.get_rank() == 0:
+            self.snapshot.particles.position[:] = [[0,1,2], [1,2,3], [0,-1,-2], [-1,-2,-3]];
+            self.snapshot.particles.velocity[:] = [[10,11,12], [11,12,13], [12,13,14], [13,14,15]];
+            self.snapshot.particles.typeid[:] = [0,0,1,1];
+            self.snapshot.particles.mass[:] = [33, 34, 35, 36];
+            self.snapshot.particles.charge[:] = [44, 45, 46, 47];
+            self.snapshot.particles.diameter[:] = [55, 56, 57, 58];
+            self.snapshot.particles.image[:] = [[60,61,62], [63,64,65], [66,67,68], [69,70,71]];
+            self.snapshot.particles.orientation[:] = [[1,0,0,0], [0,1,0,0], [0,0,1,0], [0,0,0,1]];
+
+            self.snapshot.bonds.resize(2);
+            self.snapshot.bonds.group[:] = [[0,1], [2,3]];
+
+    # test that a restored system matches the one that was written
+    def test_write_read(self):
+        init.read_snapshot(self.snapshot);
+        context.current.system.setCurrentTimeStep(123);
+        dump.checkpoint(filename=self.tmp_file, period=None);
+
+        context.initialize();
+        system = init.read_checkpoint(self.tmp_file);
+        self.assertEqual(context.current.system.getCurrentTimeStep(), 123);
+
+        snap = system.take_snapshot(all=True);
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.box.Lx, 10);
+            self.assertEqual(snap.box.xy, 0.5);
+            self.assertEqual(snap.particles.N, 4);
+            self.assertEqual(snap.particles.types, ['A', 'B']);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass);
+            numpy.testing.assert_array_equal(snap.particles.charge, self.snapshot.particles.charge);
+            numpy.testing.assert_array_equal(snap.particles.diameter, self.snapshot.particles.diameter);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+            numpy.testing.assert_array_equal(snap.particles.orientation, self.snapshot.particles.orientation);
+            self.assertEqual(snap.bonds.N, 2);
+            self.assertEqual(snap.bonds.types, ['bondA']);
+            numpy.testing.assert_array_equal(snap.bonds.group, self.snapshot.bonds.group);
+
+    # test that removed particles leave holes in the tag space after restoring
+    def test_removed_tags(self):
+        system = init.read_snapshot(self.snapshot);
+        system.particles.remove(1);
+        dump.checkpoint(filename=self.tmp_file, period=None);
+
+        context.initialize();
+        system = init.read_checkpoint(self.tmp_file);
+        self.assertEqual(len(system.particles), 3);
+        self.assertEqual(system.particles.get(2).position, (0,-1,-2));
+        self.assertEqual(system.particles.add('A'), 1);
+
+    # test that the simulation continues from a checkpoint
+    def test_run(self):
+        init.read_snapshot(self.snapshot);
+        ckp = dump.checkpoint(filename=self.tmp_file, period=10);
+        run(10);
+
+        context.initialize();
+        init.read_checkpoint(self.tmp_file);
+        self.assertEqual(context.current.system.getCurrentTimeStep(), 10);
+        run(10);
+
+    # test that only the data files of the latest checkpoint are kept
+    def test_replace(self):
+        init.read_snapshot(self.snapshot);
+        ckp = dump.checkpoint(filename=self.tmp_file, period=10);
+        run(21);
+
+        comm.barrier_all();
+        if comm.get_rank() == 0:
+            files = sorted(os.listdir(self.tmp_dir));
+            expected = ['test.ckp'] + ['test.ckp.20.%d' % r for r in range(comm.get_num_ranks())];
+            self.assertEqual(files, sorted(expected));
+
+    def tearDown(self):
+        if comm.get_rank() == 0:
+            for f in os.listdir(self.tmp_dir):
+                os.remove(os.path.join(self.tmp_dir, f));
+            os.rmdir(self.tmp_dir);
+        comm.barrier_all();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
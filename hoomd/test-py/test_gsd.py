@@ -376,6 +376,25 @@ class gsd_read_tests (unittest.TestCase):
             numpy.testing.assert_array_equal(snap.pairs.group, self.snapshot.pairs.group);
 
 
+    # tests data.gsd_snapshot with a memory mapped file
+    def test_gsd_snapshot_mmap(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=None, overwrite=True);
+
+        snap = data.gsd_snapshot(self.tmp_file, frame=0, mmap=True);
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, self.snapshot.particles.N);
+            self.assertEqual(snap.particles.types, self.snapshot.particles.types);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.orientation, self.snapshot.particles.orientation);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+
+            self.assertEqual(snap.bonds.types, self.snapshot.bonds.types);
+            numpy.testing.assert_array_equal(snap.bonds.group, self.snapshot.bonds.group);
+            numpy.testing.assert_array_equal(snap.constraints.value, self.snapshot.constraints.value);
+            numpy.testing.assert_array_equal(snap.pairs.group, self.snapshot.pairs.group);
+
+
     # test changing the order particles
     def test_remove(self):
         # remove particle so that tag 2 points to no particle, and particle tags are no longer contiguous
@@ -11,12 +11,36 @@ import os
 class update_sorter_tests (unittest.TestCase):
     def setUp(self):
         print
-        init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
+        self.s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
 
     # test set_params
     def test_set_params(self):
 
         context.current.sorter.set_params(grid=20);
+        context.current.sorter.set_params(tolerance=1.5);
+        context.current.sorter.set_params(tolerance=0);
+        self.assertRaises(RuntimeError, context.current.sorter.set_params, tolerance=0.5);
+
+    # test that sorting only permutes the particles
+    def test_sort(self):
+        snap = self.s.take_snapshot();
+        context.current.sorter.set_params(grid=1024);
+        context.current.sorter.cpp_updater.update(0);
+
+        for p in self.s.particles:
+            pos = p.position;
+            if comm.get_rank() == 0:
+                self.assertAlmostEqual(pos[0], snap.particles.position[p.tag][0], places=5)
+                self.assertAlmostEqual(pos[1], snap.particles.position[p.tag][1], places=5)
+                self.assertAlmostEqual(pos[2], snap.particles.position[p.tag][2], places=5)
+
+    # test adaptive sorting
+    def test_tolerance(self):
+        context.current.sorter.set_params(tolerance=2.0);
+        context.current.sorter.set_period(1);
+        run(10);
+
+        self.assertGreater(context.current.sorter.cpp_updater.getLocality(), 0.0);
 
     def tearDown(self):
         context.initialize();
@@ -223,6 +223,161 @@ UP_TEST( ParticleGroup_sort_test )
     }
     }
 
+//! Helper to verify the index list of a group against the current tags
+void check_group_indices(const ParticleGroup& group, std::shared_ptr<ParticleData> pdata, unsigned int max_tag)
+    {
+    unsigned int n_members = 0;
+    unsigned int last_idx = 0;
+    for (unsigned int i = 0; i < group.getNumMembers(); i++)
+        {
+        unsigned int idx = group.getMemberIndex(i);
+        if (i > 0)
+            UP_ASSERT(idx > last_idx);
+        last_idx = idx;
+        }
+
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        if (h_tag.data[i] <= max_tag)
+            {
+            UP_ASSERT(group.isMember(i));
+            n_members++;
+            }
+        else
+            UP_ASSERT(!group.isMember(i));
+        }
+    CHECK_EQUAL_UINT(group.getNumMembers(), n_members);
+    }
+
+//! Checks that ParticleGroup updates its index list incrementally when particles are permuted, removed and added
+/*! The group holds at most one in eight particles, so that the index list is updated from the member tags instead of
+    being rebuilt.
+*/
+UP_TEST( ParticleGroup_incremental_test )
+    {
+    const unsigned int N = 100;
+    BoxDim box(10.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, box, 1));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<ParticleSelector> selector09(new ParticleSelectorTag(sysdef, 0, 9));
+    ParticleGroup tags09(sysdef, selector09);
+    CHECK_EQUAL_UINT(tags09.getNumMembers(), 10);
+    check_group_indices(tags09, pdata, 9);
+
+    // permute the particles, without adding any
+    {
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_tag.data[i] = (i*37) % N;
+        h_rtag.data[(i*37) % N] = i;
+        }
+    }
+
+    pdata->notifyParticleSort(pdata->getN());
+    check_group_indices(tags09, pdata, 9);
+
+    // permute the particles twice before accessing the group
+    {
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_tag.data[i] = N-1-i;
+        h_rtag.data[N-1-i] = i;
+        }
+    }
+    pdata->notifyParticleSort(pdata->getN());
+
+    {
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        h_tag.data[i] = (i+55) % N;
+        h_rtag.data[(i+55) % N] = i;
+        }
+    }
+    pdata->notifyParticleSort(pdata->getN());
+    check_group_indices(tags09, pdata, 9);
+    CHECK_EQUAL_UINT(tags09.getNumMembers(), 10);
+
+    #ifdef ENABLE_MPI
+    // members depart: remove three members and two non-members, as done in particle migration
+    std::vector<pdata_element> out;
+    std::vector<unsigned int> comm_flags;
+    {
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_comm_flags(pdata->getCommFlags(), access_location::host, access_mode::readwrite);
+    h_comm_flags.data[h_rtag.data[1]] = 1;
+    h_comm_flags.data[h_rtag.data[3]] = 1;
+    h_comm_flags.data[h_rtag.data[8]] = 1;
+    h_comm_flags.data[h_rtag.data[42]] = 1;
+    h_comm_flags.data[h_rtag.data[77]] = 1;
+    }
+
+    pdata->removeParticles(out, comm_flags);
+    CHECK_EQUAL_UINT(pdata->getN(), N-5);
+    check_group_indices(tags09, pdata, 9);
+    CHECK_EQUAL_UINT(tags09.getNumMembers(), 7);
+
+    // members arrive: add them back after another member departed, without accessing the group in between
+    {
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_comm_flags(pdata->getCommFlags(), access_location::host, access_mode::readwrite);
+    h_comm_flags.data[h_rtag.data[0]] = 1;
+    }
+    std::vector<pdata_element> out2;
+    pdata->removeParticles(out2, comm_flags);
+    pdata->addParticles(out);
+    CHECK_EQUAL_UINT(pdata->getN(), N-1);
+    check_group_indices(tags09, pdata, 9);
+    CHECK_EQUAL_UINT(tags09.getNumMembers(), 9);
+
+    // permute the particles after the arrival, before accessing the group
+    pdata->addParticles(out2);
+    {
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int tag = h_tag.data[(i*37) % N];
+        h_tag.data[(i*37) % N] = h_tag.data[i];
+        h_tag.data[i] = tag;
+        h_rtag.data[h_tag.data[i]] = i;
+        h_rtag.data[h_tag.data[(i*37) % N]] = (i*37) % N;
+        }
+    }
+    pdata->notifyParticleSort(pdata->getN());
+    CHECK_EQUAL_UINT(pdata->getN(), N);
+    check_group_indices(tags09, pdata, 9);
+    CHECK_EQUAL_UINT(tags09.getNumMembers(), 10);
+
+    // members keep departing and arriving without the group being accessed, which stops the incremental tracking
+    for (unsigned int cycle = 0; cycle < 20; cycle++)
+        {
+        std::vector<pdata_element> out3;
+        {
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_comm_flags(pdata->getCommFlags(), access_location::host, access_mode::readwrite);
+        h_comm_flags.data[h_rtag.data[cycle % 10]] = 1;
+        }
+        pdata->removeParticles(out3, comm_flags);
+        pdata->addParticles(out3);
+        }
+    CHECK_EQUAL_UINT(pdata->getN(), N);
+    check_group_indices(tags09, pdata, 9);
+    CHECK_EQUAL_UINT(tags09.getNumMembers(), 10);
+    #endif
+    }
+
 //! Checks that ParticleGroup can initialize by particle type
 UP_TEST( ParticleGroup_type_test )
     {
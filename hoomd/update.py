@@ -225,8 +225,17 @@ class sort(_updater):
     of the simulation is held constant, and the default is chosen to be as fine as possible
     without utilizing too much memory. The grid size can be changed with :py:meth:`set_params()`.
 
+    On the CPU, the position along the curve is computed directly for every particle and the
+    grid may be as large as 2097152 in 3D (2147483648 in 2D) without using any additional memory.
+    Finer grids need more radix sort passes.
+
+    The sorter can also sort adaptively. With *tolerance* set in :py:meth:`set_params()`, it
+    measures the mean distance between particles that are adjacent in memory every *period* time
+    steps and only sorts once that distance has grown by more than a factor of *tolerance* since
+    the last sort. Use a short period with this option.
+
     Warning:
-        Memory usage by the sorter grows quickly with the grid size:
+        On the GPU, memory usage by the sorter grows quickly with the grid size:
 
         * grid=128 uses 8 MB
         * grid=256 uses 64 MB
@@ -262,14 +271,18 @@ class sort(_updater):
 
         self.setupUpdater(default_period);
 
-    def set_params(self, grid=None):
+    def set_params(self, grid=None, tolerance=None):
         R""" Change sorter parameters.
 
         Args:
             grid (int): New grid dimension (if set)
+            tolerance (float): Sort only when locality has degraded by more than this factor since the last sort,
+                               0 to sort every *period* time steps (if set)
 
         Examples::
             sorter.set_params(grid=128)
+            sorter.set_params(tolerance=1.5)
+            sorter.set_period(10)
         """
 
         hoomd.util.print_status_line();
@@ -278,6 +291,9 @@ class sort(_updater):
         if grid is not None:
             self.cpp_updater.setGrid(grid);
 
+        if tolerance is not None:
+            self.cpp_updater.setTolerance(tolerance);
+
 class box_resize(_updater):
     R""" Rescale the system box size.
 